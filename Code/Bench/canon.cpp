@@ -0,0 +1,65 @@
+#include <catch2/catch_all.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <GraphMol/ROMol.h>
+#include <GraphMol/new_canon.h>
+#include <GraphMol/SmilesParse/SmilesParse.h>
+
+using namespace RDKit;
+
+namespace {
+std::string repeat(const std::string &unit, unsigned int n) {
+  std::string res;
+  res.reserve(unit.size() * n);
+  for (unsigned int i = 0; i < n; ++i) {
+    res += unit;
+  }
+  return res;
+}
+
+// a branched polyamide where every generation doubles the number of arms
+std::string dendrimer(unsigned int generations) {
+  if (!generations) {
+    return "N";
+  }
+  auto arm = dendrimer(generations - 1);
+  return "CC(=O)N(" + arm + ")" + arm;
+}
+
+// highly symmetric molecules and macromolecules, where canonical ranking
+// needs many refinement passes
+std::vector<std::pair<std::string, std::string>> symmetricCases() {
+  return {
+      {"C60",
+       "C12=C3C4=C5C6=C1C7=C8C9=C1C%10=C%11C(=C29)C3=C2C3=C4C4=C5C5=C9C6=C7C6="
+       "C7C8=C1C1=C8C%10=C%10C%11=C2C2=C3C3=C4C4=C5C5=C%11C%12=C(C6=C95)C7=C1C1"
+       "=C%12C5=C%11C4=C3C3=C5C(=C81)C%10=C23"},
+      {"C1000 chain", repeat("C", 1000)},
+      {"C1000 ring", "C1" + repeat("C", 998) + "C1"},
+      {"dendrimer G7", dendrimer(7)},
+      {"polyglycine 200", "N" + repeat("CC(=O)N", 199) + "CC(=O)O"},
+      {"polyalanine 200", repeat("NC(C)C(=O)", 200) + "O"},
+      {"poly-p-phenylene 100", "C" + repeat("c1ccc(cc1)", 100) + "C"},
+  };
+}
+}  // namespace
+
+TEST_CASE("Canon::rankMolAtoms symmetric", "[canon]") {
+  for (const auto &[name, smiles] : symmetricCases()) {
+    auto mol = v2::SmilesParse::MolFromSmiles(smiles);
+    REQUIRE(mol);
+
+    BENCHMARK("Canon::rankMolAtoms: " + name) {
+      std::vector<unsigned int> ranks;
+      Canon::rankMolAtoms(*mol, ranks);
+      return ranks;
+    };
+    BENCHMARK("Canon::rankMolAtoms no tie breaking: " + name) {
+      std::vector<unsigned int> ranks;
+      Canon::rankMolAtoms(*mol, ranks, false);
+      return ranks;
+    };
+  }
+}
@@ -0,0 +1,60 @@
+#include <catch2/catch_all.hpp>
+#include <memory>
+#include <vector>
+
+#include "bench_common.hpp"
+
+#include <GraphMol/FrozenMol.h>
+#include <GraphMol/ROMol.h>
+#include <GraphMol/Descriptors/MolSurf.h>
+#include <GraphMol/Fingerprints/FingerprintUtil.h>
+#include <GraphMol/SmilesParse/SmilesParse.h>
+
+using namespace RDKit;
+
+namespace {
+std::vector<std::unique_ptr<RWMol>> getMols() {
+  std::vector<std::unique_ptr<RWMol>> mols;
+  for (auto smiles : bench_common::CASES) {
+    mols.push_back(v2::SmilesParse::MolFromSmiles(smiles));
+    REQUIRE(mols.back());
+  }
+  return mols;
+}
+}  // namespace
+
+TEST_CASE("TPSA and Morgan invariants", "[descriptors]") {
+  auto mols = getMols();
+  std::vector<FrozenMol> frozen;
+  for (const auto &mol : mols) {
+    frozen.emplace_back(*mol);
+  }
+  BENCHMARK("ROMol") {
+    double res = 0;
+    for (const auto &mol : mols) {
+      res += Descriptors::calcTPSA(*mol, true);
+      std::vector<std::uint32_t> invars(mol->getNumAtoms());
+      MorganFingerprints::getConnectivityInvariants(*mol, invars);
+      res += invars[0];
+    }
+    return res;
+  };
+  BENCHMARK("FrozenMol") {
+    double res = 0;
+    for (const auto &mol : frozen) {
+      res += Descriptors::calcTPSA(mol);
+      std::vector<std::uint32_t> invars(mol.getNumAtoms());
+      MorganFingerprints::getConnectivityInvariants(mol, invars);
+      res += invars[0];
+    }
+    return res;
+  };
+  BENCHMARK("FrozenMol construction") {
+    unsigned int res = 0;
+    for (const auto &mol : mols) {
+      FrozenMol fmol(*mol);
+      res += fmol.getNumBonds();
+    }
+    return res;
+  };
+}
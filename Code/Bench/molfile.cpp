@@ -0,0 +1,85 @@
+#include <catch2/catch_all.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench_common.hpp"
+
+#include <GraphMol/ROMol.h>
+#include <GraphMol/FileParsers/FileParsers.h>
+#include <GraphMol/FileParsers/MolSupplier.h>
+#include <GraphMol/SmilesParse/SmilesParse.h>
+
+using namespace RDKit;
+
+namespace {
+std::vector<std::string> getMolBlocks(bool forceV3000) {
+  std::vector<std::string> res;
+  for (auto smiles : bench_common::CASES) {
+    auto mol = v2::SmilesParse::MolFromSmiles(smiles);
+    REQUIRE(mol);
+    res.push_back(MolToMolBlock(*mol, true, -1, true, forceV3000));
+  }
+  return res;
+}
+}  // namespace
+
+TEST_CASE("MolFromMolBlock", "[molfile]") {
+  for (auto forceV3000 : {false, true}) {
+    const auto molBlocks = getMolBlocks(forceV3000);
+    for (auto sanitize : {true, false}) {
+      v2::FileParsers::MolFileParserParams ps;
+      ps.sanitize = sanitize;
+      ps.removeHs = sanitize;
+      BENCHMARK("MolFromMolBlock " + std::to_string(molBlocks.size()) +
+                (forceV3000 ? " V3000" : " V2000") + " mol blocks" +
+                (sanitize ? "" : ", no sanitization")) {
+        unsigned int nAtoms = 0;
+        for (const auto &molBlock : molBlocks) {
+          // the string_view means that the block is parsed in place
+          auto mol = v2::FileParsers::MolFromMolBlock(
+              std::string_view(molBlock), ps);
+          REQUIRE(mol);
+          nAtoms += mol->getNumAtoms();
+        }
+        return nAtoms;
+      };
+    }
+  }
+}
+
+TEST_CASE("SD file throughput", "[molfile]") {
+  // use the standard NCI subset if we can find it, otherwise build an SD
+  // file from the benchmark cases
+  std::string sdText;
+  if (const char *rdbase = std::getenv("RDBASE")) {
+    std::ifstream inStream(std::string(rdbase) +
+                           "/Data/NCI/first_200.props.sdf");
+    sdText.assign(std::istreambuf_iterator<char>(inStream),
+                  std::istreambuf_iterator<char>());
+  }
+  if (sdText.empty()) {
+    for (const auto &molBlock : getMolBlocks(false)) {
+      sdText += molBlock + "$$$$\n";
+    }
+  }
+  v2::FileParsers::MolFileParserParams ps;
+  ps.sanitize = false;
+  BENCHMARK("ForwardSDMolSupplier, no sanitization") {
+    std::istringstream inStream(sdText);
+    v2::FileParsers::ForwardSDMolSupplier suppl(&inStream, false, ps);
+    unsigned int nAtoms = 0;
+    while (!suppl.atEnd()) {
+      auto mol = suppl.next();
+      if (mol) {
+        nAtoms += mol->getNumAtoms();
+      }
+    }
+    return nAtoms;
+  };
+}
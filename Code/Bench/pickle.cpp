@@ -0,0 +1,104 @@
+#include <catch2/catch_all.hpp>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+
+#include <GraphMol/MolPickler.h>
+#include <GraphMol/ROMol.h>
+#include <GraphMol/Conformer.h>
+#include <GraphMol/SmilesParse/SmilesParse.h>
+
+using namespace RDKit;
+
+namespace {
+// fake conformers: each atom is a bond length away from a neighbor with a
+// lower index, so the coordinates look like those of real molecules
+void addConformers(RWMol &mol, unsigned int numConfs) {
+  std::mt19937 gen(42);
+  std::normal_distribution<double> dist;
+  for (unsigned int i = 0; i < numConfs; ++i) {
+    auto conf = new Conformer(mol.getNumAtoms());
+    for (const auto atom : mol.atoms()) {
+      auto idx = atom->getIdx();
+      if (!idx) {
+        continue;
+      }
+      auto from = idx - 1;
+      for (const auto nbr : mol.atomNeighbors(atom)) {
+        if (nbr->getIdx() < idx) {
+          from = nbr->getIdx();
+          break;
+        }
+      }
+      RDGeom::Point3D step(dist(gen), dist(gen), dist(gen));
+      step.normalize();
+      conf->setAtomPos(idx, conf->getAtomPos(from) + step * 1.5);
+    }
+    mol.addConformer(conf, true);
+  }
+}
+
+std::vector<std::string> getPickles(unsigned int propertyFlags) {
+  std::vector<std::string> pickles;
+  for (auto smiles : bench_common::CASES) {
+    auto mol = v2::SmilesParse::MolFromSmiles(smiles);
+    REQUIRE(mol);
+    addConformers(*mol, 50);
+    pickles.emplace_back();
+    MolPickler::pickleMol(*mol, pickles.back(), propertyFlags);
+  }
+  return pickles;
+}
+
+size_t totalSize(const std::vector<std::string> &pickles) {
+  size_t res = 0;
+  for (const auto &pkl : pickles) {
+    res += pkl.size();
+  }
+  return res;
+}
+}  // namespace
+
+TEST_CASE("pickles with conformers", "[pickle]") {
+  auto floatPickles = getPickles(PicklerOps::NoProps);
+  auto quantizedPickles = getPickles(PicklerOps::CoordsQuantized);
+  CHECK(totalSize(quantizedPickles) < totalSize(floatPickles));
+
+  BENCHMARK("float coordinates") {
+    unsigned int res = 0;
+    for (const auto &pkl : floatPickles) {
+      ROMol mol(pkl);
+      res += mol.getNumConformers();
+    }
+    return res;
+  };
+  BENCHMARK("quantized coordinates") {
+    unsigned int res = 0;
+    for (const auto &pkl : quantizedPickles) {
+      ROMol mol(pkl);
+      res += mol.getNumConformers();
+    }
+    return res;
+  };
+  BENCHMARK("one quantized conformer") {
+    double res = 0;
+    for (const auto &pkl : quantizedPickles) {
+      auto conf = MolPickler::conformerFromPickle(pkl, 25);
+      res += conf->getAtomPos(0).x;
+    }
+    return res;
+  };
+  BENCHMARK("five quantized conformers") {
+    double res = 0;
+    for (const auto &pkl : quantizedPickles) {
+      for (const auto &conf :
+           MolPickler::conformersFromPickle(pkl, {5, 15, 25, 35, 45})) {
+        res += conf->getAtomPos(0).x;
+      }
+    }
+    return res;
+  };
+}
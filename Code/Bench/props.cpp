@@ -0,0 +1,78 @@
+#include <catch2/catch_all.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+
+#include <RDGeneral/Dict.h>
+#include <GraphMol/ROMol.h>
+#include <GraphMol/SmilesParse/SmilesParse.h>
+
+using namespace RDKit;
+
+namespace {
+// every atom gets a handful of properties, the way they would after reading
+// a mapped reaction and assigning stereochemistry
+std::vector<std::unique_ptr<RWMol>> getMols() {
+  std::vector<std::unique_ptr<RWMol>> mols;
+  for (auto smiles : bench_common::CASES) {
+    auto mol = v2::SmilesParse::MolFromSmiles(smiles);
+    REQUIRE(mol);
+    for (auto atom : mol->atoms()) {
+      atom->setAtomMapNum(atom->getIdx() + 1);
+      atom->setProp(common_properties::_CIPRank, atom->getIdx());
+      atom->setProp("some_user_property", 1.0);
+    }
+    mols.push_back(std::move(mol));
+  }
+  return mols;
+}
+}  // namespace
+
+TEST_CASE("atom property lookups", "[props]") {
+  auto mols = getMols();
+  BENCHMARK("hasProp by name") {
+    unsigned int res = 0;
+    for (const auto &mol : mols) {
+      for (const auto atom : mol->atoms()) {
+        res += atom->hasProp(common_properties::_CIPCode);
+        res += atom->hasProp(common_properties::molAtomMapNumber);
+      }
+    }
+    return res;
+  };
+  BENCHMARK("hasProp by key") {
+    unsigned int res = 0;
+    for (const auto &mol : mols) {
+      for (const auto atom : mol->atoms()) {
+        res += atom->hasProp(common_properties::keys::_CIPCode);
+        res += atom->hasProp(common_properties::keys::molAtomMapNumber);
+      }
+    }
+    return res;
+  };
+  BENCHMARK("getPropIfPresent by name") {
+    int res = 0;
+    for (const auto &mol : mols) {
+      for (const auto atom : mol->atoms()) {
+        int mapno = 0;
+        atom->getPropIfPresent(common_properties::molAtomMapNumber, mapno);
+        res += mapno;
+      }
+    }
+    return res;
+  };
+  BENCHMARK("getPropIfPresent by key") {
+    int res = 0;
+    for (const auto &mol : mols) {
+      for (const auto atom : mol->atoms()) {
+        int mapno = 0;
+        atom->getPropIfPresent(common_properties::keys::molAtomMapNumber,
+                               mapno);
+        res += mapno;
+      }
+    }
+    return res;
+  };
+}
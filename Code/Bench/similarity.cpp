@@ -0,0 +1,145 @@
+#include <catch2/catch_all.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <DataStructs/BitOps.h>
+#include <DataStructs/FPBReader.h>
+
+namespace {
+// a block of random fingerprints laid out the same way as the FPB arena
+std::vector<unsigned char> makeFingerprints(unsigned int nFps,
+                                            unsigned int nBytes) {
+  std::mt19937 rng(42);
+  std::bernoulli_distribution bitDist(0.05);
+  std::vector<unsigned char> res(nFps * nBytes, 0);
+  for (unsigned int i = 0; i < res.size() * 8; ++i) {
+    if (bitDist(rng)) {
+      res[i / 8] |= 1 << (i % 8);
+    }
+  }
+  return res;
+}
+
+void addChunk(std::string &fpb, const std::string &tag,
+              const std::string &data) {
+  std::uint64_t sz = data.size();
+  fpb.append(reinterpret_cast<const char *>(&sz), sizeof(sz));
+  fpb += tag;
+  fpb += data;
+}
+
+// an in-memory FPB file with the fingerprints sorted by popcount
+std::string makeFPB(std::vector<unsigned char> fps, unsigned int nBytes) {
+  const unsigned int nFps = fps.size() / nBytes;
+  const unsigned int nBits = nBytes * 8;
+  std::vector<std::pair<unsigned int, unsigned int>> order;
+  for (unsigned int i = 0; i < nFps; ++i) {
+    order.emplace_back(CalcBitmapPopcount(fps.data() + i * nBytes, nBytes), i);
+  }
+  std::sort(order.begin(), order.end());
+
+  std::vector<std::uint32_t> popCounts(nBits + 2, 0);
+  for (const auto &elem : order) {
+    ++popCounts[elem.first + 1];
+  }
+  for (unsigned int i = 1; i < popCounts.size(); ++i) {
+    popCounts[i] += popCounts[i - 1];
+  }
+  std::string arena;
+  std::uint32_t sz = nBytes;
+  arena.append(reinterpret_cast<const char *>(&sz), sizeof(sz));
+  arena.append(reinterpret_cast<const char *>(&sz), sizeof(sz));
+  arena += '\0';  // no spacer
+  for (const auto &elem : order) {
+    arena.append(reinterpret_cast<const char *>(fps.data()) +
+                     elem.second * nBytes,
+                 nBytes);
+  }
+  // every fingerprint gets an empty id
+  std::string ids(8, '\0');
+  std::uint32_t nIds = nFps;
+  ids.replace(0, sizeof(nIds), reinterpret_cast<const char *>(&nIds),
+              sizeof(nIds));
+  ids.append(nFps, '\0');
+  for (std::uint32_t i = 0; i <= nFps; ++i) {
+    std::uint32_t offset = 8 + i;
+    ids.append(reinterpret_cast<const char *>(&offset), sizeof(offset));
+  }
+
+  std::string res("FPB1\r\n\0\0", 8);
+  addChunk(res, "POPC",
+           std::string(reinterpret_cast<const char *>(popCounts.data()),
+                       popCounts.size() * sizeof(std::uint32_t)));
+  addChunk(res, "AREN", arena);
+  addChunk(res, "FPID", ids);
+  addChunk(res, "FEND", "");
+  return res;
+}
+}  // namespace
+
+TEST_CASE("Bitmap Tanimoto", "[similarity]") {
+  const unsigned int nFps = 10000;
+  for (unsigned int nBits : {1024u, 2048u}) {
+    const unsigned int nBytes = nBits / 8;
+    auto fps = makeFingerprints(nFps, nBytes);
+    const unsigned char *probe = fps.data() + 17 * nBytes;
+    std::vector<double> sims(nFps);
+
+    BENCHMARK("CalcBitmapTanimoto: " + std::to_string(nBits) + " bits") {
+      for (unsigned int i = 0; i < nFps; ++i) {
+        sims[i] = CalcBitmapTanimoto(probe, fps.data() + i * nBytes, nBytes);
+      }
+      return sims.back();
+    };
+    BENCHMARK("CalcBitmapTanimotoBatch: " + std::to_string(nBits) + " bits") {
+      CalcBitmapTanimotoBatch(probe, fps.data(), nFps, nBytes, nBytes,
+                              sims.data());
+      return sims.back();
+    };
+
+    std::vector<unsigned int> common(nFps);
+    BENCHMARK("CalcBitmapNumBitsInCommonBatch: " + std::to_string(nBits) +
+              " bits") {
+      CalcBitmapNumBitsInCommonBatch(probe, fps.data(), nFps, nBytes, nBytes,
+                                     common.data());
+      return common.back();
+    };
+  }
+}
+
+TEST_CASE("FPBReader bulk neighbors", "[similarity]") {
+  const unsigned int nDb = 20000;
+  const unsigned int nQueries = 50;
+  const unsigned int nBytes = 128;
+  auto fps = makeFingerprints(nDb + nQueries, nBytes);
+  std::vector<unsigned char> dbFps(fps.begin(), fps.begin() + nDb * nBytes);
+  RDKit::FPBReader reader(new std::istringstream(makeFPB(dbFps, nBytes)));
+  reader.init();
+  std::vector<const std::uint8_t *> queries;
+  for (unsigned int i = 0; i < nQueries; ++i) {
+    queries.push_back(fps.data() + (nDb + i) * nBytes);
+  }
+
+  for (double threshold : {0.3, 0.7}) {
+    const auto suffix = " threshold " + std::to_string(threshold).substr(0, 3);
+    BENCHMARK("getTanimotoNeighbors per query:" + suffix) {
+      size_t nHits = 0;
+      for (const auto query : queries) {
+        nHits += reader.getTanimotoNeighbors(query, threshold).size();
+      }
+      return nHits;
+    };
+    BENCHMARK("getBulkTanimotoNeighbors:" + suffix) {
+      size_t nHits = 0;
+      for (const auto &hits :
+           reader.getBulkTanimotoNeighbors(queries, threshold)) {
+        nHits += hits.size();
+      }
+      return nHits;
+    };
+  }
+}
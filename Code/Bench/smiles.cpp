@@ -1,5 +1,9 @@
 #include <catch2/catch_all.hpp>
+#include <iterator>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "bench_common.hpp"
 
@@ -19,6 +23,43 @@ TEST_CASE("SmilesToMol", "[smiles]") {
   }
 }
 
+TEST_CASE("SmilesToMol fast parser", "[smiles]") {
+  v2::SmilesParse::SmilesParserParams ps;
+  ps.useFastParser = true;
+  for (auto smiles : bench_common::CASES) {
+    BENCHMARK("SmilesToMol fast parser: " + std::string(smiles)) {
+      auto mol = v2::SmilesParse::MolFromSmiles(smiles, ps);
+      REQUIRE(mol);
+      return mol;
+    };
+  }
+}
+
+TEST_CASE("SmilesToMol throughput", "[smiles]") {
+  // each iteration parses all of the cases, without sanitization the
+  // parser is most of the work
+  const auto nCases = std::size(bench_common::CASES);
+  for (auto sanitize : {true, false}) {
+    for (auto fast : {false, true}) {
+      v2::SmilesParse::SmilesParserParams ps;
+      ps.sanitize = sanitize;
+      ps.removeHs = sanitize;
+      ps.useFastParser = fast;
+      BENCHMARK("SmilesToMol " + std::to_string(nCases) + " SMILES" +
+                (sanitize ? "" : ", no sanitization") +
+                (fast ? ", fast parser" : ", bison parser")) {
+        unsigned int nAtoms = 0;
+        for (auto smiles : bench_common::CASES) {
+          auto mol = v2::SmilesParse::MolFromSmiles(smiles, ps);
+          REQUIRE(mol);
+          nAtoms += mol->getNumAtoms();
+        }
+        return nAtoms;
+      };
+    }
+  }
+}
+
 TEST_CASE("MolToSmiles", "[smiles]") {
   for (auto smiles : bench_common::CASES) {
     auto mol = v2::SmilesParse::MolFromSmiles(smiles);
@@ -28,3 +69,32 @@ TEST_CASE("MolToSmiles", "[smiles]") {
     };
   }
 }
+
+TEST_CASE("MolToSmiles throughput", "[smiles]") {
+  std::vector<std::unique_ptr<ROMol>> mols;
+  std::vector<const ROMol *> molPtrs;
+  for (auto smiles : bench_common::CASES) {
+    mols.push_back(v2::SmilesParse::MolFromSmiles(smiles));
+    REQUIRE(mols.back());
+    molPtrs.push_back(mols.back().get());
+  }
+  SmilesWriteParams ps;
+  BENCHMARK("MolToSmiles " + std::to_string(mols.size()) +
+            " molecules, reused buffer") {
+    std::string smi;
+    size_t nChars = 0;
+    for (const auto &mol : mols) {
+      MolToSmiles(*mol, smi, ps);
+      nChars += smi.size();
+    }
+    return nChars;
+  };
+  for (auto numThreads : {1, 4}) {
+    BENCHMARK("MolsToSmiles " + std::to_string(mols.size()) + " molecules, " +
+              std::to_string(numThreads) + " threads") {
+      std::ostringstream oss;
+      MolsToSmiles(molPtrs, oss, ps, numThreads);
+      return oss.str().size();
+    };
+  }
+}
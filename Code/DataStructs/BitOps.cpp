@@ -18,6 +18,7 @@
 #include <RDGeneral/Exceptions.h>
 #include <sstream>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
 
 #include <boost/lexical_cast.hpp>
@@ -26,6 +27,16 @@
 #include <intrin.h>
 #endif
 
+// the batched bitmap operations at the end of this file can use AVX2 and
+// AVX-512 kernels. These are compiled using function-level target attributes
+// and selected at runtime based on what the CPU supports, so the library
+// itself does not require any special compiler flags.
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+#define RDK_BITMAP_BATCH_DISPATCH
+#include <immintrin.h>
+#endif
+
 using namespace RDKit;
 
 int getBitId(const char *&text, int format, int size, int curr) {
@@ -1103,3 +1114,299 @@ bool CalcBitmapAllProbeBitsMatch(const unsigned char *probe,
 #endif
   return true;
 }
+
+//-----------------------------------------------------
+//  Batched bitmap operations
+//
+// These compare a single probe against a block of fingerprints which are
+// stored with a fixed stride (this is the layout used in the FPB arena).
+namespace {
+using BitmapBatchCountFunc = void (*)(const unsigned char *,
+                                      const unsigned char *, unsigned int,
+                                      unsigned int, unsigned int,
+                                      unsigned int *, unsigned int *);
+
+// the reference implementation, this is used on CPUs without AVX2 support
+// and to handle any bytes left over by the vectorized kernels
+template <bool withCounts>
+void bitmapBatchCountsScalar(const unsigned char *probe,
+                             const unsigned char *fps, unsigned int nFps,
+                             unsigned int nBytes, unsigned int stride,
+                             unsigned int *common, unsigned int *counts) {
+  for (unsigned int i = 0; i < nFps; ++i) {
+    const unsigned char *fp = fps + static_cast<std::size_t>(i) * stride;
+    common[i] = CalcBitmapNumBitsInCommon(probe, fp, nBytes);
+    if (withCounts) {
+      counts[i] = CalcBitmapPopcount(fp, nBytes);
+    }
+  }
+}
+
+#ifdef RDK_BITMAP_BATCH_DISPATCH
+// AVX2 does not have a popcount instruction, so we use the nibble lookup
+// approach from Mula, Kurz, and Lemire (https://arxiv.org/abs/1611.07612)
+// the per-byte counts are summed into 64 bit lanes with vpsadbw
+__attribute__((target("avx2"))) inline __m256i popcount256(__m256i v) {
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1,
+                       1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i lowMask = _mm256_set1_epi8(0x0f);
+  __m256i lo = _mm256_and_si256(v, lowMask);
+  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask);
+  __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                _mm256_shuffle_epi8(lookup, hi));
+  return _mm256_sad_epu8(cnt, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2"))) inline unsigned int hsum256(__m256i v) {
+  alignas(32) std::uint64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), v);
+  return static_cast<unsigned int>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+
+template <bool withCounts>
+__attribute__((target("avx2"))) void bitmapBatchCountsAVX2(
+    const unsigned char *probe, const unsigned char *fps, unsigned int nFps,
+    unsigned int nBytes, unsigned int stride, unsigned int *common,
+    unsigned int *counts) {
+  const unsigned int nVecs = nBytes / sizeof(__m256i);
+  const unsigned int tail = nVecs * sizeof(__m256i);
+  for (unsigned int i = 0; i < nFps; ++i) {
+    const unsigned char *fp = fps + static_cast<std::size_t>(i) * stride;
+    __m256i commonAcc = _mm256_setzero_si256();
+    __m256i countAcc = _mm256_setzero_si256();
+    for (unsigned int v = 0; v < nVecs; ++v) {
+      __m256i f = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(fp + v * sizeof(__m256i)));
+      __m256i p = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(probe + v * sizeof(__m256i)));
+      commonAcc =
+          _mm256_add_epi64(commonAcc, popcount256(_mm256_and_si256(p, f)));
+      if (withCounts) {
+        countAcc = _mm256_add_epi64(countAcc, popcount256(f));
+      }
+    }
+    common[i] = hsum256(commonAcc);
+    if (withCounts) {
+      counts[i] = hsum256(countAcc);
+    }
+    if (tail < nBytes) {
+      common[i] +=
+          CalcBitmapNumBitsInCommon(probe + tail, fp + tail, nBytes - tail);
+      if (withCounts) {
+        counts[i] += CalcBitmapPopcount(fp + tail, nBytes - tail);
+      }
+    }
+  }
+}
+
+template <bool withCounts>
+__attribute__((target("avx512f,avx512vpopcntdq"))) void
+bitmapBatchCountsAVX512(const unsigned char *probe, const unsigned char *fps,
+                        unsigned int nFps, unsigned int nBytes,
+                        unsigned int stride, unsigned int *common,
+                        unsigned int *counts) {
+  const unsigned int nVecs = nBytes / sizeof(__m512i);
+  const unsigned int tail = nVecs * sizeof(__m512i);
+  for (unsigned int i = 0; i < nFps; ++i) {
+    const unsigned char *fp = fps + static_cast<std::size_t>(i) * stride;
+    __m512i commonAcc = _mm512_setzero_si512();
+    __m512i countAcc = _mm512_setzero_si512();
+    for (unsigned int v = 0; v < nVecs; ++v) {
+      __m512i f = _mm512_loadu_si512(fp + v * sizeof(__m512i));
+      __m512i p = _mm512_loadu_si512(probe + v * sizeof(__m512i));
+      commonAcc = _mm512_add_epi64(commonAcc,
+                                   _mm512_popcnt_epi64(_mm512_and_si512(p, f)));
+      if (withCounts) {
+        countAcc = _mm512_add_epi64(countAcc, _mm512_popcnt_epi64(f));
+      }
+    }
+    common[i] = static_cast<unsigned int>(_mm512_reduce_add_epi64(commonAcc));
+    if (withCounts) {
+      counts[i] = static_cast<unsigned int>(_mm512_reduce_add_epi64(countAcc));
+    }
+    if (tail < nBytes) {
+      common[i] +=
+          CalcBitmapNumBitsInCommon(probe + tail, fp + tail, nBytes - tail);
+      if (withCounts) {
+        counts[i] += CalcBitmapPopcount(fp + tail, nBytes - tail);
+      }
+    }
+  }
+}
+#endif
+
+template <bool withCounts>
+BitmapBatchCountFunc chooseBitmapBatchCounts() {
+#ifdef RDK_BITMAP_BATCH_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx512vpopcntdq")) {
+    return bitmapBatchCountsAVX512<withCounts>;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return bitmapBatchCountsAVX2<withCounts>;
+  }
+#endif
+  return bitmapBatchCountsScalar<withCounts>;
+}
+
+template <bool withCounts>
+BitmapBatchCountFunc getBitmapBatchCounts() {
+  static const BitmapBatchCountFunc func =
+      chooseBitmapBatchCounts<withCounts>();
+  return func;
+}
+
+void checkBatchArgs(const unsigned char *probe, const unsigned char *fps,
+                    unsigned int nFps, unsigned int nBytes,
+                    unsigned int stride, const void *res) {
+  PRECONDITION(probe, "no probe");
+  PRECONDITION(!nFps || fps, "no fps");
+  PRECONDITION(!nFps || res, "no result storage");
+  PRECONDITION(stride >= nBytes, "stride must be at least nBytes");
+}
+
+// the subset screen does not need popcounts, a fingerprint fails as soon as
+// one word of (probe & ~fp) is non-zero
+using BitmapBatchMatchFunc = void (*)(const unsigned char *,
+                                      const unsigned char *, unsigned int,
+                                      unsigned int, unsigned int, bool *);
+
+bool bitmapAllProbeBitsMatch(const unsigned char *probe,
+                             const unsigned char *fp, unsigned int nBytes) {
+  const unsigned int nWords = nBytes / sizeof(std::uint64_t);
+  for (unsigned int w = 0; w < nWords; ++w) {
+    std::uint64_t p, f;
+    memcpy(&p, probe + w * sizeof(std::uint64_t), sizeof(std::uint64_t));
+    memcpy(&f, fp + w * sizeof(std::uint64_t), sizeof(std::uint64_t));
+    if (p & ~f) {
+      return false;
+    }
+  }
+  for (unsigned int i = nWords * sizeof(std::uint64_t); i < nBytes; ++i) {
+    if (probe[i] & ~fp[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void bitmapBatchMatchScalar(const unsigned char *probe,
+                            const unsigned char *fps, unsigned int nFps,
+                            unsigned int nBytes, unsigned int stride,
+                            bool *res) {
+  for (unsigned int i = 0; i < nFps; ++i) {
+    res[i] = bitmapAllProbeBitsMatch(
+        probe, fps + static_cast<std::size_t>(i) * stride, nBytes);
+  }
+}
+
+#ifdef RDK_BITMAP_BATCH_DISPATCH
+__attribute__((target("avx2"))) void bitmapBatchMatchAVX2(
+    const unsigned char *probe, const unsigned char *fps, unsigned int nFps,
+    unsigned int nBytes, unsigned int stride, bool *res) {
+  const unsigned int nVecs = nBytes / sizeof(__m256i);
+  const unsigned int tail = nVecs * sizeof(__m256i);
+  for (unsigned int i = 0; i < nFps; ++i) {
+    const unsigned char *fp = fps + static_cast<std::size_t>(i) * stride;
+    bool match = true;
+    for (unsigned int v = 0; v < nVecs && match; ++v) {
+      __m256i f = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(fp + v * sizeof(__m256i)));
+      __m256i p = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(probe + v * sizeof(__m256i)));
+      // testc is set when (~f & p) == 0
+      match = _mm256_testc_si256(f, p);
+    }
+    if (match && tail < nBytes) {
+      match =
+          bitmapAllProbeBitsMatch(probe + tail, fp + tail, nBytes - tail);
+    }
+    res[i] = match;
+  }
+}
+
+__attribute__((target("avx512f"))) void bitmapBatchMatchAVX512(
+    const unsigned char *probe, const unsigned char *fps, unsigned int nFps,
+    unsigned int nBytes, unsigned int stride, bool *res) {
+  const unsigned int nVecs = nBytes / sizeof(__m512i);
+  const unsigned int tail = nVecs * sizeof(__m512i);
+  for (unsigned int i = 0; i < nFps; ++i) {
+    const unsigned char *fp = fps + static_cast<std::size_t>(i) * stride;
+    bool match = true;
+    for (unsigned int v = 0; v < nVecs && match; ++v) {
+      __m512i f = _mm512_loadu_si512(fp + v * sizeof(__m512i));
+      __m512i p = _mm512_loadu_si512(probe + v * sizeof(__m512i));
+      match = !_mm512_test_epi64_mask(_mm512_andnot_si512(f, p),
+                                      _mm512_set1_epi64(-1));
+    }
+    if (match && tail < nBytes) {
+      match =
+          bitmapAllProbeBitsMatch(probe + tail, fp + tail, nBytes - tail);
+    }
+    res[i] = match;
+  }
+}
+#endif
+
+BitmapBatchMatchFunc chooseBitmapBatchMatch() {
+#ifdef RDK_BITMAP_BATCH_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return bitmapBatchMatchAVX512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return bitmapBatchMatchAVX2;
+  }
+#endif
+  return bitmapBatchMatchScalar;
+}
+}  // namespace
+
+void CalcBitmapNumBitsInCommonBatch(const unsigned char *probe,
+                                    const unsigned char *fps,
+                                    unsigned int nFps, unsigned int nBytes,
+                                    unsigned int stride, unsigned int *res) {
+  checkBatchArgs(probe, fps, nFps, nBytes, stride, res);
+  getBitmapBatchCounts<false>()(probe, fps, nFps, nBytes, stride, res,
+                                nullptr);
+}
+
+void CalcBitmapTanimotoBatch(const unsigned char *probe,
+                             const unsigned char *fps, unsigned int nFps,
+                             unsigned int nBytes, unsigned int stride,
+                             double *res) {
+  checkBatchArgs(probe, fps, nFps, nBytes, stride, res);
+  unsigned int probeCount = CalcBitmapPopcount(probe, nBytes);
+  std::vector<unsigned int> common(nFps), counts(nFps);
+  getBitmapBatchCounts<true>()(probe, fps, nFps, nBytes, stride,
+                               common.data(), counts.data());
+  for (unsigned int i = 0; i < nFps; ++i) {
+    unsigned int union_popcount = probeCount + counts[i] - common[i];
+    res[i] = union_popcount ? (common[i] + 0.0) / union_popcount : 0.0;
+  }
+}
+
+void CalcBitmapDiceBatch(const unsigned char *probe, const unsigned char *fps,
+                         unsigned int nFps, unsigned int nBytes,
+                         unsigned int stride, double *res) {
+  checkBatchArgs(probe, fps, nFps, nBytes, stride, res);
+  unsigned int probeCount = CalcBitmapPopcount(probe, nBytes);
+  std::vector<unsigned int> common(nFps), counts(nFps);
+  getBitmapBatchCounts<true>()(probe, fps, nFps, nBytes, stride,
+                               common.data(), counts.data());
+  for (unsigned int i = 0; i < nFps; ++i) {
+    unsigned int denom = probeCount + counts[i];
+    res[i] = denom ? (2.0 * common[i]) / denom : 0.0;
+  }
+}
+
+void CalcBitmapAllProbeBitsMatchBatch(const unsigned char *probe,
+                                      const unsigned char *fps,
+                                      unsigned int nFps, unsigned int nBytes,
+                                      unsigned int stride, bool *res) {
+  checkBatchArgs(probe, fps, nFps, nBytes, stride, res);
+  static const BitmapBatchMatchFunc func = chooseBitmapBatchMatch();
+  func(probe, fps, nFps, nBytes, stride, res);
+}
@@ -334,4 +334,42 @@ RDKIT_DATASTRUCTS_EXPORT double CalcBitmapTversky(const unsigned char *bv1,
                                                   double ca, double cb);
 RDKIT_DATASTRUCTS_EXPORT bool CalcBitmapAllProbeBitsMatch(
     const unsigned char *probe, const unsigned char *ref, unsigned int nBytes);
+
+//! \name Batched bitmap operations
+/*!
+  These compare a single probe against a block of fingerprints that are
+  stored one after another in memory (the layout used by FPB files).
+
+  \param probe   the probe fingerprint, \c nBytes long
+  \param fps     pointer to the first fingerprint in the block
+  \param nFps    the number of fingerprints in the block
+  \param nBytes  the number of bytes in each fingerprint
+  \param stride  the distance (in bytes) between the starts of consecutive
+                 fingerprints in \c fps. Must be at least \c nBytes
+  \param res     used to return the results, must have space for \c nFps
+                 values
+
+  The implementation (AVX-512 VPOPCNTDQ, AVX2 or scalar) is selected at
+  runtime based on the capabilities of the CPU. The results are identical
+  to calling the single-fingerprint versions in a loop.
+ */
+//@{
+RDKIT_DATASTRUCTS_EXPORT void CalcBitmapNumBitsInCommonBatch(
+    const unsigned char *probe, const unsigned char *fps, unsigned int nFps,
+    unsigned int nBytes, unsigned int stride, unsigned int *res);
+RDKIT_DATASTRUCTS_EXPORT void CalcBitmapTanimotoBatch(
+    const unsigned char *probe, const unsigned char *fps, unsigned int nFps,
+    unsigned int nBytes, unsigned int stride, double *res);
+RDKIT_DATASTRUCTS_EXPORT void CalcBitmapDiceBatch(const unsigned char *probe,
+                                                  const unsigned char *fps,
+                                                  unsigned int nFps,
+                                                  unsigned int nBytes,
+                                                  unsigned int stride,
+                                                  double *res);
+//! sets \c res[i] to whether or not all bits set in \c probe are also set in
+//! fingerprint \c i. This is the substructure screen.
+RDKIT_DATASTRUCTS_EXPORT void CalcBitmapAllProbeBitsMatchBatch(
+    const unsigned char *probe, const unsigned char *fps, unsigned int nFps,
+    unsigned int nBytes, unsigned int stride, bool *res);
+//@}
 #endif
@@ -16,9 +16,18 @@
 #include <DataStructs/BitOps.h>
 
 #include <RDGeneral/Invariant.h>
+#include <RDGeneral/MemoryMappedFileReader.h>
 #include <RDGeneral/StreamOps.h>
 #include <RDGeneral/Ranking.h>
+#include <RDGeneral/RDThreads.h>
 #include "FPBReader.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#ifdef RDK_BUILD_THREADSAFE_SSS
+#include <future>
+#endif
 #include <boost/scoped_ptr.hpp>
 #include <boost/scoped_array.hpp>
 
@@ -34,11 +43,14 @@ struct FPBReader_impl {
   unsigned int nBits;
   boost::uint32_t numBytesStoredPerFingerprint;
   std::vector<boost::uint32_t> popCountOffsets;
-  const boost::uint8_t *dp_fpData;  // do not free this
+  const boost::uint8_t *dp_fpData{nullptr};  // do not free this
   boost::scoped_array<boost::uint8_t> dp_arenaChunk;
   boost::uint32_t num4ByteElements, num8ByteElements;  // for finding ids
   const boost::uint8_t *dp_idOffsets;                  // do not free this
+  const boost::uint8_t *dp_idData{nullptr};            // do not free this
   boost::scoped_array<boost::uint8_t> dp_idChunk;
+  // when memory mapping, dp_fpData and dp_idData point into this
+  std::unique_ptr<MemoryMappedFileReader> dp_mappedFile;
   bool df_lazy;  // read the fp data lazily. In this case we use fpDataOffset
                  // and seek instead of using dp_fpData
   std::streampos fpDataOffset;   // file offset from tellg
@@ -81,10 +93,13 @@ void extractPopCounts(FPBReader_impl *dp_impl, boost::uint64_t sz,
     throw ValueErrorException("POPC must contain at least 9 offsets");
   }
 
+  // the offsets are stored little endian
   dp_impl->popCountOffsets.reserve(nEntries);
   for (unsigned int i = 0; i < nEntries; ++i) {
+    boost::uint32_t offset;
+    memcpy(&offset, chunk, sizeof(offset));
     dp_impl->popCountOffsets.push_back(
-        *reinterpret_cast<const boost::uint32_t *>(chunk));
+        EndianSwapBytes<LITTLE_ENDIAN_ORDER, HOST_ENDIAN_ORDER>(offset));
     chunk += 4;
   }
 };
@@ -345,11 +360,12 @@ void extractIdsDetails(FPBReader_impl *dp_impl, boost::uint64_t sz) {
 void extractIds(FPBReader_impl *dp_impl, boost::uint64_t sz,
                 const boost::uint8_t *chunk) {
   PRECONDITION(dp_impl, "bad pointer");
+  dp_impl->dp_idData = chunk;
   dp_impl->num4ByteElements = *reinterpret_cast<const boost::uint32_t *>(chunk);
   chunk += sizeof(boost::uint32_t);
   dp_impl->num8ByteElements = *reinterpret_cast<const boost::uint32_t *>(chunk);
   chunk += sizeof(boost::uint32_t);
-  dp_impl->dp_idOffsets = dp_impl->dp_idChunk.get() + sz -
+  dp_impl->dp_idOffsets = dp_impl->dp_idData + sz -
                           (dp_impl->num4ByteElements + 1) * 4 -
                           dp_impl->num8ByteElements * 8;
 };
@@ -411,7 +427,7 @@ std::string extractId(const FPBReader_impl *dp_impl, unsigned int which) {
 
   if (!dp_impl->df_lazy) {
     res = std::string(
-        reinterpret_cast<const char *>(dp_impl->dp_idChunk.get() + offset),
+        reinterpret_cast<const char *>(dp_impl->dp_idData + offset),
         len);
   } else {
     boost::shared_array<char> buff(new char[len + 1]);
@@ -424,19 +440,134 @@ std::string extractId(const FPBReader_impl *dp_impl, unsigned int which) {
   return res;
 };
 
+// calls func(dbCount, block, firstIdx, nInBlock) for blocks of at most
+// readCache fingerprints covering the indices [startIdx, endIdx). Blocks never
+// span more than one popcount bin, so every fingerprint in a block has dbCount
+// bits set.
+template <typename T>
+void forEachPopcountBlock(const FPBReader_impl *dp_impl,
+                          boost::uint64_t startIdx, boost::uint64_t endIdx,
+                          unsigned int readCache, T func) {
+  PRECONDITION(dp_impl->popCountOffsets.size() == dp_impl->nBits + 2,
+               "no popcounts");
+  if (startIdx >= endIdx) {
+    return;
+  }
+  const auto &offsets = dp_impl->popCountOffsets;
+  // the last bin which starts at or before startIdx
+  auto dbCount = static_cast<boost::uint32_t>(
+      std::upper_bound(offsets.begin(), offsets.end(), startIdx) -
+      offsets.begin() - 1);
+  boost::uint8_t *dbv = nullptr;
+  if (dp_impl->df_lazy) {
+    dbv = new boost::uint8_t[dp_impl->numBytesStoredPerFingerprint * readCache];
+  }
+  boost::uint64_t i = startIdx;
+  while (i < endIdx) {
+    while (offsets[dbCount + 1] <= i) {
+      ++dbCount;
+    }
+    boost::uint64_t binEnd =
+        std::min(static_cast<boost::uint64_t>(offsets[dbCount + 1]), endIdx);
+    unsigned int toRead = readCache;
+    if (i + toRead >= binEnd) {
+      toRead = binEnd - i;
+    }
+    extractBytes(dp_impl, i, dbv, toRead);
+    func(dbCount, dbv, i, toRead);
+    i += toRead;
+  }
+  if (dp_impl->df_lazy) {
+    delete[] dbv;
+  }
+}
+
+// returns the range of indices of the fingerprints which have between
+// minDbCount and maxDbCount bits set
+std::pair<boost::uint64_t, boost::uint64_t> popcountScanRange(
+    const FPBReader_impl *dp_impl, boost::uint32_t minDbCount,
+    boost::uint32_t maxDbCount) {
+  maxDbCount = std::min(maxDbCount, dp_impl->nBits);
+  if (minDbCount > maxDbCount) {
+    return std::make_pair(0, 0);
+  }
+  return std::make_pair(dp_impl->popCountOffsets[minDbCount],
+                        dp_impl->popCountOffsets[maxDbCount + 1]);
+}
+
+void appendHits(std::vector<std::pair<double, unsigned int>> &res,
+                const std::vector<std::pair<double, unsigned int>> &hits) {
+  res.insert(res.end(), hits.begin(), hits.end());
+}
+void appendHits(
+    std::vector<std::vector<std::pair<double, unsigned int>>> &res,
+    const std::vector<std::vector<std::pair<double, unsigned int>>> &hits) {
+  if (res.size() < hits.size()) {
+    res.resize(hits.size());
+  }
+  for (unsigned int i = 0; i < hits.size(); ++i) {
+    appendHits(res[i], hits[i]);
+  }
+}
+
+// splits [startScan, endScan) into contiguous pieces, one per thread, and calls
+// scan(start, end, hits) on each of them. The hits from each piece are
+// appended to res in index order, so the results do not depend on the number
+// of threads used.
+template <typename T, typename H>
+void scanInParallel(const FPBReader_impl *dp_impl, boost::uint64_t startScan,
+                    boost::uint64_t endScan, unsigned int numThreads, T scan,
+                    H &res) {
+  // the lazy reader shares a single stream, so it cannot be used from
+  // multiple threads
+  if (dp_impl->df_lazy || endScan <= startScan) {
+    numThreads = 1;
+  }
+  numThreads = std::min(static_cast<boost::uint64_t>(numThreads),
+                        endScan - startScan);
+  if (numThreads <= 1) {
+    scan(startScan, endScan, res);
+    return;
+  }
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  boost::uint64_t chunkSize =
+      (endScan - startScan + numThreads - 1) / numThreads;
+  std::vector<H> accum(numThreads);
+  std::vector<std::future<void>> tg;
+  for (unsigned int tid = 0; tid < numThreads; ++tid) {
+    boost::uint64_t start = startScan + tid * chunkSize;
+    boost::uint64_t end = std::min(start + chunkSize, endScan);
+    if (start >= end) {
+      break;
+    }
+    tg.emplace_back(std::async(
+        std::launch::async,
+        [&scan, &accum, start, end, tid]() { scan(start, end, accum[tid]); }));
+  }
+  for (auto &fut : tg) {
+    fut.get();
+  }
+  for (const auto &hits : accum) {
+    appendHits(res, hits);
+  }
+#else
+  scan(startScan, endScan, res);
+#endif
+}
+
 void tanimotoNeighbors(const FPBReader_impl *dp_impl, const boost::uint8_t *bv,
                        double threshold,
                        std::vector<std::pair<double, unsigned int>> &res,
-                       bool usePopcountScreen, unsigned int readCache = 1000) {
+                       bool usePopcountScreen, unsigned int numThreads = 1,
+                       unsigned int readCache = 1000) {
   PRECONDITION(dp_impl, "bad reader pointer");
   PRECONDITION(bv, "bad bv");
   RANGE_CHECK(-1e-6, threshold, 1.0 + 1e-6);
   PRECONDITION(readCache > 0, "bad cache size");
   res.clear();
-  boost::uint64_t probeCount =
-      CalcBitmapPopcount(bv, dp_impl->numBytesStoredPerFingerprint);
+  const unsigned int nBytes = dp_impl->numBytesStoredPerFingerprint;
+  boost::uint64_t probeCount = CalcBitmapPopcount(bv, nBytes);
 
-  boost::uint64_t startScan = 0, endScan = dp_impl->len;
   if (usePopcountScreen &&
       dp_impl->popCountOffsets.size() == dp_impl->nBits + 2) {
     // figure out the bounds based on equation 24 from:
@@ -449,49 +580,371 @@ void tanimotoNeighbors(const FPBReader_impl *dp_impl, const boost::uint8_t *bv,
     boost::uint32_t maxDbCount =
         (threshold > 1e-6)
             ? static_cast<boost::uint32_t>(ceil(probeCount / threshold))
-            : dp_impl->numBytesStoredPerFingerprint;
-    // std::cerr << "probeCount: " << probeCount << " bounds: " << minDbCount
-    //           << "-" << maxDbCount << std::endl;
-    startScan = dp_impl->popCountOffsets[minDbCount];
-    endScan = dp_impl->popCountOffsets[maxDbCount + 1];
-    // std::cerr << " scan: " << startScan << "-" << endScan << std::endl;
+            : dp_impl->nBits;
+    auto scanRange = popcountScanRange(dp_impl, minDbCount, maxDbCount);
+    // within a popcount bin we already know the number of bits set in the db
+    // fingerprints, so we only need the size of the intersection
+    auto scan = [&](boost::uint64_t start, boost::uint64_t end,
+                    std::vector<std::pair<double, unsigned int>> &hits) {
+      std::vector<unsigned int> common(readCache);
+      forEachPopcountBlock(
+          dp_impl, start, end, readCache,
+          [&](boost::uint32_t dbCount, const boost::uint8_t *dbv,
+              boost::uint64_t firstIdx, unsigned int nInBlock) {
+            CalcBitmapNumBitsInCommonBatch(bv, dbv, nInBlock, nBytes, nBytes,
+                                           common.data());
+            for (unsigned int j = 0; j < nInBlock; ++j) {
+              unsigned int unionCount = probeCount + dbCount - common[j];
+              double tani = unionCount ? (common[j] + 0.0) / unionCount : 0.0;
+              if (tani >= threshold) {
+                hits.emplace_back(tani, firstIdx + j);
+              }
+            }
+          });
+    };
+    scanInParallel(dp_impl, scanRange.first, scanRange.second, numThreads,
+                   scan, res);
+    return;
   }
-  boost::uint8_t *dbv;
-  if (dp_impl->df_lazy) {
-    dbv = new boost::uint8_t[dp_impl->numBytesStoredPerFingerprint * readCache];
+
+  auto scan = [&](boost::uint64_t start, boost::uint64_t end,
+                  std::vector<std::pair<double, unsigned int>> &hits) {
+    boost::uint8_t *dbv = nullptr;
+    if (dp_impl->df_lazy) {
+      dbv = new boost::uint8_t[nBytes * readCache];
+    }
+    std::vector<double> sims(readCache);
+    for (boost::uint64_t i = start; i < end; i += readCache) {
+      unsigned int toRead = readCache;
+      if (i + toRead >= end) {
+        toRead = end - i;
+      }
+      extractBytes(dp_impl, i, dbv, toRead);
+      CalcBitmapTanimotoBatch(bv, dbv, toRead, nBytes, nBytes, sims.data());
+      for (unsigned int j = 0; j < toRead; ++j) {
+        if (sims[j] >= threshold) {
+          hits.emplace_back(sims[j], i + j);
+        }
+      }
+    }
+    if (dp_impl->df_lazy) {
+      delete[] dbv;
+    }
+  };
+  scanInParallel(dp_impl, 0, dp_impl->len, numThreads, scan, res);
+}
+
+// Finds the neighbors of a set of queries in a single pass over the
+// fingerprints. The queries are handled in tiles that are small enough to
+// stay in cache while each block of database fingerprints is compared to all
+// of them, so the database only has to be streamed from memory once per tile
+// instead of once per query.
+void bulkTanimotoNeighbors(
+    const FPBReader_impl *dp_impl,
+    const std::vector<const boost::uint8_t *> &bvs, double threshold,
+    std::vector<std::vector<std::pair<double, unsigned int>>> &res,
+    bool usePopcountScreen, unsigned int numThreads = 1,
+    unsigned int readCache = 256, unsigned int queryTileBytes = 1 << 17) {
+  PRECONDITION(dp_impl, "bad reader pointer");
+  RANGE_CHECK(-1e-6, threshold, 1.0 + 1e-6);
+  PRECONDITION(readCache > 0, "bad cache size");
+  res.clear();
+  res.resize(bvs.size());
+  if (bvs.empty()) {
+    return;
   }
-  for (boost::uint64_t i = startScan; i < endScan; i += readCache) {
-    unsigned int toRead = readCache;
-    if (i + toRead >= endScan) {
-      toRead = endScan - i;
+  const unsigned int nBytes = dp_impl->numBytesStoredPerFingerprint;
+  const bool useScreen =
+      usePopcountScreen &&
+      dp_impl->popCountOffsets.size() == dp_impl->nBits + 2;
+  std::vector<boost::uint32_t> probeCounts(bvs.size());
+  std::vector<boost::uint32_t> minDbCounts(bvs.size(), 0);
+  std::vector<boost::uint32_t> maxDbCounts(bvs.size(), dp_impl->nBits);
+  boost::uint64_t startScan = 0, endScan = dp_impl->len;
+  if (useScreen) {
+    startScan = dp_impl->len;
+    endScan = 0;
+  }
+  for (unsigned int q = 0; q < bvs.size(); ++q) {
+    PRECONDITION(bvs[q], "bad bv");
+    probeCounts[q] = CalcBitmapPopcount(bvs[q], nBytes);
+    if (useScreen) {
+      // these are the same bounds used in tanimotoNeighbors()
+      minDbCounts[q] =
+          static_cast<boost::uint32_t>(floor(threshold * probeCounts[q]));
+      if (threshold > 1e-6) {
+        maxDbCounts[q] = std::min(
+            dp_impl->nBits,
+            static_cast<boost::uint32_t>(ceil(probeCounts[q] / threshold)));
+      }
+      auto scanRange =
+          popcountScanRange(dp_impl, minDbCounts[q], maxDbCounts[q]);
+      if (scanRange.first < scanRange.second) {
+        startScan = std::min(startScan, scanRange.first);
+        endScan = std::max(endScan, scanRange.second);
+      }
     }
-    extractBytes(dp_impl, i, dbv, toRead);
-    for (unsigned int j = 0; j < toRead; ++j) {
-      double tani =
-          CalcBitmapTanimoto(dbv + j * dp_impl->numBytesStoredPerFingerprint,
-                             bv, dp_impl->numBytesStoredPerFingerprint);
-      if (tani >= threshold) {
-        res.emplace_back(tani, i + j);
+  }
+  const unsigned int queryTile = std::max(1u, queryTileBytes / nBytes);
+
+  auto scan = [&](boost::uint64_t start, boost::uint64_t end,
+                  std::vector<std::vector<std::pair<double, unsigned int>>>
+                      &hits) {
+    hits.resize(bvs.size());
+    std::vector<unsigned int> common(readCache);
+    std::vector<double> sims(readCache);
+    boost::uint8_t *dbv = nullptr;
+    if (!useScreen && dp_impl->df_lazy) {
+      dbv = new boost::uint8_t[nBytes * readCache];
+    }
+    for (unsigned int tileStart = 0; tileStart < bvs.size();
+         tileStart += queryTile) {
+      unsigned int tileEnd = std::min(tileStart + queryTile,
+                                      static_cast<unsigned int>(bvs.size()));
+      if (useScreen) {
+        forEachPopcountBlock(
+            dp_impl, start, end, readCache,
+            [&](boost::uint32_t dbCount, const boost::uint8_t *block,
+                boost::uint64_t firstIdx, unsigned int nInBlock) {
+              for (unsigned int q = tileStart; q < tileEnd; ++q) {
+                if (dbCount < minDbCounts[q] || dbCount > maxDbCounts[q]) {
+                  continue;
+                }
+                CalcBitmapNumBitsInCommonBatch(bvs[q], block, nInBlock, nBytes,
+                                               nBytes, common.data());
+                for (unsigned int j = 0; j < nInBlock; ++j) {
+                  unsigned int unionCount =
+                      probeCounts[q] + dbCount - common[j];
+                  double tani =
+                      unionCount ? (common[j] + 0.0) / unionCount : 0.0;
+                  if (tani >= threshold) {
+                    hits[q].emplace_back(tani, firstIdx + j);
+                  }
+                }
+              }
+            });
+      } else {
+        for (boost::uint64_t i = start; i < end; i += readCache) {
+          unsigned int toRead = readCache;
+          if (i + toRead >= end) {
+            toRead = end - i;
+          }
+          extractBytes(dp_impl, i, dbv, toRead);
+          for (unsigned int q = tileStart; q < tileEnd; ++q) {
+            CalcBitmapTanimotoBatch(bvs[q], dbv, toRead, nBytes, nBytes,
+                                    sims.data());
+            for (unsigned int j = 0; j < toRead; ++j) {
+              if (sims[j] >= threshold) {
+                hits[q].emplace_back(sims[j], i + j);
+              }
+            }
+          }
+        }
       }
     }
+    if (!useScreen && dp_impl->df_lazy) {
+      delete[] dbv;
+    }
+  };
+  scanInParallel(dp_impl, startScan, endScan, numThreads, scan, res);
+}
+
+// orders hits by decreasing similarity, breaking ties in favor of the lower
+// index
+inline bool betterHit(const std::pair<double, unsigned int> &a,
+                      const std::pair<double, unsigned int> &b) {
+  return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+
+// keeps the best k hits seen. The hits are stored in a heap with the worst of
+// them at the front.
+class TopKHits {
+ public:
+  explicit TopKHits(unsigned int k) : d_k(k) { d_hits.reserve(k); }
+  bool full() const { return d_k && d_hits.size() == d_k; }
+  // the similarity of the worst hit being kept, only meaningful when full()
+  double worst() const { return d_hits.front().first; }
+  void add(double sim, unsigned int idx) {
+    if (!d_k || (full() && sim < worst())) {
+      return;
+    }
+    std::pair<double, unsigned int> hit(sim, idx);
+    if (!full()) {
+      d_hits.push_back(hit);
+      std::push_heap(d_hits.begin(), d_hits.end(), betterHit);
+    } else if (betterHit(hit, d_hits.front())) {
+      std::pop_heap(d_hits.begin(), d_hits.end(), betterHit);
+      d_hits.back() = hit;
+      std::push_heap(d_hits.begin(), d_hits.end(), betterHit);
+    }
   }
-  if (dp_impl->df_lazy) {
-    delete[] dbv;
+  const std::vector<std::pair<double, unsigned int>> &hits() const {
+    return d_hits;
+  }
+
+ private:
+  unsigned int d_k;
+  std::vector<std::pair<double, unsigned int>> d_hits;
+};
+
+void topKTanimotoNeighbors(const FPBReader_impl *dp_impl,
+                           const boost::uint8_t *bv, unsigned int k,
+                           double threshold,
+                           std::vector<std::pair<double, unsigned int>> &res,
+                           unsigned int numThreads = 1,
+                           unsigned int readCache = 1000) {
+  PRECONDITION(dp_impl, "bad reader pointer");
+  PRECONDITION(bv, "bad bv");
+  RANGE_CHECK(-1e-6, threshold, 1.0 + 1e-6);
+  PRECONDITION(readCache > 0, "bad cache size");
+  res.clear();
+  if (!k) {
+    return;
+  }
+  const unsigned int nBytes = dp_impl->numBytesStoredPerFingerprint;
+  boost::uint32_t probeCount = CalcBitmapPopcount(bv, nBytes);
+  TopKHits best(k);
+
+  if (dp_impl->popCountOffsets.size() == dp_impl->nBits + 2) {
+    const auto &offsets = dp_impl->popCountOffsets;
+    // the upper bound on the similarity of anything in each non-empty bin is
+    // min(probeCount, dbCount) / max(probeCount, dbCount) (equation 24 from
+    // Swamidass and Baldi). We visit the bins from the most to the least
+    // promising so that we can stop as soon as the bound drops below the k'th
+    // best similarity found.
+    std::vector<std::pair<double, boost::uint32_t>> bins;
+    for (boost::uint32_t dbCount = 0; dbCount <= dp_impl->nBits; ++dbCount) {
+      if (offsets[dbCount + 1] <= offsets[dbCount]) {
+        continue;
+      }
+      boost::uint32_t lo = std::min(probeCount, dbCount);
+      boost::uint32_t hi = std::max(probeCount, dbCount);
+      double bound = hi ? static_cast<double>(lo) / hi : 0.0;
+      if (bound >= threshold) {
+        bins.emplace_back(bound, dbCount);
+      }
+    }
+    std::stable_sort(bins.begin(), bins.end(),
+                     [](const auto &a, const auto &b) {
+                       return a.first > b.first;
+                     });
+
+    // the largest k'th best similarity seen by any thread. Since each
+    // thread's k'th best is a lower bound on the overall k'th best, no bin
+    // with a smaller bound can contribute to the results.
+    std::atomic<double> cutoff(threshold);
+    std::atomic<unsigned int> nextBin(0);
+    auto worker = [&](TopKHits &hits) {
+      std::vector<unsigned int> common(readCache);
+      while (true) {
+        unsigned int binIdx = nextBin++;
+        if (binIdx >= bins.size() || bins[binIdx].first < cutoff.load()) {
+          break;
+        }
+        boost::uint32_t dbCount = bins[binIdx].second;
+        forEachPopcountBlock(
+            dp_impl, offsets[dbCount], offsets[dbCount + 1], readCache,
+            [&](boost::uint32_t, const boost::uint8_t *dbv,
+                boost::uint64_t firstIdx, unsigned int nInBlock) {
+              CalcBitmapNumBitsInCommonBatch(bv, dbv, nInBlock, nBytes, nBytes,
+                                             common.data());
+              for (unsigned int j = 0; j < nInBlock; ++j) {
+                unsigned int unionCount = probeCount + dbCount - common[j];
+                double tani =
+                    unionCount ? (common[j] + 0.0) / unionCount : 0.0;
+                if (tani >= threshold) {
+                  hits.add(tani, firstIdx + j);
+                }
+              }
+            });
+        if (hits.full()) {
+          double current = cutoff.load();
+          while (hits.worst() > current &&
+                 !cutoff.compare_exchange_weak(current, hits.worst())) {
+          }
+        }
+      }
+    };
+
+    if (dp_impl->df_lazy) {
+      numThreads = 1;
+    }
+    numThreads = std::min(numThreads, static_cast<unsigned int>(bins.size()));
+    if (numThreads <= 1) {
+      worker(best);
+    } else {
+#ifdef RDK_BUILD_THREADSAFE_SSS
+      std::vector<TopKHits> accum(numThreads, TopKHits(k));
+      std::vector<std::future<void>> tg;
+      for (unsigned int tid = 0; tid < numThreads; ++tid) {
+        tg.emplace_back(
+            std::async(std::launch::async,
+                       [&worker, &accum, tid]() { worker(accum[tid]); }));
+      }
+      for (auto &fut : tg) {
+        fut.get();
+      }
+      for (const auto &hits : accum) {
+        for (const auto &hit : hits.hits()) {
+          best.add(hit.first, hit.second);
+        }
+      }
+#else
+      worker(best);
+#endif
+    }
+  } else {
+    // no popcounts, so we have to look at everything. Each piece of the scan
+    // returns its own top k, which we merge below.
+    auto scan = [&](boost::uint64_t start, boost::uint64_t end,
+                    std::vector<std::pair<double, unsigned int>> &hits) {
+      boost::uint8_t *dbv = nullptr;
+      if (dp_impl->df_lazy) {
+        dbv = new boost::uint8_t[nBytes * readCache];
+      }
+      TopKHits localBest(k);
+      std::vector<double> sims(readCache);
+      for (boost::uint64_t i = start; i < end; i += readCache) {
+        unsigned int toRead = readCache;
+        if (i + toRead >= end) {
+          toRead = end - i;
+        }
+        extractBytes(dp_impl, i, dbv, toRead);
+        CalcBitmapTanimotoBatch(bv, dbv, toRead, nBytes, nBytes, sims.data());
+        for (unsigned int j = 0; j < toRead; ++j) {
+          if (sims[j] >= threshold) {
+            localBest.add(sims[j], i + j);
+          }
+        }
+      }
+      if (dp_impl->df_lazy) {
+        delete[] dbv;
+      }
+      hits.insert(hits.end(), localBest.hits().begin(),
+                  localBest.hits().end());
+    };
+    std::vector<std::pair<double, unsigned int>> candidates;
+    scanInParallel(dp_impl, 0, dp_impl->len, numThreads, scan, candidates);
+    for (const auto &hit : candidates) {
+      best.add(hit.first, hit.second);
+    }
   }
+  res = best.hits();
 }
 
 void tverskyNeighbors(const FPBReader_impl *dp_impl, const boost::uint8_t *bv,
                       double ca, double cb, double threshold,
                       std::vector<std::pair<double, unsigned int>> &res,
-                      bool usePopcountScreen) {
+                      bool usePopcountScreen, unsigned int numThreads = 1,
+                      unsigned int readCache = 1000) {
   PRECONDITION(dp_impl, "bad reader pointer");
   PRECONDITION(bv, "bad bv");
   RANGE_CHECK(-1e-6, threshold, 1.0 + 1e-6);
+  PRECONDITION(readCache > 0, "bad cache size");
   res.clear();
-  boost::uint64_t probeCount =
-      CalcBitmapPopcount(bv, dp_impl->numBytesStoredPerFingerprint);
+  const unsigned int nBytes = dp_impl->numBytesStoredPerFingerprint;
+  boost::uint64_t probeCount = CalcBitmapPopcount(bv, nBytes);
 
-  boost::uint64_t startScan = 0, endScan = dp_impl->len;
   if (usePopcountScreen &&
       dp_impl->popCountOffsets.size() == dp_impl->nBits + 2) {
     // figure out the bounds based on equation 25 from:
@@ -506,31 +959,57 @@ void tverskyNeighbors(const FPBReader_impl *dp_impl, const boost::uint8_t *bv,
             ? static_cast<boost::uint32_t>(
                   ceil(probeCount * (1 - threshold + threshold * cb) /
                        (threshold * cb)))
-            : dp_impl->numBytesStoredPerFingerprint;
-    // std::cerr << "probeCount: " << probeCount << " bounds: " << minDbCount
-    //          << "-" << maxDbCount << std::endl;
-    startScan = dp_impl->popCountOffsets[minDbCount];
-    endScan = dp_impl->popCountOffsets[maxDbCount + 1];
-    // std::cerr << " scan: " << startScan << "-" << endScan << std::endl;
+            : dp_impl->nBits;
+    auto scanRange = popcountScanRange(dp_impl, minDbCount, maxDbCount);
+    auto scan = [&](boost::uint64_t start, boost::uint64_t end,
+                    std::vector<std::pair<double, unsigned int>> &hits) {
+      std::vector<unsigned int> common(readCache);
+      forEachPopcountBlock(
+          dp_impl, start, end, readCache,
+          [&](boost::uint32_t dbCount, const boost::uint8_t *dbv,
+              boost::uint64_t firstIdx, unsigned int nInBlock) {
+            CalcBitmapNumBitsInCommonBatch(bv, dbv, nInBlock, nBytes, nBytes,
+                                           common.data());
+            for (unsigned int j = 0; j < nInBlock; ++j) {
+              // this needs to match what CalcBitmapTversky(dbv, bv, ...) does
+              double denom =
+                  ca * dbCount + cb * probeCount + (1 - ca - cb) * common[j];
+              double sim = (denom == 0.0) ? 0.0 : common[j] / denom;
+              if (sim >= threshold) {
+                hits.emplace_back(sim, firstIdx + j);
+              }
+            }
+          });
+    };
+    scanInParallel(dp_impl, scanRange.first, scanRange.second, numThreads,
+                   scan, res);
+    return;
   }
 
-  boost::uint8_t *dbv;
-  if (dp_impl->df_lazy) {
-    dbv = new boost::uint8_t[dp_impl->numBytesStoredPerFingerprint];
-  }
-  for (boost::uint64_t i = startScan; i < endScan; ++i) {
-    extractBytes(dp_impl, i, dbv);
-    double sim = CalcBitmapTversky(
-        dbv, bv, dp_impl->numBytesStoredPerFingerprint, ca, cb);
-    // std::cerr << "  i:" << i << " " << tani << " ? " << threshold <<
-    // std::endl;
-    if (sim >= threshold) {
-      res.emplace_back(sim, i);
+  auto scan = [&](boost::uint64_t start, boost::uint64_t end,
+                  std::vector<std::pair<double, unsigned int>> &hits) {
+    boost::uint8_t *dbv = nullptr;
+    if (dp_impl->df_lazy) {
+      dbv = new boost::uint8_t[nBytes * readCache];
     }
-  }
-  if (dp_impl->df_lazy) {
-    delete[] dbv;
-  }
+    for (boost::uint64_t i = start; i < end; i += readCache) {
+      unsigned int toRead = readCache;
+      if (i + toRead >= end) {
+        toRead = end - i;
+      }
+      extractBytes(dp_impl, i, dbv, toRead);
+      for (unsigned int j = 0; j < toRead; ++j) {
+        double sim = CalcBitmapTversky(dbv + j * nBytes, bv, nBytes, ca, cb);
+        if (sim >= threshold) {
+          hits.emplace_back(sim, i + j);
+        }
+      }
+    }
+    if (dp_impl->df_lazy) {
+      delete[] dbv;
+    }
+  };
+  scanInParallel(dp_impl, 0, dp_impl->len, numThreads, scan, res);
 }
 
 void containingNeighbors(const FPBReader_impl *dp_impl,
@@ -565,8 +1044,69 @@ void containingNeighbors(const FPBReader_impl *dp_impl,
 
 }  // namespace detail
 
+namespace detail {
+// handles a chunk which has been read into (or is mapped into) memory.
+// The caller is responsible for keeping the AREN and FPID chunks alive.
+void processChunk(FPBReader_impl *dp_impl, const std::string &chunkNm,
+                  boost::uint64_t chunkSz, const boost::uint8_t *chunk) {
+  if (chunkNm == "POPC") {
+    extractPopCounts(dp_impl, chunkSz, chunk);
+  } else if (chunkNm == "AREN") {
+    extractArena(dp_impl, chunkSz, chunk);
+  } else if (chunkNm == "FPID") {
+    extractIds(dp_impl, chunkSz, chunk);
+  } else if (chunkNm == "META") {
+    // currently ignored
+  } else if (chunkNm == "HASH") {
+    // currently ignored
+  } else {
+    BOOST_LOG(rdWarningLog)
+        << "Unknown chunk: " << chunkNm << " ignored." << std::endl;
+  }
+}
+
+void initFromMappedFile(FPBReader_impl *dp_impl, const std::string &fname) {
+  PRECONDITION(dp_impl, "bad pointer");
+  try {
+    dp_impl->dp_mappedFile.reset(new MemoryMappedFileReader(fname));
+  } catch (const std::runtime_error &) {
+    throw BadFileException("Bad input file " + fname);
+  }
+  const auto *data = reinterpret_cast<const boost::uint8_t *>(
+      dp_impl->dp_mappedFile->d_mappedMemory);
+  const boost::uint64_t size = dp_impl->dp_mappedFile->d_size;
+
+  if (size < magicSize ||
+      FPB_MAGIC != std::string(reinterpret_cast<const char *>(data),
+                               magicSize)) {
+    throw BadFileException("Invalid FPB magic");
+  }
+  boost::uint64_t pos = magicSize;
+  while (1) {
+    if (pos + sizeof(boost::uint64_t) + tagNameSize > size) {
+      throw BadFileException("EOF hit before FEND record");
+    }
+    boost::uint64_t chunkSz;
+    memcpy(&chunkSz, data + pos, sizeof(chunkSz));
+    chunkSz = EndianSwapBytes<LITTLE_ENDIAN_ORDER, HOST_ENDIAN_ORDER>(chunkSz);
+    pos += sizeof(chunkSz);
+    std::string chunkNm(reinterpret_cast<const char *>(data + pos),
+                        tagNameSize);
+    pos += tagNameSize;
+    if (chunkSz > size - pos) {
+      throw BadFileException("EOF hit reading " + chunkNm + " record");
+    }
+    if (chunkNm == "FEND") {
+      break;
+    }
+    processChunk(dp_impl, chunkNm, chunkSz, data + pos);
+    pos += chunkSz;
+  }
+}
+}  // namespace detail
+
 void FPBReader::init() {
-  PRECONDITION(dp_istrm, "no stream");
+  PRECONDITION(dp_istrm || df_memoryMap, "no stream");
   if (df_init) {
     return;
   }
@@ -575,59 +1115,53 @@ void FPBReader::init() {
   dp_impl->istrm = dp_istrm;
   dp_impl->df_lazy = df_lazyRead;
 
-  char magic[detail::magicSize];
-  dp_istrm->read(magic, detail::magicSize);
-  if (detail::FPB_MAGIC != std::string(magic, detail::magicSize)) {
-    throw BadFileException("Invalid FPB magic");
-  }
-  while (1) {
-    if (dp_istrm->eof()) {
-      throw BadFileException("EOF hit before FEND record");
+  if (df_memoryMap) {
+    detail::initFromMappedFile(dp_impl, d_fileName);
+  } else {
+    char magic[detail::magicSize];
+    dp_istrm->read(magic, detail::magicSize);
+    if (detail::FPB_MAGIC != std::string(magic, detail::magicSize)) {
+      throw BadFileException("Invalid FPB magic");
     }
-    std::string chunkNm;
-    boost::uint64_t chunkSz;
-    boost::uint8_t *chunk = nullptr;
-    detail::readChunkDetails(*dp_istrm, chunkNm, chunkSz);
-    // std::cerr << " Chunk: " << chunkNm << " " << chunkSz << std::endl;
-    if (!df_lazyRead || (chunkNm != "AREN" && chunkNm != "FPID")) {
-      detail::readChunkData(*dp_istrm, chunkSz, chunk);
-      if (chunkNm == "FEND") {
-        break;
-      } else if (chunkNm == "POPC") {
-        detail::extractPopCounts(dp_impl, chunkSz, chunk);
-      } else if (chunkNm == "AREN") {
-        dp_impl->dp_arenaChunk.reset(chunk);
-        detail::extractArena(dp_impl, chunkSz, chunk);
-        chunk = nullptr;
-      } else if (chunkNm == "FPID") {
-        dp_impl->dp_idChunk.reset(chunk);
-        detail::extractIds(dp_impl, chunkSz, chunk);
-        chunk = nullptr;
-      } else if (chunkNm == "META") {
-        // currently ignored
-      } else if (chunkNm == "HASH") {
-        // currently ignored
-      } else {
-        BOOST_LOG(rdWarningLog)
-            << "Unknown chunk: " << chunkNm << " ignored." << std::endl;
+    while (1) {
+      if (dp_istrm->eof()) {
+        throw BadFileException("EOF hit before FEND record");
       }
-      delete[] chunk;
-    } else {
-      // we are reading the AREN or FPID chunk in lazy mode, just get our
-      // position in
-      // the file.
-      if (chunkNm == "AREN") {
-        detail::extractArenaDetails(dp_impl, chunkSz);
-      } else if (chunkNm == "FPID") {
-        detail::extractIdsDetails(dp_impl, chunkSz);
+      std::string chunkNm;
+      boost::uint64_t chunkSz;
+      boost::uint8_t *chunk = nullptr;
+      detail::readChunkDetails(*dp_istrm, chunkNm, chunkSz);
+      if (!df_lazyRead || (chunkNm != "AREN" && chunkNm != "FPID")) {
+        detail::readChunkData(*dp_istrm, chunkSz, chunk);
+        if (chunkNm == "FEND") {
+          delete[] chunk;
+          break;
+        }
+        detail::processChunk(dp_impl, chunkNm, chunkSz, chunk);
+        if (chunkNm == "AREN") {
+          dp_impl->dp_arenaChunk.reset(chunk);
+        } else if (chunkNm == "FPID") {
+          dp_impl->dp_idChunk.reset(chunk);
+        } else {
+          delete[] chunk;
+        }
+      } else {
+        // we are reading the AREN or FPID chunk in lazy mode, just get our
+        // position in
+        // the file.
+        if (chunkNm == "AREN") {
+          detail::extractArenaDetails(dp_impl, chunkSz);
+        } else if (chunkNm == "FPID") {
+          detail::extractIdsDetails(dp_impl, chunkSz);
+        }
       }
     }
   }
-  if ((!df_lazyRead && !dp_impl->dp_arenaChunk) ||
+  if ((!df_lazyRead && !dp_impl->dp_fpData) ||
       (df_lazyRead && !dp_impl->fpDataOffset)) {
     throw BadFileException("No AREN record found");
   }
-  if ((!df_lazyRead && !dp_impl->dp_idChunk) ||
+  if ((!df_lazyRead && !dp_impl->dp_idData) ||
       (df_lazyRead && !dp_impl->idDataOffset)) {
     throw BadFileException("No FPID record found");
   }
@@ -639,9 +1173,11 @@ void FPBReader::destroy() {
   if (dp_impl) {
     dp_impl->dp_arenaChunk.reset();
     dp_impl->dp_idChunk.reset();
+    dp_impl->dp_mappedFile.reset();
 
     dp_impl->dp_fpData = nullptr;
     dp_impl->dp_idOffsets = nullptr;
+    dp_impl->dp_idData = nullptr;
   }
   delete dp_impl;
   dp_impl = nullptr;
@@ -704,20 +1240,75 @@ double FPBReader::getTanimoto(unsigned int idx,
 }
 
 std::vector<std::pair<double, unsigned int>> FPBReader::getTanimotoNeighbors(
-    const boost::uint8_t *bv, double threshold, bool usePopcountScreen) const {
+    const boost::uint8_t *bv, double threshold, bool usePopcountScreen,
+    int numThreads) const {
   PRECONDITION(df_init, "not initialized");
   std::vector<std::pair<double, unsigned int>> res;
-  detail::tanimotoNeighbors(dp_impl, bv, threshold, res, usePopcountScreen);
+  detail::tanimotoNeighbors(dp_impl, bv, threshold, res, usePopcountScreen,
+                            getNumThreadsToUse(numThreads));
   std::sort(res.begin(), res.end(), Rankers::pairGreater);
   return res;
 }
 
 std::vector<std::pair<double, unsigned int>> FPBReader::getTanimotoNeighbors(
-    const ExplicitBitVect &ebv, double threshold,
-    bool usePopcountScreen) const {
+    const ExplicitBitVect &ebv, double threshold, bool usePopcountScreen,
+    int numThreads) const {
   const boost::uint8_t *bv = detail::bitsetToBytes(*(ebv.dp_bits));
   std::vector<std::pair<double, unsigned int>> res =
-      getTanimotoNeighbors(bv, threshold, usePopcountScreen);
+      getTanimotoNeighbors(bv, threshold, usePopcountScreen, numThreads);
+  delete[] bv;
+  return res;
+}
+
+std::vector<std::vector<std::pair<double, unsigned int>>>
+FPBReader::getBulkTanimotoNeighbors(
+    const std::vector<const boost::uint8_t *> &bvs, double threshold,
+    bool usePopcountScreen, int numThreads) const {
+  PRECONDITION(df_init, "not initialized");
+  std::vector<std::vector<std::pair<double, unsigned int>>> res;
+  detail::bulkTanimotoNeighbors(dp_impl, bvs, threshold, res,
+                                usePopcountScreen,
+                                getNumThreadsToUse(numThreads));
+  for (auto &nbrs : res) {
+    std::sort(nbrs.begin(), nbrs.end(), Rankers::pairGreater);
+  }
+  return res;
+}
+
+std::vector<std::vector<std::pair<double, unsigned int>>>
+FPBReader::getBulkTanimotoNeighbors(
+    const std::vector<const ExplicitBitVect *> &ebvs, double threshold,
+    bool usePopcountScreen, int numThreads) const {
+  std::vector<std::unique_ptr<boost::uint8_t[]>> owners;
+  owners.reserve(ebvs.size());
+  std::vector<const boost::uint8_t *> bvs;
+  bvs.reserve(ebvs.size());
+  for (const auto ebv : ebvs) {
+    PRECONDITION(ebv, "bad fingerprint");
+    owners.emplace_back(detail::bitsetToBytes(*(ebv->dp_bits)));
+    bvs.push_back(owners.back().get());
+  }
+  return getBulkTanimotoNeighbors(bvs, threshold, usePopcountScreen,
+                                  numThreads);
+}
+
+std::vector<std::pair<double, unsigned int>>
+FPBReader::getTopKTanimotoNeighbors(const boost::uint8_t *bv, unsigned int k,
+                                    double threshold, int numThreads) const {
+  PRECONDITION(df_init, "not initialized");
+  std::vector<std::pair<double, unsigned int>> res;
+  detail::topKTanimotoNeighbors(dp_impl, bv, k, threshold, res,
+                                getNumThreadsToUse(numThreads));
+  std::sort(res.begin(), res.end(), detail::betterHit);
+  return res;
+}
+
+std::vector<std::pair<double, unsigned int>>
+FPBReader::getTopKTanimotoNeighbors(const ExplicitBitVect &ebv, unsigned int k,
+                                    double threshold, int numThreads) const {
+  const boost::uint8_t *bv = detail::bitsetToBytes(*(ebv.dp_bits));
+  std::vector<std::pair<double, unsigned int>> res =
+      getTopKTanimotoNeighbors(bv, k, threshold, numThreads);
   delete[] bv;
   return res;
 }
@@ -737,21 +1328,21 @@ double FPBReader::getTversky(unsigned int idx, const ExplicitBitVect &ebv,
 
 std::vector<std::pair<double, unsigned int>> FPBReader::getTverskyNeighbors(
     const boost::uint8_t *bv, double ca, double cb, double threshold,
-    bool usePopcountScreen) const {
+    bool usePopcountScreen, int numThreads) const {
   PRECONDITION(df_init, "not initialized");
   std::vector<std::pair<double, unsigned int>> res;
   detail::tverskyNeighbors(dp_impl, bv, ca, cb, threshold, res,
-                           usePopcountScreen);
+                           usePopcountScreen, getNumThreadsToUse(numThreads));
   std::sort(res.begin(), res.end(), Rankers::pairGreater);
   return res;
 }
 
 std::vector<std::pair<double, unsigned int>> FPBReader::getTverskyNeighbors(
     const ExplicitBitVect &ebv, double ca, double cb, double threshold,
-    bool usePopcountScreen) const {
+    bool usePopcountScreen, int numThreads) const {
   const boost::uint8_t *bv = detail::bitsetToBytes(*(ebv.dp_bits));
-  std::vector<std::pair<double, unsigned int>> res =
-      getTverskyNeighbors(bv, ca, cb, threshold, usePopcountScreen);
+  std::vector<std::pair<double, unsigned int>> res = getTverskyNeighbors(
+      bv, ca, cb, threshold, usePopcountScreen, numThreads);
   delete[] bv;
   return res;
 }
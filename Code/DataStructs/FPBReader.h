@@ -51,7 +51,8 @@ struct FPBReader_impl;
   Operations that involve reading from the FPB file are not thread safe.
   This means that the \c init() method is not thread safe and none of the
   search operations are thread safe when an \c FPBReader is initialized in
-  \c lazyRead mode.
+  \c lazyRead mode. Memory-mapped readers do not read from a stream after
+  \c init(), so their search operations are thread safe.
 
 */
 class RDKIT_DATASTRUCTS_EXPORT FPBReader {
@@ -63,13 +64,19 @@ class RDKIT_DATASTRUCTS_EXPORT FPBReader {
   \param fname the name of the file to reads
   \param lazyRead if set to \c false all fingerprints from the file will be read
   into memory when \c init() is called.
+  \param memoryMap if set, the file will be memory mapped when \c init() is
+  called and the fingerprints and ids will be used in place. This makes \c
+  init() very fast, avoids the per-access stream reads of \c lazyRead mode, and
+  lets multiple processes reading the same file share memory. \c lazyRead is
+  ignored in this mode.
   */
-  FPBReader(const char *fname, bool lazyRead = false) {
-    _initFromFilename(fname, lazyRead);
+  FPBReader(const char *fname, bool lazyRead = false, bool memoryMap = false) {
+    _initFromFilename(fname, lazyRead, memoryMap);
   }
   //! \overload
-  FPBReader(const std::string &fname, bool lazyRead = false) {
-    _initFromFilename(fname.c_str(), lazyRead);
+  FPBReader(const std::string &fname, bool lazyRead = false,
+            bool memoryMap = false) {
+    _initFromFilename(fname.c_str(), lazyRead, memoryMap);
   }
   //! ctor for reading from an open istream
   /*!
@@ -166,21 +173,95 @@ class RDKIT_DATASTRUCTS_EXPORT FPBReader {
     \param usePopcountScreen if this is true (the default) the popcount of the
            neighbors will be used to reduce the number of calculations that need
            to be done
+    \param numThreads  Sets the number of threads to use (more than one thread
+    will only be used if the RDKit was build with multithread support) If set to
+    zero, the max supported by the system will be used. The range of
+    fingerprints to be searched is split into contiguous pieces, one per thread,
+    so the results do not depend on the number of threads. Readers in \c
+    lazyRead mode always use a single thread.
 
   */
   std::vector<std::pair<double, unsigned int>> getTanimotoNeighbors(
       const std::uint8_t *bv, double threshold = 0.7,
-      bool usePopcountScreen = true) const;
+      bool usePopcountScreen = true, int numThreads = 1) const;
   //! \overload
   std::vector<std::pair<double, unsigned int>> getTanimotoNeighbors(
       boost::shared_array<std::uint8_t> bv, double threshold = 0.7,
-      bool usePopcountScreen = true) const {
-    return getTanimotoNeighbors(bv.get(), threshold, usePopcountScreen);
+      bool usePopcountScreen = true, int numThreads = 1) const {
+    return getTanimotoNeighbors(bv.get(), threshold, usePopcountScreen,
+                                numThreads);
   }
   //! \overload
   std::vector<std::pair<double, unsigned int>> getTanimotoNeighbors(
       const ExplicitBitVect &ebv, double threshold = 0.7,
-      bool usePopcountScreen = true) const;
+      bool usePopcountScreen = true, int numThreads = 1) const;
+
+  //! returns tanimoto neighbors of a set of query fingerprints
+  /*!
+  This is equivalent to calling \c getTanimotoNeighbors() for each query, but
+  the database is scanned once for a whole tile of queries, so it is much
+  faster when there are many queries.
+
+  The result has one vector of (similarity,index) pairs per query, each sorted
+  in order of decreasing similarity.
+
+    \param bvs the query fingerprints
+    \param threshold the minimum similarity to return
+    \param usePopcountScreen if this is true (the default) the popcount of the
+           neighbors will be used to reduce the number of calculations that need
+           to be done
+    \param numThreads  Sets the number of threads to use (more than one thread
+    will only be used if the RDKit was build with multithread support) If set to
+    zero, the max supported by the system will be used. Readers in \c lazyRead
+    mode always use a single thread.
+
+  */
+  std::vector<std::vector<std::pair<double, unsigned int>>>
+  getBulkTanimotoNeighbors(const std::vector<const std::uint8_t *> &bvs,
+                           double threshold = 0.7,
+                           bool usePopcountScreen = true,
+                           int numThreads = 1) const;
+  //! \overload
+  std::vector<std::vector<std::pair<double, unsigned int>>>
+  getBulkTanimotoNeighbors(const std::vector<const ExplicitBitVect *> &ebvs,
+                           double threshold = 0.7,
+                           bool usePopcountScreen = true,
+                           int numThreads = 1) const;
+
+  //! returns the k nearest tanimoto neighbors of a fingerprint
+  /*!
+  The result vector of (similarity,index) pairs is sorted in order
+  of decreasing similarity. Fingerprints with the same similarity are sorted
+  by index, and the lowest indices are the ones kept when there are ties at
+  the k'th position, so the results do not depend on the number of threads.
+
+  If the file has popcount information, the popcount bins are searched in
+  order of decreasing maximum similarity to the query (equation 24 from
+  Swamidass and Baldi) and the search stops as soon as none of the remaining
+  bins can beat the k'th best similarity found so far.
+
+    \param bv the query fingerprint
+    \param k the maximum number of neighbors to return
+    \param threshold the minimum similarity to return
+    \param numThreads  Sets the number of threads to use (more than one thread
+    will only be used if the RDKit was build with multithread support) If set to
+    zero, the max supported by the system will be used. Readers in \c lazyRead
+    mode always use a single thread.
+
+  */
+  std::vector<std::pair<double, unsigned int>> getTopKTanimotoNeighbors(
+      const std::uint8_t *bv, unsigned int k, double threshold = 0.0,
+      int numThreads = 1) const;
+  //! \overload
+  std::vector<std::pair<double, unsigned int>> getTopKTanimotoNeighbors(
+      boost::shared_array<std::uint8_t> bv, unsigned int k,
+      double threshold = 0.0, int numThreads = 1) const {
+    return getTopKTanimotoNeighbors(bv.get(), k, threshold, numThreads);
+  }
+  //! \overload
+  std::vector<std::pair<double, unsigned int>> getTopKTanimotoNeighbors(
+      const ExplicitBitVect &ebv, unsigned int k, double threshold = 0.0,
+      int numThreads = 1) const;
 
   //! returns the Tversky similarity between the specified fingerprint and the
   //! provided fingerprint
@@ -215,21 +296,25 @@ class RDKIT_DATASTRUCTS_EXPORT FPBReader {
     \param usePopcountScreen if this is true (the default) the popcount of the
            neighbors will be used to reduce the number of calculations that need
            to be done
+    \param numThreads  Sets the number of threads to use, see
+           getTanimotoNeighbors() for details
 
   */
   std::vector<std::pair<double, unsigned int>> getTverskyNeighbors(
       const std::uint8_t *bv, double ca, double cb, double threshold = 0.7,
-      bool usePopcountScreen = true) const;
+      bool usePopcountScreen = true, int numThreads = 1) const;
   //! \overload
   std::vector<std::pair<double, unsigned int>> getTverskyNeighbors(
       boost::shared_array<std::uint8_t> bv, double ca, double cb,
-      double threshold = 0.7, bool usePopcountScreen = true) const {
-    return getTverskyNeighbors(bv.get(), ca, cb, threshold, usePopcountScreen);
+      double threshold = 0.7, bool usePopcountScreen = true,
+      int numThreads = 1) const {
+    return getTverskyNeighbors(bv.get(), ca, cb, threshold, usePopcountScreen,
+                               numThreads);
   }
   //! \overload
   std::vector<std::pair<double, unsigned int>> getTverskyNeighbors(
       const ExplicitBitVect &ebv, double ca, double cb, double threshold = 0.7,
-      bool usePopcountScreen = true) const;
+      bool usePopcountScreen = true, int numThreads = 1) const;
 
   //! returns indices of all fingerprints that completely contain this one
   /*! (i.e. where all the bits set in the query are also set in the db
@@ -252,6 +337,8 @@ class RDKIT_DATASTRUCTS_EXPORT FPBReader {
   bool df_owner{false};
   bool df_init{false};
   bool df_lazyRead{false};
+  bool df_memoryMap{false};
+  std::string d_fileName;  // only used when memory mapping
 
   // disable automatic copy constructors and assignment operators
   // for this class and its subclasses.  They will likely be
@@ -260,7 +347,7 @@ class RDKIT_DATASTRUCTS_EXPORT FPBReader {
   FPBReader(const FPBReader &);
   FPBReader &operator=(const FPBReader &);
   void destroy();
-  void _initFromFilename(const char *fname, bool lazyRead) {
+  void _initFromFilename(const char *fname, bool lazyRead, bool memoryMap) {
     std::istream *tmpStream = static_cast<std::istream *>(
         new std::ifstream(fname, std::ios_base::binary));
     if (!(*tmpStream) || (tmpStream->bad())) {
@@ -269,11 +356,19 @@ class RDKIT_DATASTRUCTS_EXPORT FPBReader {
       delete tmpStream;
       throw BadFileException(errout.str());
     }
+    if (memoryMap) {
+      // we don't need the stream, the file will be mapped in init()
+      delete tmpStream;
+      tmpStream = nullptr;
+      d_fileName = fname;
+      lazyRead = false;
+    }
     dp_istrm = tmpStream;
     dp_impl = nullptr;
     df_owner = true;
     df_init = false;
     df_lazyRead = lazyRead;
+    df_memoryMap = memoryMap;
   }
 };
 }  // namespace RDKit
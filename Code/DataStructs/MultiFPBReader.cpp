@@ -53,6 +53,7 @@ struct sim_args {
   const std::vector<FPBReader *> &readers;
   std::vector<std::vector<MultiFPBReader::ResultTuple>> *res;
   bool initOnSearch;
+  int threadsPerReader;
 };
 
 void tversky_helper(unsigned int threadId, unsigned int numThreads,
@@ -63,7 +64,8 @@ void tversky_helper(unsigned int threadId, unsigned int numThreads,
     }
     std::vector<std::pair<double, unsigned int>> r_res =
         args->readers[i]->getTverskyNeighbors(args->bv, args->ca, args->cb,
-                                              args->threshold);
+                                              args->threshold, true,
+                                              args->threadsPerReader);
     (*args->res)[i].clear();
     (*args->res)[i].reserve(r_res.size());
     for (std::vector<std::pair<double, unsigned int>>::const_iterator rit =
@@ -81,7 +83,8 @@ void tani_helper(unsigned int threadId, unsigned int numThreads,
       args->readers[i]->init();
     }
     std::vector<std::pair<double, unsigned int>> r_res =
-        args->readers[i]->getTanimotoNeighbors(args->bv, args->threshold);
+        args->readers[i]->getTanimotoNeighbors(args->bv, args->threshold, true,
+                                               args->threadsPerReader);
     (*args->res)[i].clear();
     (*args->res)[i].reserve(r_res.size());
     for (std::vector<std::pair<double, unsigned int>>::const_iterator rit =
@@ -95,22 +98,27 @@ void tani_helper(unsigned int threadId, unsigned int numThreads,
 
 template <typename T>
 void generic_nbr_helper(std::vector<MultiFPBReader::ResultTuple> &res, T func,
-                        const sim_args &args, unsigned int numThreads) {
+                        sim_args args, unsigned int numThreads) {
   res.clear();
   res.resize(0);
   numThreads = getNumThreadsToUse(numThreads);
+  // we use one thread per reader; if there are more threads than readers, the
+  // extras are used to search within the individual readers
+  unsigned int numReaderThreads =
+      std::min(numThreads, static_cast<unsigned int>(args.readers.size()));
+  args.threadsPerReader =
+      numReaderThreads ? std::max(1u, numThreads / numReaderThreads) : 1;
 #ifdef RDK_BUILD_THREADSAFE_SSS
   std::vector<std::future<void>> tg;
 #endif
-  if (numThreads == 1) {
+  if (numReaderThreads <= 1) {
     func(0, 1, &args);
   }
 #ifdef RDK_BUILD_THREADSAFE_SSS
   else {
-    for (unsigned int tid = 0; tid < numThreads && tid < args.readers.size();
-         ++tid) {
+    for (unsigned int tid = 0; tid < numReaderThreads; ++tid) {
       tg.emplace_back(
-          std::async(std::launch::async, func, tid, numThreads, &args));
+          std::async(std::launch::async, func, tid, numReaderThreads, &args));
     }
     for (auto &fut : tg) {
       fut.get();
@@ -129,7 +137,7 @@ void get_tani_nbrs(const std::vector<FPBReader *> &d_readers,
                    std::vector<MultiFPBReader::ResultTuple> &res,
                    int numThreads, bool initOnSearch) {
   std::vector<std::vector<MultiFPBReader::ResultTuple>> accum(d_readers.size());
-  sim_args args = {bv, 0., 0., threshold, d_readers, &accum, initOnSearch};
+  sim_args args = {bv, 0., 0., threshold, d_readers, &accum, initOnSearch, 1};
   generic_nbr_helper(res, tani_helper, args, numThreads);
 }
 
@@ -139,7 +147,7 @@ void get_tversky_nbrs(const std::vector<FPBReader *> &d_readers,
                       std::vector<MultiFPBReader::ResultTuple> &res,
                       int numThreads, bool initOnSearch) {
   std::vector<std::vector<MultiFPBReader::ResultTuple>> accum(d_readers.size());
-  sim_args args = {bv, a, b, threshold, d_readers, &accum, initOnSearch};
+  sim_args args = {bv, a, b, threshold, d_readers, &accum, initOnSearch, 1};
   generic_nbr_helper(res, tversky_helper, args, numThreads);
 }
 
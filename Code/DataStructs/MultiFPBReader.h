@@ -136,7 +136,9 @@ class RDKIT_DATASTRUCTS_EXPORT MultiFPBReader {
     \param threshold the minimum similarity to return
     \param numThreads  Sets the number of threads to use (more than one thread
     will only be used if the RDKit was build with multithread support) If set to
-    zero, the max supported by the system will be used.
+    zero, the max supported by the system will be used. If there are more
+    threads than readers, the extra threads are used to search within the
+    individual readers.
 
   */
   std::vector<ResultTuple> getTanimotoNeighbors(const std::uint8_t *bv,
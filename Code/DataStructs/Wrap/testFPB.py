@@ -48,6 +48,30 @@ class TestCase(unittest.TestCase):
     self.assertAlmostEqual(tpl[0][0], 1., 4)
     self.assertEqual(tpl[1][1], 1)
     self.assertAlmostEqual(tpl[1][0], 0.3704, 4)
+    self.assertEqual(self.fpbr.GetTanimotoNeighbors(bv, threshold=0.3, numThreads=4), tpl)
+
+    bvs = [self.fpbr.GetBytes(i) for i in (0, 3, 95)]
+    nbrs = self.fpbr.GetBulkTanimotoNeighbors(bvs, threshold=0.3)
+    self.assertEqual(len(nbrs), 3)
+    self.assertEqual(nbrs[0], tpl)
+    for bvi, nbri in zip(bvs, nbrs):
+      self.assertEqual(nbri, self.fpbr.GetTanimotoNeighbors(bvi, threshold=0.3))
+
+    tpl = self.fpbr.GetTopKTanimotoNeighbors(bv, 3)
+    self.assertEqual(len(tpl), 3)
+    self.assertEqual(tpl[0][1], 0)
+    self.assertAlmostEqual(tpl[0][0], 1., 4)
+    self.assertEqual(tpl[1][1], 1)
+    self.assertAlmostEqual(tpl[1][0], 0.3704, 4)
+    self.assertEqual(self.fpbr.GetTopKTanimotoNeighbors(bv, 3, numThreads=4), tpl)
+    self.assertEqual(len(self.fpbr.GetTopKTanimotoNeighbors(bv, 10, threshold=0.3)), 5)
+
+    tpl = self.fpbr.GetTanimotoNeighbors(bv, threshold=0.3)
+    mmfpbr = DataStructs.FPBReader(self.filename, memoryMap=True)
+    mmfpbr.Init()
+    self.assertEqual(len(mmfpbr), 100)
+    self.assertEqual(mmfpbr.GetId(3), "ZINC04803506")
+    self.assertEqual(mmfpbr.GetTanimotoNeighbors(bv, threshold=0.3), tpl)
 
   def test3Tversky(self):
     bv = self.fpbr.GetBytes(0)
@@ -18,10 +18,52 @@ using namespace RDKit;
 
 namespace {
 python::tuple taniNbrHelper(const FPBReader *self, const std::string &bytes,
-                            double threshold) {
+                            double threshold, int numThreads) {
   const auto *bv = reinterpret_cast<const std::uint8_t *>(bytes.c_str());
   std::vector<std::pair<double, unsigned int>> nbrs =
-      self->getTanimotoNeighbors(bv, threshold);
+      self->getTanimotoNeighbors(bv, threshold, true, numThreads);
+  python::list result;
+  for (auto &nbr : nbrs) {
+    result.append(python::make_tuple(nbr.first, nbr.second));
+  }
+  return python::tuple(result);
+}
+python::tuple bulkTaniNbrHelper(const FPBReader *self, python::object queries,
+                                double threshold, int numThreads) {
+  // hold on to the bytes objects so the pointers stay valid
+  std::vector<std::string> bytes;
+  unsigned int nQueries =
+      python::extract<unsigned int>(queries.attr("__len__")());
+  bytes.reserve(nQueries);
+  for (unsigned int i = 0; i < nQueries; ++i) {
+    bytes.push_back(python::extract<std::string>(queries[i]));
+  }
+  std::vector<const std::uint8_t *> bvs;
+  bvs.reserve(nQueries);
+  for (const auto &bv : bytes) {
+    bvs.push_back(reinterpret_cast<const std::uint8_t *>(bv.c_str()));
+  }
+  std::vector<std::vector<std::pair<double, unsigned int>>> nbrs;
+  {
+    NOGIL gil;
+    nbrs = self->getBulkTanimotoNeighbors(bvs, threshold, true, numThreads);
+  }
+  python::list result;
+  for (const auto &queryNbrs : nbrs) {
+    python::list queryResult;
+    for (const auto &nbr : queryNbrs) {
+      queryResult.append(python::make_tuple(nbr.first, nbr.second));
+    }
+    result.append(python::tuple(queryResult));
+  }
+  return python::tuple(result);
+}
+python::tuple topKTaniNbrHelper(const FPBReader *self,
+                                const std::string &bytes, unsigned int k,
+                                double threshold, int numThreads) {
+  const auto *bv = reinterpret_cast<const std::uint8_t *>(bytes.c_str());
+  std::vector<std::pair<double, unsigned int>> nbrs =
+      self->getTopKTanimotoNeighbors(bv, k, threshold, numThreads);
   python::list result;
   for (auto &nbr : nbrs) {
     result.append(python::make_tuple(nbr.first, nbr.second));
@@ -29,10 +71,11 @@ python::tuple taniNbrHelper(const FPBReader *self, const std::string &bytes,
   return python::tuple(result);
 }
 python::tuple tverskyNbrHelper(const FPBReader *self, const std::string &bytes,
-                               double ca, double cb, double threshold) {
+                               double ca, double cb, double threshold,
+                               int numThreads) {
   const auto *bv = reinterpret_cast<const std::uint8_t *>(bytes.c_str());
   std::vector<std::pair<double, unsigned int>> nbrs =
-      self->getTverskyNeighbors(bv, ca, cb, threshold);
+      self->getTverskyNeighbors(bv, ca, cb, threshold, true, numThreads);
   python::list result;
   for (auto &nbr : nbrs) {
     result.append(python::make_tuple(nbr.first, nbr.second));
@@ -122,9 +165,9 @@ struct FPB_wrapper {
     change in future releases.\n";
     python::class_<FPBReader, boost::noncopyable>(
         "FPBReader", FPBReaderClassDoc.c_str(),
-        python::init<std::string, python::optional<bool>>(
+        python::init<std::string, python::optional<bool, bool>>(
             (python::arg("self"), python::arg("filename"),
-             python::arg("lazy") = false),
+             python::arg("lazy") = false, python::arg("memoryMap") = false),
             "docstring"))
         .def("Init", &FPBReader::init, python::args("self"),
              "Read the fingerprints from the file. This can take a while.\n")
@@ -144,16 +187,30 @@ struct FPB_wrapper {
              "the bytes provided")
         .def("GetTanimotoNeighbors", &taniNbrHelper,
              ((python::arg("self"), python::arg("bv")),
-              python::arg("threshold") = 0.7),
+              python::arg("threshold") = 0.7, python::arg("numThreads") = 1),
              "returns tanimoto similarities to and indices of all neighbors "
              "above the specified threshold")
+        .def("GetBulkTanimotoNeighbors", &bulkTaniNbrHelper,
+             ((python::arg("self"), python::arg("bvs")),
+              python::arg("threshold") = 0.7, python::arg("numThreads") = 1),
+             "returns tanimoto similarities to and indices of all neighbors "
+             "above the specified threshold for each of a sequence of "
+             "queries.\n"
+             "This is much faster than calling GetTanimotoNeighbors() for "
+             "each query.")
+        .def("GetTopKTanimotoNeighbors", &topKTaniNbrHelper,
+             ((python::arg("self"), python::arg("bv"), python::arg("k")),
+              python::arg("threshold") = 0.0, python::arg("numThreads") = 1),
+             "returns tanimoto similarities to and indices of the k nearest "
+             "neighbors above the specified threshold")
         .def("GetTversky", &getTverskyHelper,
              python::args("self", "which", "bytes", "ca", "cb"),
              "return the Tverksy similarity of a particular fingerprint to "
              "the bytes provided")
         .def("GetTverskyNeighbors", &tverskyNbrHelper,
              ((python::arg("self"), python::arg("bv")), python::arg("ca"),
-              python::arg("cb"), python::arg("threshold") = 0.7),
+              python::arg("cb"), python::arg("threshold") = 0.7,
+              python::arg("numThreads") = 1),
              "returns Tversky similarities to and indices of all neighbors "
              "above the specified threshold")
         .def(
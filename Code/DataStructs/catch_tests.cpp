@@ -16,6 +16,9 @@
 #include "BitVectUtils.h"
 #include "SparseIntVect.h"
 #include <limits>
+#include <memory>
+#include <random>
+#include <vector>
 
 using namespace RDKit;
 
@@ -26,4 +29,89 @@ TEST_CASE("special cases for the limits of sparse vectors") {
     CHECK(!sbv.setBit(std::numeric_limits<unsigned int>::max()));
     CHECK(sbv.getBit(std::numeric_limits<unsigned int>::max()) == 1);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("batched bitmap operations") {
+  // cover the scalar tails of the vectorized kernels as well as the
+  // fingerprint sizes commonly used in FPB files
+  std::mt19937 rng(0xf00d);
+  std::uniform_int_distribution<unsigned int> byteDist(0, 255);
+  for (unsigned int nBytes : {5u, 24u, 40u, 128u, 256u, 264u}) {
+    for (unsigned int stride : {nBytes, nBytes + 8}) {
+      const unsigned int nFps = 37;
+      std::vector<unsigned char> probe(nBytes);
+      std::vector<unsigned char> fps(nFps * stride);
+      for (auto &v : probe) {
+        v = byteDist(rng);
+      }
+      for (auto &v : fps) {
+        v = byteDist(rng);
+      }
+      // make sure the degenerate cases are there too
+      std::fill(fps.begin(), fps.begin() + nBytes, 0);
+      std::copy(probe.begin(), probe.end(), fps.begin() + stride);
+
+      std::vector<unsigned int> common(nFps);
+      std::vector<double> tanis(nFps), dices(nFps);
+      CalcBitmapNumBitsInCommonBatch(probe.data(), fps.data(), nFps, nBytes,
+                                     stride, common.data());
+      CalcBitmapTanimotoBatch(probe.data(), fps.data(), nFps, nBytes, stride,
+                              tanis.data());
+      CalcBitmapDiceBatch(probe.data(), fps.data(), nFps, nBytes, stride,
+                          dices.data());
+      for (unsigned int i = 0; i < nFps; ++i) {
+        const unsigned char *fp = fps.data() + i * stride;
+        std::vector<unsigned char> both(nBytes);
+        for (unsigned int j = 0; j < nBytes; ++j) {
+          both[j] = probe[j] & fp[j];
+        }
+        CHECK(common[i] == CalcBitmapPopcount(both.data(), nBytes));
+        CHECK(tanis[i] == CalcBitmapTanimoto(probe.data(), fp, nBytes));
+        CHECK(dices[i] == CalcBitmapDice(probe.data(), fp, nBytes));
+      }
+      CHECK(tanis[1] == 1.0);
+    }
+  }
+}
+
+TEST_CASE("batched bitmap substructure screen") {
+  std::mt19937 rng(0xbeef);
+  std::uniform_int_distribution<unsigned int> byteDist(0, 255);
+  for (unsigned int nBytes : {5u, 24u, 40u, 128u, 256u, 264u}) {
+    for (unsigned int stride : {nBytes, nBytes + 8}) {
+      const unsigned int nFps = 41;
+      // sparse probes so that some of the random fingerprints pass
+      std::vector<unsigned char> probe(nBytes);
+      for (auto &v : probe) {
+        v = byteDist(rng) & byteDist(rng) & byteDist(rng);
+      }
+      probe[nBytes - 1] |= 1;
+      std::vector<unsigned char> fps(nFps * stride);
+      for (unsigned int i = 0; i < nFps; ++i) {
+        for (unsigned int j = 0; j < stride; ++j) {
+          fps[i * stride + j] = byteDist(rng) | byteDist(rng);
+          // every third fingerprint is a superset of the probe
+          if (j < nBytes && i % 3 == 0) {
+            fps[i * stride + j] |= probe[j];
+          }
+        }
+      }
+      // the last one has all but one of the probe bits
+      std::copy(probe.begin(), probe.end(),
+                fps.begin() + (nFps - 1) * stride);
+      fps[(nFps - 1) * stride + nBytes - 1] &= 0xfe;
+
+      std::unique_ptr<bool[]> res(new bool[nFps]);
+      CalcBitmapAllProbeBitsMatchBatch(probe.data(), fps.data(), nFps, nBytes,
+                                       stride, res.get());
+      unsigned int nMatches = 0;
+      for (unsigned int i = 0; i < nFps; ++i) {
+        const unsigned char *fp = fps.data() + i * stride;
+        CHECK(res[i] == CalcBitmapAllProbeBitsMatch(probe.data(), fp, nBytes));
+        nMatches += res[i];
+      }
+      CHECK(nMatches > 0);
+      CHECK(!res[nFps - 1]);
+    }
+  }
+}
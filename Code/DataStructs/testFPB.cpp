@@ -11,6 +11,8 @@
 #include <RDGeneral/utils.h>
 #include <DataStructs/ExplicitBitVect.h>
 #include <DataStructs/FPBReader.h>
+#include <cstring>
+#include <iterator>
 
 using namespace RDKit;
 
@@ -547,3 +549,190 @@ TEST_CASE("Github Issue 1118") {
   }
   BOOST_LOG(rdInfoLog) << "Finished" << std::endl;
 }
+
+TEST_CASE("FPBReader neighbors match pairwise similarities") {
+  std::string pathName = getenv("RDBASE");
+  pathName += "/Code/DataStructs/testData/";
+  std::string filename = pathName + "zim.head100.fpb";
+  for (auto lazy : {false, true}) {
+    FPBReader fps(filename, lazy);
+    fps.init();
+    for (auto probeIdx : {0u, 37u, 95u}) {
+      boost::shared_array<std::uint8_t> bytes = fps.getBytes(probeIdx);
+      for (auto threshold : {0.0, 0.3, 0.6}) {
+        for (auto useScreen : {true, false}) {
+          std::vector<std::pair<double, unsigned int>> expected;
+          for (unsigned int i = 0; i < fps.length(); ++i) {
+            double sim = fps.getTanimoto(i, bytes);
+            if (sim >= threshold) {
+              expected.emplace_back(sim, i);
+            }
+          }
+          auto nbrs = fps.getTanimotoNeighbors(bytes, threshold, useScreen);
+          REQUIRE(nbrs.size() == expected.size());
+          for (const auto &nbr : nbrs) {
+            CHECK(nbr.first == fps.getTanimoto(nbr.second, bytes));
+          }
+
+          expected.clear();
+          for (unsigned int i = 0; i < fps.length(); ++i) {
+            double sim = fps.getTversky(i, bytes, 0.3, 0.7);
+            if (sim >= threshold) {
+              expected.emplace_back(sim, i);
+            }
+          }
+          nbrs = fps.getTverskyNeighbors(bytes, 0.3, 0.7, threshold, useScreen);
+          REQUIRE(nbrs.size() == expected.size());
+          for (const auto &nbr : nbrs) {
+            CHECK(nbr.first == fps.getTversky(nbr.second, bytes, 0.3, 0.7));
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("FPBReader multithreaded neighbors") {
+  std::string pathName = getenv("RDBASE");
+  pathName += "/Code/DataStructs/testData/";
+  std::string filename = pathName + "zim.head100.fpb";
+  FPBReader fps(filename);
+  fps.init();
+  for (auto probeIdx : {0u, 37u, 95u}) {
+    boost::shared_array<std::uint8_t> bytes = fps.getBytes(probeIdx);
+    for (auto threshold : {0.0, 0.3}) {
+      for (auto useScreen : {true, false}) {
+        auto ref = fps.getTanimotoNeighbors(bytes, threshold, useScreen);
+        auto tvref =
+            fps.getTverskyNeighbors(bytes, 0.5, 0.5, threshold, useScreen);
+        for (auto numThreads : {2, 3, 7, 200}) {
+          CHECK(fps.getTanimotoNeighbors(bytes, threshold, useScreen,
+                                         numThreads) == ref);
+          CHECK(fps.getTverskyNeighbors(bytes, 0.5, 0.5, threshold, useScreen,
+                                        numThreads) == tvref);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("FPBReader memory mapped") {
+  std::string pathName = getenv("RDBASE");
+  pathName += "/Code/DataStructs/testData/";
+  for (const auto *fname : {"zim.head100.fpb", "zinc_random200.1.patt.fpb"}) {
+    std::string filename = pathName + fname;
+    FPBReader ref(filename);
+    ref.init();
+    FPBReader fps(filename, false, true);
+    fps.init();
+    REQUIRE(fps.length() == ref.length());
+    CHECK(fps.nBits() == ref.nBits());
+    for (unsigned int i = 0; i < fps.length(); ++i) {
+      CHECK(fps.getId(i) == ref.getId(i));
+      CHECK(*fps.getFP(i) == *ref.getFP(i));
+    }
+    boost::shared_array<std::uint8_t> bytes = ref.getBytes(3);
+    CHECK(fps.getTanimotoNeighbors(bytes, 0.3) ==
+          ref.getTanimotoNeighbors(bytes, 0.3));
+    CHECK(fps.getTanimotoNeighbors(bytes, 0.3, true, 4) ==
+          ref.getTanimotoNeighbors(bytes, 0.3));
+    CHECK(fps.getTverskyNeighbors(bytes, 0.3, 0.7, 0.3) ==
+          ref.getTverskyNeighbors(bytes, 0.3, 0.7, 0.3));
+    CHECK(fps.getContainingNeighbors(bytes) ==
+          ref.getContainingNeighbors(bytes));
+  }
+  SECTION("bad files") {
+    std::string filename = pathName + "test1.bin";
+    FPBReader fps(filename, false, true);
+    CHECK_THROWS_AS(fps.init(), BadFileException);
+  }
+}
+
+TEST_CASE("FPBReader top k Tanimoto neighbors") {
+  std::string pathName = getenv("RDBASE");
+  pathName += "/Code/DataStructs/testData/";
+  std::string filename = pathName + "zim.head100.fpb";
+  std::ifstream inStream(filename, std::ios_base::binary);
+  std::string data((std::istreambuf_iterator<char>(inStream)),
+                   std::istreambuf_iterator<char>());
+  // drop the POPC chunk (and its 12 byte header) to check the full scan
+  auto popcPos = data.find("POPC");
+  REQUIRE(popcPos != std::string::npos);
+  std::uint64_t popcSize;
+  memcpy(&popcSize, data.data() + popcPos - 8, sizeof(popcSize));
+  std::string noPopcounts = data;
+  noPopcounts.erase(popcPos - 8, popcSize + 12);
+
+  for (const auto &contents : {data, noPopcounts}) {
+    FPBReader fps(new std::istringstream(contents));
+    fps.init();
+    FPBReader lazyFps(new std::istringstream(contents), true, true);
+    lazyFps.init();
+    for (auto probeIdx : {0u, 37u, 95u}) {
+      boost::shared_array<std::uint8_t> bytes = fps.getBytes(probeIdx);
+      for (auto threshold : {0.0, 0.3}) {
+        auto all = fps.getTanimotoNeighbors(bytes, threshold, false);
+        std::sort(all.begin(), all.end(), [](const auto &a, const auto &b) {
+          return a.first > b.first ||
+                 (a.first == b.first && a.second < b.second);
+        });
+        for (auto k : {0u, 1u, 5u, 17u, 1000u}) {
+          std::vector<std::pair<double, unsigned int>> expected(
+              all.begin(), all.begin() + std::min<size_t>(k, all.size()));
+          CHECK(fps.getTopKTanimotoNeighbors(bytes, k, threshold) == expected);
+          CHECK(lazyFps.getTopKTanimotoNeighbors(bytes, k, threshold) ==
+                expected);
+          for (auto numThreads : {2, 4, 200}) {
+            CHECK(fps.getTopKTanimotoNeighbors(bytes, k, threshold,
+                                               numThreads) == expected);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("FPBReader bulk Tanimoto neighbors") {
+  std::string pathName = getenv("RDBASE");
+  pathName += "/Code/DataStructs/testData/";
+  std::string filename = pathName + "zim.head100.fpb";
+  FPBReader fps(filename);
+  fps.init();
+  FPBReader lazyFps(filename, true);
+  lazyFps.init();
+  std::vector<boost::shared_array<std::uint8_t>> queries;
+  std::vector<const std::uint8_t *> bvs;
+  for (unsigned int i = 0; i < fps.length(); i += 7) {
+    queries.push_back(fps.getBytes(i));
+    bvs.push_back(queries.back().get());
+  }
+  for (auto threshold : {0.0, 0.3, 0.7}) {
+    for (auto useScreen : {true, false}) {
+      std::vector<std::vector<std::pair<double, unsigned int>>> expected;
+      for (const auto bv : bvs) {
+        expected.push_back(fps.getTanimotoNeighbors(bv, threshold, useScreen));
+      }
+      CHECK(fps.getBulkTanimotoNeighbors(bvs, threshold, useScreen) ==
+            expected);
+      CHECK(lazyFps.getBulkTanimotoNeighbors(bvs, threshold, useScreen) ==
+            expected);
+      for (auto numThreads : {2, 4, 200}) {
+        CHECK(fps.getBulkTanimotoNeighbors(bvs, threshold, useScreen,
+                                           numThreads) == expected);
+      }
+    }
+  }
+  SECTION("ExplicitBitVects") {
+    auto fp1 = fps.getFP(0);
+    auto fp2 = fps.getFP(95);
+    auto nbrs = fps.getBulkTanimotoNeighbors(
+        std::vector<const ExplicitBitVect *>{fp1.get(), fp2.get()}, 0.3);
+    REQUIRE(nbrs.size() == 2);
+    CHECK(nbrs[0] == fps.getTanimotoNeighbors(*fp1, 0.3));
+    CHECK(nbrs[1] == fps.getTanimotoNeighbors(*fp2, 0.3));
+  }
+  SECTION("no queries") {
+    CHECK(fps.getBulkTanimotoNeighbors(std::vector<const std::uint8_t *>())
+              .empty());
+  }
+}
@@ -639,16 +639,7 @@ void Atom::setMonomerInfo(AtomMonomerInfo *info) {
 void Atom::setIsotope(unsigned int what) { d_isotope = what; }
 
 double Atom::getMass() const {
-  if (d_isotope) {
-    double res =
-        PeriodicTable::getTable()->getMassForIsotope(d_atomicNum, d_isotope);
-    if (d_atomicNum != 0 && res == 0.0) {
-      res = d_isotope;
-    }
-    return res;
-  } else {
-    return PeriodicTable::getTable()->getAtomicWeight(d_atomicNum);
-  }
+  return PeriodicTable::getTable()->getAtomMass(d_atomicNum, d_isotope);
 }
 
 bool Atom::hasValenceViolation() const {
@@ -831,7 +822,7 @@ bool Atom::invertChirality() {
       setChiralTag(CHI_TETRAHEDRAL_CW);
       return true;
     case CHI_TETRAHEDRAL:
-      if (getPropIfPresent(common_properties::_chiralPermutation, perm)) {
+      if (getPropIfPresent(common_properties::keys::_chiralPermutation, perm)) {
         if (perm == 1) {
           perm = 2;
         } else if (perm == 2) {
@@ -844,14 +835,14 @@ bool Atom::invertChirality() {
       }
       break;
     case CHI_TRIGONALBIPYRAMIDAL:
-      if (getPropIfPresent(common_properties::_chiralPermutation, perm)) {
+      if (getPropIfPresent(common_properties::keys::_chiralPermutation, perm)) {
         perm = (perm <= 20) ? trigonalbipyramidal_invert[perm] : 0;
         setProp(common_properties::_chiralPermutation, perm);
         return perm != 0;
       }
       break;
     case CHI_OCTAHEDRAL:
-      if (getPropIfPresent(common_properties::_chiralPermutation, perm)) {
+      if (getPropIfPresent(common_properties::keys::_chiralPermutation, perm)) {
         perm = (perm <= 30) ? octahedral_invert[perm] : 0;
         setProp(common_properties::_chiralPermutation, perm);
         return perm != 0;
@@ -879,7 +870,7 @@ void setAtomRLabel(Atom *atm, int rlabel) {
 int getAtomRLabel(const Atom *atom) {
   PRECONDITION(atom, "bad atom");
   unsigned int rlabel = 0;
-  atom->getPropIfPresent(common_properties::_MolFileRLabel, rlabel);
+  atom->getPropIfPresent(common_properties::keys::_MolFileRLabel, rlabel);
   return static_cast<int>(rlabel);
 }
 
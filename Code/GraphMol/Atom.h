@@ -369,16 +369,16 @@ class RDKIT_GRAPHMOL_EXPORT Atom : public RDProps {
         !strict || (mapno >= 0 && mapno < 1000),
         "atom map number out of range [0..1000], use strict=false to override");
     if (mapno) {
-      setProp(common_properties::molAtomMapNumber, mapno);
-    } else if (hasProp(common_properties::molAtomMapNumber)) {
-      clearProp(common_properties::molAtomMapNumber);
+      setProp(common_properties::keys::molAtomMapNumber, mapno);
+    } else if (hasProp(common_properties::keys::molAtomMapNumber)) {
+      clearProp(common_properties::keys::molAtomMapNumber);
     }
   }
   //! Gets the atom map Number of the atom, if no atom map exists, 0 is
   //! returned.
   int getAtomMapNum() const {
     int mapno = 0;
-    getPropIfPresent(common_properties::molAtomMapNumber, mapno);
+    getPropIfPresent(common_properties::keys::molAtomMapNumber, mapno);
     return mapno;
   }
 
@@ -1072,7 +1072,8 @@ void canonicalizeFragment(ROMol &mol, int atomIdx,
           int nSwaps = 0;
           int perm = 0;
           if (Chirality::hasNonTetrahedralStereo(atom)) {
-            atom->getPropIfPresent(common_properties::_chiralPermutation, perm);
+            atom->getPropIfPresent(common_properties::keys::_chiralPermutation,
+                                   perm);
           }
 
           const unsigned int firstIdx = molStack.begin()->obj.atom->getIdx();
@@ -1157,7 +1158,7 @@ void canonicalizeFragment(ROMol &mol, int atomIdx,
       if (msI.type == MOL_STACK_ATOM &&
           msI.obj.atom->getChiralTag() != Atom::CHI_UNSPECIFIED &&
           !msI.obj.atom->hasProp(common_properties::_brokenChirality)) {
-        if (msI.obj.atom->hasProp(common_properties::_ringStereoAtoms)) {
+        if (msI.obj.atom->hasProp(common_properties::keys::_ringStereoAtoms)) {
           // FIX: handle stereogroups here too
           if (!ringStereoChemAdjusted[msI.obj.atom->getIdx()]) {
             msI.obj.atom->setChiralTag(Atom::CHI_TETRAHEDRAL_CCW);
@@ -400,7 +400,7 @@ const Atom *findHighestCIPNeighbor(const Atom *atom, const Atom *skipAtom) {
       continue;
     }
     unsigned cip = 0;
-    if (!neighbor->getPropIfPresent(common_properties::_CIPRank, cip)) {
+    if (!neighbor->getPropIfPresent(common_properties::keys::_CIPRank, cip)) {
       // If at least one of the atoms doesn't have a CIP rank, the highest rank
       // does not make sense, so return a nullptr.
       return nullptr;
@@ -1018,7 +1018,7 @@ void buildCIPInvariants(const ROMol &mol, DOUBLE_VECT &res) {
     invariant = (invariant << nMassBits) | mass;
 
     int mapnum = -1;
-    atom->getPropIfPresent(common_properties::molAtomMapNumber, mapnum);
+    atom->getPropIfPresent(common_properties::keys::molAtomMapNumber, mapnum);
     mapnum = (mapnum + 1) % 1024;  // increment to allow map numbers of zero
                                    // (though that would be stupid)
     invariant = (invariant << 10) | mapnum;
@@ -1339,7 +1339,7 @@ void assignAtomCIPRanks(const ROMol &mol, UINT_VECT &ranks) {
 
   // copy the ranks onto the atoms:
   for (unsigned int i = 0; i < numAtoms; ++i) {
-    mol[i]->setProp(common_properties::_CIPRank, ranks[i], 1);
+    mol[i]->setProp(common_properties::keys::_CIPRank, ranks[i], 1);
   }
 }
 
@@ -1533,7 +1533,7 @@ void findChiralAtomSpecialCases(ROMol &mol,
       continue;
     }
     if (atom->getChiralTag() == Atom::CHI_UNSPECIFIED ||
-        atom->hasProp(common_properties::_CIPCode) ||
+        atom->hasProp(common_properties::keys::_CIPCode) ||
         !mol.getRingInfo()->numAtomRings(atom->getIdx()) ||
         !atomIsCandidateForRingStereochem(mol, atom, atomRanks)) {
       continue;
@@ -1557,7 +1557,7 @@ void findChiralAtomSpecialCases(ROMol &mol,
     }
     INT_VECT ringStereoAtoms(0);
     if (!nextAtoms.empty()) {
-      atom->getPropIfPresent(common_properties::_ringStereoAtoms,
+      atom->getPropIfPresent(common_properties::keys::_ringStereoAtoms,
                              ringStereoAtoms);
     }
 
@@ -1566,15 +1566,16 @@ void findChiralAtomSpecialCases(ROMol &mol,
       nextAtoms.pop_front();
       atomsSeen.set(ratom->getIdx());
       if (ratom->getChiralTag() != Atom::CHI_UNSPECIFIED &&
-          !ratom->hasProp(common_properties::_CIPCode) &&
+          !ratom->hasProp(common_properties::keys::_CIPCode) &&
           atomIsCandidateForRingStereochem(mol, ratom, atomRanks)) {
         int same = (ratom->getChiralTag() == atom->getChiralTag()) ? 1 : -1;
         ringStereoAtoms.push_back(same * (ratom->getIdx() + 1));
         INT_VECT oringatoms(0);
-        ratom->getPropIfPresent(common_properties::_ringStereoAtoms,
+        ratom->getPropIfPresent(common_properties::keys::_ringStereoAtoms,
                                 oringatoms);
         oringatoms.push_back(same * (atom->getIdx() + 1));
-        ratom->setProp(common_properties::_ringStereoAtoms, oringatoms, true);
+        ratom->setProp(common_properties::keys::_ringStereoAtoms, oringatoms,
+                       true);
         possibleSpecialCases.set(ratom->getIdx());
         possibleSpecialCases.set(atom->getIdx());
       }
@@ -1594,7 +1595,8 @@ void findChiralAtomSpecialCases(ROMol &mol,
       }
     }  // end of BFS
     if (ringStereoAtoms.size() != 0) {
-      atom->setProp(common_properties::_ringStereoAtoms, ringStereoAtoms, true);
+      atom->setProp(common_properties::keys::_ringStereoAtoms, ringStereoAtoms,
+                    true);
       // because we're only going to hit each ring atom once, the first atom we
       // encounter in a ring is going to end up with all the other atoms set as
       // stereoAtoms, but each of them will only have the first atom present. We
@@ -1614,7 +1616,8 @@ void findChiralAtomSpecialCases(ROMol &mol,
             ringAtomEntry < 0 ? -ringAtomEntry - 1 : ringAtomEntry - 1;
         INT_VECT lringatoms(0);
         mol.getAtomWithIdx(ringAtomIdx)
-            ->getPropIfPresent(common_properties::_ringStereoAtoms, lringatoms);
+            ->getPropIfPresent(common_properties::keys::_ringStereoAtoms,
+                               lringatoms);
         CHECK_INVARIANT(lringatoms.size() > 0, "no other ring atoms found.");
         for (auto orae = rae + 1; orae != ringStereoAtoms.end(); ++orae) {
           int oringAtomEntry = *orae;
@@ -1625,16 +1628,16 @@ void findChiralAtomSpecialCases(ROMol &mol,
                                               : (oringAtomIdx + 1));
           INT_VECT olringatoms(0);
           mol.getAtomWithIdx(oringAtomIdx)
-              ->getPropIfPresent(common_properties::_ringStereoAtoms,
+              ->getPropIfPresent(common_properties::keys::_ringStereoAtoms,
                                  olringatoms);
           CHECK_INVARIANT(olringatoms.size() > 0, "no other ring atoms found.");
           olringatoms.push_back(theseDifferent ? -(ringAtomIdx + 1)
                                                : (ringAtomIdx + 1));
           mol.getAtomWithIdx(oringAtomIdx)
-              ->setProp(common_properties::_ringStereoAtoms, olringatoms);
+              ->setProp(common_properties::keys::_ringStereoAtoms, olringatoms);
         }
         mol.getAtomWithIdx(ringAtomIdx)
-            ->setProp(common_properties::_ringStereoAtoms, lringatoms);
+            ->setProp(common_properties::keys::_ringStereoAtoms, lringatoms);
       }
 
     } else {
@@ -1751,7 +1754,7 @@ std::pair<bool, bool> assignAtomChiralCodes(ROMol &mol, UINT_VECT &ranks,
     // we understand:
     if (flagPossibleStereoCenters ||
         (tag != Atom::CHI_UNSPECIFIED && tag != Atom::CHI_OTHER)) {
-      if (atom->hasProp(common_properties::_CIPCode)) {
+      if (atom->hasProp(common_properties::keys::_CIPCode)) {
         continue;
       }
 
@@ -1809,7 +1812,7 @@ std::pair<bool, bool> assignAtomChiralCodes(ROMol &mol, UINT_VECT &ranks,
         } else {
           cipCode = "R";
         }
-        atom->setProp(common_properties::_CIPCode, cipCode);
+        atom->setProp(common_properties::keys::_CIPCode, cipCode);
       }
     }
   }
@@ -2081,7 +2084,7 @@ void rerankAtoms(const ROMol &mol, UINT_VECT &ranks) {
     const Atom *atom = mol.getAtomWithIdx(i);
     // Priority order: R > S > nothing
     std::string cipCode;
-    if (atom->getPropIfPresent(common_properties::_CIPCode, cipCode)) {
+    if (atom->getPropIfPresent(common_properties::keys::_CIPCode, cipCode)) {
       if (cipCode == "S") {
         invars[i] += 10;
       } else if (cipCode == "R") {
@@ -2101,7 +2104,7 @@ void rerankAtoms(const ROMol &mol, UINT_VECT &ranks) {
   iterateCIPRanks(mol, invars, ranks, true);
   // copy the ranks onto the atoms:
   for (unsigned int i = 0; i < mol.getNumAtoms(); i++) {
-    mol.getAtomWithIdx(i)->setProp(common_properties::_CIPRank, ranks[i]);
+    mol.getAtomWithIdx(i)->setProp(common_properties::keys::_CIPRank, ranks[i]);
   }
 
 #ifdef VERBOSE_CANON
@@ -2282,10 +2285,10 @@ void legacyStereoPerception(ROMol &mol, bool cleanIt,
   bool hasPotentialStereoAtoms = false;
   for (auto atom : mol.atoms()) {
     if (cleanIt) {
-      if (atom->hasProp(common_properties::_CIPCode)) {
-        atom->clearProp(common_properties::_CIPCode);
+      if (atom->hasProp(common_properties::keys::_CIPCode)) {
+        atom->clearProp(common_properties::keys::_CIPCode);
       }
-      if (atom->hasProp(common_properties::_ChiralityPossible)) {
+      if (atom->hasProp(common_properties::keys::_ChiralityPossible)) {
         atom->clearProp(common_properties::_ChiralityPossible);
       }
     }
@@ -2303,7 +2306,7 @@ void legacyStereoPerception(ROMol &mol, bool cleanIt,
   bool hasPotentialStereoBonds = false;
   for (auto bond : mol.bonds()) {
     if (cleanIt) {
-      bond->clearProp(common_properties::_CIPCode);
+      bond->clearProp(common_properties::keys::_CIPCode);
       // enforce no stereo on small rings
       if ((bond->getBondType() == Bond::DOUBLE ||
            bond->getBondType() == Bond::AROMATIC) &&
@@ -2394,8 +2397,8 @@ void legacyStereoPerception(ROMol &mol, bool cleanIt,
       if (atom->hasProp(common_properties::_ringStereochemCand)) {
         atom->clearProp(common_properties::_ringStereochemCand);
       }
-      if (atom->hasProp(common_properties::_ringStereoAtoms)) {
-        atom->clearProp(common_properties::_ringStereoAtoms);
+      if (atom->hasProp(common_properties::keys::_ringStereoAtoms)) {
+        atom->clearProp(common_properties::keys::_ringStereoAtoms);
       }
     }
     boost::dynamic_bitset<> possibleSpecialCases(mol.getNumAtoms());
@@ -2404,9 +2407,9 @@ void legacyStereoPerception(ROMol &mol, bool cleanIt,
     for (auto atom : mol.atoms()) {
       if (atom->getChiralTag() != Atom::CHI_UNSPECIFIED &&
           !Chirality::hasNonTetrahedralStereo(atom) &&
-          !atom->hasProp(common_properties::_CIPCode) &&
+          !atom->hasProp(common_properties::keys::_CIPCode) &&
           (!possibleSpecialCases[atom->getIdx()] ||
-           !atom->hasProp(common_properties::_ringStereoAtoms))) {
+           !atom->hasProp(common_properties::keys::_ringStereoAtoms))) {
         atom->setChiralTag(Atom::CHI_UNSPECIFIED);
 
         // If the atom has an explicit hydrogen and no charge, that H
@@ -2560,11 +2563,11 @@ void stereoPerception(ROMol &mol, bool cleanIt,
                       bool flagPossibleStereoCenters) {
   if (cleanIt) {
     for (auto atom : mol.atoms()) {
-      atom->clearProp(common_properties::_CIPCode);
+      atom->clearProp(common_properties::keys::_CIPCode);
       atom->clearProp(common_properties::_ChiralityPossible);
     }
     for (auto bond : mol.bonds()) {
-      bond->clearProp(common_properties::_CIPCode);
+      bond->clearProp(common_properties::keys::_CIPCode);
       if (bond->getBondDir() == Bond::BondDir::EITHERDOUBLE) {
         bond->setStereo(Bond::BondStereo::STEREOANY);
         bond->getStereoAtoms().clear();
@@ -2632,7 +2635,8 @@ bool canBeStereoBond(const Bond *bond) {
         const auto otherAtom = nbrBond->getOtherAtom(atom);
         int rank;
         if (RDKit::Chirality::getUseLegacyStereoPerception()) {
-          if (!otherAtom->getPropIfPresent(common_properties::_CIPRank, rank)) {
+          if (!otherAtom->getPropIfPresent(common_properties::keys::_CIPRank,
+                                           rank)) {
             rank = -1;
           }
         } else {  // NOT legacy stereo
@@ -2819,7 +2823,7 @@ void addStereoAnnotations(ROMol &mol, std::string absLabel, std::string orLabel,
         continue;
       }
       std::string cip;
-      atom->getPropIfPresent(common_properties::_CIPCode, cip);
+      atom->getPropIfPresent(common_properties::keys::_CIPCode, cip);
 
       std::string lab;
       switch (sg.getGroupType()) {
@@ -2852,7 +2856,7 @@ void addStereoAnnotations(ROMol &mol, std::string absLabel, std::string orLabel,
     for (auto atom : mol.atoms()) {
       std::string cip;
       if (!doneAts[atom->getIdx()] &&
-          atom->getPropIfPresent(common_properties::_CIPCode, cip)) {
+          atom->getPropIfPresent(common_properties::keys::_CIPCode, cip)) {
         std::string lab = cipLabel;
         boost::algorithm::replace_all(lab, "{cip}", cip);
         atom->setProp(common_properties::atomNote, lab);
@@ -2862,7 +2866,7 @@ void addStereoAnnotations(ROMol &mol, std::string absLabel, std::string orLabel,
   if (!bondLabel.empty()) {
     for (auto bond : mol.bonds()) {
       std::string cip;
-      if (!bond->getPropIfPresent(common_properties::_CIPCode, cip)) {
+      if (!bond->getPropIfPresent(common_properties::keys::_CIPCode, cip)) {
         if (bond->getStereo() == Bond::STEREOE) {
           cip = "E";
         } else if (bond->getStereo() == Bond::STEREOZ) {
@@ -2940,7 +2944,7 @@ void findPotentialStereoBonds(ROMol &mol, bool cleanIt) {
             // ------------------
             // get the CIP ranking of each atom if we need it:
             if (!cipDone) {
-              if (!begAtom->hasProp(common_properties::_CIPRank)) {
+              if (!begAtom->hasProp(common_properties::keys::_CIPRank)) {
                 Chirality::assignAtomCIPRanks(mol, ranks);
               } else {
                 // no need to recompute if we don't need to recompute. :-)
@@ -3044,10 +3048,11 @@ void cleanupChirality(RWMol &mol) {
           atom->setChiralTag(Atom::CHI_UNSPECIFIED);
         } else {
           perm = 0;
-          atom->getPropIfPresent(common_properties::_chiralPermutation, perm);
+          atom->getPropIfPresent(common_properties::keys::_chiralPermutation,
+                                 perm);
           if (perm > 2) {
             perm = 0;
-            atom->setProp(common_properties::_chiralPermutation, perm);
+            atom->setProp(common_properties::keys::_chiralPermutation, perm);
           }
         }
         break;
@@ -3058,10 +3063,11 @@ void cleanupChirality(RWMol &mol) {
           atom->setChiralTag(Atom::CHI_UNSPECIFIED);
         } else {
           perm = 0;
-          atom->getPropIfPresent(common_properties::_chiralPermutation, perm);
+          atom->getPropIfPresent(common_properties::keys::_chiralPermutation,
+                                 perm);
           if (perm > 3) {
             perm = 0;
-            atom->setProp(common_properties::_chiralPermutation, perm);
+            atom->setProp(common_properties::keys::_chiralPermutation, perm);
           }
         }
         break;
@@ -3072,10 +3078,11 @@ void cleanupChirality(RWMol &mol) {
           atom->setChiralTag(Atom::CHI_UNSPECIFIED);
         } else {
           perm = 0;
-          atom->getPropIfPresent(common_properties::_chiralPermutation, perm);
+          atom->getPropIfPresent(common_properties::keys::_chiralPermutation,
+                                 perm);
           if (perm > 20) {
             perm = 0;
-            atom->setProp(common_properties::_chiralPermutation, perm);
+            atom->setProp(common_properties::keys::_chiralPermutation, perm);
           }
         }
         break;
@@ -3086,10 +3093,11 @@ void cleanupChirality(RWMol &mol) {
           atom->setChiralTag(Atom::CHI_UNSPECIFIED);
         } else {
           perm = 0;
-          atom->getPropIfPresent(common_properties::_chiralPermutation, perm);
+          atom->getPropIfPresent(common_properties::keys::_chiralPermutation,
+                                 perm);
           if (perm > 30) {
             perm = 0;
-            atom->setProp(common_properties::_chiralPermutation, perm);
+            atom->setProp(common_properties::keys::_chiralPermutation, perm);
           }
         }
         break;
@@ -3246,7 +3254,7 @@ static bool assignNontetrahedralChiralTypeFrom3D(ROMol &mol,
           } else /* pair[0] == 3 */ {
             perm = 1;  // U
           }
-          atom->setProp(common_properties::_chiralPermutation, perm);
+          atom->setProp(common_properties::keys::_chiralPermutation, perm);
           break;
         case 4:                /* See-saw */
           if (pair[0] == 2) {  // a b
@@ -3300,7 +3308,7 @@ static bool assignNontetrahedralChiralTypeFrom3D(ROMol &mol,
           }
           atom->setChiralTag(tag);
           res = true;
-          atom->setProp(common_properties::_chiralPermutation, perm);
+          atom->setProp(common_properties::keys::_chiralPermutation, perm);
           break;
         case 5: /* Trigonal bipyramidal */
           atom->setChiralTag(Atom::ChiralType::CHI_TRIGONALBIPYRAMIDAL);
@@ -3326,7 +3334,7 @@ static bool assignNontetrahedralChiralTypeFrom3D(ROMol &mol,
           } else /* pair[2] == 4 */ {
             perm = VOLTEST(3, 0, 1) ? 17 : 18;  // d e
           }
-          atom->setProp(common_properties::_chiralPermutation, perm);
+          atom->setProp(common_properties::keys::_chiralPermutation, perm);
           break;
       }
       break;
@@ -3342,13 +3350,13 @@ static bool assignNontetrahedralChiralTypeFrom3D(ROMol &mol,
         } else /* pair[1] == 4 */ {
           perm = 3;  // Z
         }
-        atom->setProp(common_properties::_chiralPermutation, perm);
+        atom->setProp(common_properties::keys::_chiralPermutation, perm);
       } else if (count == 5) {
         /* Square pyramidal */
         atom->setChiralTag(Atom::ChiralType::CHI_OCTAHEDRAL);
         res = true;
         perm = OctahedralPermFrom3D(pair, v);
-        atom->setProp(common_properties::_chiralPermutation, perm);
+        atom->setProp(common_properties::keys::_chiralPermutation, perm);
       }
       break;
     case 3:
@@ -3357,7 +3365,7 @@ static bool assignNontetrahedralChiralTypeFrom3D(ROMol &mol,
         atom->setChiralTag(Atom::ChiralType::CHI_OCTAHEDRAL);
         res = true;
         perm = OctahedralPermFrom3D(pair, v);
-        atom->setProp(common_properties::_chiralPermutation, perm);
+        atom->setProp(common_properties::keys::_chiralPermutation, perm);
       }
       break;
   }
@@ -3520,7 +3528,7 @@ void assignChiralTypesFromMolParity(ROMol &mol, bool replaceExistingTags) {
       continue;
     }
     int parity = 0;
-    atom->getPropIfPresent(common_properties::molParity, parity);
+    atom->getPropIfPresent(common_properties::keys::molParity, parity);
     if (parity <= 0 || parity > 2 || atom->getDegree() < 3) {
       atom->setChiralTag(Atom::CHI_UNSPECIFIED);
       continue;
@@ -3582,8 +3590,9 @@ void setDoubleBondNeighborDirections(ROMol &mol, const Conformer *conf) {
             int hasUnknownStereo = 0;
             if (nbrBond->getBeginAtom() == bondAtom &&
                 nbrDir == Bond::BondDir::UNKNOWN &&
-                nbrBond->getPropIfPresent(common_properties::_UnknownStereo,
-                                          hasUnknownStereo) &&
+                nbrBond->getPropIfPresent(
+                    common_properties::keys::_UnknownStereo,
+                    hasUnknownStereo) &&
                 hasUnknownStereo) {
               // if there's a wiggly bond starting here, then we're not a
               // candidate for stereo
@@ -3807,11 +3816,11 @@ void removeStereochemistry(ROMol &mol) {
   }
   for (auto atom : mol.atoms()) {
     atom->setChiralTag(Atom::CHI_UNSPECIFIED);
-    if (atom->hasProp(common_properties::_CIPCode)) {
-      atom->clearProp(common_properties::_CIPCode);
+    if (atom->hasProp(common_properties::keys::_CIPCode)) {
+      atom->clearProp(common_properties::keys::_CIPCode);
     }
-    if (atom->hasProp(common_properties::_CIPRank)) {
-      atom->clearProp(common_properties::_CIPRank);
+    if (atom->hasProp(common_properties::keys::_CIPRank)) {
+      atom->clearProp(common_properties::keys::_CIPRank);
     }
   }
   for (auto bond : mol.bonds()) {
@@ -3859,7 +3868,7 @@ void simplifyEnhancedStereo(ROMol &mol, bool removeAffectedStereoGroups) {
         // clear the chiral codes on the atoms in the group
         for (const auto atm : sgs[0].getAtoms()) {
           mol.getAtomWithIdx(atm->getIdx())
-              ->clearProp(common_properties::_CIPCode);
+              ->clearProp(common_properties::keys::_CIPCode);
         }
       }
     }
@@ -9,6 +9,7 @@
 //
 
 #include <GraphMol/RDKitBase.h>
+#include <GraphMol/FrozenMol.h>
 #include <GraphMol/Descriptors/MolDescriptors.h>
 #include <GraphMol/PartialCharges/GasteigerCharges.h>
 #include <vector>
@@ -100,6 +101,188 @@ double calcLabuteASA(const ROMol &mol, bool includeHs, bool force) {
   return res;
 }
 
+namespace {
+// the TPSA contribution of a single atom, nNbrs and nHs include neighboring
+// Hs and the bond counts don't include bonds to Hs
+double getTPSAContrib(int atNum, int chg, int nNbrs, int nHs, int nSing,
+                      int nDoub, int nTrip, int nArom, bool in3Ring,
+                      bool includeSandP) {
+  double tmp = -1;
+  if (atNum == 7) {
+    switch (nNbrs) {
+      case 1:
+        if (nHs == 0 && chg == 0 && nTrip == 1) {
+          tmp = 23.79;
+        } else if (nHs == 1 && chg == 0 && nDoub == 1) {
+          tmp = 23.85;
+        } else if (nHs == 2 && chg == 0 && nSing == 1) {
+          tmp = 26.02;
+        } else if (nHs == 2 && chg == 1 && nDoub == 1) {
+          tmp = 25.59;
+        } else if (nHs == 3 && chg == 1 && nSing == 1) {
+          tmp = 27.64;
+        }
+        break;
+      case 2:
+        if (nHs == 0 && chg == 0 && nSing == 1 && nDoub == 1) {
+          tmp = 12.36;
+        } else if (nHs == 0 && chg == 0 && nTrip == 1 &&
+                   nDoub == 1) {
+          tmp = 13.60;
+        } else if (nHs == 1 && chg == 0 && nSing == 2 && in3Ring) {
+          tmp = 21.94;
+        } else if (nHs == 1 && chg == 0 && nSing == 2 && !in3Ring) {
+          tmp = 12.03;
+        } else if (nHs == 0 && chg == 1 && nTrip == 1 &&
+                   nSing == 1) {
+          tmp = 4.36;
+        } else if (nHs == 1 && chg == 1 && nDoub == 1 &&
+                   nSing == 1) {
+          tmp = 13.97;
+        } else if (nHs == 2 && chg == 1 && nSing == 2) {
+          tmp = 16.61;
+        } else if (nHs == 0 && chg == 0 && nArom == 2) {
+          tmp = 12.89;
+        } else if (nHs == 1 && chg == 0 && nArom == 2) {
+          tmp = 15.79;
+        } else if (nHs == 1 && chg == 1 && nArom == 2) {
+          tmp = 14.14;
+        }
+        break;
+      case 3:
+        if (nHs == 0 && chg == 0 && nSing == 3 && in3Ring) {
+          tmp = 3.01;
+        } else if (nHs == 0 && chg == 0 && nSing == 3 && !in3Ring) {
+          tmp = 3.24;
+
+        } else if (nHs == 0 && chg == 0 && nSing == 1 &&
+                   nDoub == 2) {
+          tmp = 11.68;
+        } else if (nHs == 0 && chg == 1 && nSing == 2 &&
+                   nDoub == 1) {
+          tmp = 3.01;
+        } else if (nHs == 1 && chg == 1 && nSing == 3) {
+          tmp = 4.44;
+        } else if (nHs == 0 && chg == 0 && nArom == 3) {
+          tmp = 4.41;
+        } else if (nHs == 0 && chg == 0 && nSing == 1 &&
+                   nArom == 2) {
+          tmp = 4.93;
+        } else if (nHs == 0 && chg == 0 && nDoub == 1 &&
+                   nArom == 2) {
+          tmp = 8.39;
+        } else if (nHs == 0 && chg == 1 && nArom == 3) {
+          tmp = 4.10;
+        } else if (nHs == 0 && chg == 1 && nSing == 1 &&
+                   nArom == 2) {
+          tmp = 3.88;
+        }
+        break;
+      case 4:
+        if (nHs == 0 && nSing == 4 && chg == 1) {
+          tmp = 0.0;
+        }
+        break;
+      default:
+        break;
+    }
+    if (tmp < 0.0) {
+      tmp = 30.5 - nNbrs * 8.2 + nHs * 1.5;
+      if (tmp < 0) {
+        tmp = 0.0;
+      }
+    }
+  } else if (atNum == 8) {
+    switch (nNbrs) {
+      case 1:
+        if (nHs == 0 && chg == 0 && nDoub == 1) {
+          tmp = 17.07;
+        } else if (nHs == 1 && chg == 0 && nSing == 1) {
+          tmp = 20.23;
+        } else if (nHs == 0 && chg == -1 && nSing == 1) {
+          tmp = 23.06;
+        }
+        break;
+      case 2:
+        if (nHs == 0 && chg == 0 && nSing == 2 && in3Ring) {
+          tmp = 12.53;
+        } else if (nHs == 0 && chg == 0 && nSing == 2 && !in3Ring) {
+          tmp = 9.23;
+        } else if (nHs == 0 && chg == 0 && nArom == 2) {
+          tmp = 13.14;
+        }
+        break;
+      default:
+        break;
+    }
+    if (tmp < 0.0) {
+      tmp = 28.5 - nNbrs * 8.6 + nHs * 1.5;
+      if (tmp < 0) {
+        tmp = 0.0;
+      }
+    }
+  } else if (includeSandP && atNum == 15) {
+    tmp = 0.0;
+    switch (nNbrs) {
+      case 2:
+        if (nHs == 0 && chg == 0 && nSing == 1 && nDoub == 1) {
+          tmp = 34.14;
+        }
+        break;
+      case 3:
+        if (nHs == 0 && chg == 0 && nSing == 3) {
+          tmp = 13.59;
+        } else if (nHs == 1 && chg == 0 && nSing == 2 &&
+                   nDoub == 1) {
+          tmp = 23.47;
+        }
+        break;
+      case 4:
+        if (nHs == 0 && chg == 0 && nSing == 3 && nDoub == 1) {
+          tmp = 9.81;
+        }
+        break;
+      default:
+        break;
+    }
+  } else if (includeSandP && atNum == 16) {
+    tmp = 0.0;
+    switch (nNbrs) {
+      case 1:
+        if (nHs == 0 && chg == 0 && nDoub == 1) {
+          tmp = 32.09;
+        } else if (nHs == 1 && chg == 0 && nSing == 1) {
+          tmp = 38.80;
+        }
+        break;
+      case 2:
+        if (nHs == 0 && chg == 0 && nSing == 2) {
+          tmp = 25.30;
+        } else if (nHs == 0 && chg == 0 && nArom == 2) {
+          tmp = 28.24;
+        }
+        break;
+      case 3:
+        if (nHs == 0 && chg == 0 && nArom == 2 && nDoub == 1) {
+          tmp = 21.70;
+        } else if (nHs == 0 && chg == 0 && nSing == 2 &&
+                   nDoub == 1) {
+          tmp = 19.21;
+        }
+        break;
+      case 4:
+        if (nHs == 0 && chg == 0 && nSing == 2 && nDoub == 2) {
+          tmp = 8.38;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return tmp;
+}
+}  // namespace
+
 double getTPSAAtomContribs(const ROMol &mol, std::vector<double> &Vi,
                            bool force, bool includeSandP) {
   TEST_ASSERT(Vi.size() >= mol.getNumAtoms());
@@ -164,178 +347,9 @@ double getTPSAAtomContribs(const ROMol &mol, std::vector<double> &Vi,
     bool in3Ring = mol.getRingInfo()->isAtomInRingOfSize(i, 3);
     nNbrs[i] += atom->getDegree();
 
-    double tmp = -1;
-    if (atNum == 7) {
-      switch (nNbrs[i]) {
-        case 1:
-          if (nHs[i] == 0 && chg == 0 && nTrip[i] == 1) {
-            tmp = 23.79;
-          } else if (nHs[i] == 1 && chg == 0 && nDoub[i] == 1) {
-            tmp = 23.85;
-          } else if (nHs[i] == 2 && chg == 0 && nSing[i] == 1) {
-            tmp = 26.02;
-          } else if (nHs[i] == 2 && chg == 1 && nDoub[i] == 1) {
-            tmp = 25.59;
-          } else if (nHs[i] == 3 && chg == 1 && nSing[i] == 1) {
-            tmp = 27.64;
-          }
-          break;
-        case 2:
-          if (nHs[i] == 0 && chg == 0 && nSing[i] == 1 && nDoub[i] == 1) {
-            tmp = 12.36;
-          } else if (nHs[i] == 0 && chg == 0 && nTrip[i] == 1 &&
-                     nDoub[i] == 1) {
-            tmp = 13.60;
-          } else if (nHs[i] == 1 && chg == 0 && nSing[i] == 2 && in3Ring) {
-            tmp = 21.94;
-          } else if (nHs[i] == 1 && chg == 0 && nSing[i] == 2 && !in3Ring) {
-            tmp = 12.03;
-          } else if (nHs[i] == 0 && chg == 1 && nTrip[i] == 1 &&
-                     nSing[i] == 1) {
-            tmp = 4.36;
-          } else if (nHs[i] == 1 && chg == 1 && nDoub[i] == 1 &&
-                     nSing[i] == 1) {
-            tmp = 13.97;
-          } else if (nHs[i] == 2 && chg == 1 && nSing[i] == 2) {
-            tmp = 16.61;
-          } else if (nHs[i] == 0 && chg == 0 && nArom[i] == 2) {
-            tmp = 12.89;
-          } else if (nHs[i] == 1 && chg == 0 && nArom[i] == 2) {
-            tmp = 15.79;
-          } else if (nHs[i] == 1 && chg == 1 && nArom[i] == 2) {
-            tmp = 14.14;
-          }
-          break;
-        case 3:
-          if (nHs[i] == 0 && chg == 0 && nSing[i] == 3 && in3Ring) {
-            tmp = 3.01;
-          } else if (nHs[i] == 0 && chg == 0 && nSing[i] == 3 && !in3Ring) {
-            tmp = 3.24;
-
-          } else if (nHs[i] == 0 && chg == 0 && nSing[i] == 1 &&
-                     nDoub[i] == 2) {
-            tmp = 11.68;
-          } else if (nHs[i] == 0 && chg == 1 && nSing[i] == 2 &&
-                     nDoub[i] == 1) {
-            tmp = 3.01;
-          } else if (nHs[i] == 1 && chg == 1 && nSing[i] == 3) {
-            tmp = 4.44;
-          } else if (nHs[i] == 0 && chg == 0 && nArom[i] == 3) {
-            tmp = 4.41;
-          } else if (nHs[i] == 0 && chg == 0 && nSing[i] == 1 &&
-                     nArom[i] == 2) {
-            tmp = 4.93;
-          } else if (nHs[i] == 0 && chg == 0 && nDoub[i] == 1 &&
-                     nArom[i] == 2) {
-            tmp = 8.39;
-          } else if (nHs[i] == 0 && chg == 1 && nArom[i] == 3) {
-            tmp = 4.10;
-          } else if (nHs[i] == 0 && chg == 1 && nSing[i] == 1 &&
-                     nArom[i] == 2) {
-            tmp = 3.88;
-          }
-          break;
-        case 4:
-          if (nHs[i] == 0 && nSing[i] == 4 && chg == 1) {
-            tmp = 0.0;
-          }
-          break;
-        default:
-          break;
-      }
-      if (tmp < 0.0) {
-        tmp = 30.5 - nNbrs[i] * 8.2 + nHs[i] * 1.5;
-        if (tmp < 0) {
-          tmp = 0.0;
-        }
-      }
-    } else if (atNum == 8) {
-      switch (nNbrs[i]) {
-        case 1:
-          if (nHs[i] == 0 && chg == 0 && nDoub[i] == 1) {
-            tmp = 17.07;
-          } else if (nHs[i] == 1 && chg == 0 && nSing[i] == 1) {
-            tmp = 20.23;
-          } else if (nHs[i] == 0 && chg == -1 && nSing[i] == 1) {
-            tmp = 23.06;
-          }
-          break;
-        case 2:
-          if (nHs[i] == 0 && chg == 0 && nSing[i] == 2 && in3Ring) {
-            tmp = 12.53;
-          } else if (nHs[i] == 0 && chg == 0 && nSing[i] == 2 && !in3Ring) {
-            tmp = 9.23;
-          } else if (nHs[i] == 0 && chg == 0 && nArom[i] == 2) {
-            tmp = 13.14;
-          }
-          break;
-        default:
-          break;
-      }
-      if (tmp < 0.0) {
-        tmp = 28.5 - nNbrs[i] * 8.6 + nHs[i] * 1.5;
-        if (tmp < 0) {
-          tmp = 0.0;
-        }
-      }
-    } else if (includeSandP && atNum == 15) {
-      tmp = 0.0;
-      switch (nNbrs[i]) {
-        case 2:
-          if (nHs[i] == 0 && chg == 0 && nSing[i] == 1 && nDoub[i] == 1) {
-            tmp = 34.14;
-          }
-          break;
-        case 3:
-          if (nHs[i] == 0 && chg == 0 && nSing[i] == 3) {
-            tmp = 13.59;
-          } else if (nHs[i] == 1 && chg == 0 && nSing[i] == 2 &&
-                     nDoub[i] == 1) {
-            tmp = 23.47;
-          }
-          break;
-        case 4:
-          if (nHs[i] == 0 && chg == 0 && nSing[i] == 3 && nDoub[i] == 1) {
-            tmp = 9.81;
-          }
-          break;
-        default:
-          break;
-      }
-    } else if (includeSandP && atNum == 16) {
-      tmp = 0.0;
-      switch (nNbrs[i]) {
-        case 1:
-          if (nHs[i] == 0 && chg == 0 && nDoub[i] == 1) {
-            tmp = 32.09;
-          } else if (nHs[i] == 1 && chg == 0 && nSing[i] == 1) {
-            tmp = 38.80;
-          }
-          break;
-        case 2:
-          if (nHs[i] == 0 && chg == 0 && nSing[i] == 2) {
-            tmp = 25.30;
-          } else if (nHs[i] == 0 && chg == 0 && nArom[i] == 2) {
-            tmp = 28.24;
-          }
-          break;
-        case 3:
-          if (nHs[i] == 0 && chg == 0 && nArom[i] == 2 && nDoub[i] == 1) {
-            tmp = 21.70;
-          } else if (nHs[i] == 0 && chg == 0 && nSing[i] == 2 &&
-                     nDoub[i] == 1) {
-            tmp = 19.21;
-          }
-          break;
-        case 4:
-          if (nHs[i] == 0 && chg == 0 && nSing[i] == 2 && nDoub[i] == 2) {
-            tmp = 8.38;
-          }
-          break;
-        default:
-          break;
-      }
-    }
+    double tmp =
+        getTPSAContrib(atNum, chg, nNbrs[i], nHs[i], nSing[i], nDoub[i],
+                       nTrip[i], nArom[i], in3Ring, includeSandP);
     Vi[i] = tmp;
     res += tmp;
   }
@@ -359,6 +373,75 @@ double calcTPSA(const ROMol &mol, bool force, bool includeSandP) {
   return res;
 }
 
+double getTPSAAtomContribs(const FrozenMol &mol, std::vector<double> &Vi,
+                           bool includeSandP) {
+  PRECONDITION(Vi.size() >= mol.getNumAtoms(), "bad contribs size");
+  const auto atomicNums = mol.getAtomicNums();
+  unsigned int nAtoms = mol.getNumAtoms();
+  std::vector<int> nNbrs(nAtoms, 0), nSing(nAtoms, 0), nDoub(nAtoms, 0),
+      nTrip(nAtoms, 0), nArom(nAtoms, 0), nHs(nAtoms, 0);
+  const auto bondTypes = mol.getBondTypes();
+  const auto bondIsAromatic = mol.getBondIsAromatic();
+  const auto beginAtoms = mol.getBondBeginAtoms();
+  const auto endAtoms = mol.getBondEndAtoms();
+  for (unsigned int i = 0; i < mol.getNumBonds(); ++i) {
+    const auto begIdx = beginAtoms[i];
+    const auto endIdx = endAtoms[i];
+    if (atomicNums[begIdx] == 1) {
+      nNbrs[endIdx] -= 1;
+      nHs[endIdx] += 1;
+    } else if (atomicNums[endIdx] == 1) {
+      nNbrs[begIdx] -= 1;
+      nHs[begIdx] += 1;
+    } else if (bondIsAromatic[i]) {
+      nArom[begIdx] += 1;
+      nArom[endIdx] += 1;
+    } else {
+      switch (bondTypes[i]) {
+        case Bond::SINGLE:
+          nSing[begIdx] += 1;
+          nSing[endIdx] += 1;
+          break;
+        case Bond::DOUBLE:
+          nDoub[begIdx] += 1;
+          nDoub[endIdx] += 1;
+          break;
+        case Bond::TRIPLE:
+          nTrip[begIdx] += 1;
+          nTrip[endIdx] += 1;
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  const auto formalCharges = mol.getFormalCharges();
+  const auto totalNumHs = mol.getTotalNumHs();
+  const auto minRingSizes = mol.getAtomMinRingSizes();
+  double res = 0;
+  for (unsigned int i = 0; i < nAtoms; ++i) {
+    int atNum = atomicNums[i];
+    if (atNum != 7 && atNum != 8 &&
+        (!includeSandP || (atNum != 15 && atNum != 16))) {
+      continue;
+    }
+    nHs[i] += totalNumHs[i];
+    nNbrs[i] += mol.getDegree(i);
+    double tmp = getTPSAContrib(atNum, formalCharges[i], nNbrs[i], nHs[i],
+                                nSing[i], nDoub[i], nTrip[i], nArom[i],
+                                minRingSizes[i] == 3, includeSandP);
+    Vi[i] = tmp;
+    res += tmp;
+  }
+  return res;
+}
+
+double calcTPSA(const FrozenMol &mol, bool includeSandP) {
+  std::vector<double> contribs(mol.getNumAtoms(), 0.0);
+  return getTPSAAtomContribs(mol, contribs, includeSandP);
+}
+
 namespace {
 void assignContribsToBins(const std::vector<double> &contribs,
                           const std::vector<double> &binProp,
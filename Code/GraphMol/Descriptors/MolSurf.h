@@ -21,6 +21,7 @@
 
 namespace RDKit {
 class ROMol;
+class FrozenMol;
 namespace Descriptors {
 const std::string labuteASAVersion = "1.0.2";
 
@@ -104,6 +105,21 @@ RDKIT_DESCRIPTORS_EXPORT double getTPSAAtomContribs(const ROMol &mol,
 RDKIT_DESCRIPTORS_EXPORT double calcTPSA(const ROMol &mol, bool force = false,
                                          bool includeSandP = false);
 
+//! \overload
+/*!
+  The values are not cached.
+
+  \param mol          the molecule of interest
+  \param Vi           used to return the atom contribs
+  \param includeSandP (optional) include contributions from S and P atoms
+*/
+RDKIT_DESCRIPTORS_EXPORT double getTPSAAtomContribs(const FrozenMol &mol,
+                                                    std::vector<double> &Vi,
+                                                    bool includeSandP = false);
+//! \overload
+RDKIT_DESCRIPTORS_EXPORT double calcTPSA(const FrozenMol &mol,
+                                         bool includeSandP = false);
+
 RDKIT_DESCRIPTORS_EXPORT std::vector<double> calcSlogP_VSA(
     const ROMol &mol, std::vector<double> *bins = nullptr, bool force = false);
 RDKIT_DESCRIPTORS_EXPORT std::vector<double> calcSMR_VSA(
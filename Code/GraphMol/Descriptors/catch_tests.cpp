@@ -11,6 +11,7 @@
 #include <catch2/catch_all.hpp>
 
 #include <GraphMol/RDKitBase.h>
+#include <GraphMol/FrozenMol.h>
 #include <GraphMol/FileParsers/FileParsers.h>
 #include <GraphMol/SmilesParse/SmilesParse.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
@@ -727,4 +728,36 @@ TEST_CASE("Github #7264: GETAWAY descriptors are non-deterministic") {
       CHECK(res1[i] == res2[i]);
     }
   }
-}
\ No newline at end of file
+}
+TEST_CASE("TPSA from a FrozenMol") {
+  std::string pathName = getenv("RDBASE");
+  v2::FileParsers::SDMolSupplier suppl(pathName +
+                                       "/Data/NCI/first_200.props.sdf");
+  unsigned int nMols = 0;
+  while (!suppl.atEnd()) {
+    auto mol = suppl.next();
+    if (!mol) {
+      continue;
+    }
+    ++nMols;
+    FrozenMol frozen(*mol);
+    for (auto includeSandP : {false, true}) {
+      std::vector<double> contribs(mol->getNumAtoms(), 0.0);
+      std::vector<double> frozenContribs(mol->getNumAtoms(), 0.0);
+      auto tpsa =
+          Descriptors::getTPSAAtomContribs(*mol, contribs, true, includeSandP);
+      CHECK(Descriptors::getTPSAAtomContribs(frozen, frozenContribs,
+                                             includeSandP) == tpsa);
+      CHECK(frozenContribs == contribs);
+      CHECK(Descriptors::calcTPSA(frozen, includeSandP) == tpsa);
+    }
+  }
+  CHECK(nMols > 150);
+  SECTION("explicit Hs and three-rings") {
+    auto mol = "[H]OC1CN1.[H]N([H])C1OC1"_smiles;
+    REQUIRE(mol);
+    FrozenMol frozen(*mol);
+    CHECK(Descriptors::calcTPSA(frozen) ==
+          Descriptors::calcTPSA(*mol, true));
+  }
+}
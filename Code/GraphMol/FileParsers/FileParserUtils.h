@@ -77,6 +77,11 @@ inline std::string getV3000CTAB(const ROMol &tmol, int confId = -1,
 // reads a line from an MDL v3K CTAB
 RDKIT_FILEPARSERS_EXPORT std::string getV3000Line(std::istream *inStream,
                                                   unsigned int &line);
+//! \overload
+//! the line is read into \c res, reusing its storage
+RDKIT_FILEPARSERS_EXPORT void getV3000Line(std::istream *inStream,
+                                           unsigned int &line,
+                                           std::string &res);
 
 // nAtoms and nBonds are ignored on input, set on output
 RDKIT_FILEPARSERS_EXPORT bool ParseV3000CTAB(
@@ -87,8 +87,9 @@ struct RDKIT_FILEPARSERS_EXPORT MolFromSCSRParams {
 RDKIT_FILEPARSERS_EXPORT std::unique_ptr<RWMol> MolFromMolDataStream(
     std::istream &inStream, unsigned int &line,
     const MolFileParserParams &params = MolFileParserParams());
+//! the mol block is parsed in place, it is not copied
 RDKIT_FILEPARSERS_EXPORT std::unique_ptr<RWMol> MolFromMolBlock(
-    const std::string &molBlock,
+    std::string_view molBlock,
     const MolFileParserParams &params = MolFileParserParams());
 RDKIT_FILEPARSERS_EXPORT std::unique_ptr<RWMol> MolFromMolFile(
     const std::string &fName,
@@ -0,0 +1,197 @@
+//
+//  Copyright (C) 2025 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <sstream>
+
+#include <RDGeneral/BadFileException.h>
+#include <RDGeneral/FileParseException.h>
+#include <RDGeneral/MemoryMappedFileReader.h>
+#include <RDGeneral/RDLog.h>
+#include <RDGeneral/StreamOps.h>
+
+#include "MappedSDMolSupplier.h"
+
+namespace RDKit {
+namespace v2 {
+namespace FileParsers {
+
+namespace {
+const std::string indexMagic = "RDKit SD file index";
+const std::uint32_t indexVersion = 1;
+
+// this mirrors SDMolSupplier::checkForEnd(): the file ends if there are
+// fewer than four more lines or if the next four lines are all blank.
+bool isEndOfFile(std::string_view text, size_t pos) {
+  unsigned int nempty = 0;
+  for (unsigned int i = 0; i < 4; ++i) {
+    auto eol = text.find('\n', pos);
+    if (eol == std::string_view::npos) {
+      return true;
+    }
+    if (text.substr(pos, eol - pos).find_first_not_of(" \t\r\n") ==
+        std::string_view::npos) {
+      ++nempty;
+    }
+    pos = eol + 1;
+  }
+  return nempty == 4;
+}
+}  // namespace
+
+MappedSDMolSupplier::MappedSDMolSupplier(const std::string &fileName,
+                                         const MolFileParserParams &params,
+                                         const std::string &indexFileName)
+    : d_params(params) {
+  try {
+    dp_file.reset(new MemoryMappedFileReader(fileName));
+  } catch (const std::runtime_error &) {
+    std::ostringstream errout;
+    errout << "Bad input file " << fileName;
+    throw BadFileException(errout.str());
+  }
+  if (indexFileName.empty() || !loadIndex(indexFileName)) {
+    buildIndex();
+  }
+}
+
+MappedSDMolSupplier::~MappedSDMolSupplier() { close(); }
+
+void MappedSDMolSupplier::close() {
+  dp_file.reset();
+  d_offsets.clear();
+  d_next = 0;
+  MolSupplier::close();
+}
+
+void MappedSDMolSupplier::buildIndex() {
+  PRECONDITION(dp_file, "no file");
+  d_offsets.clear();
+  const std::string_view text(dp_file->d_mappedMemory, dp_file->d_size);
+  if (isEndOfFile(text, 0)) {
+    return;
+  }
+  d_offsets.push_back(0);
+  // memchr() is vectorized in every C library we care about, and '$' is
+  // rare in SD files, so this is much faster than looking at each line
+  const char *data = text.data();
+  size_t pos = 0;
+  while (pos < text.size()) {
+    auto *dollar =
+        static_cast<const char *>(memchr(data + pos, '$', text.size() - pos));
+    if (!dollar) {
+      break;
+    }
+    pos = dollar - data;
+    if ((pos && data[pos - 1] != '\n') || text.substr(pos, 4) != "$$$$") {
+      ++pos;
+      continue;
+    }
+    auto eol = text.find('\n', pos);
+    if (eol == std::string_view::npos) {
+      break;
+    }
+    pos = eol + 1;
+    if (isEndOfFile(text, pos)) {
+      break;
+    }
+    d_offsets.push_back(pos);
+  }
+  // the last record extends to the end of the file
+  d_offsets.push_back(text.size());
+}
+
+bool MappedSDMolSupplier::loadIndex(const std::string &indexFileName) {
+  PRECONDITION(dp_file, "no file");
+  std::ifstream inStream(indexFileName, std::ios_base::binary);
+  if (!inStream) {
+    return false;
+  }
+  try {
+    std::string magic;
+    streamRead(inStream, magic, 0);
+    std::uint32_t version;
+    streamRead(inStream, version);
+    std::uint64_t fileSize;
+    streamRead(inStream, fileSize);
+    if (magic != indexMagic || version != indexVersion ||
+        fileSize != dp_file->d_size) {
+      BOOST_LOG(rdWarningLog) << "WARNING: index file " << indexFileName
+                              << " does not match, ignoring it" << std::endl;
+      return false;
+    }
+    std::vector<std::uint64_t> offsets;
+    streamReadVec(inStream, offsets);
+    if (offsets.size() == 1 ||
+        (!offsets.empty() && offsets.back() != fileSize) ||
+        !std::is_sorted(offsets.begin(), offsets.end())) {
+      BOOST_LOG(rdWarningLog) << "WARNING: index file " << indexFileName
+                              << " is corrupt, ignoring it" << std::endl;
+      return false;
+    }
+    d_offsets = std::move(offsets);
+  } catch (const std::runtime_error &) {
+    BOOST_LOG(rdWarningLog) << "WARNING: could not read index file "
+                            << indexFileName << ", ignoring it" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void MappedSDMolSupplier::saveIndex(const std::string &indexFileName) const {
+  PRECONDITION(dp_file, "no file");
+  std::ofstream outStream(indexFileName, std::ios_base::binary);
+  if (!outStream) {
+    std::ostringstream errout;
+    errout << "Bad output file " << indexFileName;
+    throw BadFileException(errout.str());
+  }
+  streamWrite(outStream, indexMagic);
+  streamWrite(outStream, indexVersion);
+  streamWrite(outStream, static_cast<std::uint64_t>(dp_file->d_size));
+  streamWriteVec(outStream, d_offsets);
+}
+
+std::string_view MappedSDMolSupplier::getItemText(unsigned int idx) const {
+  PRECONDITION(dp_file, "no file");
+  if (idx >= length()) {
+    std::ostringstream errout;
+    errout << "ERROR: Index error (idx = " << idx << ") : "
+           << " we do no have enough mol blocks";
+    throw FileParseException(errout.str());
+  }
+  return std::string_view(dp_file->d_mappedMemory + d_offsets[idx],
+                          d_offsets[idx + 1] - d_offsets[idx]);
+}
+
+std::unique_ptr<RWMol> MappedSDMolSupplier::getMol(unsigned int idx) const {
+  // the parser stops at the end of the record, but it is given the rest of
+  // the file so that it behaves exactly like SDMolSupplier on odd records
+  // (e.g. with an S  SKP line which skips past the $$$$)
+  const auto text = getItemText(idx);
+  MemoryStreamBuf buf(text.data(), dp_file->d_size - d_offsets[idx]);
+  std::istream inStream(&buf);
+  ForwardSDMolSupplier suppl(&inStream, false, d_params);
+  suppl.setProcessPropertyLists(df_processPropertyLists);
+  return suppl.next();
+}
+
+std::unique_ptr<RWMol> MappedSDMolSupplier::next() {
+  if (atEnd()) {
+    throw FileParseException("EOF hit.");
+  }
+  return getMol(d_next++);
+}
+
+}  // namespace FileParsers
+}  // namespace v2
+}  // namespace RDKit
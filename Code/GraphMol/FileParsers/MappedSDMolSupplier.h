@@ -0,0 +1,101 @@
+//
+//  Copyright (C) 2025 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include <RDGeneral/export.h>
+#ifndef RD_MAPPEDSDMOLSUPPLIER_H
+#define RD_MAPPEDSDMOLSUPPLIER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MolSupplier.h"
+
+namespace RDKit {
+struct MemoryMappedFileReader;
+
+namespace v2 {
+namespace FileParsers {
+//! a random access supplier for SD files which are memory mapped
+/*!
+  The offsets of all the records are found when the supplier is
+  constructed, so length() is known immediately and any record can be
+  read in constant time without going through a stream. The index can be
+  saved next to the SD file with saveIndex() and reused the next time the
+  file is opened.
+
+  Reading records with getMol() or getItemText() doesn't change the state
+  of the supplier, so several threads can read (disjoint or overlapping)
+  sets of records from one supplier at the same time. next() and reset()
+  are not thread-safe.
+
+  The file must not be modified while the supplier is open.
+*/
+class RDKIT_FILEPARSERS_EXPORT MappedSDMolSupplier : public MolSupplier {
+ public:
+  /*!
+   *   \param fileName      - the name of the SD file
+   *   \param params        - controls the parsing of the mol blocks
+   *   \param indexFileName - if this is provided and the file exists, the
+   *                          record index is read from it instead of being
+   *                          built. An index which doesn't match the SD file
+   *                          is ignored.
+   */
+  explicit MappedSDMolSupplier(
+      const std::string &fileName,
+      const MolFileParserParams &params = MolFileParserParams(),
+      const std::string &indexFileName = "");
+  ~MappedSDMolSupplier() override;
+
+  void init() override {}
+  void reset() override { d_next = 0; }
+  bool atEnd() override { return d_next >= length(); }
+  //! returns the next molecule, sequential reads are not thread-safe
+  std::unique_ptr<RWMol> next() override;
+  void close() override;
+
+  //! returns the number of records in the file
+  unsigned int length() const {
+    return d_offsets.empty() ? 0 : rdcast<unsigned int>(d_offsets.size() - 1);
+  }
+  //! parses and returns a particular record, this is thread-safe
+  std::unique_ptr<RWMol> getMol(unsigned int idx) const;
+  std::unique_ptr<RWMol> operator[](unsigned int idx) const {
+    return getMol(idx);
+  }
+  //! returns the text of a particular record.
+  //! The view is only valid while the supplier is open.
+  std::string_view getItemText(unsigned int idx) const;
+
+  //! writes the record index so that it can be passed to the constructor
+  void saveIndex(const std::string &indexFileName) const;
+  //! returns the offsets of the records in the file; the last element is
+  //! the end of the last record
+  const std::vector<std::uint64_t> &getOffsets() const { return d_offsets; }
+
+  void setProcessPropertyLists(bool val) { df_processPropertyLists = val; }
+  bool getProcessPropertyLists() const { return df_processPropertyLists; }
+
+ private:
+  void buildIndex();
+  bool loadIndex(const std::string &indexFileName);
+
+  std::unique_ptr<MemoryMappedFileReader> dp_file;
+  std::vector<std::uint64_t> d_offsets;
+  MolFileParserParams d_params;
+  bool df_processPropertyLists = true;
+  unsigned int d_next = 0;
+};
+}  // namespace FileParsers
+}  // namespace v2
+}  // namespace RDKit
+
+#endif
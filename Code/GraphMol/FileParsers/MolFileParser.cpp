@@ -51,6 +51,43 @@ using std::smatch;
 
 namespace RDKit {
 
+namespace {
+// skips leading whitespace and a leading '+', neither of which
+// std::from_chars() accepts
+const char *skipToNumber(std::string_view text) {
+  const char *txt = text.data();
+  const char *end = txt + text.size();
+  while (txt < end && (*txt == ' ' || *txt == '\t')) {
+    ++txt;
+  }
+  if (txt < end && *txt == '+') {
+    ++txt;
+  }
+  return txt;
+}
+
+// these are equivalent to atof() and atoi(), but they only look at the
+// characters in the view, so the text does not need to be copied into a
+// null-terminated string first
+double viewToDouble(std::string_view text) {
+  const char *txt = skipToNumber(text);
+  const char *end = text.data() + text.size();
+  double res = 0.0;
+#ifdef __cpp_lib_to_chars
+  std::from_chars(txt, end, res);
+#else
+  // from_chars() for doubles didn't work on g++ until v11.1
+  res = atof(std::string(txt, end).c_str());
+#endif
+  return res;
+}
+int viewToInt(std::string_view text) {
+  int res = 0;
+  std::from_chars(skipToNumber(text), text.data() + text.size(), res);
+  return res;
+}
+}  // namespace
+
 namespace FileParserUtils {
 
 int toInt(const std::string_view input, bool acceptSpaces) {
@@ -134,45 +171,50 @@ double toDouble(const std::string_view input, bool acceptSpaces) {
       throw boost::bad_lexical_cast();
     }
   }
-  // unfortunately from_chars() with doubles didn't work on g++ until v11.1
-  // and the status with clang is hard to figure out... we remain old-school
-  // remove leading spaces
-  double res = atof(input.data());
-  return res;
+  return viewToDouble(input);
 }
 double toDouble(const std::string &input, bool acceptSpaces) {
   return toDouble(std::string_view(input.c_str()), acceptSpaces);
 }
-std::string getV3000Line(std::istream *inStream, unsigned int &line) {
-  // FIX: technically V3K blocks are case-insensitive. We should really be
-  // up-casing everything here.
-  PRECONDITION(inStream, "bad stream");
-  std::string res;
-  ++line;
-  auto inl = getLine(inStream);
-  std::string_view tempStr = inl;
-  if (tempStr.size() < 7 || tempStr.substr(0, 7) != "M  V30 ") {
+namespace {
+void checkV3000LineStart(std::string_view text, unsigned int line) {
+  if (text.size() < 7 || text.substr(0, 7) != "M  V30 ") {
     std::ostringstream errout;
     errout << "Line " << line << " does not start with 'M  V30 '" << std::endl;
     throw FileParseException(errout.str());
   }
+}
+}  // namespace
+
+void getV3000Line(std::istream *inStream, unsigned int &line,
+                  std::string &res) {
+  // FIX: technically V3K blocks are case-insensitive. We should really be
+  // up-casing everything here.
+  PRECONDITION(inStream, "bad stream");
+  ++line;
+  // read straight into res so that its storage is reused
+  getLine(inStream, res);
+  checkV3000LineStart(res, line);
   // FIX: do we need to handle trailing whitespace after a -?
-  while (tempStr.back() == '-') {
-    // continuation character, append what we read:
-    res += tempStr.substr(7, tempStr.length() - 8);
-    // and then read another line:
-    ++line;
-    inl = getLine(inStream);
-    tempStr = inl;
-    if (tempStr.size() < 7 || tempStr.substr(0, 7) != "M  V30 ") {
-      std::ostringstream errout;
-      errout << "Line " << line << " does not start with 'M  V30 '"
-             << std::endl;
-      throw FileParseException(errout.str());
+  bool continued = res.back() == '-';
+  res.erase(0, 7);
+  if (continued) {
+    std::string inl;
+    while (continued) {
+      // continuation character, drop it and append the next line:
+      res.pop_back();
+      ++line;
+      getLine(inStream, inl);
+      checkV3000LineStart(inl, line);
+      continued = inl.back() == '-';
+      res.append(inl, 7);
     }
   }
-  res += tempStr.substr(7, tempStr.length() - 7);
+}
 
+std::string getV3000Line(std::istream *inStream, unsigned int &line) {
+  std::string res;
+  getV3000Line(inStream, line, res);
   return res;
 }
 
@@ -1414,7 +1456,9 @@ Atom *ParseMolFileAtomLine(const std::string_view text, RDGeom::Point3D &pos,
   try {
     pos.x = FileParserUtils::toDouble(text.substr(0, 10));
     pos.y = FileParserUtils::toDouble(text.substr(10, 10));
-    pos.z = FileParserUtils::toDouble(text.substr(20, 10));
+    // column 31 should be blank, but some programs use it when the z
+    // coordinate doesn't fit in its 10 columns
+    pos.z = FileParserUtils::toDouble(text.substr(20, 11));
   } catch (boost::bad_lexical_cast &) {
     std::ostringstream errout;
     errout << "Cannot process coordinates on line " << line;
@@ -1821,9 +1865,10 @@ void ParseMolBlockAtoms(std::istream *inStream, unsigned int &line,
   PRECONDITION(inStream, "bad stream");
   PRECONDITION(mol, "bad molecule");
   PRECONDITION(conf, "bad conformer");
+  std::string tempStr;
   for (unsigned int i = 1; i <= nAtoms; ++i) {
     ++line;
-    std::string tempStr = getLine(inStream);
+    getLine(inStream, tempStr);
     if (inStream->eof()) {
       throw FileParseException("EOF hit while reading atoms");
     }
@@ -1840,9 +1885,10 @@ void ParseMolBlockBonds(std::istream *inStream, unsigned int &line,
                         bool &chiralityPossible) {
   PRECONDITION(inStream, "bad stream");
   PRECONDITION(mol, "bad molecule");
+  std::string tempStr;
   for (unsigned int i = 1; i <= nBonds; ++i) {
     ++line;
-    std::string tempStr = getLine(inStream);
+    getLine(inStream, tempStr);
     if (inStream->eof()) {
       throw FileParseException("EOF hit while reading bonds");
     }
@@ -2047,7 +2093,7 @@ bool ParseMolBlockProperties(std::istream *inStream, unsigned int &line,
       ParseLinkNodeLine(mol, tempStr, line);
     }
     line++;
-    tempStr = getLine(inStream);
+    getLine(inStream, tempStr);
     lineBeg = tempStr.substr(0, 6);
   }
   if (tempStr[0] == 'M' && tempStr.substr(0, 6) == "M  END") {
@@ -2526,23 +2572,23 @@ void ParseV3000AtomBlock(std::istream *inStream, unsigned int &line,
   PRECONDITION(nAtoms > 0, "bad atom count");
   PRECONDITION(mol, "bad molecule");
   PRECONDITION(conf, "bad conformer");
-  std::vector<std::string> splitLine;
 
-  auto inl = getV3000Line(inStream, line);
+  // the line and the tokens are reused for each atom
+  std::string inl;
+  getV3000Line(inStream, line, inl);
   std::string_view tempStr = inl;
   if (tempStr.length() < 10 || tempStr.substr(0, 10) != "BEGIN ATOM") {
     std::ostringstream errout;
     errout << "BEGIN ATOM line not found on line " << line;
     throw FileParseException(errout.str());
   }
+  std::vector<std::string_view> tokens;
+  std::vector<std::string_view>::iterator token;
   for (unsigned int i = 0; i < nAtoms; ++i) {
-    inl = getV3000Line(inStream, line);
+    getV3000Line(inStream, line, inl);
     tempStr = inl;
     auto trimmed = FileParserUtils::strip(tempStr);
 
-    std::vector<std::string_view> tokens;
-    std::vector<std::string_view>::iterator token;
-
     tokenizeV3000Line(trimmed, tokens);
     token = tokens.begin();
 
@@ -2601,7 +2647,7 @@ void ParseV3000AtomBlock(std::istream *inStream, unsigned int &line,
       throw FileParseException(errout.str());
     }
 
-    pos.x = atof(std::string(*token).c_str());
+    pos.x = viewToDouble(*token);
     ++token;
     if (token == tokens.end()) {
       delete atom;
@@ -2609,7 +2655,7 @@ void ParseV3000AtomBlock(std::istream *inStream, unsigned int &line,
       errout << "Bad atom line : '" << tempStr << "' on line " << line;
       throw FileParseException(errout.str());
     }
-    pos.y = atof(std::string(*token).c_str());
+    pos.y = viewToDouble(*token);
     ++token;
     if (token == tokens.end()) {
       delete atom;
@@ -2617,7 +2663,7 @@ void ParseV3000AtomBlock(std::istream *inStream, unsigned int &line,
       errout << "Bad atom line : '" << tempStr << "' on line " << line;
       throw FileParseException(errout.str());
     }
-    pos.z = atof(std::string(*token).c_str());
+    pos.z = viewToDouble(*token);
     // the map number:
     ++token;
     if (token == tokens.end()) {
@@ -2626,7 +2672,7 @@ void ParseV3000AtomBlock(std::istream *inStream, unsigned int &line,
       errout << "Bad atom line : '" << tempStr << "' on line " << line;
       throw FileParseException(errout.str());
     }
-    int mapNum = atoi(std::string(*token).c_str());
+    int mapNum = viewToInt(*token);
     if (mapNum > 0) {
       atom->setProp(common_properties::molAtomMapNumber, mapNum);
     }
@@ -2641,7 +2687,7 @@ void ParseV3000AtomBlock(std::istream *inStream, unsigned int &line,
     mol->setAtomBookmark(atom, molIdx);
     conf->setAtomPos(aid, pos);
   }
-  inl = getV3000Line(inStream, line);
+  getV3000Line(inStream, line, inl);
   tempStr = inl;
   if (tempStr.length() < 8 || tempStr.substr(0, 8) != "END ATOM") {
     std::ostringstream errout;
@@ -2657,16 +2703,18 @@ void ParseV3000BondBlock(std::istream *inStream, unsigned int &line,
   PRECONDITION(nBonds > 0, "bad bond count");
   PRECONDITION(mol, "bad molecule");
 
-  auto inl = getV3000Line(inStream, line);
+  // the line and the tokens are reused for each bond
+  std::string inl;
+  getV3000Line(inStream, line, inl);
   std::string_view tempStr = inl;
   if (tempStr.length() < 10 || tempStr.substr(0, 10) != "BEGIN BOND") {
     throw FileParseException("BEGIN BOND line not found");
   }
+  std::vector<std::string_view> splitLine;
   for (unsigned int i = 0; i < nBonds; ++i) {
-    inl = getV3000Line(inStream, line);
+    getV3000Line(inStream, line, inl);
     tempStr = inl;
     tempStr = FileParserUtils::strip(tempStr);
-    std::vector<std::string_view> splitLine;
     tokenizeV3000Line(tempStr, splitLine);
     if (splitLine.size() < 4) {
       std::ostringstream errout;
@@ -2829,7 +2877,7 @@ void ParseV3000BondBlock(std::istream *inStream, unsigned int &line,
       }
     }
   }
-  inl = getV3000Line(inStream, line);
+  getV3000Line(inStream, line, inl);
   tempStr = inl;
   if (tempStr.length() < 8 || tempStr.substr(0, 8) != "END BOND") {
     std::ostringstream errout;
@@ -3728,9 +3776,10 @@ std::unique_ptr<RWMol> MolFromMolDataStream(std::istream &inStream,
 //  Read a molecule from a string
 //
 //------------------------------------------------
-std::unique_ptr<RWMol> MolFromMolBlock(const std::string &molBlock,
+std::unique_ptr<RWMol> MolFromMolBlock(std::string_view molBlock,
                                        const MolFileParserParams &params) {
-  std::istringstream inStream(molBlock);
+  MemoryStreamBuf buf(molBlock.data(), molBlock.size());
+  std::istream inStream(&buf);
   unsigned int line = 0;
   return MolFromMolDataStream(inStream, line, params);
 }
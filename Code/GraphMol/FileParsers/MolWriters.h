@@ -83,6 +83,29 @@ class RDKIT_FILEPARSERS_EXPORT SmilesWriter : public MolWriter {
   //! written out for each molecule
   void setProps(const STR_VECT &propNames) override;
 
+  //! \brief return the line that would be written to the file for a molecule
+  /*!
+    \param mol            : the molecule to write
+    \param molid          : the index of the molecule, used as its name if
+                            it doesn't have one
+    \param delimiter      : delimiter to use between the fields
+    \param nameHeader     : if this is empty, no names will be written
+    \param propNames      : the properties to write
+    \param isomericSmiles : toggles generation of isomeric SMILES
+    \param kekuleSmiles   : toggles the generation of kekule SMILES
+   */
+  static std::string getText(const ROMol &mol, unsigned int molid,
+                             const std::string &delimiter = " ",
+                             const std::string &nameHeader = "Name",
+                             const STR_VECT &propNames = STR_VECT(),
+                             bool isomericSmiles = true,
+                             bool kekuleSmiles = false);
+
+  //! \brief return the header line for a file with the given columns
+  static std::string getHeaderText(const std::string &delimiter = " ",
+                                   const std::string &nameHeader = "Name",
+                                   const STR_VECT &propNames = STR_VECT());
+
   //! \brief write a new molecule to the file
   void write(const ROMol &mol, int confId = defaultConfId) override;
 
@@ -161,7 +184,8 @@ class RDKIT_FILEPARSERS_EXPORT SDWriter : public MolWriter {
   //! \brief return the text that would be written to the file
   static std::string getText(const ROMol &mol, int confId = defaultConfId,
                              bool kekulize = true, bool force_V3000 = false,
-                             int molid = -1, STR_VECT *propNames = nullptr);
+                             int molid = -1,
+                             const STR_VECT *propNames = nullptr);
 
   //! \brief write a new molecule to the file
   void write(const ROMol &mol, int confId = defaultConfId) override;
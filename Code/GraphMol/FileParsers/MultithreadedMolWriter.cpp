@@ -0,0 +1,284 @@
+#ifdef RDK_BUILD_THREADSAFE_SSS
+//
+//  Copyright (C) 2025 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include <fstream>
+#include <sstream>
+
+#include <RDGeneral/BadFileException.h>
+#include <RDGeneral/FileParseException.h>
+#include <RDGeneral/RDLog.h>
+#include <RDGeneral/RDThreads.h>
+
+#ifdef RDK_BUILD_MAEPARSER_SUPPORT
+#undef RDK_BUILD_MAEPARSER_SUPPORT
+#endif
+#include "MultithreadedMolWriter.h"
+
+namespace RDKit {
+
+namespace {
+// the settings are read by the formatter threads, so they cannot change
+// once writing has started
+bool canChangeSettings(unsigned int numMols, const char *what) {
+  if (numMols > 0) {
+    BOOST_LOG(rdErrorLog)
+        << "ERROR: Atleast one molecule has already been written\n";
+    BOOST_LOG(rdErrorLog) << "ERROR: Cannot change " << what
+                          << " now - ignoring it\n";
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+MultithreadedMolWriter::MultithreadedMolWriter(const std::string &fileName,
+                                               const Parameters &params) {
+  if (fileName != "-") {
+    auto *tmpStream = new std::ofstream(fileName.c_str());
+    if (!(*tmpStream) || (tmpStream->bad())) {
+      delete tmpStream;
+      std::ostringstream errout;
+      errout << "Bad output file " << fileName;
+      throw BadFileException(errout.str());
+    }
+    dp_ostream = static_cast<std::ostream *>(tmpStream);
+    df_owner = true;
+  } else {
+    dp_ostream = static_cast<std::ostream *>(&std::cout);
+    df_owner = false;
+  }
+  init(params);
+}
+
+MultithreadedMolWriter::MultithreadedMolWriter(std::ostream *outStream,
+                                               bool takeOwnership,
+                                               const Parameters &params) {
+  PRECONDITION(outStream, "null stream");
+  if (outStream->bad()) {
+    throw FileParseException("Bad output stream.");
+  }
+  dp_ostream = outStream;
+  df_owner = takeOwnership;
+  init(params);
+}
+
+void MultithreadedMolWriter::init(const Parameters &params) {
+  PRECONDITION(params.sizeInputQueue > 0 && params.sizeOutputQueue > 0,
+               "queue sizes must be positive");
+  d_params = params;
+  d_params.numWriterThreads = getNumThreadsToUse(d_params.numWriterThreads);
+  // if this many records are queued, but not yet written, write() waits for
+  // the oldest one before queueing another. With this many records in flight
+  // the queues cannot all be full, so neither the formatters nor write() can
+  // block forever.
+  d_maxInFlight = d_params.sizeInputQueue + d_params.sizeOutputQueue +
+                  d_params.numWriterThreads;
+  d_inputQueue.reset(
+      new ConcurrentQueue<std::tuple<ROMol *, int, unsigned int>>(
+          d_params.sizeInputQueue));
+  d_outputQueue.reset(
+      new ConcurrentQueue<std::tuple<std::string, unsigned int>>(
+          d_params.sizeOutputQueue));
+  d_reorderBuffer.resize(d_maxInFlight);
+  d_reorderBufferUsed.resize(d_maxInFlight, 0);
+}
+
+void MultithreadedMolWriter::formatter() {
+  std::tuple<ROMol *, int, unsigned int> r;
+  while (d_inputQueue->pop(r)) {
+    std::unique_ptr<ROMol> mol(std::get<0>(r));
+    const auto molid = std::get<2>(r);
+    std::string text;
+    try {
+      text = getRecordText(*mol, std::get<1>(r), molid);
+    } catch (const std::exception &e) {
+      BOOST_LOG(rdErrorLog) << "ERROR: could not write molecule " << molid
+                            << ": " << e.what() << std::endl;
+    } catch (...) {
+      BOOST_LOG(rdErrorLog)
+          << "ERROR: could not write molecule " << molid << std::endl;
+    }
+    d_outputQueue->push(std::make_tuple(std::move(text), molid));
+  }
+}
+
+void MultithreadedMolWriter::collectRecord() {
+  std::tuple<std::string, unsigned int> r;
+  if (d_outputQueue->pop(r)) {
+    const auto slot = std::get<1>(r) % d_maxInFlight;
+    CHECK_INVARIANT(!d_reorderBufferUsed[slot], "record slot in use");
+    d_reorderBuffer[slot] = std::move(std::get<0>(r));
+    d_reorderBufferUsed[slot] = 1;
+  }
+}
+
+void MultithreadedMolWriter::writeReadyRecords() {
+  while (d_numWritten < d_molid) {
+    const auto slot = d_numWritten % d_maxInFlight;
+    if (!d_reorderBufferUsed[slot]) {
+      break;
+    }
+    (*dp_ostream) << d_reorderBuffer[slot];
+    d_reorderBuffer[slot].clear();
+    d_reorderBufferUsed[slot] = 0;
+    ++d_numWritten;
+  }
+}
+
+void MultithreadedMolWriter::writeAllRecords() {
+  while (d_numWritten < d_molid) {
+    collectRecord();
+    writeReadyRecords();
+  }
+}
+
+void MultithreadedMolWriter::write(const ROMol &mol, int confId) {
+  PRECONDITION(dp_ostream, "no output stream");
+  if (!df_started) {
+    (*dp_ostream) << getHeaderText();
+    df_started = true;
+    startThreads();
+  }
+  while (d_molid - d_numWritten >= d_maxInFlight) {
+    collectRecord();
+    writeReadyRecords();
+  }
+  d_inputQueue->push(std::make_tuple(new ROMol(mol), confId, d_molid));
+  ++d_molid;
+  // pick up whatever has been finished in the meantime, this is the only
+  // thread which takes from the output queue, so this doesn't block
+  while (!d_outputQueue->isEmpty()) {
+    collectRecord();
+  }
+  writeReadyRecords();
+}
+
+void MultithreadedMolWriter::flush() {
+  PRECONDITION(dp_ostream, "no output stream");
+  writeAllRecords();
+  try {
+    dp_ostream->flush();
+  } catch (...) {
+    try {
+      if (dp_ostream->good()) {
+        dp_ostream->setstate(std::ios::badbit);
+      }
+    } catch (const std::runtime_error &) {
+    }
+  }
+}
+
+void MultithreadedMolWriter::close() {
+  if (dp_ostream) {
+    flush();
+  }
+  endThreads();
+  if (df_owner) {
+    delete dp_ostream;
+    df_owner = false;
+  }
+  dp_ostream = nullptr;
+}
+
+void MultithreadedMolWriter::startThreads() {
+  for (unsigned int i = 0; i < d_params.numWriterThreads; ++i) {
+    d_formatterThreads.emplace_back(&MultithreadedMolWriter::formatter, this);
+  }
+}
+
+void MultithreadedMolWriter::endThreads() {
+  if (d_formatterThreads.empty()) {
+    return;
+  }
+  // everything has been written, so the formatters are all waiting for
+  // more input
+  d_inputQueue->setDone();
+  for (auto &thread : d_formatterThreads) {
+    thread.join();
+  }
+  d_formatterThreads.clear();
+}
+
+MultithreadedSmilesWriter::MultithreadedSmilesWriter(
+    const std::string &fileName, const Parameters &params,
+    const std::string &delimiter, const std::string &nameHeader,
+    bool includeHeader, bool isomericSmiles, bool kekuleSmiles)
+    : MultithreadedMolWriter(fileName, params),
+      d_delim(delimiter),
+      d_nameHeader(nameHeader),
+      df_includeHeader(includeHeader),
+      df_isomericSmiles(isomericSmiles),
+      df_kekuleSmiles(kekuleSmiles) {}
+
+MultithreadedSmilesWriter::MultithreadedSmilesWriter(
+    std::ostream *outStream, bool takeOwnership, const Parameters &params,
+    const std::string &delimiter, const std::string &nameHeader,
+    bool includeHeader, bool isomericSmiles, bool kekuleSmiles)
+    : MultithreadedMolWriter(outStream, takeOwnership, params),
+      d_delim(delimiter),
+      d_nameHeader(nameHeader),
+      df_includeHeader(includeHeader),
+      df_isomericSmiles(isomericSmiles),
+      df_kekuleSmiles(kekuleSmiles) {}
+
+void MultithreadedSmilesWriter::setProps(const STR_VECT &propNames) {
+  if (canChangeSettings(d_molid, "properties")) {
+    d_props = propNames;
+  }
+}
+
+std::string MultithreadedSmilesWriter::getRecordText(
+    const ROMol &mol, int, unsigned int molid) const {
+  return SmilesWriter::getText(mol, molid, d_delim, d_nameHeader, d_props,
+                               df_isomericSmiles, df_kekuleSmiles);
+}
+
+std::string MultithreadedSmilesWriter::getHeaderText() const {
+  if (!df_includeHeader) {
+    return "";
+  }
+  return SmilesWriter::getHeaderText(d_delim, d_nameHeader, d_props);
+}
+
+MultithreadedSDWriter::MultithreadedSDWriter(const std::string &fileName,
+                                             const Parameters &params)
+    : MultithreadedMolWriter(fileName, params) {}
+
+MultithreadedSDWriter::MultithreadedSDWriter(std::ostream *outStream,
+                                             bool takeOwnership,
+                                             const Parameters &params)
+    : MultithreadedMolWriter(outStream, takeOwnership, params) {}
+
+void MultithreadedSDWriter::setProps(const STR_VECT &propNames) {
+  if (canChangeSettings(d_molid, "properties")) {
+    d_props = propNames;
+  }
+}
+
+void MultithreadedSDWriter::setForceV3000(bool val) {
+  if (canChangeSettings(d_molid, "forceV3000")) {
+    df_forceV3000 = val;
+  }
+}
+
+void MultithreadedSDWriter::setKekulize(bool val) {
+  if (canChangeSettings(d_molid, "kekulize")) {
+    df_kekulize = val;
+  }
+}
+
+std::string MultithreadedSDWriter::getRecordText(const ROMol &mol, int confId,
+                                                 unsigned int molid) const {
+  return SDWriter::getText(mol, confId, df_kekulize, df_forceV3000, molid,
+                           &d_props);
+}
+
+}  // namespace RDKit
+#endif
@@ -0,0 +1,207 @@
+//
+//  Copyright (C) 2025 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#ifdef RDK_BUILD_THREADSAFE_SSS
+#ifndef MULTITHREADED_MOL_WRITER
+#define MULTITHREADED_MOL_WRITER
+
+#include <RDGeneral/export.h>
+#include <RDGeneral/ConcurrentQueue.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "MolWriters.h"
+
+namespace RDKit {
+//! an abstract base class for writers which format records on a pool of
+//! worker threads.
+/*!
+  Molecules passed to write() are copied and queued, the worker threads
+  convert them to text and the results are written to the output stream
+  in the order in which the molecules were submitted. The number of records
+  which can be in flight at any time is limited by the queue sizes, so
+  memory use does not grow with the size of the output.
+
+  Writing to the stream happens on the calling thread, during calls to
+  write(), flush() and close(). Molecules which cannot be formatted are
+  logged and skipped.
+
+  This class is still a bit experimental and the public API may change
+  in future releases.
+*/
+class RDKIT_FILEPARSERS_EXPORT MultithreadedMolWriter : public MolWriter {
+ public:
+  struct Parameters {
+    unsigned int numWriterThreads = 1;  //!< number of formatting threads
+    size_t sizeInputQueue = 5;   //!< molecules waiting to be formatted
+    size_t sizeOutputQueue = 5;  //!< formatted records waiting to be written
+  };
+
+  // Derived classes MUST have a destructor that calls close
+  //  to properly end threads while the instance is alive
+  ~MultithreadedMolWriter() override { close(); }
+
+  //! \brief queue a copy of a molecule to be written
+  void write(const ROMol &mol, int confId = defaultConfId) override;
+
+  //! \brief write all queued molecules and flush the ostream
+  void flush() override;
+
+  //! \brief write all queued molecules and close our stream (the writer
+  //! cannot be used again)
+  void close() override;
+
+  //! \brief get the number of molecules written so far
+  //! (this includes those which are still queued)
+  unsigned int numMols() const override { return d_molid; }
+
+ protected:
+  MultithreadedMolWriter(const std::string &fileName,
+                         const Parameters &params);
+  MultithreadedMolWriter(std::ostream *outStream, bool takeOwnership,
+                         const Parameters &params);
+
+  //! returns the text for a single record, this is called from the worker
+  //! threads
+  virtual std::string getRecordText(const ROMol &mol, int confId,
+                                    unsigned int molid) const = 0;
+  //! returns the text written before the first record
+  virtual std::string getHeaderText() const { return ""; }
+
+  std::ostream *dp_ostream = nullptr;
+  bool df_owner = false;
+  unsigned int d_molid = 0;  //!< the number of molecules queued so far
+
+ private:
+  void init(const Parameters &params);
+  //! formats molecules from the input queue into the output queue
+  void formatter();
+  //! waits for the next formatted record
+  void collectRecord();
+  //! writes the formatted records which are next in order
+  void writeReadyRecords();
+  //! waits until everything queued has been written
+  void writeAllRecords();
+  void startThreads();
+  void endThreads();
+
+  Parameters d_params;
+  size_t d_maxInFlight = 0;  //!< queued but not yet written
+  unsigned int d_numWritten = 0;
+  bool df_started = false;
+  std::vector<std::thread> d_formatterThreads;
+  std::unique_ptr<ConcurrentQueue<std::tuple<ROMol *, int, unsigned int>>>
+      d_inputQueue;
+  std::unique_ptr<ConcurrentQueue<std::tuple<std::string, unsigned int>>>
+      d_outputQueue;
+  //! records which arrived out of order, indexed by molid % d_maxInFlight
+  std::vector<std::string> d_reorderBuffer;
+  std::vector<char> d_reorderBufferUsed;
+};
+
+//! writes SMILES files, formatting the records on multiple threads. See
+//! SmilesWriter for details of the output.
+class RDKIT_FILEPARSERS_EXPORT MultithreadedSmilesWriter
+    : public MultithreadedMolWriter {
+ public:
+  /*!
+    \param fileName       : filename to write to ("-" to write to stdout)
+    \param params         : controls the threading
+    \param delimiter      : delimiter to use in the text file
+    \param nameHeader     : used to label the name column in the output. If this
+                            is provided as the empty string, no names will be
+                            written.
+    \param includeHeader  : toggles inclusion of a header line in the output
+    \param isomericSmiles : toggles generation of isomeric SMILES
+    \param kekuleSmiles   : toggles the generation of kekule SMILES
+   */
+  explicit MultithreadedSmilesWriter(const std::string &fileName,
+                                     const Parameters &params = Parameters(),
+                                     const std::string &delimiter = " ",
+                                     const std::string &nameHeader = "Name",
+                                     bool includeHeader = true,
+                                     bool isomericSmiles = true,
+                                     bool kekuleSmiles = false);
+  //! \overload
+  explicit MultithreadedSmilesWriter(std::ostream *outStream,
+                                     bool takeOwnership = false,
+                                     const Parameters &params = Parameters(),
+                                     const std::string &delimiter = " ",
+                                     const std::string &nameHeader = "Name",
+                                     bool includeHeader = true,
+                                     bool isomericSmiles = true,
+                                     bool kekuleSmiles = false);
+  ~MultithreadedSmilesWriter() override { close(); }
+
+  //! \brief set a vector of property names that are need to be
+  //! written out for each molecule. This must be called before the
+  //! first molecule is written.
+  void setProps(const STR_VECT &propNames) override;
+
+ protected:
+  std::string getRecordText(const ROMol &mol, int confId,
+                            unsigned int molid) const override;
+  std::string getHeaderText() const override;
+
+ private:
+  std::string d_delim;
+  std::string d_nameHeader;
+  bool df_includeHeader;
+  bool df_isomericSmiles;
+  bool df_kekuleSmiles;
+  STR_VECT d_props;
+};
+
+//! writes SD files, formatting the records on multiple threads. See
+//! SDWriter for details of the output.
+class RDKIT_FILEPARSERS_EXPORT MultithreadedSDWriter
+    : public MultithreadedMolWriter {
+ public:
+  /*!
+    \param fileName       : filename to write to ("-" to write to stdout)
+    \param params         : controls the threading
+   */
+  explicit MultithreadedSDWriter(const std::string &fileName,
+                                 const Parameters &params = Parameters());
+  //! \overload
+  explicit MultithreadedSDWriter(std::ostream *outStream,
+                                 bool takeOwnership = false,
+                                 const Parameters &params = Parameters());
+  ~MultithreadedSDWriter() override { close(); }
+
+  //! \brief set a vector of property names that are need to be
+  //! written out for each molecule. This must be called before the
+  //! first molecule is written.
+  void setProps(const STR_VECT &propNames) override;
+
+  //! this must be called before the first molecule is written
+  void setForceV3000(bool val);
+  bool getForceV3000() const { return df_forceV3000; }
+
+  //! this must be called before the first molecule is written
+  void setKekulize(bool val);
+  bool getKekulize() const { return df_kekulize; }
+
+ protected:
+  std::string getRecordText(const ROMol &mol, int confId,
+                            unsigned int molid) const override;
+
+ private:
+  STR_VECT d_props;
+  bool df_forceV3000 = false;
+  bool df_kekulize = true;
+};
+
+}  // namespace RDKit
+#endif
+#endif
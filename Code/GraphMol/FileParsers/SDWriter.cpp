@@ -118,7 +118,7 @@ void _writePropToStream(std::ostream *dp_ostream, const ROMol &mol,
 }
 void _MolToSDStream(std::ostream *dp_ostream, const ROMol &mol, int confId,
                     bool df_kekulize, bool df_forceV3000, int d_molid,
-                    STR_VECT *props) {
+                    const STR_VECT *props) {
   PRECONDITION(dp_ostream, "no output stream");
 
   // write the molecule
@@ -163,7 +163,8 @@ void _MolToSDStream(std::ostream *dp_ostream, const ROMol &mol, int confId,
 }  // namespace
 
 std::string SDWriter::getText(const ROMol &mol, int confId, bool kekulize,
-                              bool forceV3000, int molid, STR_VECT *propNames) {
+                              bool forceV3000, int molid,
+                              const STR_VECT *propNames) {
   std::stringstream sstr;
   _MolToSDStream(&sstr, mol, confId, kekulize, forceV3000, molid, propNames);
   return sstr.str();
@@ -85,24 +85,31 @@ void SmilesWriter::setProps(const STR_VECT &propNames) {
   d_props = propNames;
 }
 
-void SmilesWriter::dumpHeader() const {
-  CHECK_INVARIANT(dp_ostream, "no output stream");
-  if (df_includeHeader) {
-    (*dp_ostream) << "SMILES" << d_delim;
-    if (d_nameHeader != "") {
-      (*dp_ostream) << d_nameHeader << d_delim;
-    }
+std::string SmilesWriter::getHeaderText(const std::string &delimiter,
+                                        const std::string &nameHeader,
+                                        const STR_VECT &propNames) {
+  std::string res = "SMILES" + delimiter;
+  if (nameHeader != "") {
+    res += nameHeader + delimiter;
+  }
 
-    if (d_props.size() > 0) {
-      auto pi = d_props.begin();
-      (*dp_ostream) << (*pi);
+  if (propNames.size() > 0) {
+    auto pi = propNames.begin();
+    res += *pi;
+    pi++;
+    while (pi != propNames.end()) {
+      res += delimiter + *pi;
       pi++;
-      while (pi != d_props.end()) {
-        (*dp_ostream) << d_delim << (*pi);
-        pi++;
-      }
     }
-    (*dp_ostream) << "\n";
+  }
+  res += "\n";
+  return res;
+}
+
+void SmilesWriter::dumpHeader() const {
+  CHECK_INVARIANT(dp_ostream, "no output stream");
+  if (df_includeHeader) {
+    (*dp_ostream) << getHeaderText(d_delim, d_nameHeader, d_props);
   }
 }
 
@@ -113,39 +120,44 @@ SmilesWriter::~SmilesWriter() {
   }
 }
 
-void SmilesWriter::write(const ROMol &mol, int) {
-  CHECK_INVARIANT(dp_ostream, "no output stream");
-  if (d_molid <= 0 && df_includeHeader) {
-    dumpHeader();
-  }
-
-  std::string name = "";
-  std::string smi = MolToSmiles(mol, df_isomericSmiles, df_kekuleSmiles);
-  (*dp_ostream) << smi;
-  if (d_nameHeader != "") {
+std::string SmilesWriter::getText(const ROMol &mol, unsigned int molid,
+                                  const std::string &delimiter,
+                                  const std::string &nameHeader,
+                                  const STR_VECT &propNames,
+                                  bool isomericSmiles, bool kekuleSmiles) {
+  std::string res = MolToSmiles(mol, isomericSmiles, kekuleSmiles);
+  if (nameHeader != "") {
+    std::string name;
     if (!mol.getPropIfPresent(common_properties::_Name, name) ||
         name.size() == 0) {
-      std::stringstream tstream;
-      tstream << d_molid;
-      name = tstream.str();
+      name = std::to_string(molid);
     }
 
-    (*dp_ostream) << d_delim << name;
+    res += delimiter + name;
   }
 
-  STR_VECT_CI pi;
-  for (pi = d_props.begin(); pi != d_props.end(); pi++) {
+  for (const auto &prop : propNames) {
+    res += delimiter;
     std::string pval;
     // FIX: we will assume that any property that the user requests is castable
     // to
     // a std::string
-    if (mol.getPropIfPresent(*pi, pval)) {
-      (*dp_ostream) << d_delim << pval;
-    } else {
-      (*dp_ostream) << d_delim << "";
+    if (mol.getPropIfPresent(prop, pval)) {
+      res += pval;
     }
   }
-  (*dp_ostream) << "\n";
+  res += "\n";
+  return res;
+}
+
+void SmilesWriter::write(const ROMol &mol, int) {
+  CHECK_INVARIANT(dp_ostream, "no output stream");
+  if (d_molid <= 0 && df_includeHeader) {
+    dumpHeader();
+  }
+
+  (*dp_ostream) << getText(mol, d_molid, d_delim, d_nameHeader, d_props,
+                           df_isomericSmiles, df_kekuleSmiles);
   d_molid++;
 }
 }  // namespace RDKit
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <streambuf>
 
@@ -22,6 +23,7 @@
 #include <GraphMol/MolPickler.h>
 #include <GraphMol/Chirality.h>
 #include <GraphMol/FileParsers/FileParsers.h>
+#include <GraphMol/FileParsers/FileParserUtils.h>
 #include <GraphMol/FileParsers/MolSupplier.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
 #include <GraphMol/SmilesParse/SmilesParse.h>
@@ -7909,3 +7911,46 @@ TEST_CASE(
     CHECK(m->getBondWithIdx(0)->getBondType() == Bond::AROMATIC);
   }
 }
+
+TEST_CASE("parsing mol blocks in place") {
+  SECTION("the view does not need to be null terminated") {
+    auto mol = "C[C@H](F)Cl"_smiles;
+    REQUIRE(mol);
+    for (auto forceV3000 : {false, true}) {
+      CAPTURE(forceV3000);
+      auto molBlock = MolToMolBlock(*mol, true, -1, true, forceV3000);
+      // put the block in the middle of other text so that anything read past
+      // the end of the view would cause problems
+      auto text = "junk\n" + molBlock + "$$$$\njunk";
+      std::string_view view(text);
+      view = view.substr(5, molBlock.size());
+      auto mol2 = v2::FileParsers::MolFromMolBlock(view);
+      REQUIRE(mol2);
+      CHECK(MolToSmiles(*mol2) == MolToSmiles(*mol));
+    }
+  }
+  SECTION("numeric fields stop at the end of the view") {
+    std::string_view text = "12345.678912345.6789";
+    CHECK(FileParserUtils::toDouble(text.substr(0, 10)) == 12345.6789);
+    CHECK(FileParserUtils::toDouble(text.substr(10, 10)) == 12345.6789);
+    CHECK(FileParserUtils::toDouble(std::string_view("  +1.5")) == 1.5);
+    CHECK(FileParserUtils::toDouble(std::string_view("    ")) == 0.0);
+    CHECK(FileParserUtils::toInt(std::string_view(" -3")) == -3);
+  }
+  SECTION("V3000 lines with continuations") {
+    std::istringstream inStream(
+        "M  V30 BEGIN -\nM  V30 ATOM\nM  V30 1 C 0 0 0 0\nM  V30 COUNTS -\n"
+        "M  V30 1 0 0 0 0\n");
+    unsigned int line = 0;
+    std::string text;
+    FileParserUtils::getV3000Line(&inStream, line, text);
+    CHECK(text == "BEGIN ATOM");
+    CHECK(line == 2);
+    FileParserUtils::getV3000Line(&inStream, line, text);
+    CHECK(text == "1 C 0 0 0 0");
+    CHECK(line == 3);
+    CHECK(FileParserUtils::getV3000Line(&inStream, line) ==
+          "COUNTS 1 0 0 0 0");
+    CHECK(line == 5);
+  }
+}
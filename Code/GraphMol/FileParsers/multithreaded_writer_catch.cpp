@@ -0,0 +1,152 @@
+//
+//  Copyright (C) 2025 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+#include <GraphMol/RDKitBase.h>
+#include <GraphMol/FileParsers/MolSupplier.h>
+#include <GraphMol/FileParsers/MolWriters.h>
+#include <GraphMol/FileParsers/MultithreadedMolWriter.h>
+#include <GraphMol/SmilesParse/SmilesParse.h>
+
+using namespace RDKit;
+
+namespace {
+std::vector<std::unique_ptr<RWMol>> readSDF(const std::string &fname) {
+  std::vector<std::unique_ptr<RWMol>> res;
+  v2::FileParsers::SDMolSupplier suppl(fname);
+  while (!suppl.atEnd()) {
+    auto mol = suppl.next();
+    if (mol) {
+      res.push_back(std::move(mol));
+    }
+  }
+  return res;
+}
+}  // namespace
+
+TEST_CASE("multithreaded writers match the serial ones") {
+  std::string rdbase = getenv("RDBASE");
+  auto mols = readSDF(rdbase + "/Data/NCI/first_200.props.sdf");
+  REQUIRE(mols.size() > 150);
+  MultithreadedMolWriter::Parameters params;
+  params.numWriterThreads = 4;
+
+  SECTION("SMILES") {
+    STR_VECT props = {"AMW", "NUM_HEAVYATOMS"};
+    std::ostringstream expected;
+    {
+      SmilesWriter writer(&expected, "\t", "Name", true, false);
+      writer.setProps(props);
+      for (const auto &mol : mols) {
+        writer.write(*mol);
+      }
+    }
+    for (auto sizeQueues : {1, 5, 100}) {
+      params.sizeInputQueue = sizeQueues;
+      params.sizeOutputQueue = sizeQueues;
+      std::ostringstream oss;
+      MultithreadedSmilesWriter writer(&oss, false, params, "\t");
+      writer.setProps(props);
+      for (const auto &mol : mols) {
+        writer.write(*mol);
+      }
+      CHECK(writer.numMols() == mols.size());
+      writer.close();
+      CHECK(oss.str() == expected.str());
+    }
+  }
+  SECTION("SDF") {
+    std::ostringstream expected;
+    {
+      SDWriter writer(&expected);
+      writer.setForceV3000(true);
+      for (const auto &mol : mols) {
+        writer.write(*mol);
+      }
+    }
+    std::ostringstream oss;
+    {
+      MultithreadedSDWriter writer(&oss, false, params);
+      writer.setForceV3000(true);
+      for (const auto &mol : mols) {
+        writer.write(*mol);
+      }
+    }
+    CHECK(oss.str() == expected.str());
+  }
+}
+
+TEST_CASE("multithreaded writer details") {
+  MultithreadedMolWriter::Parameters params;
+  params.numWriterThreads = 2;
+  SECTION("flush writes everything queued") {
+    std::ostringstream oss;
+    MultithreadedSmilesWriter writer(&oss, false, params, " ", "", false);
+    auto mol = std::unique_ptr<RWMol>(SmilesToMol("CCO"));
+    REQUIRE(mol);
+    for (unsigned int i = 0; i < 20; ++i) {
+      writer.write(*mol);
+    }
+    writer.flush();
+    std::string expected;
+    for (unsigned int i = 0; i < 20; ++i) {
+      expected += "CCO\n";
+    }
+    CHECK(oss.str() == expected);
+  }
+  SECTION("the molecule can change after write()") {
+    std::ostringstream oss;
+    MultithreadedSmilesWriter writer(&oss, false, params, " ", "", false);
+    auto mol = std::unique_ptr<RWMol>(SmilesToMol("CCO"));
+    REQUIRE(mol);
+    writer.write(*mol);
+    mol->getAtomWithIdx(0)->setAtomicNum(7);
+    writer.write(*mol);
+    writer.close();
+    CHECK(oss.str() == "CCO\nNCO\n");
+  }
+  SECTION("settings can't change after writing") {
+    std::ostringstream oss;
+    MultithreadedSDWriter writer(&oss, false, params);
+    auto mol = std::unique_ptr<RWMol>(SmilesToMol("c1ccccc1"));
+    REQUIRE(mol);
+    writer.write(*mol);
+    writer.setKekulize(false);
+    CHECK(writer.getKekulize());
+  }
+  SECTION("no molecules") {
+    std::ostringstream oss;
+    {
+      MultithreadedSmilesWriter writer(&oss, false, params);
+    }
+    CHECK(oss.str().empty());
+  }
+  SECTION("bad molecules are skipped") {
+    std::ostringstream oss;
+    MultithreadedSDWriter writer(&oss, false, params);
+    // this can't be kekulized
+    SmilesParserParams ps;
+    ps.sanitize = false;
+    std::unique_ptr<RWMol> bad(SmilesToMol("c1cccc1", ps));
+    REQUIRE(bad);
+    auto good = std::unique_ptr<RWMol>(SmilesToMol("CC"));
+    writer.write(*good);
+    writer.write(*bad);
+    writer.write(*good);
+    writer.close();
+    auto text = oss.str();
+    CHECK(std::count(text.begin(), text.end(), '$') == 8);
+  }
+}
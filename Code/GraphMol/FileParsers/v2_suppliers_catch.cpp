@@ -8,15 +8,20 @@
 //
 
 #include <algorithm>
+#include <cstdio>
 #include <fstream>
+#include <future>
 #include <string>
 #include <sstream>
 #include "RDGeneral/test.h"
 #include <catch2/catch_all.hpp>
 #include <RDGeneral/Invariant.h>
 #include <GraphMol/RDKitBase.h>
+#include <GraphMol/SmilesParse/SmilesWrite.h>
 #include <GraphMol/FileParsers/FileParsers.h>
+#include <GraphMol/FileParsers/MappedSDMolSupplier.h>
 #include <GraphMol/FileParsers/MolSupplier.h>
+#include <RDGeneral/BadFileException.h>
 #include <RDGeneral/FileParseException.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
@@ -64,6 +69,111 @@ TEST_CASE("SDMolSupplier") {
   }
 }
 
+TEST_CASE("MappedSDMolSupplier") {
+  std::string rdbase = getenv("RDBASE");
+  SECTION("matches SDMolSupplier") {
+    auto fName = GENERATE(as<std::string>{}, "/Data/NCI/first_200.props.sdf",
+                          "/Code/GraphMol/FileParsers/test_data/esters.sdf",
+                          "/Code/GraphMol/FileParsers/test_data/esters_end.sdf",
+                          "/Code/GraphMol/FileParsers/test_data/empty.sdf",
+                          "/Code/GraphMol/FileParsers/test_data/sdErrors1.sdf",
+                          "/Code/GraphMol/FileParsers/test_data/sdErrors3.sdf",
+                          "/Code/GraphMol/FileParsers/test_data/missingCR.sdf",
+                          "/Code/GraphMol/FileParsers/test_data/SkipLines.sdf");
+    CAPTURE(fName);
+    FileParsers::SDMolSupplier sdsup(rdbase + fName);
+    FileParsers::MappedSDMolSupplier msup(rdbase + fName);
+    REQUIRE(msup.length() == sdsup.length());
+    for (unsigned int i = 0; i < msup.length(); ++i) {
+      CHECK(msup.getItemText(i) == sdsup.getItemText(i));
+      auto mol1 = sdsup[i];
+      auto mol2 = msup[i];
+      REQUIRE(static_cast<bool>(mol1) == static_cast<bool>(mol2));
+      if (mol1) {
+        CHECK(MolToSmiles(*mol1) == MolToSmiles(*mol2));
+        CHECK(mol1->getPropList(false, false) ==
+              mol2->getPropList(false, false));
+      }
+    }
+  }
+  SECTION("sequential reads") {
+    FileParsers::MappedSDMolSupplier msup(
+        rdbase + "/Code/GraphMol/FileParsers/test_data/NCI_aids_few.sdf");
+    CHECK(msup.length() == 16);
+    unsigned int nmols = 0;
+    while (!msup.atEnd()) {
+      auto mol = msup.next();
+      REQUIRE(mol);
+      ++nmols;
+    }
+    CHECK(nmols == msup.length());
+    CHECK_THROWS_AS(msup.next(), FileParseException);
+    CHECK_THROWS_AS(msup[msup.length()], FileParseException);
+    msup.reset();
+    auto mol = msup.next();
+    REQUIRE(mol);
+    CHECK(mol->getProp<std::string>("_Name") == "48");
+  }
+  SECTION("saving and loading the index") {
+    auto fName = rdbase + "/Data/NCI/first_200.props.sdf";
+    auto idxName = rdbase +
+                   "/Code/GraphMol/FileParsers/test_data/"
+                   "mapped_sdsupplier.idx";
+    FileParsers::MappedSDMolSupplier msup(fName);
+    msup.saveIndex(idxName);
+    {
+      FileParsers::MappedSDMolSupplier msup2(fName, {}, idxName);
+      CHECK(msup2.getOffsets() == msup.getOffsets());
+      CHECK(msup2.getItemText(10) == msup.getItemText(10));
+    }
+    {
+      // an index for a different file is ignored
+      FileParsers::MappedSDMolSupplier msup2(
+          rdbase + "/Code/GraphMol/FileParsers/test_data/NCI_aids_few.sdf",
+          {}, idxName);
+      CHECK(msup2.length() == 16);
+    }
+    {
+      // as is one which doesn't exist
+      FileParsers::MappedSDMolSupplier msup2(fName, {}, idxName + ".missing");
+      CHECK(msup2.length() == msup.length());
+    }
+    std::remove(idxName.c_str());
+  }
+  SECTION("bad file") {
+    CHECK_THROWS_AS(FileParsers::MappedSDMolSupplier("no_such_file.sdf"),
+                    BadFileException);
+  }
+#ifdef RDK_TEST_MULTITHREADED
+  SECTION("parallel reads") {
+    FileParsers::MappedSDMolSupplier msup(rdbase +
+                                          "/Data/NCI/first_200.props.sdf");
+    std::vector<std::string> expected;
+    for (unsigned int i = 0; i < msup.length(); ++i) {
+      auto mol = msup[i];
+      expected.push_back(mol ? MolToSmiles(*mol) : "");
+    }
+    const unsigned int numThreads = 4;
+    std::vector<std::vector<std::string>> results(numThreads);
+    std::vector<std::future<void>> tg;
+    for (unsigned int t = 0; t < numThreads; ++t) {
+      tg.emplace_back(std::async(std::launch::async, [&, t]() {
+        for (unsigned int i = t; i < msup.length(); i += numThreads) {
+          auto mol = msup.getMol(i);
+          results[t].push_back(mol ? MolToSmiles(*mol) : "");
+        }
+      }));
+    }
+    for (auto &fut : tg) {
+      fut.get();
+    }
+    for (unsigned int i = 0; i < msup.length(); ++i) {
+      CHECK(results[i % numThreads][i / numThreads] == expected[i]);
+    }
+  }
+#endif
+}
+
 TEST_CASE("SmilesMolSupplier") {
   SECTION("basics") {
     std::string fName = getenv("RDBASE");
@@ -216,6 +216,8 @@ bool FilterCatalog::hasMatch(const ROMol &mol) const {
 
 FilterCatalog::CONST_SENTRY FilterCatalog::getFirstMatch(
     const ROMol &mol) const {
+  // the patterns share many of their recursive queries
+  RecursiveMatchCache recursiveMatches(mol);
   for (const auto &d_entry : d_entries) {
     if (d_entry->hasFilterMatch(mol)) {
       return d_entry;
@@ -226,6 +228,7 @@ FilterCatalog::CONST_SENTRY FilterCatalog::getFirstMatch(
 
 const std::vector<FilterCatalog::CONST_SENTRY> FilterCatalog::getMatches(
     const ROMol &mol) const {
+  RecursiveMatchCache recursiveMatches(mol);
   std::vector<CONST_SENTRY> result;
   for (const auto &d_entry : d_entries) {
     if (d_entry->hasFilterMatch(mol)) {
@@ -237,6 +240,7 @@ const std::vector<FilterCatalog::CONST_SENTRY> FilterCatalog::getMatches(
 
 const std::vector<FilterMatch> FilterCatalog::getFilterMatches(
     const ROMol &mol) const {
+  RecursiveMatchCache recursiveMatches(mol);
   std::vector<FilterMatch> result;
   for (const auto &d_entry : d_entries) {
     d_entry->getFilterMatches(mol, result);
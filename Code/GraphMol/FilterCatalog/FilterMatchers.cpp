@@ -46,40 +46,51 @@ SmartsMatcher::SmartsMatcher(const ROMol &pattern, unsigned int minCount,
     : FilterMatcherBase(SMARTS_MATCH_NAME_DEFAULT),
       d_pattern(new ROMol(pattern)),
       d_min_count(minCount),
-      d_max_count(maxCount) {}
+      d_max_count(maxCount) {
+  prepare();
+}
 
 SmartsMatcher::SmartsMatcher(const std::string &name, const ROMol &pattern,
                              unsigned int minCount, unsigned int maxCount)
     : FilterMatcherBase(name),
       d_pattern(new ROMol(pattern)),
       d_min_count(minCount),
-      d_max_count(maxCount) {}
+      d_max_count(maxCount) {
+  prepare();
+}
 
 SmartsMatcher::SmartsMatcher(const std::string &name, const std::string &smarts,
                              unsigned int minCount, unsigned int maxCount)
     : FilterMatcherBase(name),
       d_pattern(SmartsToMol(smarts, debugParse, mergeHs)),
       d_min_count(minCount),
-      d_max_count(maxCount) {}
+      d_max_count(maxCount) {
+  prepare();
+}
 
 SmartsMatcher::SmartsMatcher(const std::string &name, ROMOL_SPTR pattern,
                              unsigned int minCount, unsigned int maxCount)
     : FilterMatcherBase(name),
       d_pattern(std::move(pattern)),
       d_min_count(minCount),
-      d_max_count(maxCount) {}
+      d_max_count(maxCount) {
+  prepare();
+}
 
 void SmartsMatcher::setPattern(const std::string &smarts) {
   d_pattern.reset(SmartsToMol(smarts, debugParse, mergeHs));
+  prepare();
 }
 
 void SmartsMatcher::setPattern(const ROMol &mol) {
   d_pattern.reset(new ROMol(mol));
+  prepare();
 }
 
 SmartsMatcher::SmartsMatcher(const SmartsMatcher &rhs)
     : FilterMatcherBase(rhs),
       d_pattern(rhs.d_pattern),
+      d_prepared(rhs.d_prepared),
       d_min_count(rhs.d_min_count),
       d_max_count(rhs.d_max_count) {}
 
@@ -90,16 +101,17 @@ bool SmartsMatcher::getMatches(const ROMol &mol,
   bool onPatExists = false;
   std::vector<RDKit::MatchVectType> matches;
 
+  SubstructMatchParameters params;
   if (d_min_count == 1 && d_max_count == UINT_MAX) {
-    RDKit::MatchVectType match;
-    onPatExists = RDKit::SubstructMatch(mol, *d_pattern.get(), match);
+    params.maxMatches = 1;
+    matches = RDKit::SubstructMatch(mol, *d_prepared, params);
+    onPatExists = !matches.empty();
     if (onPatExists) {
-      matchVect.emplace_back(copy(), match);
+      matchVect.emplace_back(copy(), matches.front());
     }
   } else {  // need to count
-    const bool uniquify = true;
-    unsigned int count =
-        RDKit::SubstructMatch(mol, *d_pattern.get(), matches, uniquify);
+    matches = RDKit::SubstructMatch(mol, *d_prepared, params);
+    unsigned int count = matches.size();
     onPatExists = (count >= d_min_count &&
                    (d_max_count == UINT_MAX || count <= d_max_count));
     if (onPatExists) {
@@ -115,14 +127,12 @@ bool SmartsMatcher::getMatches(const ROMol &mol,
 bool SmartsMatcher::hasMatch(const ROMol &mol) const {
   PRECONDITION(d_pattern.get(), "bad on pattern");
 
+  SubstructMatchParameters params;
   if (d_min_count == 1 && d_max_count == UINT_MAX) {
-    RDKit::MatchVectType matches;
-    return SubstructMatch(mol, *d_pattern.get(), matches);
+    params.maxMatches = 1;
+    return !SubstructMatch(mol, *d_prepared, params).empty();
   } else {  // need to count
-    const bool uniquify = true;
-    std::vector<RDKit::MatchVectType> matches;
-    unsigned int count =
-        RDKit::SubstructMatch(mol, *d_pattern.get(), matches, uniquify);
+    unsigned int count = SubstructMatch(mol, *d_prepared, params).size();
     return (count >= d_min_count &&
             (d_max_count == UINT_MAX || count <= d_max_count));
   }
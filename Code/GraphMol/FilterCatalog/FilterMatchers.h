@@ -243,15 +243,27 @@ class RDKIT_FILTERCATALOG_EXPORT Not : public FilterMatcherBase {
 RDKIT_FILTERCATALOG_EXPORT extern const char *SMARTS_MATCH_NAME_DEFAULT;
 class RDKIT_FILTERCATALOG_EXPORT SmartsMatcher : public FilterMatcherBase {
   ROMOL_SPTR d_pattern;
+  // d_pattern prepared for matching, the atom order is kept so that the
+  // reported matches are the same as SubstructMatch() finds
+  boost::shared_ptr<const PreparedSubstructQuery> d_prepared;
   unsigned int d_min_count{0};
   unsigned int d_max_count;
 
+  void prepare() {
+    if (d_pattern) {
+      d_prepared = boost::make_shared<const PreparedSubstructQuery>(
+          *d_pattern, false);
+    } else {
+      d_prepared.reset();
+    }
+  }
+
  public:
   //! Construct a SmartsMatcher
   SmartsMatcher(const std::string &name = SMARTS_MATCH_NAME_DEFAULT)
       : FilterMatcherBase(name),
         d_pattern(),
-
+        d_prepared(),
         d_max_count(UINT_MAX) {}
 
   //! Construct a SmartsMatcher from a query molecule
@@ -322,7 +334,10 @@ class RDKIT_FILTERCATALOG_EXPORT SmartsMatcher : public FilterMatcherBase {
   //! Set the query molecule for the matcher
   void setPattern(const ROMol &mol);
   //! Set the shared query molecule for the matcher
-  void setPattern(const ROMOL_SPTR &pat) { d_pattern = pat; }
+  void setPattern(const ROMOL_SPTR &pat) {
+    d_pattern = pat;
+    prepare();
+  }
 
   //! Get the minimum match count for the pattern to be true
   unsigned int getMinCount() const { return d_min_count; }
@@ -360,6 +375,7 @@ class RDKIT_FILTERCATALOG_EXPORT SmartsMatcher : public FilterMatcherBase {
     std::string res;
     ar & res;
     d_pattern = boost::shared_ptr<ROMol>(new ROMol(res));
+    prepare();
     ar & d_min_count;
     ar & d_max_count;
   }
@@ -266,6 +266,41 @@ void getConnectivityInvariants(const ROMol &mol, std::vector<uint32_t> &invars,
   }
 }  // end of getConnectivityInvariants()
 
+void getConnectivityInvariants(const FrozenMol &mol,
+                               std::vector<uint32_t> &invars,
+                               bool includeRingMembership) {
+  unsigned int nAtoms = mol.getNumAtoms();
+  PRECONDITION(invars.size() >= nAtoms, "vector too small");
+  gboost::hash<std::vector<uint32_t>> vectHasher;
+  const auto atomicNums = mol.getAtomicNums();
+  const auto formalCharges = mol.getFormalCharges();
+  const auto isotopes = mol.getIsotopes();
+  const auto totalNumHs = mol.getTotalNumHs();
+  const auto numRings = mol.getAtomNumRings();
+  const auto *periodicTable = PeriodicTable::getTable();
+  std::vector<uint32_t> components;
+  for (unsigned int i = 0; i < nAtoms; ++i) {
+    unsigned int nHNbrs = 0;
+    for (auto nbr : mol.getAtomNeighbors(i)) {
+      nHNbrs += (atomicNums[nbr] == 1);
+    }
+    const unsigned int atNum = atomicNums[i];
+    const double mass = periodicTable->getAtomMass(atNum, isotopes[i]);
+
+    components.clear();
+    components.push_back(atNum);
+    components.push_back(totalNumHs[i] + mol.getDegree(i));
+    components.push_back(totalNumHs[i] + nHNbrs);
+    components.push_back(formalCharges[i]);
+    components.push_back(
+        static_cast<int>(mass - periodicTable->getAtomicWeight(atNum)));
+    if (includeRingMembership && numRings[i]) {
+      components.push_back(1);
+    }
+    invars[i] = vectHasher(components);
+  }
+}
+
 }  // namespace MorganFingerprints
 
 namespace RDKitFPUtils {
@@ -282,6 +317,19 @@ void buildDefaultRDKitFingerprintAtomInvariants(
   }
 }
 
+void buildDefaultRDKitFingerprintAtomInvariants(
+    const FrozenMol &mol, std::vector<std::uint32_t> &lAtomInvariants) {
+  const auto atomicNums = mol.getAtomicNums();
+  const auto isAromatic = mol.getAtomIsAromatic();
+  lAtomInvariants.clear();
+  lAtomInvariants.reserve(mol.getNumAtoms());
+  for (unsigned int i = 0; i < mol.getNumAtoms(); ++i) {
+    unsigned int aHash = (atomicNums[i] % 128) << 1 |
+                         static_cast<unsigned int>(isAromatic[i] != 0);
+    lAtomInvariants.push_back(aHash);
+  }
+}
+
 void enumerateAllPaths(const ROMol &mol, INT_PATH_LIST_MAP &allPaths,
                        const std::vector<std::uint32_t> *fromAtoms,
                        bool branchedPaths, bool useHs, unsigned int minPath,
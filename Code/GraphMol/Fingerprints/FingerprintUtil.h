@@ -13,6 +13,7 @@
 #define RD_FINGERPRINTUTIL_H_2018_07
 
 #include <GraphMol/RDKitBase.h>
+#include <GraphMol/FrozenMol.h>
 #include <DataStructs/SparseIntVect.h>
 #include <DataStructs/BitVects.h>
 #include <cstdint>
@@ -111,6 +112,10 @@ RDKIT_FINGERPRINTS_EXPORT extern std::vector<std::string> defaultFeatureSmarts;
 RDKIT_FINGERPRINTS_EXPORT void getConnectivityInvariants(
     const ROMol &mol, std::vector<std::uint32_t> &invars,
     bool includeRingMembership = true);
+//! \overload
+RDKIT_FINGERPRINTS_EXPORT void getConnectivityInvariants(
+    const FrozenMol &mol, std::vector<std::uint32_t> &invars,
+    bool includeRingMembership = true);
 const std::string morganConnectivityInvariantVersion = "1.0.0";
 
 //! returns the feature invariants for a molecule
@@ -137,6 +142,8 @@ namespace RDKitFPUtils {
 
 RDKIT_FINGERPRINTS_EXPORT void buildDefaultRDKitFingerprintAtomInvariants(
     const ROMol &mol, std::vector<std::uint32_t> &lAtomInvariants);
+RDKIT_FINGERPRINTS_EXPORT void buildDefaultRDKitFingerprintAtomInvariants(
+    const FrozenMol &mol, std::vector<std::uint32_t> &lAtomInvariants);
 
 RDKIT_FINGERPRINTS_EXPORT void enumerateAllPaths(
     const ROMol &mol, std::map<int, std::list<std::vector<int>>> &allPaths,
@@ -38,9 +38,30 @@
 #include <GraphMol/Fingerprints/MorganFingerprints.h>
 #include <GraphMol/Fingerprints/FingerprintGenerator.h>
 #include <GraphMol/Fingerprints/MorganGenerator.h>
+#include <GraphMol/FrozenMol.h>
 
 namespace RDKit {
 namespace MorganFingerprints {
+namespace {
+// the bit ids of the environments MorganEnvGenerator finds with the default
+// atom invariants and without chirality
+std::vector<std::uint32_t> getFrozenMolBitIds(
+    const FrozenMol &mol, unsigned int radius, bool useBondTypes,
+    bool includeRedundantEnvironments) {
+  std::vector<std::uint32_t> atomInvariants(mol.getNumAtoms());
+  getConnectivityInvariants(mol, atomInvariants);
+  std::vector<std::uint32_t> bondInvariants(mol.getNumBonds(), 1);
+  if (useBondTypes) {
+    const auto bondTypes = mol.getBondTypes();
+    std::copy(bondTypes.begin(), bondTypes.end(), bondInvariants.begin());
+  }
+  MorganFingerprint::MorganArguments arguments(radius);
+  arguments.df_includeRedundantEnvironments = includeRedundantEnvironments;
+  arguments.df_useBondTypes = useBondTypes;
+  return MorganFingerprint::getEnvironmentIds(mol, arguments, atomInvariants,
+                                              bondInvariants);
+}
+}  // namespace
 
 SparseIntVect<uint32_t> *getFingerprint(
     const ROMol &mol, unsigned int radius, std::vector<uint32_t> *invariants,
@@ -154,5 +175,48 @@ ExplicitBitVect *getFingerprintAsBitVect(
   return res;
 }
 
+SparseIntVect<uint32_t> *getFingerprint(const FrozenMol &mol,
+                                        unsigned int radius, bool useBondTypes,
+                                        bool useCounts,
+                                        bool includeRedundantEnvironments) {
+  auto *res =
+      new SparseIntVect<uint32_t>(std::numeric_limits<uint32_t>::max());
+  for (auto bitId : getFrozenMolBitIds(mol, radius, useBondTypes,
+                                       includeRedundantEnvironments)) {
+    res->setVal(bitId, useCounts ? res->getVal(bitId) + 1 : 1);
+  }
+  return res;
+}
+
+SparseIntVect<uint32_t> *getHashedFingerprint(
+    const FrozenMol &mol, unsigned int radius, unsigned int nBits,
+    bool useBondTypes, bool includeRedundantEnvironments) {
+  if (nBits == 0) {
+    throw ValueErrorException("nBits can not be zero");
+  }
+  auto *res = new SparseIntVect<uint32_t>(nBits);
+  for (auto bitId : getFrozenMolBitIds(mol, radius, useBondTypes,
+                                       includeRedundantEnvironments)) {
+    bitId %= nBits;
+    res->setVal(bitId, res->getVal(bitId) + 1);
+  }
+  return res;
+}
+
+ExplicitBitVect *getFingerprintAsBitVect(const FrozenMol &mol,
+                                         unsigned int radius,
+                                         unsigned int nBits, bool useBondTypes,
+                                         bool includeRedundantEnvironments) {
+  if (nBits == 0) {
+    throw ValueErrorException("nBits can not be zero");
+  }
+  auto *res = new ExplicitBitVect(nBits);
+  for (auto bitId : getFrozenMolBitIds(mol, radius, useBondTypes,
+                                       includeRedundantEnvironments)) {
+    res->setBit(bitId % nBits);
+  }
+  return res;
+}
+
 }  // end of namespace MorganFingerprints
 }  // end of namespace RDKit
@@ -206,6 +206,44 @@ RDKIT_FINGERPRINTS_EXPORT ExplicitBitVect *getFingerprintAsBitVect(
     bool onlyNonzeroInvariants = false, BitInfoMap *atomsSettingBits = nullptr,
     bool includeRedundantEnvironments = false);
 
+//! returns the Morgan fingerprint of a FrozenMol
+/*!
+  The fingerprint is the same as the one getFingerprint() returns for the
+  molecule the FrozenMol was created from, using the default (ECFP-type)
+  atom invariants. Chirality, custom invariants and fromAtoms aren't
+  supported.
+
+  \param mol:    the molecule to be fingerprinted
+  \param radius: the number of iterations to grow the fingerprint
+  \param useBondTypes : if set, bond types will be included as part of the
+                        hash for calculating bits
+  \param useCounts : if set, counts of the features will be used
+  \param includeRedundantEnvironments : if set, the check for redundant atom
+                           environments will not be done.
+
+  \return a pointer to the fingerprint. The client is
+  responsible for calling delete on this.
+*/
+RDKIT_FINGERPRINTS_EXPORT SparseIntVect<std::uint32_t> *getFingerprint(
+    const FrozenMol &mol, unsigned int radius, bool useBondTypes = true,
+    bool useCounts = true, bool includeRedundantEnvironments = false);
+
+//! returns the hashed Morgan fingerprint of a FrozenMol
+/*!
+  see the FrozenMol overload of getFingerprint() for what is supported
+*/
+RDKIT_FINGERPRINTS_EXPORT SparseIntVect<std::uint32_t> *getHashedFingerprint(
+    const FrozenMol &mol, unsigned int radius, unsigned int nBits = 2048,
+    bool useBondTypes = true, bool includeRedundantEnvironments = false);
+
+//! returns the Morgan fingerprint of a FrozenMol as a bit vector
+/*!
+  see the FrozenMol overload of getFingerprint() for what is supported
+*/
+RDKIT_FINGERPRINTS_EXPORT ExplicitBitVect *getFingerprintAsBitVect(
+    const FrozenMol &mol, unsigned int radius, unsigned int nBits,
+    bool useBondTypes = true, bool includeRedundantEnvironments = false);
+
 }  // end of namespace MorganFingerprints
 }  // namespace RDKit
 
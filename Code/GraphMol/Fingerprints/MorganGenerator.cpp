@@ -9,6 +9,7 @@
 //
 
 #include <GraphMol/RDKitBase.h>
+#include <GraphMol/FrozenMol.h>
 #include <GraphMol/Fingerprints/FingerprintGenerator.h>
 #include <GraphMol/Fingerprints/MorganGenerator.h>
 #include <RDGeneral/hash/hash.hpp>
@@ -173,41 +174,83 @@ MorganAtomEnv<OutputType>::MorganAtomEnv(const std::uint32_t code,
                                          const unsigned int layer)
     : d_code(code), d_atomId(atomId), d_layer(layer) {}
 
-template <typename OutputType>
-std::vector<AtomEnvironment<OutputType> *>
-MorganEnvGenerator<OutputType>::getEnvironments(
-    const ROMol &mol, FingerprintArguments *arguments,
-    const std::vector<std::uint32_t> *fromAtoms,
-    const std::vector<std::uint32_t> *,  // ignoreAtoms
-    const int,                           // confId
-    const AdditionalOutput *,            // additionalOutput
-    const std::vector<std::uint32_t> *atomInvariants,
-    const std::vector<std::uint32_t> *bondInvariants,
-    const bool  // hashResults
-) const {
-  PRECONDITION(atomInvariants && (atomInvariants->size() >= mol.getNumAtoms()),
-               "bad atom invariants size");
-  PRECONDITION(bondInvariants && (bondInvariants->size() >= mol.getNumBonds()),
-               "bad bond invariants size");
-  auto *morganArguments = dynamic_cast<MorganArguments *>(arguments);
-  PRECONDITION(morganArguments, "bad arguments type");
-
-  unsigned int nAtoms = mol.getNumAtoms();
-  const unsigned int maxNumResults = (morganArguments->d_radius + 1) * nAtoms;
-
-  std::vector<AtomEnvironment<OutputType> *> result =
-      std::vector<AtomEnvironment<OutputType> *>();
-  result.reserve(maxNumResults);
+namespace {
+// The environment loop only needs the connectivity of the molecule and, for
+// chirality, the atoms' chiral tags and CIP codes. These adapt ROMol and
+// FrozenMol to that.
+class ROMolGraph {
+ public:
+  explicit ROMolGraph(const ROMol &mol) : d_mol(mol) {}
+  unsigned int getNumAtoms() const { return d_mol.getNumAtoms(); }
+  unsigned int getNumBonds() const { return d_mol.getNumBonds(); }
+  unsigned int getDegree(unsigned int idx) const {
+    return d_mol.getAtomWithIdx(idx)->getDegree();
+  }
+  // calls f(bond index, neighbor index) for each of the atom's bonds
+  template <typename F>
+  void forEachNeighbor(unsigned int idx, F f) const {
+    ROMol::OEDGE_ITER beg, end;
+    boost::tie(beg, end) = d_mol.getAtomBonds(d_mol.getAtomWithIdx(idx));
+    while (beg != end) {
+      const Bond *bond = d_mol[*beg];
+      f(bond->getIdx(), bond->getOtherAtomIdx(idx));
+      ++beg;
+    }
+  }
+  bool hasChiralTag(unsigned int idx) const {
+    return d_mol.getAtomWithIdx(idx)->getChiralTag() != Atom::CHI_UNSPECIFIED;
+  }
+  std::string getCIPCode(unsigned int idx) const {
+    std::string cip = "";
+    d_mol.getAtomWithIdx(idx)->getPropIfPresent(common_properties::_CIPCode,
+                                                cip);
+    return cip;
+  }
 
-  // if we are using chirality, we need to make sure the atoms have R/S labels
-  if (morganArguments->df_includeChirality &&
-      !Chirality::getUseLegacyStereoPerception() &&
-      !mol.hasProp(common_properties::_CIPComputed)) {
-    CIPLabeler::assignCIPLabels(const_cast<ROMol &>(mol));
+ private:
+  const ROMol &d_mol;
+};
+
+class FrozenMolGraph {
+ public:
+  explicit FrozenMolGraph(const FrozenMol &mol) : d_mol(mol) {}
+  unsigned int getNumAtoms() const { return d_mol.getNumAtoms(); }
+  unsigned int getNumBonds() const { return d_mol.getNumBonds(); }
+  unsigned int getDegree(unsigned int idx) const {
+    return d_mol.getDegree(idx);
+  }
+  template <typename F>
+  void forEachNeighbor(unsigned int idx, F f) const {
+    const auto nbrs = d_mol.getAtomNeighbors(idx);
+    const auto bonds = d_mol.getAtomBonds(idx);
+    for (unsigned int i = 0; i < nbrs.size(); ++i) {
+      f(bonds[i], nbrs[i]);
+    }
+  }
+  bool hasChiralTag(unsigned int idx) const {
+    return d_mol.getChiralTags()[idx] != Atom::CHI_UNSPECIFIED;
   }
+  // a FrozenMol has no CIP codes, getEnvironmentIds() doesn't allow
+  // chirality
+  std::string getCIPCode(unsigned int) const { return ""; }
+
+ private:
+  const FrozenMol &d_mol;
+};
+
+// calls addEnvironment(bit id, atom index, layer) for each of the
+// environments of mol
+template <typename OutputType, typename Graph, typename AddEnvironment>
+void findEnvironments(const Graph &mol, const MorganArguments &arguments,
+                      const std::vector<std::uint32_t> *fromAtoms,
+                      const std::vector<std::uint32_t> &atomInvariants,
+                      const std::vector<std::uint32_t> &bondInvariants,
+                      AddEnvironment addEnvironment) {
+  unsigned int nAtoms = mol.getNumAtoms();
+  const unsigned int maxNumResults = (arguments.d_radius + 1) * nAtoms;
 
-  std::vector<OutputType> currentInvariants(atomInvariants->size());
-  std::copy(atomInvariants->begin(), atomInvariants->end(),
+  std::vector<OutputType> currentInvariants(atomInvariants.size());
+  std::copy(atomInvariants.begin(), atomInvariants.end(),
             currentInvariants.begin());
   // will hold bit ids calculated this round to be used as invariants next
   // round
@@ -249,7 +292,7 @@ MorganEnvGenerator<OutputType>::getEnvironments(
   // with zero invariants are processed last so that in case of duplicate
   // environments atoms with non-zero invariants are used
   std::vector<unsigned int> atomOrder(nAtoms);
-  if (morganArguments->df_onlyNonzeroInvariants) {
+  if (arguments.df_onlyNonzeroInvariants) {
     std::vector<std::pair<int32_t, uint32_t>> ordering;
     for (unsigned int i = 0; i < nAtoms; ++i) {
       if (!currentInvariants[i]) {
@@ -271,47 +314,38 @@ MorganEnvGenerator<OutputType>::getEnvironments(
   // add the round 0 invariants to the result
   for (unsigned int i = 0; i < nAtoms; ++i) {
     if (includeAtoms[i]) {
-      if (!morganArguments->df_onlyNonzeroInvariants || currentInvariants[i]) {
-        result.push_back(
-            new MorganAtomEnv<OutputType>(currentInvariants[i], i, 0));
+      if (!arguments.df_onlyNonzeroInvariants || currentInvariants[i]) {
+        addEnvironment(currentInvariants[i], i, 0);
       }
     }
   }
 
   // now do our subsequent rounds:
-  for (unsigned int layer = 0; layer < morganArguments->d_radius; ++layer) {
+  for (unsigned int layer = 0; layer < arguments.d_radius; ++layer) {
     std::vector<AccumTuple> allNeighborhoodsThisRound;
     for (auto atomIdx : atomOrder) {
       // skip atoms which will not generate unique environments
       // (neighborhoods) anymore
       if (!deadAtoms[atomIdx]) {
-        const Atom *tAtom = mol.getAtomWithIdx(atomIdx);
-        if (!tAtom->getDegree()) {
+        if (!mol.getDegree(atomIdx)) {
           deadAtoms.set(atomIdx, 1);
           continue;
         }
 
-        ROMol::OEDGE_ITER beg, end;
-        boost::tie(beg, end) = mol.getAtomBonds(tAtom);
-
         // add up to date invariants of neighbors
         // This should keep capacity, so reallocation only triggers if we
         // haven't seen a molecule of this size.
         neighborhoodInvariants.clear();
 
-        while (beg != end) {
-          const Bond *bond = mol[*beg];
-          roundAtomNeighborhoods[atomIdx][bond->getIdx()] = 1;
-
-          unsigned int oIdx = bond->getOtherAtomIdx(atomIdx);
-          roundAtomNeighborhoods[atomIdx] |= atomNeighborhoods[oIdx];
+        mol.forEachNeighbor(
+            atomIdx, [&](unsigned int bondIdx, unsigned int oIdx) {
+              roundAtomNeighborhoods[atomIdx][bondIdx] = 1;
+              roundAtomNeighborhoods[atomIdx] |= atomNeighborhoods[oIdx];
 
-          auto bt = static_cast<int32_t>((*bondInvariants)[bond->getIdx()]);
-          neighborhoodInvariants.push_back(
-              std::make_pair(bt, currentInvariants[oIdx]));
-
-          ++beg;
-        }
+              auto bt = static_cast<int32_t>(bondInvariants[bondIdx]);
+              neighborhoodInvariants.push_back(
+                  std::make_pair(bt, currentInvariants[oIdx]));
+            });
 
         // sort the neighbor list:
         std::sort(neighborhoodInvariants.begin(), neighborhoodInvariants.end());
@@ -319,7 +353,7 @@ MorganEnvGenerator<OutputType>::getEnvironments(
         // "chiral"
         std::uint32_t invar = layer;
         gboost::hash_combine(invar, currentInvariants[atomIdx]);
-        bool looksChiral = (tAtom->getChiralTag() != Atom::CHI_UNSPECIFIED);
+        bool looksChiral = mol.hasChiralTag(atomIdx);
         for (std::vector<std::pair<int32_t, uint32_t>>::const_iterator it =
                  neighborhoodInvariants.begin();
              it != neighborhoodInvariants.end(); ++it) {
@@ -327,7 +361,7 @@ MorganEnvGenerator<OutputType>::getEnvironments(
           gboost::hash_combine(invar, *it);
 
           // check our "chirality":
-          if (morganArguments->df_includeChirality && looksChiral &&
+          if (arguments.df_includeChirality && looksChiral &&
               !chiralAtoms[atomIdx]) {
             if (it->first != static_cast<int32_t>(Bond::SINGLE)) {
               looksChiral = false;
@@ -338,11 +372,10 @@ MorganEnvGenerator<OutputType>::getEnvironments(
           }
         }
 
-        if (morganArguments->df_includeChirality && looksChiral) {
+        if (arguments.df_includeChirality && looksChiral) {
           chiralAtoms[atomIdx] = 1;
           // add an extra value to the invariant to reflect chirality:
-          std::string cip = "";
-          tAtom->getPropIfPresent(common_properties::_CIPCode, cip);
+          const auto cip = mol.getCIPCode(atomIdx);
           if (cip == "R") {
             gboost::hash_combine(invar, 3);
           } else if (cip == "S") {
@@ -371,13 +404,12 @@ MorganEnvGenerator<OutputType>::getEnvironments(
          iter != allNeighborhoodsThisRound.end(); ++iter) {
       // if we haven't seen this exact environment before, add it to the
       // result
-      if (morganArguments->df_includeRedundantEnvironments ||
+      if (arguments.df_includeRedundantEnvironments ||
           neighborhoods.count(std::get<0>(*iter)) == 0) {
-        if (!morganArguments->df_onlyNonzeroInvariants ||
-            (*atomInvariants)[std::get<2>(*iter)]) {
+        if (!arguments.df_onlyNonzeroInvariants ||
+            atomInvariants[std::get<2>(*iter)]) {
           if (includeAtoms[std::get<2>(*iter)]) {
-            result.push_back(new MorganAtomEnv<OutputType>(
-                std::get<1>(*iter), std::get<2>(*iter), layer + 1));
+            addEnvironment(std::get<1>(*iter), std::get<2>(*iter), layer + 1);
             neighborhoods.insert(std::get<0>(*iter));
           }
         }
@@ -396,7 +428,69 @@ MorganEnvGenerator<OutputType>::getEnvironments(
     // so the radius can grow every iteration
     atomNeighborhoods = roundAtomNeighborhoods;
   }
+}
+}  // namespace
 
+template <typename OutputType>
+std::vector<AtomEnvironment<OutputType> *>
+MorganEnvGenerator<OutputType>::getEnvironments(
+    const ROMol &mol, FingerprintArguments *arguments,
+    const std::vector<std::uint32_t> *fromAtoms,
+    const std::vector<std::uint32_t> *,  // ignoreAtoms
+    const int,                           // confId
+    const AdditionalOutput *,            // additionalOutput
+    const std::vector<std::uint32_t> *atomInvariants,
+    const std::vector<std::uint32_t> *bondInvariants,
+    const bool  // hashResults
+) const {
+  PRECONDITION(atomInvariants && (atomInvariants->size() >= mol.getNumAtoms()),
+               "bad atom invariants size");
+  PRECONDITION(bondInvariants && (bondInvariants->size() >= mol.getNumBonds()),
+               "bad bond invariants size");
+  auto *morganArguments = dynamic_cast<MorganArguments *>(arguments);
+  PRECONDITION(morganArguments, "bad arguments type");
+
+  const unsigned int maxNumResults =
+      (morganArguments->d_radius + 1) * mol.getNumAtoms();
+
+  std::vector<AtomEnvironment<OutputType> *> result =
+      std::vector<AtomEnvironment<OutputType> *>();
+  result.reserve(maxNumResults);
+
+  // if we are using chirality, we need to make sure the atoms have R/S labels
+  if (morganArguments->df_includeChirality &&
+      !Chirality::getUseLegacyStereoPerception() &&
+      !mol.hasProp(common_properties::_CIPComputed)) {
+    CIPLabeler::assignCIPLabels(const_cast<ROMol &>(mol));
+  }
+
+  findEnvironments<OutputType>(
+      ROMolGraph(mol), *morganArguments, fromAtoms, *atomInvariants,
+      *bondInvariants,
+      [&result](OutputType code, unsigned int atomIdx, unsigned int layer) {
+        result.push_back(new MorganAtomEnv<OutputType>(code, atomIdx, layer));
+      });
+  return result;
+}
+
+std::vector<std::uint32_t> getEnvironmentIds(
+    const FrozenMol &mol, const MorganArguments &arguments,
+    const std::vector<std::uint32_t> &atomInvariants,
+    const std::vector<std::uint32_t> &bondInvariants) {
+  PRECONDITION(atomInvariants.size() >= mol.getNumAtoms(),
+               "bad atom invariants size");
+  PRECONDITION(bondInvariants.size() >= mol.getNumBonds(),
+               "bad bond invariants size");
+  PRECONDITION(!arguments.df_includeChirality,
+               "chirality is not supported for FrozenMols");
+
+  std::vector<std::uint32_t> result;
+  result.reserve((arguments.d_radius + 1) * mol.getNumAtoms());
+  findEnvironments<std::uint32_t>(
+      FrozenMolGraph(mol), arguments, nullptr, atomInvariants, bondInvariants,
+      [&result](std::uint32_t code, unsigned int, unsigned int) {
+        result.push_back(code);
+      });
   return result;
 }
 
@@ -16,6 +16,7 @@
 #include <cstdint>
 
 namespace RDKit {
+class FrozenMol;
 
 namespace MorganFingerprint {
 
@@ -202,6 +203,24 @@ class RDKIT_FINGERPRINTS_EXPORT MorganEnvGenerator
   OutputType getResultSize() const override;
 };
 
+/**
+ \brief Returns the bit ids of the Morgan environments of a FrozenMol
+
+ This runs the same loop as MorganEnvGenerator::getEnvironments() does for an
+ ROMol, without creating the environment objects, so the ids are the same as
+ the ones the generator finds for the molecule the FrozenMol was created from.
+
+ \param mol the molecule
+ \param arguments the fingerprint arguments, chirality is not supported
+ \param atomInvariants the atom invariants, for example from
+ MorganFingerprints::getConnectivityInvariants()
+ \param bondInvariants the bond invariants
+ */
+RDKIT_FINGERPRINTS_EXPORT std::vector<std::uint32_t> getEnvironmentIds(
+    const FrozenMol &mol, const MorganArguments &arguments,
+    const std::vector<std::uint32_t> &atomInvariants,
+    const std::vector<std::uint32_t> &bondInvariants);
+
 /**
  \brief Get a fingerprint generator for Morgan fingerprint
 
@@ -802,4 +802,69 @@ TEST_CASE("github #7533: IndexError while computing fingerprint") {
       MorganFingerprints::getFingerprint(*mol, 2));
   REQUIRE(fp);
   CHECK(fp->getLength() == std::numeric_limits<unsigned>::max());
-}
\ No newline at end of file
+}
+TEST_CASE("atom invariants from a FrozenMol") {
+  auto smis = {"CC(=O)[O-]", "[2H]OC([13CH3])c1ccccc1", "C1CC1[NH3+]",
+               "[H]N([H])C", "*C(=O)[U]"};
+  for (const auto smi : smis) {
+    SmilesParserParams ps;
+    ps.removeHs = false;
+    std::unique_ptr<RWMol> mol(SmilesToMol(smi, ps));
+    REQUIRE(mol);
+    FrozenMol frozen(*mol);
+    for (auto includeRingMembership : {false, true}) {
+      std::vector<std::uint32_t> invars(mol->getNumAtoms());
+      std::vector<std::uint32_t> frozenInvars(mol->getNumAtoms());
+      MorganFingerprints::getConnectivityInvariants(*mol, invars,
+                                                    includeRingMembership);
+      MorganFingerprints::getConnectivityInvariants(frozen, frozenInvars,
+                                                    includeRingMembership);
+      CHECK(frozenInvars == invars);
+    }
+    std::vector<std::uint32_t> invars;
+    std::vector<std::uint32_t> frozenInvars;
+    RDKitFPUtils::buildDefaultRDKitFingerprintAtomInvariants(*mol, invars);
+    RDKitFPUtils::buildDefaultRDKitFingerprintAtomInvariants(frozen,
+                                                             frozenInvars);
+    CHECK(frozenInvars == invars);
+  }
+}
+
+TEST_CASE("Morgan fingerprints of a FrozenMol") {
+  auto smis = {"CC(=O)[O-]", "[2H]OC([13CH3])c1ccccc1", "C1CC1[NH3+]",
+               "c1ccc2ccccc2c1CC(=O)N", "C/C=C/C.[Na+].[Cl-]", "C1CC2CCC1C2"};
+  for (const auto smi : smis) {
+    std::unique_ptr<RWMol> mol(SmilesToMol(smi));
+    REQUIRE(mol);
+    FrozenMol frozen(*mol);
+    for (auto radius : {0u, 1u, 3u}) {
+      for (auto useBondTypes : {false, true}) {
+        for (auto useCounts : {false, true}) {
+          std::unique_ptr<SparseIntVect<std::uint32_t>> fp(
+              MorganFingerprints::getFingerprint(*mol, radius, nullptr,
+                                                 nullptr, false, useBondTypes,
+                                                 useCounts));
+          std::unique_ptr<SparseIntVect<std::uint32_t>> frozenFp(
+              MorganFingerprints::getFingerprint(frozen, radius, useBondTypes,
+                                                 useCounts));
+          CHECK(*frozenFp == *fp);
+        }
+        std::unique_ptr<SparseIntVect<std::uint32_t>> hashed(
+            MorganFingerprints::getHashedFingerprint(
+                *mol, radius, 1024, nullptr, nullptr, false, useBondTypes,
+                false, nullptr, true));
+        std::unique_ptr<SparseIntVect<std::uint32_t>> frozenHashed(
+            MorganFingerprints::getHashedFingerprint(frozen, radius, 1024,
+                                                     useBondTypes, true));
+        CHECK(*frozenHashed == *hashed);
+        std::unique_ptr<ExplicitBitVect> bv(
+            MorganFingerprints::getFingerprintAsBitVect(
+                *mol, radius, 512, nullptr, nullptr, false, useBondTypes));
+        std::unique_ptr<ExplicitBitVect> frozenBv(
+            MorganFingerprints::getFingerprintAsBitVect(frozen, radius, 512,
+                                                        useBondTypes));
+        CHECK(*frozenBv == *bv);
+      }
+    }
+  }
+}
@@ -0,0 +1,86 @@
+//
+//  Copyright (C) 2025 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include <algorithm>
+
+#include <GraphMol/RDKitBase.h>
+#include <GraphMol/MolPickler.h>
+
+#include "FrozenMol.h"
+
+namespace RDKit {
+namespace {
+std::uint8_t clampToByte(unsigned int val) {
+  return static_cast<std::uint8_t>(std::min(val, 255u));
+}
+}  // namespace
+
+FrozenMol::FrozenMol(const ROMol &mol) {
+  if (!mol.getRingInfo()->isInitialized()) {
+    MolOps::findSSSR(mol);
+  }
+  const auto *ringInfo = mol.getRingInfo();
+
+  const auto nAtoms = mol.getNumAtoms();
+  d_atomicNums.reserve(nAtoms);
+  d_formalCharges.reserve(nAtoms);
+  d_isotopes.reserve(nAtoms);
+  d_totalNumHs.reserve(nAtoms);
+  d_atomIsAromatic.reserve(nAtoms);
+  d_chiralTags.reserve(nAtoms);
+  d_atomNumRings.reserve(nAtoms);
+  d_atomMinRingSizes.reserve(nAtoms);
+  d_nbrOffsets.reserve(nAtoms + 1);
+  d_nbrAtoms.reserve(2 * mol.getNumBonds());
+  d_nbrBonds.reserve(2 * mol.getNumBonds());
+  for (const auto atom : mol.atoms()) {
+    const auto idx = atom->getIdx();
+    d_atomicNums.push_back(static_cast<std::uint8_t>(atom->getAtomicNum()));
+    d_formalCharges.push_back(
+        static_cast<std::int8_t>(atom->getFormalCharge()));
+    d_isotopes.push_back(static_cast<std::uint16_t>(atom->getIsotope()));
+    d_totalNumHs.push_back(clampToByte(atom->getTotalNumHs()));
+    d_atomIsAromatic.push_back(atom->getIsAromatic());
+    d_chiralTags.push_back(static_cast<std::uint8_t>(atom->getChiralTag()));
+    d_atomNumRings.push_back(clampToByte(ringInfo->numAtomRings(idx)));
+    d_atomMinRingSizes.push_back(clampToByte(ringInfo->minAtomRingSize(idx)));
+    for (const auto bond : mol.atomBonds(atom)) {
+      d_nbrAtoms.push_back(bond->getOtherAtomIdx(idx));
+      d_nbrBonds.push_back(bond->getIdx());
+    }
+    d_nbrOffsets.push_back(rdcast<std::uint32_t>(d_nbrAtoms.size()));
+  }
+
+  const auto nBonds = mol.getNumBonds();
+  d_bondTypes.reserve(nBonds);
+  d_bondBeginAtoms.reserve(nBonds);
+  d_bondEndAtoms.reserve(nBonds);
+  d_bondIsAromatic.reserve(nBonds);
+  d_bondStereos.reserve(nBonds);
+  d_bondNumRings.reserve(nBonds);
+  for (const auto bond : mol.bonds()) {
+    d_bondTypes.push_back(static_cast<std::uint8_t>(bond->getBondType()));
+    d_bondBeginAtoms.push_back(bond->getBeginAtomIdx());
+    d_bondEndAtoms.push_back(bond->getEndAtomIdx());
+    d_bondIsAromatic.push_back(bond->getIsAromatic());
+    d_bondStereos.push_back(static_cast<std::uint8_t>(bond->getStereo()));
+    d_bondNumRings.push_back(
+        clampToByte(ringInfo->numBondRings(bond->getIdx())));
+  }
+}
+
+FrozenMol FrozenMol::fromPickle(const std::string &pickle) {
+  // none of the properties are needed, so don't bother decoding them
+  ROMol mol;
+  MolPickler::molFromPickle(pickle, mol,
+                            PicklerOps::PropertyPickleOptions::NoProps);
+  return FrozenMol(mol);
+}
+
+}  // namespace RDKit
@@ -0,0 +1,175 @@
+//
+//  Copyright (C) 2025 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include <RDGeneral/export.h>
+#ifndef RD_FROZENMOL_H
+#define RD_FROZENMOL_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <RDGeneral/Invariant.h>
+
+namespace RDKit {
+class ROMol;
+
+//! a read-only, flat snapshot of a molecule's atoms, bonds and rings
+/*!
+  The atom and bond properties which are needed by most fingerprinting and
+  descriptor code are stored in contiguous arrays indexed by atom or bond
+  index, and the neighbors of the atoms are stored in compressed sparse row
+  form. Walking these arrays is much friendlier to the cache than following
+  the Atom and Bond pointers in an ROMol, which is what matters when
+  scoring large numbers of molecules.
+
+  A FrozenMol doesn't refer back to the molecule it was created from, and it
+  can't be modified. Only a few algorithms accept one, and they give the
+  same results as their ROMol versions:
+   - Descriptors::calcTPSA() and Descriptors::getTPSAAtomContribs()
+   - MorganFingerprints::getFingerprint(), getHashedFingerprint() and
+     getFingerprintAsBitVect(), with the default atom invariants and without
+     chirality, and MorganFingerprint::getEnvironmentIds()
+   - MorganFingerprints::getConnectivityInvariants() and
+     RDKitFPUtils::buildDefaultRDKitFingerprintAtomInvariants()
+
+  Everything else, including the fingerprint generators, the RDKit and
+  pattern fingerprints and Crippen, needs an ROMol.
+
+  The neighbors of each atom are in the same order as ROMol::getAtomBonds()
+  returns them.
+*/
+class RDKIT_GRAPHMOL_EXPORT FrozenMol {
+ public:
+  FrozenMol() = default;
+  //! creates a snapshot of a molecule
+  /*!
+    The molecule must have had its implicit valences calculated (this is
+    done during sanitization). If the ring information has not been
+    initialized, the SSSR is found.
+  */
+  explicit FrozenMol(const ROMol &mol);
+  //! creates a snapshot of a molecule from a MolPickler pickle
+  /*!
+    This is a convenience: the pickle is decoded into a temporary ROMol,
+    without its properties, and the snapshot is taken from that.
+  */
+  static FrozenMol fromPickle(const std::string &pickle);
+
+  unsigned int getNumAtoms() const {
+    return rdcast<unsigned int>(d_atomicNums.size());
+  }
+  unsigned int getNumBonds() const {
+    return rdcast<unsigned int>(d_bondTypes.size());
+  }
+
+  //! \name Atom properties, indexed by atom index
+  //! @{
+  std::span<const std::uint8_t> getAtomicNums() const { return d_atomicNums; }
+  std::span<const std::int8_t> getFormalCharges() const {
+    return d_formalCharges;
+  }
+  std::span<const std::uint16_t> getIsotopes() const { return d_isotopes; }
+  //! the explicit and implicit Hs, not counting H neighbors
+  std::span<const std::uint8_t> getTotalNumHs() const { return d_totalNumHs; }
+  std::span<const std::uint8_t> getAtomIsAromatic() const {
+    return d_atomIsAromatic;
+  }
+  //! Atom::ChiralType values
+  std::span<const std::uint8_t> getChiralTags() const { return d_chiralTags; }
+  //! the number of SSSR rings each atom is in
+  std::span<const std::uint8_t> getAtomNumRings() const {
+    return d_atomNumRings;
+  }
+  //! the size of the smallest ring each atom is in, 0 for atoms not in rings
+  std::span<const std::uint8_t> getAtomMinRingSizes() const {
+    return d_atomMinRingSizes;
+  }
+  //! @}
+
+  //! \name Bond properties, indexed by bond index
+  //! @{
+  //! Bond::BondType values
+  std::span<const std::uint8_t> getBondTypes() const { return d_bondTypes; }
+  std::span<const std::uint32_t> getBondBeginAtoms() const {
+    return d_bondBeginAtoms;
+  }
+  std::span<const std::uint32_t> getBondEndAtoms() const {
+    return d_bondEndAtoms;
+  }
+  std::span<const std::uint8_t> getBondIsAromatic() const {
+    return d_bondIsAromatic;
+  }
+  //! Bond::BondStereo values
+  std::span<const std::uint8_t> getBondStereos() const {
+    return d_bondStereos;
+  }
+  //! the number of SSSR rings each bond is in
+  std::span<const std::uint8_t> getBondNumRings() const {
+    return d_bondNumRings;
+  }
+  //! @}
+
+  //! \name Connectivity
+  //! @{
+  //! the number of explicit neighbors of an atom
+  unsigned int getDegree(unsigned int idx) const {
+    PRECONDITION(idx < getNumAtoms(), "atom index out of range");
+    return d_nbrOffsets[idx + 1] - d_nbrOffsets[idx];
+  }
+  //! the indices of an atom's neighbors
+  std::span<const std::uint32_t> getAtomNeighbors(unsigned int idx) const {
+    PRECONDITION(idx < getNumAtoms(), "atom index out of range");
+    return std::span<const std::uint32_t>(d_nbrAtoms).subspan(
+        d_nbrOffsets[idx], getDegree(idx));
+  }
+  //! the indices of an atom's bonds, in the same order as its neighbors
+  std::span<const std::uint32_t> getAtomBonds(unsigned int idx) const {
+    PRECONDITION(idx < getNumAtoms(), "atom index out of range");
+    return std::span<const std::uint32_t>(d_nbrBonds).subspan(
+        d_nbrOffsets[idx], getDegree(idx));
+  }
+  //! the CSR offsets: the neighbors of atom i are at positions
+  //! [offsets[i], offsets[i+1]) of the neighbor and bond arrays
+  std::span<const std::uint32_t> getNeighborOffsets() const {
+    return d_nbrOffsets;
+  }
+  std::span<const std::uint32_t> getNeighborAtoms() const {
+    return d_nbrAtoms;
+  }
+  std::span<const std::uint32_t> getNeighborBonds() const {
+    return d_nbrBonds;
+  }
+  //! @}
+
+ private:
+  std::vector<std::uint8_t> d_atomicNums;
+  std::vector<std::int8_t> d_formalCharges;
+  std::vector<std::uint16_t> d_isotopes;
+  std::vector<std::uint8_t> d_totalNumHs;
+  std::vector<std::uint8_t> d_atomIsAromatic;
+  std::vector<std::uint8_t> d_chiralTags;
+  std::vector<std::uint8_t> d_atomNumRings;
+  std::vector<std::uint8_t> d_atomMinRingSizes;
+
+  std::vector<std::uint8_t> d_bondTypes;
+  std::vector<std::uint32_t> d_bondBeginAtoms;
+  std::vector<std::uint32_t> d_bondEndAtoms;
+  std::vector<std::uint8_t> d_bondIsAromatic;
+  std::vector<std::uint8_t> d_bondStereos;
+  std::vector<std::uint8_t> d_bondNumRings;
+
+  std::vector<std::uint32_t> d_nbrOffsets{0};
+  std::vector<std::uint32_t> d_nbrAtoms;
+  std::vector<std::uint32_t> d_nbrBonds;
+};
+}  // namespace RDKit
+
+#endif
@@ -16,11 +16,14 @@
 #include <GraphMol/SubstanceGroup.h>
 #include <RDGeneral/utils.h>
 #include <RDGeneral/RDLog.h>
+#include <RDGeneral/Exceptions.h>
 #include <RDGeneral/StreamOps.h>
 #include <RDGeneral/types.h>
 #include <DataStructs/DatastructsStreamOps.h>
 #include <Query/QueryObjects.h>
+#include <algorithm>
 #include <map>
+#include <cmath>
 #include <cstdint>
 #include <boost/algorithm/string.hpp>
 
@@ -34,7 +37,7 @@ using std::uint32_t;
 namespace RDKit {
 
 const int32_t MolPickler::versionMajor = 16;
-const int32_t MolPickler::versionMinor = 2;
+const int32_t MolPickler::versionMinor = 4;
 const int32_t MolPickler::versionPatch = 0;
 const int32_t MolPickler::endianId = 0xDEADBEEF;
 
@@ -75,6 +78,7 @@ void streamReadPositiveChar(std::istream &ss, char &res, int version) {
 
 namespace {
 static unsigned int defaultProperties = PicklerOps::NoProps;
+static double coordinatePrecision = 0.001;
 static CustomPropHandlerVec defaultPropHandlers = {};
 
 #ifdef RDK_BUILD_THREADSAFE_SSS
@@ -104,6 +108,38 @@ void write_sstream_to_stream(std::ostream &outStream,
   outStream.write(ts.c_str(), sizeof(char) * tmpInt);
 }
 
+// quantized coordinates are stored as zigzag-encoded LEB128 varints, so the
+// small differences between the positions of neighboring atoms only take one
+// or two bytes
+void appendVarInt(std::string &buf, std::int64_t val) {
+  auto zz = (static_cast<std::uint64_t>(val) << 1) ^
+            static_cast<std::uint64_t>(val >> 63);
+  while (zz >= 0x80) {
+    buf.push_back(static_cast<char>((zz & 0x7F) | 0x80));
+    zz >>= 7;
+  }
+  buf.push_back(static_cast<char>(zz));
+}
+
+std::int64_t readVarInt(const char *&ptr, const char *end) {
+  std::uint64_t zz = 0;
+  for (unsigned int shift = 0; shift < 64; shift += 7) {
+    if (ptr == end) {
+      throw MolPicklerException("Bad pickle format: truncated coordinates");
+    }
+    auto byte = static_cast<unsigned char>(*ptr++);
+    zz |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return static_cast<std::int64_t>((zz >> 1) ^ (~(zz & 1) + 1));
+    }
+  }
+  throw MolPicklerException("Bad pickle format: bad coordinate value");
+}
+
+// keeps the quantized values, and the differences between them, well within
+// the range of an int64
+const double maxQuantizedCoord = 1e15;
+
 }  // namespace
 
 void MolPickler::_pickleProperties(std::ostream &ss, const RDProps &props,
@@ -279,6 +315,21 @@ void MolPickler::setDefaultPickleProperties(unsigned int props) {
   defaultProperties = props;
 }
 
+double MolPickler::getCoordinatePrecision() {
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  std::lock_guard<std::mutex> lock(GetPropMutex());
+#endif
+  return coordinatePrecision;
+}
+
+void MolPickler::setCoordinatePrecision(double precision) {
+  PRECONDITION(precision > 0 && std::isfinite(precision), "bad precision");
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  std::lock_guard<std::mutex> lock(GetPropMutex());
+#endif
+  coordinatePrecision = precision;
+}
+
 const CustomPropHandlerVec &MolPickler::getCustomPropHandlers() {
 #ifdef RDK_BUILD_THREADSAFE_SSS
   std::lock_guard<std::mutex> lock(GetPropMutex());
@@ -1040,6 +1091,12 @@ void MolPickler::pickleMol(const ROMol &mol, std::string &ss) {
 // will be blown out by the end of this process.
 void MolPickler::molFromPickle(std::istream &ss, ROMol *mol,
                                unsigned int propertyFlags) {
+  _molFromPickle(ss, mol, propertyFlags, nullptr);
+}
+
+void MolPickler::_molFromPickle(std::istream &ss, ROMol *mol,
+                                unsigned int propertyFlags,
+                                const std::vector<unsigned int> *confIdxs) {
   PRECONDITION(mol, "empty molecule");
 
   // Ensure that the exception state of the `istream` is reset to the previous
@@ -1089,10 +1146,11 @@ void MolPickler::molFromPickle(std::istream &ss, ROMol *mol,
       int32_t numAtoms;
       streamRead(ss, numAtoms, majorVersion);
       if (numAtoms > 255) {
-        _depickle<int32_t>(ss, mol, majorVersion, numAtoms, propertyFlags);
+        _depickle<int32_t>(ss, mol, majorVersion, numAtoms, propertyFlags,
+                           confIdxs);
       } else {
         _depickle<unsigned char>(ss, mol, majorVersion, numAtoms,
-                                 propertyFlags);
+                                 propertyFlags, confIdxs);
       }
     }
     mol->clearAllAtomBookmarks();
@@ -1119,12 +1177,56 @@ void MolPickler::molFromPickle(std::istream &ss, ROMol *mol,
 void MolPickler::molFromPickle(const std::string &pickle, ROMol *mol,
                                unsigned int propertyFlags) {
   PRECONDITION(mol, "empty molecule");
-  std::stringstream ss(std::ios_base::binary | std::ios_base::out |
-                       std::ios_base::in);
-  ss.write(pickle.c_str(), pickle.length());
+  // read the pickle in place instead of copying it into a stringstream
+  MemoryStreamBuf buf(pickle.data(), pickle.size());
+  std::istream ss(&buf);
   MolPickler::molFromPickle(ss, mol, propertyFlags);
 }
 
+std::unique_ptr<Conformer> MolPickler::conformerFromPickle(
+    const std::string &pickle, unsigned int confIdx) {
+  auto res = conformersFromPickle(pickle, {confIdx});
+  return std::move(res.front());
+}
+
+std::vector<std::unique_ptr<Conformer>> MolPickler::conformersFromPickle(
+    const std::string &pickle, const std::vector<unsigned int> &confIdxs) {
+  std::vector<unsigned int> wanted(confIdxs);
+  std::sort(wanted.begin(), wanted.end());
+  wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+
+  MemoryStreamBuf buf(pickle.data(), pickle.size());
+  std::istream ss(&buf);
+  ROMol mol;
+  _molFromPickle(ss, &mol, PicklerOps::MolProps | PicklerOps::NoSubstanceGroups,
+                 &wanted);
+  // the decoded conformers are in the order of their indices
+  if (mol.getNumConformers() != wanted.size()) {
+    throw IndexErrorException(rdcast<int>(wanted[mol.getNumConformers()]));
+  }
+  std::vector<const Conformer *> decoded;
+  for (auto cit = mol.beginConformers(); cit != mol.endConformers(); ++cit) {
+    decoded.push_back(cit->get());
+  }
+
+  std::vector<std::unique_ptr<Conformer>> res;
+  res.reserve(confIdxs.size());
+  for (auto confIdx : confIdxs) {
+    const auto &conf = *decoded[std::lower_bound(wanted.begin(), wanted.end(),
+                                                 confIdx) -
+                                wanted.begin()];
+    // copy the positions and properties over to a conformer which doesn't
+    // know about the scratch molecule
+    auto detached = std::make_unique<Conformer>();
+    detached->getPositions() = conf.getPositions();
+    detached->setId(conf.getId());
+    detached->set3D(conf.is3D());
+    static_cast<RDProps &>(*detached) = conf;
+    res.push_back(std::move(detached));
+  }
+  return res;
+}
+
 //--------------------------------------
 //
 //            Molecules
@@ -1202,15 +1304,18 @@ void MolPickler::_pickle(const ROMol *mol, std::ostream &ss,
   //
   // -------------------
   const auto &sgroups = getSubstanceGroups(*mol);
-  if (!sgroups.empty()) {
+  if (!sgroups.empty() && !(propertyFlags & PicklerOps::NoSubstanceGroups)) {
     streamWrite(ss, BEGINSGROUP);
 
+    // the SubstanceGroups are written as a block so that they can be skipped
+    std::stringstream tss;
     tmpInt = static_cast<int32_t>(sgroups.size());
-    streamWrite(ss, tmpInt);
+    streamWrite(tss, tmpInt);
 
     for (const auto &sgroup : sgroups) {
-      _pickleSubstanceGroup<T>(ss, sgroup, atomIdxMap, bondIdxMap);
+      _pickleSubstanceGroup<T>(tss, sgroup, atomIdxMap, bondIdxMap);
     }
+    write_sstream_to_stream(ss, tss);
   }
   // Write Stereo Groups
   {
@@ -1223,7 +1328,20 @@ void MolPickler::_pickle(const ROMol *mol, std::ostream &ss,
 
   if (!(propertyFlags & PicklerOps::NoConformers)) {
     std::stringstream tss;
-    if (propertyFlags & PicklerOps::CoordsAsDouble) {
+    if (propertyFlags & PicklerOps::CoordsQuantized) {
+      // each conformer is written as a block of its own so that readers can
+      // skip the ones they don't want
+      streamWrite(ss, BEGINCONFS_QUANTIZED);
+      tmpInt = static_cast<int32_t>(mol->getNumConformers());
+      streamWrite(tss, tmpInt);
+      const auto precision = getCoordinatePrecision();
+      streamWrite(tss, precision);
+      for (auto ci = mol->beginConformers(); ci != mol->endConformers(); ++ci) {
+        std::stringstream css;
+        _pickleQuantizedConformer<T>(css, ci->get(), precision);
+        write_sstream_to_stream(tss, css);
+      }
+    } else if (propertyFlags & PicklerOps::CoordsAsDouble) {
       // pickle the conformations
       streamWrite(ss, BEGINCONFS_DOUBLE);
       tmpInt = static_cast<int32_t>(mol->getNumConformers());
@@ -1295,7 +1413,8 @@ void MolPickler::_pickle(const ROMol *mol, std::ostream &ss,
 
 template <typename T>
 void MolPickler::_depickle(std::istream &ss, ROMol *mol, int version,
-                           int numAtoms, unsigned int propertyFlags) {
+                           int numAtoms, unsigned int propertyFlags,
+                           const std::vector<unsigned int> *confIdxs) {
   PRECONDITION(mol, "empty molecule");
   bool directMap = mol->getNumAtoms() == 0;
   Tags tag;
@@ -1397,12 +1516,22 @@ void MolPickler::_depickle(std::istream &ss, ROMol *mol, int version,
   // -------------------
 
   if (tag == BEGINSGROUP) {
-    streamRead(ss, tmpInt, version);
+    int32_t blkSize = 0;
+    if (version >= 16030) {
+      streamRead(ss, blkSize, version);
+    }
+    if (version >= 16030 && (propertyFlags & PicklerOps::NoSubstanceGroups)) {
+      ss.seekg(blkSize, std::ios_base::cur);
+    } else {
+      streamRead(ss, tmpInt, version);
 
-    // Create SubstanceGroups
-    for (int i = 0; i < tmpInt; ++i) {
-      auto sgroup = _getSubstanceGroupFromPickle<T>(ss, mol, version);
-      addSubstanceGroup(*mol, sgroup);
+      // Create SubstanceGroups
+      for (int i = 0; i < tmpInt; ++i) {
+        auto sgroup = _getSubstanceGroupFromPickle<T>(ss, mol, version);
+        if (!(propertyFlags & PicklerOps::NoSubstanceGroups)) {
+          addSubstanceGroup(*mol, sgroup);
+        }
+      }
     }
 
     streamRead(ss, tag, version);
@@ -1413,7 +1542,8 @@ void MolPickler::_depickle(std::istream &ss, ROMol *mol, int version,
     streamRead(ss, tag, version);
   }
 
-  if (tag == BEGINCONFS || tag == BEGINCONFS_DOUBLE) {
+  if (tag == BEGINCONFS || tag == BEGINCONFS_DOUBLE ||
+      tag == BEGINCONFS_QUANTIZED) {
     int32_t blkSize = 0;
     if (version >= 13000) {
       streamRead(ss, blkSize, version);
@@ -1425,16 +1555,38 @@ void MolPickler::_depickle(std::istream &ss, ROMol *mol, int version,
     } else {
       // read in the conformation
       streamRead(ss, tmpInt, version);
-      std::vector<unsigned int> cids(tmpInt);
+      double precision = 0.0;
+      if (tag == BEGINCONFS_QUANTIZED) {
+        streamRead(ss, precision, version);
+      }
+      // the conformers we decoded, nullptr for the ones which were skipped
+      std::vector<Conformer *> confs(tmpInt, nullptr);
       for (auto i = 0; i < tmpInt; i++) {
+        const bool keep =
+            !confIdxs || std::binary_search(confIdxs->begin(),
+                                            confIdxs->end(),
+                                            static_cast<unsigned int>(i));
         Conformer *conf;
-        if (tag == BEGINCONFS) {
+        if (tag == BEGINCONFS_QUANTIZED) {
+          int32_t confBlkSize;
+          streamRead(ss, confBlkSize, version);
+          if (!keep) {
+            ss.seekg(confBlkSize, std::ios_base::cur);
+            continue;
+          }
+          conf = _quantizedConformerFromPickle<T>(ss, confBlkSize, precision,
+                                                  version);
+        } else if (tag == BEGINCONFS) {
           conf = _conformerFromPickle<T, float>(ss, version);
         } else {
           conf = _conformerFromPickle<T, double>(ss, version);
         }
+        if (!keep) {
+          delete conf;
+          continue;
+        }
         mol->addConformer(conf);
-        cids[i] = conf->getId();
+        confs[i] = conf;
       }
       streamRead(ss, tag, version);
       if (tag == BEGINCONFPROPS) {
@@ -1445,8 +1597,13 @@ void MolPickler::_depickle(std::istream &ss, ROMol *mol, int version,
         if (version >= 13000 && !(propertyFlags & PicklerOps::MolProps)) {
           ss.seekg(blkSize, std::ios_base::cur);
         } else {
-          for (auto cid : cids) {
-            _unpickleProperties(ss, mol->getConformer(cid), version);
+          for (auto conf : confs) {
+            if (conf) {
+              _unpickleProperties(ss, *conf, version);
+            } else {
+              RDProps skipped;
+              _unpickleProperties(ss, skipped, version);
+            }
           }
         }
         streamRead(ss, tag, version);
@@ -1530,13 +1687,13 @@ void MolPickler::_depickle(std::istream &ss, ROMol *mol, int version,
 namespace {
 bool getAtomMapNumber(const Atom *atom, int &mapNum) {
   PRECONDITION(atom, "bad atom");
-  if (!atom->hasProp(common_properties::molAtomMapNumber)) {
+  if (!atom->hasProp(common_properties::keys::molAtomMapNumber)) {
     return false;
   }
   bool res = true;
   int tmpInt;
   try {
-    atom->getProp(common_properties::molAtomMapNumber, tmpInt);
+    atom->getProp(common_properties::keys::molAtomMapNumber, tmpInt);
   } catch (std::bad_any_cast &) {
     const std::string &tmpSVal =
         atom->getProp<std::string>(common_properties::molAtomMapNumber);
@@ -1762,6 +1919,82 @@ void MolPickler::_pickleConformer(std::ostream &ss, const Conformer *conf) {
   }
 }
 
+template <typename T>
+void MolPickler::_pickleQuantizedConformer(std::ostream &ss,
+                                           const Conformer *conf,
+                                           double precision) {
+  PRECONDITION(conf, "empty conformer");
+  char tmpChr = static_cast<int>(conf->is3D());
+  streamWrite(ss, tmpChr);
+  auto tmpInt = static_cast<int32_t>(conf->getId());
+  streamWrite(ss, tmpInt);
+  T tmpT = static_cast<T>(conf->getNumAtoms());
+  streamWrite(ss, tmpT);
+  // each coordinate is stored as the difference from the same coordinate of
+  // the previous atom
+  std::string buf;
+  buf.reserve(6 * conf->getNumAtoms());
+  std::int64_t prev[3] = {0, 0, 0};
+  for (const auto &pt : conf->getPositions()) {
+    const double coords[3] = {pt.x, pt.y, pt.z};
+    for (unsigned int i = 0; i < 3; ++i) {
+      const auto val = coords[i] / precision;
+      if (!(std::fabs(val) < maxQuantizedCoord)) {
+        throw MolPicklerException("coordinate cannot be quantized");
+      }
+      const std::int64_t quantized = std::llround(val);
+      appendVarInt(buf, quantized - prev[i]);
+      prev[i] = quantized;
+    }
+  }
+  ss.write(buf.data(), buf.size());
+}
+
+template <typename T>
+Conformer *MolPickler::_quantizedConformerFromPickle(std::istream &ss,
+                                                     int32_t blkSize,
+                                                     double precision,
+                                                     int version) {
+  char tmpChr;
+  streamRead(ss, tmpChr, version);
+  int32_t tmpInt;
+  streamRead(ss, tmpInt, version);
+  auto cid = static_cast<unsigned int>(tmpInt);
+  T tmpT;
+  streamRead(ss, tmpT, version);
+  auto numAtoms = static_cast<unsigned int>(tmpT);
+  const auto headerSize = static_cast<int32_t>(sizeof(char) + sizeof(int32_t) +
+                                               sizeof(T));
+  if (blkSize < headerSize || !(precision > 0)) {
+    throw MolPicklerException("Bad pickle format: bad quantized conformer");
+  }
+  std::string buf(blkSize - headerSize, '\0');
+  ss.read(buf.data(), buf.size());
+  if (ss.gcount() != static_cast<std::streamsize>(buf.size())) {
+    throw MolPicklerException(
+        "Bad pickle format: unexpected End-of-File while reading");
+  }
+
+  std::unique_ptr<Conformer> conf(new Conformer(numAtoms));
+  conf->setId(cid);
+  conf->set3D(static_cast<bool>(tmpChr));
+  const char *ptr = buf.data();
+  const char *end = ptr + buf.size();
+  // unsigned arithmetic so that corrupt pickles can't overflow
+  std::uint64_t prev[3] = {0, 0, 0};
+  for (auto &pt : conf->getPositions()) {
+    for (unsigned int i = 0; i < 3; ++i) {
+      prev[i] += static_cast<std::uint64_t>(readVarInt(ptr, end));
+      pt[i] = static_cast<double>(static_cast<std::int64_t>(prev[i])) *
+              precision;
+    }
+  }
+  if (ptr != end) {
+    throw MolPicklerException("Bad pickle format: bad quantized conformer");
+  }
+  return conf.release();
+}
+
 template <typename T, typename C>
 Conformer *MolPickler::_conformerFromPickle(std::istream &ss, int version) {
   C tmpFloat;
@@ -1913,7 +2146,7 @@ Atom *MolPickler::_addAtomFromPickle(std::istream &ss, ROMol *mol,
         int32_t tmpInt;
         streamRead(ss, tmpChar, version);
         tmpInt = tmpChar;
-        atom->setProp(common_properties::molAtomMapNumber, tmpInt);
+        atom->setProp(common_properties::keys::molAtomMapNumber, tmpInt);
       } else {
         ss.seekg(sPos);
       }
@@ -1942,7 +2175,7 @@ Atom *MolPickler::_addAtomFromPickle(std::istream &ss, ROMol *mol,
         } else {
           tmpInt = tmpChar;
         }
-        atom->setProp(common_properties::molAtomMapNumber, tmpInt);
+        atom->setProp(common_properties::keys::molAtomMapNumber, tmpInt);
       }
       if (hasDummyLabel) {
         streamRead(ss, tag, version);
@@ -16,14 +16,17 @@
 #include <GraphMol/QueryAtom.h>
 #include <GraphMol/Bond.h>
 #include <GraphMol/QueryBond.h>
+#include <GraphMol/Conformer.h>
 #include <RDGeneral/StreamOps.h>
 #include <boost/utility/binary.hpp>
 #include <boost/variant.hpp>
 #include <Query/QueryObjects.h>
 
 // Std stuff
+#include <memory>
 #include <string>
 #include <sstream>
+#include <vector>
 #include <exception>
 #ifdef WIN32
 #include <ios>
@@ -59,7 +62,11 @@ BETTER_ENUM(
     AllProps = 0x0000FFFF,        // all data pickled
     CoordsAsDouble = 0x00010000,  // save coordinates in double precision
     NoConformers =
-        0x00020000  // do not include conformers or associated properties
+        0x00020000,  // do not include conformers or associated properties
+    NoSubstanceGroups = 0x00040000,  // do not include SubstanceGroups
+    CoordsQuantized =
+        0x00080000  // save quantized, delta-encoded coordinates (see
+                    // MolPickler::setCoordinatePrecision())
 );
 }  // namespace PicklerOps
 
@@ -147,6 +154,7 @@ class RDKIT_GRAPHMOL_EXPORT MolPickler {
     BEGINFINDOTHERORUNKNOWN,
     QUERY_PROPERTY,
     QUERY_PROPERTY_WITH_VALUE,
+    BEGINCONFS_QUANTIZED,
     // add new entries above here
     INVALID_TAG = 255
   } Tags;
@@ -154,6 +162,19 @@ class RDKIT_GRAPHMOL_EXPORT MolPickler {
   static unsigned int getDefaultPickleProperties();
   static void setDefaultPickleProperties(unsigned int);
 
+  //! the precision (in Angstrom) of coordinates pickled with
+  //! PicklerOps::CoordsQuantized, defaults to 0.001
+  static double getCoordinatePrecision();
+  //! sets the precision of coordinates pickled with
+  //! PicklerOps::CoordsQuantized
+  /*!
+    Coordinates are rounded to the nearest multiple of \c precision and each
+    atom's position is stored as the difference from the previous atom's,
+    which typically takes about 6 bytes per atom instead of 12 at the default
+    precision.
+  */
+  static void setCoordinatePrecision(double precision);
+
   static const CustomPropHandlerVec &getCustomPropHandlers();
   static void addCustomPropHandler(const CustomPropHandler &handler);
 
@@ -180,6 +201,16 @@ class RDKIT_GRAPHMOL_EXPORT MolPickler {
   }
 
   //! constructs a molecule from a pickle stored in a string
+  /*!
+    \param propertyFlags controls which optional parts of the pickle are
+    decoded: properties which aren't in the flags are skipped, as are
+    conformers with PicklerOps::NoConformers and SubstanceGroups with
+    PicklerOps::NoSubstanceGroups. These parts are stored as blocks, so
+    skipping them is nearly free (SubstanceGroups in pickles older than
+    version 16.3 are decoded and then dropped). Decoding only the molecular
+    graph, e.g. for substructure matching, is much faster than decoding
+    everything.
+  */
   static void molFromPickle(const std::string &pickle, ROMol *mol,
                             unsigned int propertyFlags);
   static void molFromPickle(const std::string &pickle, ROMol &mol,
@@ -195,6 +226,34 @@ class RDKIT_GRAPHMOL_EXPORT MolPickler {
                               PicklerOps::PropertyPickleOptions::AllProps);
   }
 
+  //! decodes a single conformer from a pickle
+  /*!
+    \param confIdx the index (not the ID) of the conformer in the molecule
+
+    The molecular graph is decoded, but the other conformers aren't. Those
+    pickled with PicklerOps::CoordsQuantized are skipped without looking at
+    their coordinates at all, so this is a cheap way to get at a few of the
+    conformers of a molecule with many of them, e.g. after reading the
+    molecule itself with PicklerOps::NoConformers. Use
+    conformersFromPickle() to get more than one of them, that only decodes
+    the molecular graph once.
+    The conformer's properties are decoded, and it doesn't belong to a
+    molecule.
+  */
+  static std::unique_ptr<Conformer> conformerFromPickle(
+      const std::string &pickle, unsigned int confIdx);
+  //! decodes some of the conformers from a pickle
+  /*!
+    \param confIdxs the indices (not the IDs) of the conformers in the
+    molecule, in the order they should be returned
+
+    Works like conformerFromPickle(), but the molecular graph is only decoded
+    once for all of the conformers. Throws an IndexErrorException if any of
+    the indices is out of range.
+  */
+  static std::vector<std::unique_ptr<Conformer>> conformersFromPickle(
+      const std::string &pickle, const std::vector<unsigned int> &confIdxs);
+
   //! constructs a molecule from a pickle stored in a stream
   static void molFromPickle(std::istream &ss, ROMol *mol,
                             unsigned int propertyFlags);
@@ -255,10 +314,22 @@ class RDKIT_GRAPHMOL_EXPORT MolPickler {
   template <typename T, typename C>
   static void _pickleConformer(std::ostream &ss, const Conformer *conf);
 
+  //! do the actual work of pickling a Conformer with quantized coordinates
+  template <typename T>
+  static void _pickleQuantizedConformer(std::ostream &ss, const Conformer *conf,
+                                        double precision);
+
+  //! reads the pickle header and hands over to _depickle(); if confIdxs is
+  //! not null only the conformers at those (sorted) indices are decoded
+  static void _molFromPickle(std::istream &ss, ROMol *mol,
+                             unsigned int propertyFlags,
+                             const std::vector<unsigned int> *confIdxs);
+
   //! do the actual work of de-pickling a molecule
   template <typename T>
   static void _depickle(std::istream &ss, ROMol *mol, int version, int numAtoms,
-                        unsigned int propertyFlags);
+                        unsigned int propertyFlags,
+                        const std::vector<unsigned int> *confIdxs);
 
   //! extract atomic data from a pickle and add the resulting Atom to the
   /// molecule
@@ -292,6 +363,13 @@ class RDKIT_GRAPHMOL_EXPORT MolPickler {
   template <typename T, typename C>
   static Conformer *_conformerFromPickle(std::istream &ss, int version);
 
+  //! extract a conformation with quantized coordinates from a pickle
+  template <typename T>
+  static Conformer *_quantizedConformerFromPickle(std::istream &ss,
+                                                  std::int32_t blkSize,
+                                                  double precision,
+                                                  int version);
+
   //! pickle standard properties
   static void _pickleProperties(std::ostream &ss, const RDProps &props,
                                 unsigned int pickleFlags);
@@ -261,6 +261,23 @@ class RDKIT_GRAPHMOL_EXPORT PeriodicTable {
   double getMassForIsotope(const char *elementSymbol, UINT isotope) const {
     return getMassForIsotope(std::string(elementSymbol), isotope);
   }
+  //! returns the mass of an atom with the given isotope, this is what
+  //! Atom::getMass() returns
+  /*!
+    An isotope of zero gives the atomic weight. Isotopes with an unknown mass
+    give the isotope number itself, except for dummy atoms where they give
+    zero.
+  */
+  double getAtomMass(UINT atomicNumber, UINT isotope) const {
+    if (!isotope) {
+      return getAtomicWeight(atomicNumber);
+    }
+    double res = getMassForIsotope(atomicNumber, isotope);
+    if (atomicNumber != 0 && res == 0.0) {
+      res = isotope;
+    }
+    return res;
+  }
   //! returns the abundance of a particular isotope; zero if that
   //! isotope is unknown.
   double getAbundanceForIsotope(UINT atomicNumber, UINT isotope) const {
@@ -0,0 +1,557 @@
+//
+//  Copyright (C) 2026 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+
+// A hand-written parser for the parts of the SMILES syntax which are
+// used by almost all real-world input. It builds exactly the same
+// molecule as the actions in smiles.yy do, so anything it does not
+// understand (or which would be an error) is left to the full parser.
+
+#include <GraphMol/RDKitBase.h>
+#include <GraphMol/PeriodicTable.h>
+#include "SmilesParseOps.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace SmilesParseOps {
+using namespace RDKit;
+
+namespace {
+// atomic numbers of the element symbols allowed in brackets, indexed by
+// the symbol's letters
+class BracketElements {
+ public:
+  BracketElements() {
+    d_single.fill(0);
+    d_double.fill(0);
+    const auto *table = PeriodicTable::getTable();
+    for (unsigned int num = 1; num <= 118; ++num) {
+      const auto symb = table->getElementSymbol(num);
+      if (symb.size() == 1 && symb[0] >= 'A' && symb[0] <= 'Z') {
+        d_single[symb[0] - 'A'] = num;
+      } else if (symb.size() == 2 && symb[0] >= 'A' && symb[0] <= 'Z' &&
+                 symb[1] >= 'a' && symb[1] <= 'z') {
+        d_double[(symb[0] - 'A') * 26 + (symb[1] - 'a')] = num;
+      }
+    }
+  }
+  std::uint8_t single(char c) const { return d_single[c - 'A']; }
+  std::uint8_t pair(char c1, char c2) const {
+    return d_double[(c1 - 'A') * 26 + (c2 - 'a')];
+  }
+
+ private:
+  std::array<std::uint8_t, 26> d_single;
+  std::array<std::uint8_t, 26 * 26> d_double;
+};
+
+const BracketElements &bracketElements() {
+  static const BracketElements elements;
+  return elements;
+}
+
+const std::string cxsmilesBondIdx = "_cxsmilesBondIdx";
+
+bool isUpper(char c) { return c >= 'A' && c <= 'Z'; }
+bool isLower(char c) { return c >= 'a' && c <= 'z'; }
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+class SimpleSmilesParser {
+ public:
+  explicit SimpleSmilesParser(std::string_view text) : d_text(text) {}
+
+  std::unique_ptr<RWMol> parse() {
+    auto atom = parseAtom();
+    if (!atom) {
+      return nullptr;
+    }
+    auto mol = std::make_unique<RWMol>();
+    atom->setProp(common_properties::_SmilesStart, 1);
+    mol->addAtom(atom.release(), true, true);
+    if (!parseChain(*mol)) {
+      CleanupAfterParseError(mol.get());
+      return nullptr;
+    }
+    return mol;
+  }
+
+ private:
+  // the bond which precedes an atom or ring closure digit
+  enum class BondToken { None, Minus, Other };
+  // the bond the lexer would have created for a BondToken::Other
+  struct BondSpec {
+    Bond::BondType type = Bond::UNSPECIFIED;
+    Bond::BondDir dir = Bond::NONE;
+    bool unspecifiedOrder = false;
+    bool aromatic = false;
+  };
+
+  char peek(size_t offset = 0) const {
+    return d_pos + offset < d_text.size() ? d_text[d_pos + offset] : '\0';
+  }
+
+  bool parseChain(RWMol &mol) {
+    std::vector<unsigned int> branchPoints;
+    while (d_pos < d_text.size()) {
+      const char c = peek();
+      if (c == ')') {
+        if (branchPoints.empty()) {
+          return false;
+        }
+        mol.setActiveAtom(branchPoints.back());
+        branchPoints.pop_back();
+        ++d_pos;
+        continue;
+      }
+      if (c == '.') {
+        ++d_pos;
+        auto atom = parseAtom();
+        if (!atom) {
+          return false;
+        }
+        atom->setProp(common_properties::_SmilesStart, 1, true);
+        mol.addAtom(atom.release(), true, true);
+        continue;
+      }
+      bool branch = false;
+      if (c == '(') {
+        branch = true;
+        ++d_pos;
+      }
+      BondSpec bond;
+      auto bondToken = parseBond(bond);
+      if (!branch && (isDigit(peek()) || peek() == '%')) {
+        int ringNum;
+        if (!parseRingNumber(ringNum)) {
+          return false;
+        }
+        addRingClosure(mol, ringNum, bondToken, bond);
+        continue;
+      }
+      auto atom = parseAtom();
+      if (!atom) {
+        return false;
+      }
+      auto atomIdx1 = mol.getActiveAtom()->getIdx();
+      addAtom(mol, atom.release(), bondToken, bond);
+      if (branch) {
+        branchPoints.push_back(atomIdx1);
+      }
+    }
+    return branchPoints.empty();
+  }
+
+  void addAtom(RWMol &mp, Atom *atom, BondToken bondToken,
+               const BondSpec &spec) {
+    Atom *a1 = mp.getActiveAtom();
+    unsigned int atomIdx1 = a1->getIdx();
+    unsigned int atomIdx2 = mp.addAtom(atom, true, true);
+    if (bondToken == BondToken::Other) {
+      auto *bond = new Bond(spec.type);
+      if (spec.aromatic) {
+        bond->setIsAromatic(true);
+      }
+      if (spec.unspecifiedOrder) {
+        bond->setProp(common_properties::_unspecifiedOrder, 1);
+      }
+      bond->setBondDir(spec.dir);
+      if (bond->getBondType() == Bond::DATIVER) {
+        bond->setBeginAtomIdx(atomIdx1);
+        bond->setEndAtomIdx(atomIdx2);
+        bond->setBondType(Bond::DATIVE);
+      } else if (bond->getBondType() == Bond::DATIVEL) {
+        bond->setBeginAtomIdx(atomIdx2);
+        bond->setEndAtomIdx(atomIdx1);
+        bond->setBondType(Bond::DATIVE);
+      } else {
+        bond->setBeginAtomIdx(atomIdx1);
+        bond->setEndAtomIdx(atomIdx2);
+      }
+      bond->setProp(cxsmilesBondIdx, d_numBondsParsed++);
+      mp.addBond(bond, true);
+      return;
+    }
+    auto bondType =
+        bondToken == BondToken::Minus
+            ? Bond::SINGLE
+            : GetUnspecifiedBondType(&mp, a1, mp.getAtomWithIdx(atomIdx2));
+    auto numBonds = mp.addBond(atomIdx1, atomIdx2, bondType);
+    mp.getBondWithIdx(numBonds - 1)
+        ->setProp(cxsmilesBondIdx, d_numBondsParsed++);
+  }
+
+  void addRingClosure(RWMol &mp, int ringNum, BondToken bondToken,
+                      const BondSpec &bond) {
+    Atom *atom = mp.getActiveAtom();
+    Bond *newB;
+    if (bondToken == BondToken::None) {
+      mp.setAtomBookmark(atom, ringNum);
+      newB = mp.createPartialBond(atom->getIdx(), Bond::UNSPECIFIED);
+      mp.setBondBookmark(newB, ringNum);
+      newB->setProp(common_properties::_unspecifiedOrder, 1);
+    } else {
+      if (bondToken == BondToken::Minus) {
+        newB = mp.createPartialBond(atom->getIdx(), Bond::SINGLE);
+      } else {
+        newB = mp.createPartialBond(atom->getIdx(), bond.type);
+        if (bond.unspecifiedOrder) {
+          newB->setProp(common_properties::_unspecifiedOrder, 1);
+        }
+        newB->setBondDir(bond.dir);
+      }
+      mp.setAtomBookmark(atom, ringNum);
+      mp.setBondBookmark(newB, ringNum);
+    }
+    if (!(mp.getAllBondsWithBookmark(ringNum).size() % 2)) {
+      newB->setProp(cxsmilesBondIdx, d_numBondsParsed++);
+    }
+
+    CheckRingClosureBranchStatus(atom, &mp);
+
+    INT_VECT tmp;
+    atom->getPropIfPresent(common_properties::_RingClosures, tmp);
+    tmp.push_back(-(ringNum + 1));
+    atom->setProp(common_properties::_RingClosures, tmp);
+  }
+
+  BondToken parseBond(BondSpec &bond) {
+    switch (peek()) {
+      case '-':
+        if (peek(1) == '>') {
+          bond.type = Bond::DATIVER;
+          d_pos += 2;
+          return BondToken::Other;
+        }
+        ++d_pos;
+        return BondToken::Minus;
+      case '<':
+        if (peek(1) != '-') {
+          return BondToken::None;
+        }
+        bond.type = Bond::DATIVEL;
+        d_pos += 2;
+        return BondToken::Other;
+      case '=':
+        bond.type = Bond::DOUBLE;
+        break;
+      case '#':
+        bond.type = Bond::TRIPLE;
+        break;
+      case ':':
+        bond.type = Bond::AROMATIC;
+        bond.aromatic = true;
+        break;
+      case '$':
+        bond.type = Bond::QUADRUPLE;
+        break;
+      case '\\':
+        if (peek(1) == '\\') {
+          ++d_pos;
+        }
+        bond.unspecifiedOrder = true;
+        bond.dir = Bond::ENDDOWNRIGHT;
+        break;
+      case '/':
+        bond.unspecifiedOrder = true;
+        bond.dir = Bond::ENDUPRIGHT;
+        break;
+      default:
+        return BondToken::None;
+    }
+    ++d_pos;
+    return BondToken::Other;
+  }
+
+  bool parseRingNumber(int &val) {
+    if (isDigit(peek())) {
+      val = peek() - '0';
+      ++d_pos;
+      return true;
+    }
+    // '%'
+    ++d_pos;
+    if (peek() == '(') {
+      ++d_pos;
+      val = 0;
+      unsigned int nDigits = 0;
+      while (isDigit(peek()) && nDigits < 5) {
+        val = val * 10 + (peek() - '0');
+        ++d_pos;
+        ++nDigits;
+      }
+      if (!nDigits || peek() != ')') {
+        return false;
+      }
+      ++d_pos;
+      return true;
+    }
+    if (peek() < '1' || peek() > '9' || !isDigit(peek(1))) {
+      return false;
+    }
+    val = (peek() - '0') * 10 + (peek(1) - '0');
+    d_pos += 2;
+    return true;
+  }
+
+  // the grammar's "number": a single zero or digits without a leading zero
+  bool parseNumber(int &val) {
+    if (!isDigit(peek())) {
+      return false;
+    }
+    val = peek() - '0';
+    ++d_pos;
+    if (!val) {
+      return true;
+    }
+    while (isDigit(peek())) {
+      int digit = peek() - '0';
+      if (val >= std::numeric_limits<std::int32_t>::max() / 10 ||
+          val * 10 >= std::numeric_limits<std::int32_t>::max() - digit) {
+        return false;
+      }
+      val = val * 10 + digit;
+      ++d_pos;
+    }
+    return true;
+  }
+
+  std::unique_ptr<Atom> parseAtom() {
+    std::unique_ptr<Atom> res;
+    const char c = peek();
+    int atomicNum = 0;
+    bool aromatic = false;
+    switch (c) {
+      case 'C':
+        atomicNum = peek(1) == 'l' ? 17 : 6;
+        break;
+      case 'B':
+        atomicNum = peek(1) == 'r' ? 35 : 5;
+        break;
+      case 'N':
+        atomicNum = 7;
+        break;
+      case 'O':
+        atomicNum = 8;
+        break;
+      case 'P':
+        atomicNum = 15;
+        break;
+      case 'S':
+        atomicNum = 16;
+        break;
+      case 'F':
+        atomicNum = 9;
+        break;
+      case 'I':
+        atomicNum = 53;
+        break;
+      case 'b':
+      case 'c':
+      case 'n':
+      case 'o':
+      case 'p':
+      case 's':
+        atomicNum = aromaticElement(c);
+        aromatic = true;
+        break;
+      case '*':
+        ++d_pos;
+        res.reset(new Atom(0));
+        res->setProp(common_properties::dummyLabel, std::string("*"));
+        return res;
+      case '[':
+        return parseBracketAtom();
+      default:
+        return res;
+    }
+    d_pos += (atomicNum == 17 || atomicNum == 35) ? 2 : 1;
+    res.reset(new Atom(atomicNum));
+    if (aromatic) {
+      res->setIsAromatic(true);
+    }
+    return res;
+  }
+
+  static int aromaticElement(char c) {
+    switch (c) {
+      case 'b':
+        return 5;
+      case 'c':
+        return 6;
+      case 'n':
+        return 7;
+      case 'o':
+        return 8;
+      case 'p':
+        return 15;
+      case 's':
+        return 16;
+      default:
+        return 0;
+    }
+  }
+
+  // the element inside square brackets, the flex lexer takes the longest
+  // symbol which matches
+  std::unique_ptr<Atom> parseBracketElement() {
+    std::unique_ptr<Atom> res;
+    const char c = peek();
+    const char next = peek(1);
+    if (isUpper(c)) {
+      const auto &elements = bracketElements();
+      if (isLower(next)) {
+        if (auto num = elements.pair(c, next)) {
+          d_pos += 2;
+          res.reset(new Atom(num));
+        }
+      } else if (c != 'H') {
+        if (auto num = elements.single(c)) {
+          ++d_pos;
+          res.reset(new Atom(num));
+        }
+      }
+    } else if (isLower(c)) {
+      int num = 0;
+      unsigned int len = 2;
+      if (c == 's' && next == 'i') {
+        num = 14;
+      } else if (c == 'a' && next == 's') {
+        num = 33;
+      } else if (c == 's' && next == 'e') {
+        num = 34;
+      } else if (c == 't' && next == 'e') {
+        num = 52;
+      } else {
+        num = aromaticElement(c);
+        len = 1;
+      }
+      if (num) {
+        d_pos += len;
+        res.reset(new Atom(num));
+        res->setIsAromatic(true);
+      }
+    } else if (c == '*') {
+      ++d_pos;
+      res.reset(new Atom(0));
+      res->setProp(common_properties::dummyLabel, std::string("*"));
+    }
+    return res;
+  }
+
+  std::unique_ptr<Atom> parseBracketAtom() {
+    std::unique_ptr<Atom> res;
+    // '['
+    ++d_pos;
+    int isotope = -1;
+    if (isDigit(peek()) && !parseNumber(isotope)) {
+      return res;
+    }
+    if (peek() == 'H' && !isLower(peek(1))) {
+      // a hydrogen atom, these can't have chirality
+      ++d_pos;
+      res.reset(new Atom(1));
+      if (isotope >= 0) {
+        res->setIsotope(isotope);
+      }
+      if (peek() == 'H') {
+        ++d_pos;
+        int numHs = 1;
+        if (isDigit(peek()) && !parseNumber(numHs)) {
+          return nullptr;
+        }
+        res->setNumExplicitHs(numHs);
+      }
+    } else {
+      res = parseBracketElement();
+      if (!res) {
+        return res;
+      }
+      if (isotope >= 0) {
+        res->setIsotope(isotope);
+      }
+      if (peek() == '@') {
+        ++d_pos;
+        auto tag = Atom::CHI_TETRAHEDRAL_CCW;
+        if (peek() == '@') {
+          ++d_pos;
+          tag = Atom::CHI_TETRAHEDRAL_CW;
+        }
+        // chirality classes (@TH1, @SP2, ...) are left to the full parser
+        const char next = peek();
+        if (next == '@' || next == ' ' || next == 'T' || next == 'A' ||
+            next == 'S' || next == 'O') {
+          return nullptr;
+        }
+        res->setChiralTag(tag);
+      }
+      if (peek() == 'H' && !isLower(peek(1))) {
+        ++d_pos;
+        int numHs = 1;
+        if (isDigit(peek()) && !parseNumber(numHs)) {
+          return nullptr;
+        }
+        res->setNumExplicitHs(numHs);
+      }
+    }
+    if (peek() == '+' || peek() == '-') {
+      const int sign = peek() == '+' ? 1 : -1;
+      ++d_pos;
+      int charge = 1;
+      if (peek() == (sign > 0 ? '+' : '-')) {
+        ++d_pos;
+        charge = 2;
+      } else if (isDigit(peek()) && !parseNumber(charge)) {
+        return nullptr;
+      }
+      res->setFormalCharge(sign * charge);
+    }
+    int mapNum = -1;
+    if (peek() == ':') {
+      ++d_pos;
+      if (!parseNumber(mapNum)) {
+        return nullptr;
+      }
+    }
+    if (peek() != ']') {
+      return nullptr;
+    }
+    ++d_pos;
+    res->setNoImplicit(true);
+    if (mapNum >= 0) {
+      res->setProp(common_properties::keys::molAtomMapNumber, mapNum);
+    }
+    return res;
+  }
+
+  std::string_view d_text;
+  size_t d_pos = 0;
+  unsigned int d_numBondsParsed = 0;
+};
+}  // namespace
+
+std::unique_ptr<RWMol> ParseSimpleSmiles(std::string_view smiles) {
+  // trim the input the same way the lexer does
+  size_t start = 0;
+  while (start < smiles.size() && smiles[start] <= 32) {
+    ++start;
+  }
+  size_t end = smiles.size();
+  while (end > start && smiles[end - 1] <= 32) {
+    --end;
+  }
+  if (start == end) {
+    return nullptr;
+  }
+  SimpleSmilesParser parser(smiles.substr(start, end - start));
+  return parser.parse();
+}
+}  // namespace SmilesParseOps
@@ -39,15 +39,20 @@
 #include "SmilesParseOps.h"
 #include <RDGeneral/RDLog.h>
 #include <RDGeneral/Invariant.h>
+#include <RDGeneral/RDThreads.h>
 #include "smiles.tab.hpp"
 // NOTE: this is a bit fragile since a lot of the #defines in smiles.tab.hpp
 // could prevent the same #defines in smarts.tab.hpp from being read.
 // Fortunately if there are actually any problems here, they will inevitably
 // show up very quickly in the tests.
 #include "smarts.tab.hpp"
+#include <algorithm>
 #include <list>
 #include <utility>
 #include <vector>
+#ifdef RDK_BUILD_THREADSAFE_SSS
+#include <future>
+#endif
 
 int yysmiles_lex_init(void **);
 int yysmiles_lex_destroy(void *);
@@ -237,12 +242,40 @@ std::string labelRecursivePatterns(const std::string &sma) {
   return sma;
 #endif
 }
+
+// the steps which follow parsing with either SMILES parser
+void finishParsedMol(RWMol *res) {
+  SmilesParseOps::CloseMolRings(res, false);
+  SmilesParseOps::CheckChiralitySpecifications(res, true);
+  SmilesParseOps::SetUnspecifiedBondTypes(res);
+  SmilesParseOps::AdjustAtomChiralityFlags(res);
+  // No sense leaving this bookmark intact:
+  if (res->hasAtomBookmark(ci_RIGHTMOST_ATOM)) {
+    res->clearAtomBookmark(ci_RIGHTMOST_ATOM);
+  }
+}
+
+// returns nullptr if the SMILES needs the full parser
+std::unique_ptr<RWMol> toMolFast(const std::string &inp) {
+  auto res = SmilesParseOps::ParseSimpleSmiles(inp);
+  if (res) {
+    try {
+      finishParsedMol(res.get());
+    } catch (const SmilesParseException &) {
+      // the full parser will report the problem
+      SmilesParseOps::CleanupAfterParseError(res.get());
+      res.reset();
+    }
+  }
+  return res;
+}
 }  // namespace
 
 std::unique_ptr<RWMol> toMol(const std::string &inp,
                              int func(const std::string &,
                                       std::vector<RDKit::RWMol *> &),
-                             const std::string &origInp) {
+                             const std::string &origInp,
+                             std::string *errorMessage = nullptr) {
   // empty strings produce empty molecules:
   if (inp.empty()) {
     return std::make_unique<RWMol>();
@@ -253,14 +286,7 @@ std::unique_ptr<RWMol> toMol(const std::string &inp,
     func(inp, molVect);
     if (!molVect.empty()) {
       res.reset(molVect[0]);
-      SmilesParseOps::CloseMolRings(res.get(), false);
-      SmilesParseOps::CheckChiralitySpecifications(res.get(), true);
-      SmilesParseOps::SetUnspecifiedBondTypes(res.get());
-      SmilesParseOps::AdjustAtomChiralityFlags(res.get());
-      // No sense leaving this bookmark intact:
-      if (res->hasAtomBookmark(ci_RIGHTMOST_ATOM)) {
-        res->clearAtomBookmark(ci_RIGHTMOST_ATOM);
-      }
+      finishParsedMol(res.get());
       molVect[0] = nullptr;  // NOTE: to avoid leaks on failures, this should
                              // occur last in this if.
     }
@@ -271,6 +297,9 @@ std::unique_ptr<RWMol> toMol(const std::string &inp,
     }
     BOOST_LOG(rdErrorLog) << nm << " Parse Error: " << e.what()
                           << " for input: '" << origInp << "'" << std::endl;
+    if (errorMessage) {
+      *errorMessage = e.what();
+    }
 
     // reset res so that we return a nullptr. We don't want to reset(),
     // because that would delete the mol and leak any unmatched
@@ -415,23 +444,23 @@ void handleCXPartAndName(RWMol *res, const T &params, const std::string &cxPart,
     name = boost::trim_copy(nmpart);
   }
 }
-}  // namespace
-
-std::unique_ptr<RWMol> MolFromSmiles(const std::string &smiles,
-                                     const SmilesParserParams &params) {
-  // Calling MolFromSmiles in a multithreaded context is generally safe *unless*
-  // the value of debugParse is different for different threads. The if
-  // statement below avoids a TSAN warning in the case where multiple threads
-  // all use the same value for debugParse.
-  if (yysmiles_debug != params.debugParse) {
-    yysmiles_debug = params.debugParse;
-  }
 
+// does the work of MolFromSmiles() once the parser debug flag is set.
+// Parse errors are recorded in errorMessage, if it is provided.
+std::unique_ptr<RWMol> molFromSmiles(const std::string &smiles,
+                                     const SmilesParserParams &params,
+                                     std::string *errorMessage) {
   std::string lsmiles, name, cxPart;
   preprocessSmiles(smiles, params, lsmiles, name, cxPart);
   // strip any leading/trailing whitespace:
   // boost::trim_if(smi,boost::is_any_of(" \t\r\n"));
-  auto res = toMol(lsmiles, smiles_parse, lsmiles);
+  std::unique_ptr<RWMol> res;
+  if (params.useFastParser && !params.debugParse) {
+    res = toMolFast(lsmiles);
+  }
+  if (!res) {
+    res = toMol(lsmiles, smiles_parse, lsmiles, errorMessage);
+  }
   if (!res) {
     return res;
   }
@@ -531,7 +560,100 @@ std::unique_ptr<RWMol> MolFromSmiles(const std::string &smiles,
     }
   }
   return res;
-};
+}
+
+std::unique_ptr<RWMol> molFromSmarts(const std::string &smarts,
+                                     const SmartsParserParams &params,
+                                     std::string *errorMessage) {
+  std::string lsmarts, name, cxPart;
+  preprocessSmiles(smarts, params, lsmarts, name, cxPart);
+
+  auto res = toMol(labelRecursivePatterns(lsmarts), smarts_parse, lsmarts,
+                   errorMessage);
+  handleCXPartAndName(res.get(), params, cxPart, name);
+  if (res) {
+    if (params.mergeHs) {
+      MolOps::mergeQueryHs(*res);
+    }
+    MolOps::setBondStereoFromDirections(*res);
+    if (!params.skipCleanup) {
+      SmilesParseOps::CleanupAfterParsing(res.get());
+    }
+    if (!name.empty()) {
+      res->setProp(common_properties::_Name, name);
+    }
+  }
+  return res;
+}
+
+template <typename T, typename ParseFunc>
+void parseBatch(const std::vector<std::string_view> &inputs, const T &params,
+                ParseFunc parseOne, std::vector<MolParseResult> &results,
+                unsigned int start, unsigned int step) {
+  // reused for every entry this worker handles
+  std::string input;
+  for (auto idx = start; idx < inputs.size(); idx += step) {
+    auto &result = results[idx];
+    input.assign(inputs[idx]);
+    try {
+      result.mol = parseOne(input, params, &result.error);
+    } catch (const std::exception &e) {
+      result.mol.reset();
+      result.error = e.what();
+    }
+  }
+}
+
+template <typename T, typename ParseFunc>
+std::vector<MolParseResult> parseAll(
+    const std::vector<std::string_view> &inputs, const T &params,
+    ParseFunc parseOne, int numThreads) {
+  // preallocate results so that each worker writes straight into the slot
+  // for its input and the output order matches the input order
+  std::vector<MolParseResult> results(inputs.size());
+  auto nThreads = std::min(getNumThreadsToUse(numThreads),
+                           static_cast<unsigned int>(inputs.size()));
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  if (nThreads > 1) {
+    std::vector<std::future<void>> thread_group;
+    for (unsigned int ti = 0; ti < nThreads; ++ti) {
+      thread_group.emplace_back(std::async(
+          std::launch::async, parseBatch<T, ParseFunc>, std::ref(inputs),
+          std::ref(params), parseOne, std::ref(results), ti, nThreads));
+    }
+    for (auto &fut : thread_group) {
+      fut.get();
+    }
+    return results;
+  }
+#endif
+  RDUNUSED_PARAM(nThreads);
+  parseBatch(inputs, params, parseOne, results, 0, 1);
+  return results;
+}
+}  // namespace
+
+std::unique_ptr<RWMol> MolFromSmiles(const std::string &smiles,
+                                     const SmilesParserParams &params) {
+  // Calling MolFromSmiles in a multithreaded context is generally safe *unless*
+  // the value of debugParse is different for different threads. The if
+  // statement below avoids a TSAN warning in the case where multiple threads
+  // all use the same value for debugParse.
+  if (yysmiles_debug != params.debugParse) {
+    yysmiles_debug = params.debugParse;
+  }
+  return molFromSmiles(smiles, params, nullptr);
+}
+
+std::vector<MolParseResult> MolsFromSmiles(
+    const std::vector<std::string_view> &smis,
+    const SmilesParserParams &params, int numThreads) {
+  // set this once up front so that the workers never write it
+  if (yysmiles_debug != params.debugParse) {
+    yysmiles_debug = params.debugParse;
+  }
+  return parseAll(smis, params, molFromSmiles, numThreads);
+}
 
 std::unique_ptr<Atom> AtomFromSmarts(const std::string &smiles) {
   yysmarts_debug = false;
@@ -554,26 +676,18 @@ std::unique_ptr<RWMol> MolFromSmarts(const std::string &smarts,
   if (yysmarts_debug != params.debugParse) {
     yysmarts_debug = params.debugParse;
   }
+  return molFromSmarts(smarts, params, nullptr);
+}
 
-  std::string lsmarts, name, cxPart;
-  preprocessSmiles(smarts, params, lsmarts, name, cxPart);
-
-  auto res = toMol(labelRecursivePatterns(lsmarts), smarts_parse, lsmarts);
-  handleCXPartAndName(res.get(), params, cxPart, name);
-  if (res) {
-    if (params.mergeHs) {
-      MolOps::mergeQueryHs(*res);
-    }
-    MolOps::setBondStereoFromDirections(*res);
-    if (!params.skipCleanup) {
-      SmilesParseOps::CleanupAfterParsing(res.get());
-    }
-    if (!name.empty()) {
-      res->setProp(common_properties::_Name, name);
-    }
+std::vector<MolParseResult> MolsFromSmarts(
+    const std::vector<std::string_view> &smas,
+    const SmartsParserParams &params, int numThreads) {
+  // set this once up front so that the workers never write it
+  if (yysmarts_debug != params.debugParse) {
+    yysmarts_debug = params.debugParse;
   }
-  return res;
-};
+  return parseAll(smas, params, molFromSmarts, numThreads);
+}
 }  // namespace SmilesParse
 }  // namespace v2
 }  // namespace RDKit
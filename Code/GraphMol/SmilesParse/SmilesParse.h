@@ -16,6 +16,8 @@
 #include <exception>
 #include <map>
 #include <memory>
+#include <string_view>
+#include <vector>
 
 namespace RDKit {
 class RWMol;
@@ -51,6 +53,8 @@ struct RDKIT_SMILESPARSE_EXPORT SmilesParserParams {
   bool debugParse = false;  /**< enable debugging in the SMILES parser*/
   std::map<std::string, std::string>
       replacements; /**< allows SMILES "macros" */
+  bool useFastParser =
+      false; /**< try the hand-written parser for simple SMILES first */
 };
 
 struct RDKIT_SMILESPARSE_EXPORT SmartsParserParams {
@@ -73,6 +77,39 @@ RDKIT_SMILESPARSE_EXPORT std::unique_ptr<RDKit::RWMol> MolFromSmarts(
     const std::string &sma,
     const SmartsParserParams &params = SmartsParserParams());
 
+//! the result of parsing one entry with MolsFromSmiles() or MolsFromSmarts()
+struct RDKIT_SMILESPARSE_EXPORT MolParseResult {
+  std::unique_ptr<RDKit::RWMol> mol; /**< nullptr if the entry failed */
+  std::string error; /**< why the entry failed, empty on success */
+};
+
+//! Construct molecules from a batch of SMILES strings
+/*!
+ \param smis       the SMILES to convert
+ \param params     parameters used for every entry
+ \param numThreads the number of threads to use. If this is <= 0, it is
+                   interpreted as the number of threads to leave free
+                   (so 0 uses all available threads).
+
+ \return one result per input, in input order. Entries which cannot be
+ parsed or sanitized do not throw; they have a null \c mol and the error
+ message is stored in \c error.
+
+ The strings referenced by \c smis must remain valid until the call returns.
+*/
+RDKIT_SMILESPARSE_EXPORT std::vector<MolParseResult> MolsFromSmiles(
+    const std::vector<std::string_view> &smis,
+    const SmilesParserParams &params = SmilesParserParams(),
+    int numThreads = 1);
+//! Construct molecules from a batch of SMARTS strings
+/*!
+  \see MolsFromSmiles() for a description of the arguments and results
+*/
+RDKIT_SMILESPARSE_EXPORT std::vector<MolParseResult> MolsFromSmarts(
+    const std::vector<std::string_view> &smas,
+    const SmartsParserParams &params = SmartsParserParams(),
+    int numThreads = 1);
+
 RDKIT_SMILESPARSE_EXPORT std::unique_ptr<RDKit::Atom> AtomFromSmiles(
     const std::string &smi);
 RDKIT_SMILESPARSE_EXPORT std::unique_ptr<RDKit::Bond> BondFromSmiles(
@@ -100,6 +137,8 @@ struct RDKIT_SMILESPARSE_EXPORT SmilesParserParams {
   bool parseName = true;    /**< parse (and set) the molecule name as well */
   bool removeHs = true;     /**< remove Hs after constructing the molecule */
   bool skipCleanup = false; /**<  skip the final cleanup stage */
+  bool useFastParser =
+      false; /**< try the hand-written parser for simple SMILES first */
 };
 
 struct RDKIT_SMILESPARSE_EXPORT SmartsParserParams {
@@ -129,6 +168,7 @@ inline RDKit::RWMol *SmilesToMol(const std::string &smi,
   v2ps.parseName = ps.parseName;
   v2ps.removeHs = ps.removeHs;
   v2ps.skipCleanup = ps.skipCleanup;
+  v2ps.useFastParser = ps.useFastParser;
   return RDKit::v2::SmilesParse::MolFromSmiles(smi, v2ps).release();
 }
 
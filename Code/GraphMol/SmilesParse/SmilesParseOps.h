@@ -7,6 +7,7 @@
 //  which is included in the file license.txt, found at the root
 //  of the RDKit source tree.
 //
+#include <memory>
 #include <string_view>
 
 #include <RDGeneral/export.h>
@@ -51,6 +52,17 @@ inline void parseCXExtensions(RDKit::RWMol &mol, const std::string &extText,
   auto iter = extText.begin();
   parseCXExtensions(mol, extText, iter, startAtomIdx, startBondIdx);
 };
+//! parses SMILES which only use the common parts of the syntax
+/*!
+  This is a hand-written alternative to the bison parser which handles
+  the organic subset, simple bracket atoms (isotope, element, @ or @@, H
+  count, charge and atom map number), bonds, branches, ring closures and
+  dots. It returns the same molecule the bison parser would produce before
+  the rings are closed, or nullptr if the input uses anything else or is
+  not valid, in which case the full parser should be used.
+*/
+RDKIT_SMILESPARSE_EXPORT std::unique_ptr<RDKit::RWMol> ParseSimpleSmiles(
+    std::string_view smiles);
 //! removes formal charge, isotope, etc. Primarily useful for QueryAtoms
 RDKIT_SMILESPARSE_EXPORT void ClearAtomChemicalProps(RDKit::Atom *atom);
 
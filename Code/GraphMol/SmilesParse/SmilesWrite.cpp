@@ -26,9 +26,12 @@
 #include <RDGeneral/BoostEndInclude.h>
 #include <boost/format.hpp>
 
-#include <sstream>
-#include <map>
-#include <list>
+#include <algorithm>
+#include <ostream>
+#ifdef RDK_BUILD_THREADSAFE_SSS
+#include <future>
+#include <RDGeneral/RDThreads.h>
+#endif
 
 // #define VERBOSE_CANON 1
 
@@ -77,7 +80,7 @@ std::string getAtomChiralityInfo(const Atom *atom) {
       // we need to also add permutation info
       int permutation = 0;
       if (atom->getChiralTag() > Atom::ChiralType::CHI_OTHER &&
-          atom->getPropIfPresent(common_properties::_chiralPermutation,
+          atom->getPropIfPresent(common_properties::keys::_chiralPermutation,
                                  permutation) &&
           !SmilesParseOps::checkChiralPermutation(atom->getChiralTag(),
                                                   permutation)) {
@@ -114,7 +117,7 @@ bool atomNeedsBracket(const Atom *atom, const std::string &atString,
   if (params.doIsomericSmiles && (atom->getIsotope() || !atString.empty())) {
     return true;
   }
-  if (atom->hasProp(common_properties::molAtomMapNumber)) {
+  if (atom->hasProp(common_properties::keys::molAtomMapNumber)) {
     return true;
   }
 
@@ -150,9 +153,9 @@ bool atomNeedsBracket(const Atom *atom, const std::string &atString,
 
 }  // namespace
 
-std::string GetAtomSmiles(const Atom *atom, const SmilesWriteParams &params) {
+void appendAtomSmiles(std::string &res, const Atom *atom,
+                      const SmilesWriteParams &params) {
   PRECONDITION(atom, "bad atom");
-  std::string res;
   int fc = atom->getFormalCharge();
   int num = atom->getAtomicNum();
   int isotope = atom->getIsotope();
@@ -177,7 +180,7 @@ std::string GetAtomSmiles(const Atom *atom, const SmilesWriteParams &params) {
     needsBracket = atomNeedsBracket(atom, atString, params);
   }
   if (needsBracket) {
-    res += "[";
+    res += '[';
   }
 
   if (isotope && params.doIsomericSmiles) {
@@ -210,13 +213,13 @@ std::string GetAtomSmiles(const Atom *atom, const SmilesWriteParams &params) {
   if (needsBracket) {
     unsigned int totNumHs = atom->getTotalNumHs();
     if (totNumHs > 0) {
-      res += "H";
+      res += 'H';
       if (totNumHs > 1) {
         res += std::to_string(totNumHs);
       }
     }
     if (fc > 0) {
-      res += "+";
+      res += '+';
       if (fc > 1) {
         res += std::to_string(fc);
       }
@@ -224,16 +227,17 @@ std::string GetAtomSmiles(const Atom *atom, const SmilesWriteParams &params) {
       if (fc < -1) {
         res += std::to_string(fc);
       } else {
-        res += "-";
+        res += '-';
       }
     }
 
     int mapNum;
-    if (atom->getPropIfPresent(common_properties::molAtomMapNumber, mapNum)) {
-      res += ":";
+    if (atom->getPropIfPresent(common_properties::keys::molAtomMapNumber,
+                               mapNum)) {
+      res += ':';
       res += std::to_string(mapNum);
     }
-    res += "]";
+    res += ']';
   }
 
   // If the atom has this property, the contained string will
@@ -243,18 +247,22 @@ std::string GetAtomSmiles(const Atom *atom, const SmilesWriteParams &params) {
                              label)) {
     res += label;
   }
+}
 
+std::string GetAtomSmiles(const Atom *atom, const SmilesWriteParams &params) {
+  std::string res;
+  appendAtomSmiles(res, atom, params);
   return res;
 }
 
-std::string GetBondSmiles(const Bond *bond, const SmilesWriteParams &params,
-                          int atomToLeftIdx) {
+void appendBondSmiles(std::string &out, const Bond *bond,
+                      const SmilesWriteParams &params, int atomToLeftIdx) {
   PRECONDITION(bond, "bad bond");
   if (atomToLeftIdx < 0) {
     atomToLeftIdx = bond->getBeginAtomIdx();
   }
 
-  std::string res = "";
+  const char *res = "";
   bool aromatic = false;
   if (!params.doKekule && (bond->getBondType() == Bond::SINGLE ||
                            bond->getBondType() == Bond::DOUBLE ||
@@ -356,13 +364,20 @@ std::string GetBondSmiles(const Bond *bond, const SmilesWriteParams &params,
     default:
       res = "~";
   }
+  out += res;
+}
+
+std::string GetBondSmiles(const Bond *bond, const SmilesWriteParams &params,
+                          int atomToLeftIdx) {
+  std::string res;
+  appendBondSmiles(res, bond, params, atomToLeftIdx);
   return res;
 }
 
-std::string FragmentSmilesConstruct(
-    ROMol &mol, int atomIdx, std::vector<Canon::AtomColors> &colors,
-    const UINT_VECT &ranks, const SmilesWriteParams &params,
-    std::vector<unsigned int> &atomOrdering,
+void FragmentSmilesConstruct(
+    std::string &res, ROMol &mol, int atomIdx,
+    std::vector<Canon::AtomColors> &colors, const UINT_VECT &ranks,
+    const SmilesWriteParams &params, std::vector<unsigned int> &atomOrdering,
     std::vector<unsigned int> &bondOrdering,
     const boost::dynamic_bitset<> *atomsInPlay = nullptr,
     const boost::dynamic_bitset<> *bondsInPlay = nullptr,
@@ -388,14 +403,16 @@ std::string FragmentSmilesConstruct(
   Canon::MolStack molStack;
   // try to prevent excessive reallocation
   molStack.reserve(mol.getNumAtoms() + mol.getNumBonds());
-  std::stringstream res;
 
-  std::map<int, int> ringClosureMap;
+  // (ring index, closure digit) for the rings which are currently open.
+  // There are rarely more than a handful of these, so a linear search
+  // beats a map here.
+  std::vector<std::pair<int, int>> openRings;
   int ringIdx, closureVal;
   if (!params.canonical) {
     mol.setProp(common_properties::_StereochemDone, 1);
   }
-  std::list<unsigned int> ringClosuresToErase;
+  std::vector<int> ringClosuresToErase;
 
   if (params.canonical && params.doIsomericSmiles) {
     Canon::canonicalizeEnhancedStereo(mol, &ranks);
@@ -408,14 +425,16 @@ std::string FragmentSmilesConstruct(
     switch (mSE.type) {
       case Canon::MOL_STACK_ATOM:
         for (auto rclosure : ringClosuresToErase) {
-          ringClosureMap.erase(rclosure);
+          openRings.erase(std::find_if(
+              openRings.begin(), openRings.end(),
+              [rclosure](const auto &pr) { return pr.first == rclosure; }));
         }
         ringClosuresToErase.clear();
         // std::cout << "\t\tAtom: " << mSE.obj.atom->getIdx() << std::endl;
         if (!atomSymbols) {
-          res << GetAtomSmiles(mSE.obj.atom, params);
+          appendAtomSmiles(res, mSE.obj.atom, params);
         } else {
-          res << (*atomSymbols)[mSE.obj.atom->getIdx()];
+          res += (*atomSymbols)[mSE.obj.atom->getIdx()];
         }
         atomOrdering.push_back(mSE.obj.atom->getIdx());
         break;
@@ -423,61 +442,57 @@ std::string FragmentSmilesConstruct(
         bond = mSE.obj.bond;
         // std::cout << "\t\tBond: " << bond->getIdx() << std::endl;
         if (!bondSymbols) {
-          res << GetBondSmiles(bond, params, mSE.number);
+          appendBondSmiles(res, bond, params, mSE.number);
         } else {
-          res << (*bondSymbols)[bond->getIdx()];
+          res += (*bondSymbols)[bond->getIdx()];
         }
         bondOrdering.push_back(bond->getIdx());
         break;
-      case Canon::MOL_STACK_RING:
+      case Canon::MOL_STACK_RING: {
         ringIdx = mSE.number;
         // std::cout << "\t\tRing: " << ringIdx << std::endl;
-        if (ringClosureMap.count(ringIdx)) {
-          // the index is already in the map ->
-          //   we're closing a ring, so grab
+        auto openRing = std::find_if(
+            openRings.begin(), openRings.end(),
+            [ringIdx](const auto &pr) { return pr.first == ringIdx; });
+        if (openRing != openRings.end()) {
+          // the ring is already open ->
+          //   we're closing it, so grab
           //   the index and then delete the value:
-          closureVal = ringClosureMap[ringIdx];
+          closureVal = openRing->second;
           ringClosuresToErase.push_back(ringIdx);
         } else {
-          // we're opening a new ring, find the index for it:
+          // we're opening a new ring, use the lowest free index for it:
           closureVal = 1;
-          bool done = false;
-          // EFF: there's got to be a more efficient way to do this
-          while (!done) {
-            std::map<int, int>::iterator mapIt;
-            for (mapIt = ringClosureMap.begin(); mapIt != ringClosureMap.end();
-                 ++mapIt) {
-              if (mapIt->second == closureVal) {
-                break;
-              }
-            }
-            if (mapIt == ringClosureMap.end()) {
-              done = true;
-            } else {
-              closureVal += 1;
-            }
+          while (std::any_of(openRings.begin(), openRings.end(),
+                             [closureVal](const auto &pr) {
+                               return pr.second == closureVal;
+                             })) {
+            ++closureVal;
           }
-          ringClosureMap[ringIdx] = closureVal;
+          openRings.emplace_back(ringIdx, closureVal);
         }
         if (closureVal < 10) {
-          res << (char)(closureVal + '0');
+          res += static_cast<char>(closureVal + '0');
         } else if (closureVal < 100) {
-          res << '%' << closureVal;
+          res += '%';
+          res += std::to_string(closureVal);
         } else {  // use extension to OpenSMILES
-          res << "%(" << closureVal << ')';
+          res += "%(";
+          res += std::to_string(closureVal);
+          res += ')';
         }
         break;
+      }
       case Canon::MOL_STACK_BRANCH_OPEN:
-        res << "(";
+        res += '(';
         break;
       case Canon::MOL_STACK_BRANCH_CLOSE:
-        res << ")";
+        res += ')';
         break;
       default:
         break;
     }
   }
-  return res.str();
 }
 
 }  // end of namespace SmilesWrite
@@ -492,8 +507,17 @@ namespace SmilesWrite {
 namespace detail {
 std::string MolToSmiles(const ROMol &mol, const SmilesWriteParams &params,
                         bool doingCXSmiles, bool includeStereoGroups) {
+  std::string result;
+  MolToSmiles(result, mol, params, doingCXSmiles, includeStereoGroups);
+  return result;
+}
+
+void MolToSmiles(std::string &result, const ROMol &mol,
+                 const SmilesWriteParams &params, bool doingCXSmiles,
+                 bool includeStereoGroups) {
+  result.clear();
   if (!mol.getNumAtoms()) {
-    return "";
+    return;
   }
   PRECONDITION(
       params.rootedAtAtom < 0 ||
@@ -532,7 +556,10 @@ std::string MolToSmiles(const ROMol &mol, const SmilesWriteParams &params,
     fragsMolBondMapping.push_back(bondsInFrag);
   }
 
-  std::vector<std::string> vfragsmi(mols.size());
+  // a single fragment is written straight into the result, otherwise the
+  // fragments are collected here and joined at the end
+  const bool singleFrag = mols.size() == 1;
+  std::vector<std::string> vfragsmi(singleFrag ? 0 : mols.size());
 
   //    for(unsigned i=0; i<fragsMolAtomMapping.size(); i++){
   //      std::cout << i << ": ";
@@ -623,7 +650,6 @@ std::string MolToSmiles(const ROMol &mol, const SmilesWriteParams &params,
       rootedAtAtom = getRandomGenerator()() % tmol->getNumAtoms();
     }
 
-    std::string res;
     unsigned int nAtoms = tmol->getNumAtoms();
     std::vector<unsigned int> ranks(nAtoms);
     std::vector<unsigned int> atomOrdering;
@@ -662,7 +688,6 @@ std::string MolToSmiles(const ROMol &mol, const SmilesWriteParams &params,
 
     std::vector<Canon::AtomColors> colors(nAtoms, Canon::WHITE_NODE);
     int nextAtomIdx = -1;
-    std::string subSmi;
 
     // find the next atom for a traverse
     if (rootedAtAtom >= 0) {
@@ -678,25 +703,30 @@ std::string MolToSmiles(const ROMol &mol, const SmilesWriteParams &params,
       }
     }
     CHECK_INVARIANT(nextAtomIdx >= 0, "no start atom found");
-    subSmi = SmilesWrite::FragmentSmilesConstruct(
-        *tmol, nextAtomIdx, colors, ranks, params, atomOrdering, bondOrdering);
-
-    res += subSmi;
-    vfragsmi[fragIdx] = res;
+    SmilesWrite::FragmentSmilesConstruct(
+        singleFrag ? result : vfragsmi[fragIdx], *tmol, nextAtomIdx, colors,
+        ranks, params, atomOrdering, bondOrdering);
 
     for (unsigned int &vit : atomOrdering) {
       vit = fragsMolAtomMapping[fragIdx][vit];  // Lookup the Id in the
                                                 // original molecule
     }
-    allAtomOrdering.push_back(atomOrdering);
+    allAtomOrdering.push_back(std::move(atomOrdering));
     for (unsigned int &vit : bondOrdering) {
       vit = fragsMolBondMapping[fragIdx][vit];  // Lookup the Id in the
                                                 // original molecule
     }
-    allBondOrdering.push_back(bondOrdering);
+    allBondOrdering.push_back(std::move(bondOrdering));
+  }
+
+  if (singleFrag) {
+    mol.setProp(common_properties::_smilesAtomOutputOrder,
+                allAtomOrdering.front(), true);
+    mol.setProp(common_properties::_smilesBondOutputOrder,
+                allBondOrdering.front(), true);
+    return;
   }
 
-  std::string result;
   std::vector<unsigned int> flattenedAtomOrdering;
   flattenedAtomOrdering.reserve(mol.getNumAtoms());
   std::vector<unsigned int> flattenedBondOrdering;
@@ -709,8 +739,9 @@ std::string MolToSmiles(const ROMol &mol, const SmilesWriteParams &params,
         tplType;
     std::vector<tplType> tmp(vfragsmi.size());
     for (unsigned int ti = 0; ti < vfragsmi.size(); ++ti) {
-      tmp[ti] = std::make_tuple(vfragsmi[ti], allAtomOrdering[ti],
-                                allBondOrdering[ti]);
+      tmp[ti] = std::make_tuple(std::move(vfragsmi[ti]),
+                                std::move(allAtomOrdering[ti]),
+                                std::move(allBondOrdering[ti]));
     }
 
     std::sort(tmp.begin(), tmp.end());
@@ -747,7 +778,6 @@ std::string MolToSmiles(const ROMol &mol, const SmilesWriteParams &params,
               true);
   mol.setProp(common_properties::_smilesBondOutputOrder, flattenedBondOrdering,
               true);
-  return result;
 }
 
 }  // namespace detail
@@ -758,6 +788,92 @@ std::string MolToSmiles(const ROMol &mol, const SmilesWriteParams &params) {
   return SmilesWrite::detail::MolToSmiles(mol, params, doingCXSmiles);
 }
 
+void MolToSmiles(const ROMol &mol, std::string &res,
+                 const SmilesWriteParams &params) {
+  bool doingCXSmiles = false;
+  SmilesWrite::detail::MolToSmiles(res, mol, params, doingCXSmiles);
+}
+
+namespace {
+// the number of molecules each worker converts before its output is written
+constexpr size_t smilesChunkSize = 256;
+
+void writeSmilesChunk(const std::vector<const ROMol *> &mols, size_t start,
+                      const SmilesWriteParams &params, std::string &buffer,
+                      std::string &smi) {
+  buffer.clear();
+  const auto end = std::min(mols.size(), start + smilesChunkSize);
+  for (auto i = start; i < end; ++i) {
+    if (mols[i]) {
+      MolToSmiles(*mols[i], smi, params);
+      buffer += smi;
+    }
+    buffer += '\n';
+  }
+}
+}  // namespace
+
+void MolsToSmiles(const std::vector<const ROMol *> &mols, std::ostream &dest,
+                  const SmilesWriteParams &params, int numThreads) {
+  std::string smi;
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  // random SMILES share a single global generator
+  unsigned int nThreads = params.doRandom ? 1 : getNumThreadsToUse(numThreads);
+  if (nThreads > 1) {
+    // writing SMILES sets computed properties on the molecule, so a molecule
+    // which is in the batch more than once could be written to by two
+    // threads at the same time
+    std::vector<const ROMol *> sorted(mols);
+    std::sort(sorted.begin(), sorted.end());
+    auto last = std::remove(sorted.begin(), sorted.end(), nullptr);
+    if (std::adjacent_find(sorted.begin(), last) != last) {
+      nThreads = 1;
+    }
+  }
+#else
+  RDUNUSED_PARAM(numThreads);
+  const unsigned int nThreads = 1;
+#endif
+  if (nThreads == 1) {
+    std::string buffer;
+    for (size_t start = 0; start < mols.size(); start += smilesChunkSize) {
+      writeSmilesChunk(mols, start, params, buffer, smi);
+      dest << buffer;
+    }
+    return;
+  }
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  // each round converts one chunk per thread, the chunks are then written in
+  // order. The buffers and scratch strings are reused between rounds.
+  std::vector<std::string> buffers(nThreads);
+  std::vector<std::string> scratch(nThreads);
+  std::vector<std::future<void>> tg;
+  tg.reserve(nThreads);
+  for (size_t start = 0; start < mols.size();
+       start += nThreads * smilesChunkSize) {
+    tg.clear();
+    for (unsigned int ti = 0; ti < nThreads; ++ti) {
+      const auto chunkStart = start + ti * smilesChunkSize;
+      if (chunkStart >= mols.size()) {
+        break;
+      }
+      tg.emplace_back(std::async(std::launch::async, writeSmilesChunk,
+                                 std::cref(mols), chunkStart, std::cref(params),
+                                 std::ref(buffers[ti]), std::ref(scratch[ti])));
+    }
+    // wait for everything before rethrowing so that no worker is left
+    // running with references to our buffers
+    for (auto &fut : tg) {
+      fut.wait();
+    }
+    for (unsigned int ti = 0; ti < tg.size(); ++ti) {
+      tg[ti].get();
+      dest << buffers[ti];
+    }
+  }
+#endif
+}
+
 std::string MolToCXSmiles(const ROMol &romol,
                           const SmilesWriteParams &paramsInput,
                           std::uint32_t flags,
@@ -955,7 +1071,7 @@ std::string MolFragmentToSmiles(const ROMol &mol,
       for (auto aidx : atomsToUse) {
         const Atom *oAt = mol.getAtomWithIdx(aidx);
         std::string cipCode;
-        if (oAt->getPropIfPresent(common_properties::_CIPCode, cipCode)) {
+        if (oAt->getPropIfPresent(common_properties::keys::_CIPCode, cipCode)) {
           tmol.getAtomWithIdx(aidx)->setProp(common_properties::_CIPCode,
                                              cipCode);
         }
@@ -1012,11 +1128,9 @@ std::string MolFragmentToSmiles(const ROMol &mol,
       }
     }
     CHECK_INVARIANT(nextAtomIdx >= 0, "no start atom found");
-    auto subSmi = SmilesWrite::FragmentSmilesConstruct(
-        tmol, nextAtomIdx, colors, ranks, params, atomOrdering, bondOrdering,
-        &atomsInPlay, &bondsInPlay, atomSymbols, bondSymbols);
-
-    res += subSmi;
+    SmilesWrite::FragmentSmilesConstruct(
+        res, tmol, nextAtomIdx, colors, ranks, params, atomOrdering,
+        bondOrdering, &atomsInPlay, &bondsInPlay, atomSymbols, bondSymbols);
     colorIt = std::find(colors.begin(), colors.end(), Canon::WHITE_NODE);
     if (colorIt != colors.end()) {
       res += ".";
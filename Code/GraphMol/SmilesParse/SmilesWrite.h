@@ -11,6 +11,7 @@
 #ifndef RD_SMILESWRITE_H_012020
 #define RD_SMILESWRITE_H_012020
 
+#include <iosfwd>
 #include <string>
 #include <vector>
 #include <memory>
@@ -93,6 +94,16 @@ RDKIT_SMILESPARSE_EXPORT bool inOrganicSubset(int atomicNumber);
 RDKIT_SMILESPARSE_EXPORT std::string GetAtomSmiles(const Atom *atom,
                                                    const SmilesWriteParams &ps);
 
+//! \brief appends the SMILES for an atom to \c res
+/*!
+  \param res : the string to append to
+  \param atom : the atom to work with
+  \param ps : the parameters controlling the SMILES generation
+*/
+RDKIT_SMILESPARSE_EXPORT void appendAtomSmiles(std::string &res,
+                                               const Atom *atom,
+                                               const SmilesWriteParams &ps);
+
 //! \brief returns the SMILES for an atom
 /*!
   \param atom : the atom to work with
@@ -125,6 +136,19 @@ inline std::string GetAtomSmiles(const Atom *atom, bool doKekule = false,
 RDKIT_SMILESPARSE_EXPORT std::string GetBondSmiles(const Bond *bond,
                                                    const SmilesWriteParams &ps,
                                                    int atomToLeftIdx = -1);
+
+//! \brief appends the SMILES for a bond to \c res
+/*!
+  \param res : the string to append to
+  \param bond : the bond to work with
+  \param ps : the parameters controlling the SMILES generation
+  \param atomToLeftIdx : the index of the atom preceding \c bond
+    in the SMILES
+*/
+RDKIT_SMILESPARSE_EXPORT void appendBondSmiles(std::string &res,
+                                               const Bond *bond,
+                                               const SmilesWriteParams &ps,
+                                               int atomToLeftIdx = -1);
 //! \brief returns the SMILES for a bond
 /*!
   \param bond : the bond to work with
@@ -147,6 +171,12 @@ inline std::string GetBondSmiles(const Bond *bond, int atomToLeftIdx = -1,
 namespace detail {
 RDKIT_SMILESPARSE_EXPORT std::string MolToSmiles(
     const ROMol &mol, const SmilesWriteParams &params, bool doingCXSmiles, bool includeStereoGroups=true);
+//! writes the SMILES into \c result, replacing its contents
+RDKIT_SMILESPARSE_EXPORT void MolToSmiles(std::string &result,
+                                          const ROMol &mol,
+                                          const SmilesWriteParams &params,
+                                          bool doingCXSmiles,
+                                          bool includeStereoGroups = true);
 }
 
 }  // namespace SmilesWrite
@@ -155,6 +185,36 @@ RDKIT_SMILESPARSE_EXPORT std::string MolToSmiles(
 RDKIT_SMILESPARSE_EXPORT std::string MolToSmiles(
     const ROMol &mol, const SmilesWriteParams &params);
 
+//! \brief writes canonical SMILES for a molecule into \c res
+/*!
+  The previous contents of \c res are replaced, but its capacity is kept, so
+  reusing the same string for many molecules avoids reallocating the output.
+
+  \param mol : the molecule in question.
+  \param res : the string to write into
+  \param params : the parameters controlling the SMILES generation
+ */
+RDKIT_SMILESPARSE_EXPORT void MolToSmiles(const ROMol &mol, std::string &res,
+                                          const SmilesWriteParams &params);
+
+//! \brief writes SMILES for a sequence of molecules to a stream, one per line
+/*!
+  Molecules are converted in chunks, optionally using multiple threads, and
+  the lines are always written in the order of \c mols. Null entries in \c
+  mols produce empty lines.
+
+  \param mols : the molecules to write
+  \param dest : the stream to write to
+  \param params : the parameters controlling the SMILES generation
+  \param numThreads : the number of threads to use. Zero or negative values
+      are interpreted as described for \c getNumThreadsToUse(). Random SMILES
+      (\c params.doRandom), and batches which contain the same molecule more
+      than once, are always generated on the calling thread.
+ */
+RDKIT_SMILESPARSE_EXPORT void MolsToSmiles(
+    const std::vector<const ROMol *> &mols, std::ostream &dest,
+    const SmilesWriteParams &params, int numThreads = 1);
+
 //! \brief returns SMILES for a molecule, canonical by default
 /*!
   \param mol : the molecule in question.
@@ -3323,4 +3323,120 @@ TEST_CASE("bond labels not being used in fragment canonicalization") {
         MolFragmentToSmiles(*m1, ps, atoms, &bonds, atomLabels, &bondLabels2);
     CHECK(smi1 == smi2);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("writing SMILES into reusable buffers") {
+  std::vector<std::string> smis = {
+      "CC(=O)O",
+      "c1ccccc1O.[Na+].[Cl-]",
+      "C[C@H](N)C(=O)O",
+      "C1CC2CCC1CC2",
+      "C12C3C4C5C6C7C8C9C%10C%11C%12C1C2C3C4C5C6C7C8C9C%10C%11%12",
+      "F/C=C/Cl",
+      "[2H]C([2H])([2H])[13CH2]O",
+  };
+  std::vector<std::unique_ptr<RWMol>> mols;
+  for (const auto &smi : smis) {
+    mols.emplace_back(SmilesToMol(smi));
+    REQUIRE(mols.back());
+  }
+  SECTION("buffer reuse") {
+    for (bool canonical : {true, false}) {
+      for (bool kekule : {true, false}) {
+        SmilesWriteParams ps;
+        ps.canonical = canonical;
+        ps.doKekule = kekule;
+        std::string buffer = "some junk which should be overwritten";
+        for (const auto &mol : mols) {
+          auto expected = MolToSmiles(*mol, ps);
+          auto expectedAtomOrder = mol->getProp<std::vector<unsigned int>>(
+              common_properties::_smilesAtomOutputOrder);
+          mol->clearProp(common_properties::_smilesAtomOutputOrder);
+          MolToSmiles(*mol, buffer, ps);
+          CHECK(buffer == expected);
+          CHECK(mol->getProp<std::vector<unsigned int>>(
+                    common_properties::_smilesAtomOutputOrder) ==
+                expectedAtomOrder);
+        }
+        RWMol empty;
+        MolToSmiles(empty, buffer, ps);
+        CHECK(buffer.empty());
+      }
+    }
+  }
+  SECTION("appending atoms and bonds") {
+    SmilesWriteParams ps;
+    for (const auto &mol : mols) {
+      for (const auto atom : mol->atoms()) {
+        std::string res = "x";
+        SmilesWrite::appendAtomSmiles(res, atom, ps);
+        CHECK(res == "x" + SmilesWrite::GetAtomSmiles(atom, ps));
+      }
+      for (const auto bond : mol->bonds()) {
+        std::string res = "x";
+        SmilesWrite::appendBondSmiles(res, bond, ps);
+        CHECK(res == "x" + SmilesWrite::GetBondSmiles(bond, ps));
+      }
+    }
+  }
+  SECTION("ring closure digits") {
+    const std::string smi =
+        "C1CC2CC3CC4CC5CC6CC7CC8CC9CC%10CC%11CC%11C%10C9C8C7C6C5C4C3C2C1";
+    std::unique_ptr<RWMol> m(SmilesToMol(smi));
+    REQUIRE(m);
+    SmilesWriteParams ps;
+    ps.canonical = false;
+    std::string res;
+    MolToSmiles(*m, res, ps);
+    CHECK(res == smi);
+  }
+  SECTION("streaming") {
+    std::vector<const ROMol *> molPtrs;
+    std::string expected;
+    // enough molecules to span several chunks
+    for (unsigned int i = 0; i < 2000; ++i) {
+      const auto &mol = mols[i % mols.size()];
+      if (i % 97 == 3) {
+        molPtrs.push_back(nullptr);
+      } else {
+        molPtrs.push_back(mol.get());
+        expected += MolToSmiles(*mol);
+      }
+      expected += "\n";
+    }
+    SmilesWriteParams ps;
+    {
+      std::ostringstream oss;
+      MolsToSmiles(molPtrs, oss, ps);
+      CHECK(oss.str() == expected);
+    }
+#ifdef RDK_TEST_MULTITHREADED
+    {
+      std::ostringstream oss;
+      MolsToSmiles(molPtrs, oss, ps, 4);
+      CHECK(oss.str() == expected);
+    }
+    {
+      std::ostringstream oss;
+      MolsToSmiles({}, oss, ps, 4);
+      CHECK(oss.str().empty());
+    }
+    {
+      // distinct molecules are converted in parallel
+      std::vector<std::unique_ptr<ROMol>> copies;
+      std::vector<const ROMol *> distinctPtrs;
+      for (auto ptr : molPtrs) {
+        if (ptr) {
+          copies.emplace_back(new ROMol(*ptr));
+          distinctPtrs.push_back(copies.back().get());
+        } else {
+          distinctPtrs.push_back(nullptr);
+        }
+      }
+      std::ostringstream oss;
+      MolsToSmiles(distinctPtrs, oss, ps, 4);
+      CHECK(oss.str() == expected);
+    }
+#endif
+  }
+}
@@ -20,6 +20,7 @@
 #include <GraphMol/QueryBond.h>
 #include <GraphMol/Chirality.h>
 #include <GraphMol/SmilesParse/SmilesParse.h>
+#include <GraphMol/SmilesParse/SmilesParseOps.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
 #include <GraphMol/SmilesParse/SmartsWrite.h>
 
@@ -75,3 +76,198 @@ TEST_CASE("handling of aromatic Al in SMILES") {
     CHECK(smi.find("Al") != std::string::npos);
   }
 }
+
+TEST_CASE("fast SMILES parser") {
+  auto sameMol = [](const std::string &smi,
+                    SmilesParse::SmilesParserParams ps) {
+    INFO(smi);
+    ps.useFastParser = false;
+    auto expected = SmilesParse::MolFromSmiles(smi, ps);
+    ps.useFastParser = true;
+    auto mol = SmilesParse::MolFromSmiles(smi, ps);
+    REQUIRE(static_cast<bool>(mol) == static_cast<bool>(expected));
+    if (mol) {
+      std::string expectedPkl, pkl;
+      RDKit::MolPickler::pickleMol(*expected, expectedPkl,
+                                   RDKit::PicklerOps::AllProps);
+      RDKit::MolPickler::pickleMol(*mol, pkl, RDKit::PicklerOps::AllProps);
+      CHECK(pkl == expectedPkl);
+    }
+  };
+  SmilesParse::SmilesParserParams sanitized;
+  SmilesParse::SmilesParserParams raw;
+  raw.sanitize = false;
+  raw.removeHs = false;
+  raw.skipCleanup = true;
+
+  SECTION("simple SMILES") {
+    std::vector<std::string> smis = {
+        "CCO",
+        "c1ccccc1",
+        "CC(=O)O",
+        "CC(C)(C)C",
+        "C1CC1",
+        "C%10CC%10",
+        "C%(123)CC%(123)",
+        "C=1CC1",
+        "C-1CC-1",
+        "C1CC=1",
+        "C/1=C/CC1",
+        "Cl/C=C/Br",
+        "F/C=C\\F",
+        "F/C=C\\\\F",
+        "[NH4+]",
+        "C[O-]",
+        "[13CH3]C",
+        "[2H]C",
+        "[H][H]",
+        "[HH]",
+        "[2HH]",
+        "[H+]",
+        "F[C@](Cl)(Br)I",
+        "[C@@H](F)(Cl)Br",
+        "[C@@](F)1(C)CCO1",
+        "[C@@]1(Cl)(F)I.Br1",
+        "C[C@H]1CC[C@@H](C)CC1",
+        "[Fe+2]",
+        "[Fe++]",
+        "[Cl--]",
+        "[O-2]",
+        "[N+0]",
+        "[se]1cccc1",
+        "[te]1cccc1",
+        "[nH]1cccc1",
+        "c1cc[nH]c1",
+        "[CH3:1][OH:2]",
+        "[C:0]",
+        "*C",
+        "[*]C",
+        "[2*]C",
+        "C.C",
+        "[Na+].[Cl-]",
+        "C->[Fe]",
+        "[Fe]<-N",
+        "C$C",
+        "c1:c:c:c:c:c:1",
+        "B(F)(F)F",
+        "BrCCl",
+        "IC(I)I",
+        "P(=O)(O)(O)O",
+        "OS(=O)(=O)O",
+        "c1ccc2c(c1)[nH]c1ccccc12",
+        "  CCO  ",
+        "CCO\r",
+        "COC1/C=C/OC2(C)Oc3c(C)c(O)c4c(O)c(c(/C=N/OC(c5ccccc5)c5ccccc5)"
+        "cc4c3C2=O)NC(=O)/C(C)=C\\C=C\\C(C)C(O)C(C)C(O)C(C)C(OC(C)=O)C1C",
+    };
+    for (const auto &smi : smis) {
+      INFO(smi);
+      CHECK(SmilesParseOps::ParseSimpleSmiles(smi) != nullptr);
+      sameMol(smi, sanitized);
+      sameMol(smi, raw);
+    }
+  }
+  SECTION("bracket elements") {
+    const auto *table = RDKit::PeriodicTable::getTable();
+    for (unsigned int num = 1; num <= 118; ++num) {
+      auto symb = table->getElementSymbol(num);
+      sameMol("[" + symb + "]", raw);
+      sameMol("[13" + symb + "H2+:3]", raw);
+    }
+    for (const auto symb : {"b", "c", "n", "o", "p", "s", "si", "as", "se",
+                            "te"}) {
+      sameMol("[" + std::string(symb) + "]", raw);
+    }
+  }
+  SECTION("left to the full parser") {
+    std::vector<std::string> smis = {
+        "[C@TH1](F)(Cl)(Br)I",
+        "[Fe@SP1](F)(Cl)(Br)I",
+        "[#6]",
+        "C~C",
+        "[Uuo]",
+        "['Rf']",
+        "C1CC",
+        "C(C",
+        "C)C",
+        "[C",
+        "CC=",
+        "C11",
+        "C12CC12",
+        "(C)C",
+        "C(1)",
+        "C.=C",
+        "[C@@@H](F)(Cl)Br",
+        "[Hx]",
+        "[Cc]",
+        "[CHg]",
+        "C C",
+        "%10",
+        "C%01C%01",
+        "[C+++]",
+        "[C:]",
+        "[00C]",
+        "[9999999999C]",
+        "Xe",
+        "",
+        "   ",
+    };
+    for (const auto &smi : smis) {
+      sameMol(smi, sanitized);
+      sameMol(smi, raw);
+    }
+    CHECK(SmilesParseOps::ParseSimpleSmiles("[#6]") == nullptr);
+    CHECK(SmilesParseOps::ParseSimpleSmiles("C~C") == nullptr);
+    CHECK(SmilesParseOps::ParseSimpleSmiles("C(C") == nullptr);
+  }
+  SECTION("v1 parameters") {
+    RDKit::v1::SmilesParserParams ps;
+    ps.useFastParser = true;
+    std::unique_ptr<RDKit::RWMol> mol(RDKit::SmilesToMol("c1ccccc1O", ps));
+    REQUIRE(mol);
+    CHECK(mol->getNumAtoms() == 7);
+  }
+}
+
+TEST_CASE("batched parsing") {
+  SECTION("SMILES") {
+    std::vector<std::string> smis = {"CCO", "c1ccccc1", "C1CC", "CN(C)(C)(C)C",
+                                     "", "c1ccccn1 pyridine"};
+    for (auto i = 0u; i < 100; ++i) {
+      smis.push_back(std::string(i % 20 + 1, 'C'));
+    }
+    std::vector<std::string_view> inputs(smis.begin(), smis.end());
+    for (auto numThreads : {1, 4}) {
+      INFO(numThreads);
+      auto results = SmilesParse::MolsFromSmiles(inputs, {}, numThreads);
+      REQUIRE(results.size() == smis.size());
+      for (auto i = 0u; i < smis.size(); ++i) {
+        INFO(smis[i]);
+        if (i == 2 || i == 3) {
+          CHECK(!results[i].mol);
+          CHECK(!results[i].error.empty());
+          continue;
+        }
+        auto expected = SmilesParse::MolFromSmiles(smis[i]);
+        REQUIRE(results[i].mol);
+        CHECK(results[i].error.empty());
+        CHECK(MolToSmiles(*results[i].mol) == MolToSmiles(*expected));
+      }
+      CHECK(results[5].mol->getProp<std::string>(RDKit::common_properties::_Name) ==
+            "pyridine");
+      CHECK(results[2].error.find("unclosed ring") != std::string::npos);
+      CHECK(results[3].error.find("valence") != std::string::npos);
+    }
+  }
+  SECTION("SMARTS") {
+    std::vector<std::string_view> inputs = {"[#6]-[#8]", "[C", "[$(CO)]C"};
+    auto results = SmilesParse::MolsFromSmarts(inputs, {}, 2);
+    REQUIRE(results.size() == 3);
+    REQUIRE(results[0].mol);
+    CHECK(MolToSmarts(*results[0].mol) == "[#6]-[#8]");
+    CHECK(!results[1].mol);
+    CHECK(!results[1].error.empty());
+    REQUIRE(results[2].mol);
+    CHECK(results[2].mol->getNumAtoms() == 2);
+  }
+}
@@ -15,12 +15,15 @@
 #include <GraphMol/Resonance.h>
 #include <GraphMol/MolBundle.h>
 #include <GraphMol/Chirality.h>
+#include <GraphMol/MolPickler.h>
 
 #include "SubstructMatch.h"
 #include "SubstructUtils.h"
 #include <GraphMol/GenericGroups/GenericGroups.h>
 #include <boost/smart_ptr.hpp>
+#include <deque>
 #include <map>
+#include <numeric>
 #include <span>
 
 #ifdef RDK_BUILD_THREADSAFE_SSS
@@ -121,10 +124,17 @@ typedef struct {
   const SubstructMatchParameters &params;
 } ResSubstructMatchHelperArgs_;
 
+// used to share the matches of recursive queries between searches
+struct RecursiveCacheContext {
+  const std::unordered_map<const RecursiveStructureQuery *, std::string> &keys;
+  RecursiveMatchCache &cache;
+};
+
 void MatchSubqueries(const ROMol &mol, QueryAtom::QUERYATOM_QUERY *q,
                      const SubstructMatchParameters &params,
                      SUBQUERY_MAP &subqueryMap,
-                     std::vector<RecursiveStructureQuery *> &locked);
+                     std::vector<RecursiveStructureQuery *> &locked,
+                     const RecursiveCacheContext *cacheContext = nullptr);
 
 bool insertIfNeeded(std::set<MatchVectType> &matches, const MatchVectType &m) {
   bool shouldInsert = true;
@@ -440,6 +450,26 @@ class BondLabelFunctor {
   const ROMol &d_mol;
   const SubstructMatchParameters &d_params;
 };
+// checks the prefilters before the full atom queries
+class PrefilteredAtomLabelFunctor {
+ public:
+  PrefilteredAtomLabelFunctor(const ROMol &query, const ROMol &mol,
+                              const SubstructMatchParameters &ps,
+                              const AtomDomains &domains)
+      : d_labeler(query, mol, ps), d_domains(domains) {}
+
+  bool operator()(unsigned int i, unsigned int j) const {
+    if (!d_domains.contains(i, j)) {
+      return false;
+    }
+    return d_labeler(i, j);
+  }
+
+ private:
+  AtomLabelFunctor d_labeler;
+  const AtomDomains &d_domains;
+};
+
 void ResSubstructMatchHelper_(const ResSubstructMatchHelperArgs_ &args,
                               std::set<MatchVectType> *matches, unsigned int bi,
                               unsigned int ei) {
@@ -475,39 +505,230 @@ struct RecursiveLocker {
 };
 }  // namespace detail
 
-// ----------------------------------------------
-//
-// find all matches
-std::vector<MatchVectType> SubstructMatch(
+namespace detail {
+namespace {
+AtomPrefilter queryPrefilter(const QueryAtom::QUERYATOM_QUERY *query) {
+  AtomPrefilter res;
+  if (!query || query->getNegation()) {
+    return res;
+  }
+  const auto &descr = query->getDescription();
+  if (descr == "AtomAnd") {
+    for (auto childIt = query->beginChildren();
+         childIt != query->endChildren(); ++childIt) {
+      auto child = queryPrefilter(childIt->get());
+      if (!child.anyElement) {
+        if (res.anyElement) {
+          res.elements = child.elements;
+          res.anyElement = false;
+        } else {
+          res.elements &= child.elements;
+        }
+      }
+      bool conflict = false;
+      for (auto [resVal, childVal] :
+           {std::make_pair(&res.aromatic, child.aromatic),
+            std::make_pair(&res.totalHs, child.totalHs),
+            std::make_pair(&res.inRing, child.inRing)}) {
+        if (childVal >= 0) {
+          conflict |= *resVal >= 0 && *resVal != childVal;
+          *resVal = childVal;
+        }
+      }
+      if (conflict) {
+        // nothing can match this
+        res.elements.reset();
+        res.anyElement = false;
+      }
+    }
+  } else if (descr == "AtomOr") {
+    bool first = true;
+    for (auto childIt = query->beginChildren();
+         childIt != query->endChildren(); ++childIt) {
+      auto child = queryPrefilter(childIt->get());
+      if (first) {
+        res = child;
+        first = false;
+        continue;
+      }
+      if (res.anyElement || child.anyElement) {
+        res.elements.reset();
+        res.anyElement = true;
+      } else {
+        res.elements |= child.elements;
+      }
+      for (auto [resVal, childVal] :
+           {std::make_pair(&res.aromatic, child.aromatic),
+            std::make_pair(&res.totalHs, child.totalHs),
+            std::make_pair(&res.inRing, child.inRing)}) {
+        if (*resVal != childVal) {
+          *resVal = -1;
+        }
+      }
+    }
+  } else if (descr == "AtomAtomicNum" || descr == "AtomType" ||
+             descr == "AtomIsAromatic" || descr == "AtomIsAliphatic" ||
+             descr == "AtomHCount" || descr == "AtomInRing" ||
+             descr == "AtomInNRings") {
+    const auto *eq = dynamic_cast<const ATOM_EQUALS_QUERY *>(query);
+    if (!eq || eq->getTol()) {
+      return res;
+    }
+    int val = eq->getVal();
+    if (descr == "AtomIsAromatic") {
+      res.aromatic = val ? 1 : 0;
+    } else if (descr == "AtomIsAliphatic") {
+      res.aromatic = val ? 0 : 1;
+    } else if (descr == "AtomHCount") {
+      res.totalHs = val >= 0 ? val : -1;
+    } else if (descr == "AtomInRing" || descr == "AtomInNRings") {
+      // a negative value in an AtomRingQuery means "in any ring"
+      if (val < 0 && dynamic_cast<const AtomRingQuery *>(query)) {
+        val = 1;
+      }
+      res.inRing = val > 0 ? 1 : (val == 0 ? 0 : -1);
+    } else {
+      if (descr == "AtomType") {
+        res.aromatic = getAtomTypeIsAromatic(val);
+        val = getAtomTypeAtomicNum(val);
+      }
+      if (val >= 0 && val < static_cast<int>(res.elements.size())) {
+        res.elements.set(val);
+        res.anyElement = false;
+      }
+    }
+  }
+  return res;
+}
+
+// the recursive queries are identified by their pickled query molecules
+void addRecursiveKeys(
+    const QueryAtom::QUERYATOM_QUERY *query,
+    std::unordered_map<const RecursiveStructureQuery *, std::string> &keys) {
+  if (query->getDescription() == "RecursiveStructure") {
+    const auto *rsq = static_cast<const RecursiveStructureQuery *>(query);
+    const ROMol *queryMol = rsq->getQueryMol();
+    if (queryMol && !keys.count(rsq)) {
+      std::string key;
+      try {
+        MolPickler::pickleMol(*queryMol, key, PicklerOps::NoProps);
+      } catch (const MolPicklerException &) {
+        // this one can't be shared
+        key.clear();
+      }
+      if (!key.empty()) {
+        int rootIdx = 0;
+        queryMol->getPropIfPresent(common_properties::_queryRootAtom,
+                                   rootIdx);
+        key += ":" + std::to_string(rootIdx);
+        keys[rsq] = std::move(key);
+      }
+      for (const auto atom : queryMol->atoms()) {
+        if (atom->hasQuery()) {
+          addRecursiveKeys(atom->getQuery(), keys);
+        }
+      }
+    }
+  }
+  for (auto childIt = query->beginChildren(); childIt != query->endChildren();
+       ++childIt) {
+    addRecursiveKeys(childIt->get(), keys);
+  }
+}
+
+bool hasRecursiveQuery(const QueryAtom::QUERYATOM_QUERY *query) {
+  if (query->getDescription() == "RecursiveStructure") {
+    return true;
+  }
+  for (auto childIt = query->beginChildren(); childIt != query->endChildren();
+       ++childIt) {
+    if (hasRecursiveQuery(childIt->get())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// lower is more selective
+int prefilterRank(const AtomPrefilter &prefilter) {
+  if (prefilter.anyElement) {
+    return 3;
+  }
+  auto count = prefilter.elements.count();
+  if (count == 0 || (count == 1 && !prefilter.elements[6])) {
+    return 0;
+  }
+  return count == 1 ? 1 : 2;
+}
+
+std::vector<MatchVectType> substructMatch(
     const ROMol &mol, const ROMol &query,
-    const SubstructMatchParameters &params) {
+    const SubstructMatchParameters &params,
+    const PreparedSubstructQuery *prepared) {
   std::vector<MatchVectType> matches;
   if (!mol.getNumAtoms() || !query.getNumAtoms()) {
     return matches;
   }
 
+  // the domains don't depend on the recursive queries, so we can give up
+  // before those are matched
+  std::unique_ptr<AtomDomains> domains;
+  if (prepared) {
+    // query-query matches don't use the molecule atom's properties
+    domains.reset(new AtomDomains(query, mol, prepared->getAtomPrefilters(),
+                                  params.useQueryQueryMatches));
+    if (domains->empty()) {
+      return matches;
+    }
+  }
+
   detail::RecursiveLocker locker(query, params.recursionPossible);
 
   if (params.recursionPossible) {
     detail::SUBQUERY_MAP subqueryMap;
-    ROMol::ConstAtomIterator atIt;
-    for (const auto atom : query.atoms()) {
-      if (atom->hasQuery()) {
-        // std::cerr<<"recurse from atom "<<(*atIt)->getIdx()<<std::endl;
-        detail::MatchSubqueries(mol, atom->getQuery(), params, subqueryMap,
-                                locker.locked);
+    if (prepared) {
+      std::unique_ptr<RecursiveCacheContext> cacheContext;
+      auto cache = RecursiveMatchCache::getActive(mol);
+      if (cache && !prepared->getRecursiveAtoms().empty() &&
+          cache->prepare(params)) {
+        cacheContext.reset(
+            new RecursiveCacheContext{prepared->getRecursiveKeys(), *cache});
+      }
+      for (auto idx : prepared->getRecursiveAtoms()) {
+        detail::MatchSubqueries(mol, query.getAtomWithIdx(idx)->getQuery(),
+                                params, subqueryMap, locker.locked,
+                                cacheContext.get());
+      }
+    } else {
+      for (const auto atom : query.atoms()) {
+        if (atom->hasQuery()) {
+          // std::cerr<<"recurse from atom "<<(*atIt)->getIdx()<<std::endl;
+          detail::MatchSubqueries(mol, atom->getQuery(), params, subqueryMap,
+                                  locker.locked);
+        }
       }
     }
   }
 
-  detail::AtomLabelFunctor atomLabeler(query, mol, params);
   detail::BondLabelFunctor bondLabeler(query, mol, params);
   MolMatchFinalCheckFunctor matchChecker(query, mol, params);
 
   std::vector<detail::ssPairType> pms;
-  bool found =
-      boost::vf2_all(query.getTopology(), mol.getTopology(), atomLabeler,
-                     bondLabeler, matchChecker, pms, params.maxMatches);
+  bool found;
+  if (prepared) {
+    detail::PrefilteredAtomLabelFunctor atomLabeler(query, mol, params,
+                                                    *domains);
+    const auto &order = prepared->getAtomOrder();
+    found = boost::vf2_all(query.getTopology(), mol.getTopology(),
+                           atomLabeler, bondLabeler, matchChecker, pms,
+                           params.maxMatches,
+                           order.empty() ? nullptr : order.data());
+  } else {
+    detail::AtomLabelFunctor atomLabeler(query, mol, params);
+    found =
+        boost::vf2_all(query.getTopology(), mol.getTopology(), atomLabeler,
+                       bondLabeler, matchChecker, pms, params.maxMatches);
+  }
   if (found) {
     const unsigned int nQueryAtoms = query.getNumAtoms();
     matches.reserve(pms.size());
@@ -521,6 +742,274 @@ std::vector<MatchVectType> SubstructMatch(
   }
   return matches;
 }
+}  // namespace
+
+bool AtomPrefilter::passes(const Atom *atom) const {
+  PRECONDITION(atom, "bad atom");
+  if (!anyElement) {
+    auto num = atom->getAtomicNum();
+    if (num < 0 || num >= static_cast<int>(elements.size()) ||
+        !elements[num]) {
+      return false;
+    }
+  }
+  if (aromatic >= 0 && atom->getIsAromatic() != static_cast<bool>(aromatic)) {
+    return false;
+  }
+  if (totalHs >= 0 && !atom->needsUpdatePropertyCache() &&
+      static_cast<int>(atom->getTotalNumHs(true)) != totalHs) {
+    return false;
+  }
+  if (inRing >= 0 && atom->hasOwningMol()) {
+    const auto ringInfo = atom->getOwningMol().getRingInfo();
+    if (ringInfo->isInitialized() &&
+        (ringInfo->numAtomRings(atom->getIdx()) != 0) !=
+            static_cast<bool>(inRing)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+AtomPrefilter makeAtomPrefilter(const Atom *queryAtom) {
+  PRECONDITION(queryAtom, "bad atom");
+  if (queryAtom->hasQuery()) {
+    return queryPrefilter(queryAtom->getQuery());
+  }
+  // plain atoms only match atoms of the same element
+  AtomPrefilter res;
+  auto num = queryAtom->getAtomicNum();
+  if (num >= 0 && num < static_cast<int>(res.elements.size())) {
+    res.elements.set(num);
+    res.anyElement = false;
+  }
+  return res;
+}
+
+AtomDomains::AtomDomains(const ROMol &query, const ROMol &mol,
+                         const std::vector<AtomPrefilter> &prefilters,
+                         bool skipQueryAtoms) {
+  PRECONDITION(prefilters.size() == query.getNumAtoms(),
+               "one prefilter is needed per query atom");
+  const auto nQueryAtoms = query.getNumAtoms();
+  const auto nAtoms = mol.getNumAtoms();
+  d_domains.resize(nQueryAtoms, boost::dynamic_bitset<>(nAtoms));
+  for (const auto qAt : query.atoms()) {
+    auto &domain = d_domains[qAt->getIdx()];
+    const auto &prefilter = prefilters[qAt->getIdx()];
+    const auto degree = qAt->getDegree();
+    for (const auto mAt : mol.atoms()) {
+      if (mAt->getDegree() >= degree &&
+          ((skipQueryAtoms && mAt->hasQuery()) || prefilter.passes(mAt))) {
+        domain.set(mAt->getIdx());
+      }
+    }
+    if (domain.none()) {
+      d_empty = true;
+      return;
+    }
+  }
+
+  // each query atom in the queue has had its domain reduced, so the
+  // domains of its neighbors have to be checked again
+  std::deque<unsigned int> queue(nQueryAtoms);
+  std::iota(queue.begin(), queue.end(), 0);
+  std::vector<char> queued(nQueryAtoms, 1);
+  boost::dynamic_bitset<> support(nAtoms);
+  while (!queue.empty()) {
+    auto k = queue.front();
+    queue.pop_front();
+    queued[k] = 0;
+    const auto &domain = d_domains[k];
+    support.reset();
+    for (auto j = domain.find_first(); j != boost::dynamic_bitset<>::npos;
+         j = domain.find_next(j)) {
+      for (const auto nbr : mol.atomNeighbors(mol.getAtomWithIdx(j))) {
+        support.set(nbr->getIdx());
+      }
+    }
+    for (const auto qNbr : query.atomNeighbors(query.getAtomWithIdx(k))) {
+      auto i = qNbr->getIdx();
+      auto &nbrDomain = d_domains[i];
+      if (nbrDomain.is_subset_of(support)) {
+        continue;
+      }
+      nbrDomain &= support;
+      if (nbrDomain.none()) {
+        d_empty = true;
+        return;
+      }
+      if (!queued[i]) {
+        queue.push_back(i);
+        queued[i] = 1;
+      }
+    }
+  }
+}
+}  // namespace detail
+
+PreparedSubstructQuery::PreparedSubstructQuery(const ROMol &query,
+                                               bool reorderAtoms)
+    : d_query(query) {
+  d_prefilters.reserve(query.getNumAtoms());
+  for (const auto atom : query.atoms()) {
+    d_prefilters.push_back(detail::makeAtomPrefilter(atom));
+    if (atom->hasQuery() && detail::hasRecursiveQuery(atom->getQuery())) {
+      d_recursiveAtoms.push_back(atom->getIdx());
+      detail::addRecursiveKeys(atom->getQuery(), d_recursiveKeys);
+    }
+  }
+  if (reorderAtoms) {
+    d_atomOrder.resize(query.getNumAtoms());
+    std::iota(d_atomOrder.begin(), d_atomOrder.end(), 0);
+    std::stable_sort(d_atomOrder.begin(), d_atomOrder.end(),
+                     [&](std::uint32_t a, std::uint32_t b) {
+                       auto ra = detail::prefilterRank(d_prefilters[a]);
+                       auto rb = detail::prefilterRank(d_prefilters[b]);
+                       if (ra != rb) {
+                         return ra < rb;
+                       }
+                       return query.getAtomWithIdx(a)->getDegree() >
+                              query.getAtomWithIdx(b)->getDegree();
+                     });
+  }
+}
+
+namespace {
+// the innermost RecursiveMatchCache on this thread
+thread_local RecursiveMatchCache *activeRecursiveMatchCache = nullptr;
+
+// the parameters which change the matches of recursive queries
+std::string recursiveParamsKey(const SubstructMatchParameters &params) {
+  std::string res;
+  for (auto flag :
+       {params.useChirality, params.useEnhancedStereo,
+        params.aromaticMatchesConjugated, params.useQueryQueryMatches,
+        params.useGenericMatchers,
+        params.specifiedStereoQueryMatchesUnspecified,
+        params.aromaticMatchesSingleOrDouble}) {
+    res += flag ? '1' : '0';
+  }
+  res += std::to_string(
+      std::max(params.maxRecursiveMatches, params.maxMatches));
+  for (const auto &prop : params.atomProperties) {
+    res += "|a" + prop;
+  }
+  for (const auto &prop : params.bondProperties) {
+    res += "|b" + prop;
+  }
+  return res;
+}
+
+// records the parts of the molecule the atom and bond queries look at, the
+// record changes when the molecule is edited. The values are compared
+// directly rather than hashed, so an edit can't go unnoticed.
+void getMolState(const ROMol &mol, std::vector<int> &res) {
+  res.clear();
+  res.reserve(2 + 10 * mol.getNumAtoms() + 6 * mol.getNumBonds() + 2);
+  res.push_back(static_cast<int>(mol.getNumAtoms()));
+  res.push_back(static_cast<int>(mol.getNumBonds()));
+  for (const auto atom : mol.atoms()) {
+    res.push_back(atom->getAtomicNum());
+    res.push_back(atom->getFormalCharge());
+    res.push_back(static_cast<int>(atom->getIsotope()));
+    res.push_back(static_cast<int>(atom->getNumExplicitHs()));
+    res.push_back(atom->getNoImplicit());
+    res.push_back(atom->getIsAromatic());
+    res.push_back(static_cast<int>(atom->getChiralTag()));
+    res.push_back(static_cast<int>(atom->getNumRadicalElectrons()));
+    res.push_back(static_cast<int>(atom->getHybridization()));
+    res.push_back(atom->needsUpdatePropertyCache()
+                      ? -1
+                      : static_cast<int>(atom->getTotalNumHs()));
+  }
+  for (const auto bond : mol.bonds()) {
+    res.push_back(static_cast<int>(bond->getBeginAtomIdx()));
+    res.push_back(static_cast<int>(bond->getEndAtomIdx()));
+    res.push_back(static_cast<int>(bond->getBondType()));
+    res.push_back(bond->getIsAromatic());
+    res.push_back(static_cast<int>(bond->getStereo()));
+    res.push_back(static_cast<int>(bond->getBondDir()));
+  }
+  const auto ringInfo = mol.getRingInfo();
+  res.push_back(ringInfo->isInitialized());
+  res.push_back(ringInfo->isInitialized()
+                    ? static_cast<int>(ringInfo->numRings())
+                    : -1);
+}
+}  // namespace
+
+RecursiveMatchCache::RecursiveMatchCache(const ROMol &mol)
+    : d_mol(mol), dp_previous(activeRecursiveMatchCache) {
+  getMolState(d_mol, d_molState);
+  activeRecursiveMatchCache = this;
+}
+
+RecursiveMatchCache::~RecursiveMatchCache() {
+  activeRecursiveMatchCache = dp_previous;
+}
+
+void RecursiveMatchCache::clear() {
+  d_matches.clear();
+  getMolState(d_mol, d_molState);
+}
+
+RecursiveMatchCache *RecursiveMatchCache::getActive(const ROMol &mol) {
+  for (auto cache = activeRecursiveMatchCache; cache;
+       cache = cache->dp_previous) {
+    if (&cache->d_mol == &mol) {
+      return cache;
+    }
+  }
+  return nullptr;
+}
+
+bool RecursiveMatchCache::prepare(const SubstructMatchParameters &params) {
+  if (params.extraFinalCheck) {
+    return false;
+  }
+  thread_local std::vector<int> molState;
+  getMolState(d_mol, molState);
+  if (molState != d_molState) {
+    d_matches.clear();
+    d_molState.swap(molState);
+  }
+  auto paramsKey = recursiveParamsKey(params);
+  if (paramsKey != d_paramsKey) {
+    clear();
+    d_paramsKey = std::move(paramsKey);
+  }
+  return true;
+}
+
+const std::vector<int> *RecursiveMatchCache::find(const std::string &key) {
+  auto res = d_matches.find(key);
+  if (res == d_matches.end()) {
+    return nullptr;
+  }
+  ++d_numHits;
+  return &res->second;
+}
+
+void RecursiveMatchCache::insert(const std::string &key,
+                                 std::vector<int> matches) {
+  d_matches[key] = std::move(matches);
+}
+
+// ----------------------------------------------
+//
+// find all matches
+std::vector<MatchVectType> SubstructMatch(
+    const ROMol &mol, const ROMol &query,
+    const SubstructMatchParameters &params) {
+  return detail::substructMatch(mol, query, params, nullptr);
+}
+
+std::vector<MatchVectType> SubstructMatch(
+    const ROMol &mol, const PreparedSubstructQuery &query,
+    const SubstructMatchParameters &params) {
+  return detail::substructMatch(mol, query.getQuery(), params, &query);
+}
 
 std::vector<MatchVectType> SubstructMatch(
     const MolBundle &bundle, const ROMol &query,
@@ -608,13 +1097,15 @@ unsigned int RecursiveMatcher(const ROMol &mol, const ROMol &query,
                               std::vector<int> &matches,
                               SUBQUERY_MAP &subqueryMap,
                               const SubstructMatchParameters &params,
-                              std::vector<RecursiveStructureQuery *> &locked) {
+                              std::vector<RecursiveStructureQuery *> &locked,
+                              const RecursiveCacheContext *cacheContext) {
   SubstructMatchParameters lparams = params;
   lparams.maxMatches = std::max(params.maxRecursiveMatches, params.maxMatches);
   lparams.uniquify = false;
   for (auto qAtom : query.atoms()) {
     if (qAtom->hasQuery()) {
-      MatchSubqueries(mol, qAtom->getQuery(), lparams, subqueryMap, locked);
+      MatchSubqueries(mol, qAtom->getQuery(), lparams, subqueryMap, locked,
+                      cacheContext);
     }
   }
 
@@ -663,7 +1154,8 @@ unsigned int RecursiveMatcher(const ROMol &mol, const ROMol &query,
 void MatchSubqueries(const ROMol &mol, QueryAtom::QUERYATOM_QUERY *query,
                      const SubstructMatchParameters &params,
                      SUBQUERY_MAP &subqueryMap,
-                     std::vector<RecursiveStructureQuery *> &locked) {
+                     std::vector<RecursiveStructureQuery *> &locked,
+                     const RecursiveCacheContext *cacheContext) {
   PRECONDITION(query, "bad query");
   if (query->getDescription() == "RecursiveStructure") {
     auto *rsq = (RecursiveStructureQuery *)query;
@@ -686,18 +1178,40 @@ void MatchSubqueries(const ROMol &mol, QueryAtom::QUERYATOM_QUERY *query,
       }
     }
 
+    const std::string *cacheKey = nullptr;
+    if (!matchDone && cacheContext) {
+      auto key = cacheContext->keys.find(rsq);
+      if (key != cacheContext->keys.end()) {
+        cacheKey = &key->second;
+        if (const auto *cached = cacheContext->cache.find(*cacheKey)) {
+          // another search of this molecule has matched this already
+          matchDone = true;
+          for (auto matchStart : *cached) {
+            rsq->insert(matchStart);
+          }
+          if (rsq->getSerialNumber()) {
+            subqueryMap[rsq->getSerialNumber()] = query;
+          }
+        }
+      }
+    }
+
     if (!matchDone) {
       ROMol const *queryMol = rsq->getQueryMol();
       // in case we are reusing this query, clear its contents now.
       if (queryMol) {
         std::vector<int> matchStarts;
-        unsigned int res = RecursiveMatcher(mol, *queryMol, matchStarts,
-                                            subqueryMap, params, locked);
+        unsigned int res =
+            RecursiveMatcher(mol, *queryMol, matchStarts, subqueryMap, params,
+                             locked, cacheContext);
         if (res) {
           for (int &matchStart : matchStarts) {
             rsq->insert(matchStart);
           }
         }
+        if (cacheKey) {
+          cacheContext->cache.insert(*cacheKey, std::move(matchStarts));
+        }
       }
       if (rsq->getSerialNumber()) {
         subqueryMap[rsq->getSerialNumber()] = query;
@@ -708,7 +1222,8 @@ void MatchSubqueries(const ROMol &mol, QueryAtom::QUERYATOM_QUERY *query,
   // now recurse over our children (these things can be nested)
   for (auto childIt = query->beginChildren(); childIt != query->endChildren();
        ++childIt) {
-    MatchSubqueries(mol, childIt->get(), params, subqueryMap, locked);
+    MatchSubqueries(mol, childIt->get(), params, subqueryMap, locked,
+                    cacheContext);
   }
   // std::cout << "<<- back " << (int)query << std::endl;
 }
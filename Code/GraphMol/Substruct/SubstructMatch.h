@@ -13,6 +13,7 @@
 
 // std bits
 #include <vector>
+#include <bitset>
 
 #include <unordered_set>
 #include <functional>
@@ -34,6 +35,7 @@ class Atom;
 class Bond;
 class ResonanceMolSupplier;
 class MolBundle;
+class RecursiveStructureQuery;
 
 //! \brief used to return matches from substructure searching,
 //!   The format is (queryAtomIdx, molAtomIdx)
@@ -118,6 +120,196 @@ RDKIT_SUBSTRUCTMATCH_EXPORT std::vector<MatchVectType> SubstructMatch(
     const MolBundle &bundle, const MolBundle &query,
     const SubstructMatchParameters &params = SubstructMatchParameters());
 
+namespace detail {
+//! Conditions a molecule atom must meet to match a query atom
+/*!
+  These are derived from the query once and are cheap to check, so they are
+  tested before the full atom query is evaluated. They are necessary
+  conditions only: an atom which passes still has to match the query.
+*/
+struct RDKIT_SUBSTRUCTMATCH_EXPORT AtomPrefilter {
+  std::bitset<128> elements;  //!< the allowed atomic numbers
+  bool anyElement = true;     //!< the atomic number is not constrained
+  int aromatic = -1;  //!< 1: must be aromatic, 0: must be aliphatic, -1: either
+  int totalHs = -1;   //!< the total number of Hs, -1: not constrained
+  int inRing = -1;    //!< 1: must be in a ring, 0: must not be, -1: either
+  //! the H count is only checked if the atom's property cache is current
+  //! and ring membership only if the ring info is initialized
+  bool passes(const Atom *atom) const;
+};
+//! Returns the prefilter for a query atom
+RDKIT_SUBSTRUCTMATCH_EXPORT AtomPrefilter
+makeAtomPrefilter(const Atom *queryAtom);
+
+//! The molecule atoms which each query atom could still be mapped to
+/*!
+  A domain starts as the molecule atoms which pass the query atom's
+  prefilter and have at least as many neighbors. The domains are then made
+  arc consistent: a molecule atom is dropped from a query atom's domain if
+  one of the query atom's neighbors has no candidate among its neighbors.
+  This is repeated until nothing changes.
+
+  If \c skipQueryAtoms is set, molecule atoms with queries are only
+  checked for their degree (used for query-query matching).
+*/
+class RDKIT_SUBSTRUCTMATCH_EXPORT AtomDomains {
+ public:
+  AtomDomains(const ROMol &query, const ROMol &mol,
+              const std::vector<AtomPrefilter> &prefilters,
+              bool skipQueryAtoms = false);
+
+  //! Returns whether or not some query atom has no candidates left, in
+  //! which case there can be no match
+  bool empty() const { return d_empty; }
+  //! Returns whether or not molecule atom \c molIdx is in the domain of
+  //! query atom \c queryIdx
+  bool contains(unsigned int queryIdx, unsigned int molIdx) const {
+    return d_domains[queryIdx][molIdx];
+  }
+  //! Returns the domain of query atom \c queryIdx
+  const boost::dynamic_bitset<> &getDomain(unsigned int queryIdx) const {
+    return d_domains.at(queryIdx);
+  }
+
+ private:
+  std::vector<boost::dynamic_bitset<>> d_domains;
+  bool d_empty = false;
+};
+}  // namespace detail
+
+//! A query molecule which has been prepared for matching many molecules
+/*!
+  The work which does not depend on the molecule being searched is done
+  once, when the query is prepared:
+    - each query atom is reduced to an AtomPrefilter, these are used to
+      build the AtomDomains for each molecule before the search starts
+    - the query atoms which have recursive queries are found
+    - if \c reorderAtoms is set, the search starts from the most selective
+      query atom instead of the first one
+
+  Reordering the atoms does not change which matches exist, but they may be
+  found in a different order, so a different subset can be returned if
+  maxMatches is reached.
+
+  The query molecule is not copied: it must not be modified or destroyed
+  while the prepared query is in use.
+*/
+class RDKIT_SUBSTRUCTMATCH_EXPORT PreparedSubstructQuery {
+ public:
+  explicit PreparedSubstructQuery(const ROMol &query,
+                                  bool reorderAtoms = true);
+
+  //! Returns the query molecule
+  const ROMol &getQuery() const { return d_query; }
+  //! Returns the prefilters for the query atoms
+  const std::vector<detail::AtomPrefilter> &getAtomPrefilters() const {
+    return d_prefilters;
+  }
+  //! Returns the indices of the atoms which have recursive queries
+  const std::vector<unsigned int> &getRecursiveAtoms() const {
+    return d_recursiveAtoms;
+  }
+  //! Returns the order used to pick the first query atom of each
+  //! connected component, empty if the query's atom order is used
+  const std::vector<std::uint32_t> &getAtomOrder() const {
+    return d_atomOrder;
+  }
+  //! Returns the keys used to share the results of the recursive queries
+  //! in a RecursiveMatchCache, nested recursive queries are included
+  const std::unordered_map<const RecursiveStructureQuery *, std::string> &
+  getRecursiveKeys() const {
+    return d_recursiveKeys;
+  }
+
+ private:
+  const ROMol &d_query;
+  std::vector<detail::AtomPrefilter> d_prefilters;
+  std::vector<unsigned int> d_recursiveAtoms;
+  std::vector<std::uint32_t> d_atomOrder;
+  std::unordered_map<const RecursiveStructureQuery *, std::string>
+      d_recursiveKeys;
+};
+
+//! Shares the matches of recursive queries between searches of a molecule
+/*!
+  While a RecursiveMatchCache exists, substructure searches of its molecule
+  with a PreparedSubstructQuery on the same thread reuse the matches of
+  recursive queries (the $() parts of SMARTS) which have already been
+  found, even if they came from a different query. This helps when many
+  patterns which share recursive environments, like the FilterCatalog sets,
+  are matched against one molecule.
+
+  Recursive queries are identified by their pickled query molecule. The
+  matches depend on the search parameters, so the stored matches are
+  dropped when they change, and searches with an extraFinalCheck don't use
+  the cache.
+
+  Each search compares a record of the molecule's atoms, bonds and rings
+  (elements, charges, isotopes, H counts, aromaticity, bond orders, stereo
+  and so on) with the one taken when the matches were stored, and the cache
+  is cleared when they differ. Changes to properties
+  which are matched with SubstructMatchParameters::atomProperties or
+  bondProperties aren't noticed, clear() must be called after those.
+
+  \code
+  RecursiveMatchCache cache(mol);
+  for (const auto &query : preparedQueries) {
+    auto matches = SubstructMatch(mol, query);
+  }
+  \endcode
+*/
+class RDKIT_SUBSTRUCTMATCH_EXPORT RecursiveMatchCache {
+ public:
+  explicit RecursiveMatchCache(const ROMol &mol);
+  RecursiveMatchCache(const RecursiveMatchCache &) = delete;
+  RecursiveMatchCache &operator=(const RecursiveMatchCache &) = delete;
+  ~RecursiveMatchCache();
+
+  //! Returns the molecule the matches are for
+  const ROMol &getMol() const { return d_mol; }
+  //! Drops the stored matches
+  void clear();
+  //! Returns the number of recursive queries with stored matches
+  unsigned int size() const {
+    return static_cast<unsigned int>(d_matches.size());
+  }
+  //! Returns the number of times stored matches have been reused
+  unsigned int getNumHits() const { return d_numHits; }
+
+  //! Returns the innermost cache for \c mol on this thread, if any
+  static RecursiveMatchCache *getActive(const ROMol &mol);
+
+  //! \name used by the substructure matcher
+  //! @{
+  //! Drops the stored matches if the molecule or the parameters changed,
+  //! returns false if the cache can't be used with \c params
+  bool prepare(const SubstructMatchParameters &params);
+  const std::vector<int> *find(const std::string &key);
+  void insert(const std::string &key, std::vector<int> matches);
+  //! @}
+
+ private:
+  const ROMol &d_mol;
+  std::vector<int> d_molState;
+  std::string d_paramsKey;
+  std::unordered_map<std::string, std::vector<int>> d_matches;
+  unsigned int d_numHits = 0;
+  RecursiveMatchCache *dp_previous;
+};
+
+//! Find substructure matches for a prepared query in a molecule
+/*!
+    \param mol         The ROMol to be searched
+    \param query       The prepared query
+    \param matchParams Parameters controlling the matching
+
+    \return The matches, if any
+
+*/
+RDKIT_SUBSTRUCTMATCH_EXPORT std::vector<MatchVectType> SubstructMatch(
+    const ROMol &mol, const PreparedSubstructQuery &query,
+    const SubstructMatchParameters &params = SubstructMatchParameters());
+
 //! Find a substructure match for a query
 /*!
     \param mol       The object to be searched
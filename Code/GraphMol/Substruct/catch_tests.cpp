@@ -12,6 +12,7 @@
 
 #include <catch2/catch_all.hpp>
 
+#include <set>
 #include <tuple>
 #include <utility>
 
@@ -908,4 +909,244 @@ TEST_CASE(
     CHECK(!SubstructMatch(*m1, *m2, ps).empty());
     CHECK(!SubstructMatch(*m2, *m1, ps).empty());
   }
-}
\ No newline at end of file
+}
+TEST_CASE("prepared queries") {
+  std::vector<std::string> smis = {
+      "CC(=O)Oc1ccccc1C(=O)O", "c1ccc2c(c1)[nH]c1ccccc12",
+      "O=C(O)CCN", "C[C@H](N)C(=O)O", "ClC(Cl)(Cl)Br",
+      "c1ccncc1CC1CCCCN1", "[O-][n+]1ccccc1", "OCC(O)CO"};
+  std::vector<std::string> smarts = {
+      "[#6]=O",     "c[OH1]",         "[C,N;!R]",  "[$(C=O),$(N)]~*",
+      "[n;H1]",     "a:a-[CH2]",      "[!#6;!#1]", "[$(*[OX2H])]",
+      "[c,n]1ccccc1", "C(Cl)(Cl)",    "[#7;R]",    "*~*~*",
+      "[Cl,Br]",    "[N+,n+]-[O-]",   "[$([CX3]=[OX1])]O"};
+  SubstructMatchParameters ps;
+  ps.uniquify = false;
+  for (const auto &sma : smarts) {
+    INFO(sma);
+    std::unique_ptr<RWMol> query(SmartsToMol(sma));
+    REQUIRE(query);
+    PreparedSubstructQuery prepared(*query);
+    PreparedSubstructQuery inOrder(*query, false);
+    CHECK(inOrder.getAtomOrder().empty());
+    CHECK(prepared.getAtomOrder().size() == query->getNumAtoms());
+    for (const auto &smi : smis) {
+      INFO(smi);
+      std::unique_ptr<RWMol> mol(SmilesToMol(smi));
+      REQUIRE(mol);
+      auto expected = SubstructMatch(*mol, *query, ps);
+      // the atom order is unchanged, so the matches come in the same order
+      CHECK(SubstructMatch(*mol, inOrder, ps) == expected);
+      auto matches = SubstructMatch(*mol, prepared, ps);
+      std::sort(expected.begin(), expected.end());
+      std::sort(matches.begin(), matches.end());
+      CHECK(matches == expected);
+    }
+  }
+  SECTION("prefilters") {
+    auto query = "[C,N;!R][c;H1]*[$(C=O)]"_smarts;
+    REQUIRE(query);
+    PreparedSubstructQuery prepared(*query);
+    const auto &prefilters = prepared.getAtomPrefilters();
+    REQUIRE(prefilters.size() == 4);
+    CHECK(!prefilters[0].anyElement);
+    CHECK(prefilters[0].elements.count() == 2);
+    CHECK(prefilters[0].elements[6]);
+    CHECK(prefilters[0].elements[7]);
+    CHECK(prefilters[0].aromatic == 0);
+    CHECK(!prefilters[1].anyElement);
+    CHECK(prefilters[1].elements.count() == 1);
+    CHECK(prefilters[1].aromatic == 1);
+    CHECK(prefilters[2].anyElement);
+    CHECK(prefilters[2].aromatic == -1);
+    CHECK(prepared.getRecursiveAtoms() == std::vector<unsigned int>{3});
+    // the search starts from the aromatic carbon
+    CHECK(prepared.getAtomOrder().front() == 1);
+
+    auto negated = "[!C]"_smarts;
+    REQUIRE(negated);
+    CHECK(detail::makeAtomPrefilter(negated->getAtomWithIdx(0)).anyElement);
+    auto plain = "Cl"_smiles;
+    REQUIRE(plain);
+    auto prefilter = detail::makeAtomPrefilter(plain->getAtomWithIdx(0));
+    CHECK(prefilter.elements.count() == 1);
+    CHECK(prefilter.elements[17]);
+  }
+  SECTION("query-query matches") {
+    auto mol = "[C,N]CC"_smarts;
+    auto query = "[C,N]C"_smarts;
+    REQUIRE(mol);
+    REQUIRE(query);
+    SubstructMatchParameters qps;
+    qps.useQueryQueryMatches = true;
+    PreparedSubstructQuery prepared(*query);
+    CHECK(SubstructMatch(*mol, prepared, qps).size() ==
+          SubstructMatch(*mol, *query, qps).size());
+  }
+}
+
+TEST_CASE("sharing recursive query matches") {
+  auto mol = "OC(=O)c1ccccc1CC(=O)N"_smiles;
+  REQUIRE(mol);
+  auto q1 = "[$(C=O)]O"_smarts;
+  auto q2 = "[$(C=O);$(C-[#7])]"_smarts;
+  auto q3 = "c[$(C=O)]"_smarts;
+  REQUIRE(q1);
+  REQUIRE(q2);
+  REQUIRE(q3);
+  std::vector<std::unique_ptr<PreparedSubstructQuery>> queries;
+  for (const auto &q : {q1.get(), q2.get(), q3.get()}) {
+    queries.emplace_back(new PreparedSubstructQuery(*q));
+    CHECK(!queries.back()->getRecursiveKeys().empty());
+  }
+  // the same recursive query in different patterns has the same key
+  auto keys = [](const PreparedSubstructQuery &q) {
+    std::set<std::string> res;
+    for (const auto &[rsq, key] : q.getRecursiveKeys()) {
+      res.insert(key);
+    }
+    return res;
+  };
+  CHECK(keys(*queries[0]) == keys(*queries[2]));
+  CHECK(keys(*queries[1]).size() == 2);
+  CHECK(keys(*queries[1]).count(*keys(*queries[0]).begin()));
+
+  SubstructMatchParameters ps;
+  std::vector<std::vector<MatchVectType>> expected;
+  for (const auto &query : queries) {
+    expected.push_back(SubstructMatch(*mol, *query, ps));
+    CHECK(!expected.back().empty());
+  }
+  {
+    RecursiveMatchCache cache(*mol);
+    CHECK(RecursiveMatchCache::getActive(*mol) == &cache);
+    CHECK(RecursiveMatchCache::getActive(*q1) == nullptr);
+    for (unsigned int i = 0; i < queries.size(); ++i) {
+      CHECK(SubstructMatch(*mol, *queries[i], ps) == expected[i]);
+    }
+    CHECK(cache.size() == 2);
+    CHECK(cache.getNumHits() == 2);
+
+    // different parameters can't use the stored matches
+    SubstructMatchParameters chiralPs;
+    chiralPs.useChirality = true;
+    CHECK(SubstructMatch(*mol, *queries[0], chiralPs) == expected[0]);
+    CHECK(cache.size() == 1);
+    CHECK(cache.getNumHits() == 2);
+
+    // neither can a modified molecule
+    RWMol modified(*mol);
+    RecursiveMatchCache modifiedCache(modified);
+    CHECK(SubstructMatch(modified, *queries[0], ps) == expected[0]);
+    CHECK(modifiedCache.size() == 1);
+    modified.getAtomWithIdx(1)->setAtomicNum(7);
+    modified.removeBond(1, 2);
+    CHECK(SubstructMatch(modified, *queries[2], ps).empty());
+    CHECK(modifiedCache.getNumHits() == 0);
+
+    // edits which keep the size of the molecule are noticed too
+    RWMol edited(*mol);
+    RecursiveMatchCache editedCache(edited);
+    CHECK(SubstructMatch(edited, *queries[0], ps) == expected[0]);
+    for (auto bond : edited.bonds()) {
+      if (bond->getBondType() == Bond::DOUBLE) {
+        bond->setBondType(Bond::SINGLE);
+      }
+    }
+    edited.updatePropertyCache(false);
+    CHECK(SubstructMatch(edited, *queries[2], ps).empty());
+    CHECK(editedCache.getNumHits() == 0);
+  }
+  CHECK(RecursiveMatchCache::getActive(*mol) == nullptr);
+}
+
+TEST_CASE("atom domains") {
+  SECTION("prefilters") {
+    auto query = "[c;H1;R][CH2,CH3][CH2;H3]"_smarts;
+    REQUIRE(query);
+    PreparedSubstructQuery prepared(*query);
+    const auto &prefilters = prepared.getAtomPrefilters();
+    REQUIRE(prefilters.size() == 3);
+    CHECK(prefilters[0].totalHs == 1);
+    CHECK(prefilters[0].inRing == 1);
+    CHECK(prefilters[1].totalHs == -1);
+    CHECK(prefilters[1].inRing == -1);
+    // the H counts conflict
+    CHECK(!prefilters[2].anyElement);
+    CHECK(prefilters[2].elements.none());
+  }
+  SECTION("domains") {
+    auto mol = "CCC(=O)NC"_smiles;
+    REQUIRE(mol);
+    auto query = "C(=O)N"_smarts;
+    REQUIRE(query);
+    PreparedSubstructQuery prepared(*query);
+    detail::AtomDomains domains(*query, *mol, prepared.getAtomPrefilters());
+    CHECK(!domains.empty());
+    // only the carbonyl carbon has an oxygen neighbor
+    CHECK(domains.getDomain(0).count() == 1);
+    CHECK(domains.contains(0, 2));
+    CHECK(domains.getDomain(2).count() == 1);
+    CHECK(domains.contains(2, 4));
+  }
+  SECTION("H counts and rings") {
+    auto mol = "CC1CC1O"_smiles;
+    REQUIRE(mol);
+    auto query = "[CH3][CH1;R]"_smarts;
+    REQUIRE(query);
+    PreparedSubstructQuery prepared(*query);
+    detail::AtomDomains domains(*query, *mol, prepared.getAtomPrefilters());
+    CHECK(domains.getDomain(0).count() == 1);
+    CHECK(domains.contains(0, 0));
+    CHECK(domains.getDomain(1).count() == 1);
+    CHECK(domains.contains(1, 1));
+
+    // without ring info ring membership isn't checked
+    RWMol noRings(*mol);
+    noRings.getRingInfo()->reset();
+    auto ringQuery = "[R]"_smarts;
+    REQUIRE(ringQuery);
+    PreparedSubstructQuery preparedRing(*ringQuery);
+    detail::AtomDomains noRingDomains(*ringQuery, noRings,
+                                      preparedRing.getAtomPrefilters());
+    CHECK(noRingDomains.getDomain(0).count() == noRings.getNumAtoms());
+    detail::AtomDomains ringDomains(*ringQuery, *mol,
+                                    preparedRing.getAtomPrefilters());
+    CHECK(ringDomains.getDomain(0).count() == 3);
+  }
+  SECTION("no match") {
+    auto mol = "O=CCCC=O"_smiles;
+    REQUIRE(mol);
+    for (const auto sma : {"CC(C)(C)C", "O=CC=O"}) {
+      INFO(sma);
+      std::unique_ptr<RWMol> query(SmartsToMol(sma));
+      REQUIRE(query);
+      PreparedSubstructQuery prepared(*query);
+      detail::AtomDomains domains(*query, *mol, prepared.getAtomPrefilters());
+      CHECK(domains.empty());
+      CHECK(SubstructMatch(*mol, prepared).empty());
+      CHECK(SubstructMatch(*mol, *query).empty());
+    }
+  }
+  SECTION("large targets") {
+    // a cyclic peptide
+    auto mol =
+        "O=C1NC(CC(C)C)C(=O)NC(Cc2ccccc2)C(=O)NC(CO)C(=O)NC(C)C(=O)NC(CCCCN)C(=O)NC1CC(N)=O"_smiles;
+    REQUIRE(mol);
+    SubstructMatchParameters ps;
+    ps.uniquify = false;
+    for (const auto sma :
+         {"[NH1]C(=O)C[NH1]C(=O)", "[CH2][OH1]", "C(=O)[NH2]", "c1ccccc1C",
+          "[NH1;R]C(=O)C(CC(C)C)[NH1]", "[NH3+]"}) {
+      INFO(sma);
+      std::unique_ptr<RWMol> query(SmartsToMol(sma));
+      REQUIRE(query);
+      PreparedSubstructQuery prepared(*query);
+      auto expected = SubstructMatch(*mol, *query, ps);
+      auto matches = SubstructMatch(*mol, prepared, ps);
+      std::sort(expected.begin(), expected.end());
+      std::sort(matches.begin(), matches.end());
+      CHECK(matches == expected);
+    }
+  }
+}
@@ -166,14 +166,18 @@ class VF2SubState {
   node_id *term_1;
   node_id *term_2;
 
-  node_id *order;
+  const node_id *order;
+  bool own_order;
 
   long *share_count;
   int *vs_compared;
 
  public:
+  // if nodeOrder is provided it is used to pick the first node of each
+  // connected component of g1 and must outlive the state
   VF2SubState(Graph *ag1, Graph *ag2, VertexCompatible &avc,
-              EdgeCompatible &aec, MatchChecking &amc, bool sortNodes = false)
+              EdgeCompatible &aec, MatchChecking &amc, bool sortNodes = false,
+              const node_id *nodeOrder = nullptr)
       : g1(ag1),
         g2(ag2),
         vc(avc),
@@ -181,10 +185,15 @@ class VF2SubState {
         mc(amc),
         n1(num_vertices(*ag1)),
         n2(num_vertices(*ag2)) {
-    if (sortNodes) {
+    if (nodeOrder) {
+      order = nodeOrder;
+      own_order = false;
+    } else if (sortNodes) {
       order = SortNodesByFrequency(ag1);
+      own_order = true;
     } else {
       order = nullptr;
+      own_order = false;
     }
 
     core_len = 0;
@@ -222,6 +231,7 @@ class VF2SubState {
         n1(state.n1),
         n2(state.n2),
         order(state.order),
+        own_order(state.own_order),
         vs_compared(state.vs_compared)
   // es_compared(state.es_compared)
   {
@@ -245,7 +255,9 @@ class VF2SubState {
       delete[] term_1;
       delete[] term_2;
       delete share_count;
-      delete[] order;
+      if (own_order) {
+        delete[] order;
+      }
       // delete [] vs_compared;
       // delete es_compared;
     }
@@ -662,9 +674,11 @@ template <class Graph, class VertexLabeling  // binary predicate
           >
 bool vf2_all(const Graph &g1, const Graph &g2, VertexLabeling &vertex_labeling,
              EdgeLabeling &edge_labeling, MatchChecking &match_checking,
-             DoubleBackInsertionSequence &F, unsigned int max_results = 1000) {
+             DoubleBackInsertionSequence &F, unsigned int max_results = 1000,
+             const detail::node_id *node_order = nullptr) {
   detail::VF2SubState<const Graph, VertexLabeling, EdgeLabeling, MatchChecking>
-      s0(&g1, &g2, vertex_labeling, edge_labeling, match_checking, false);
+      s0(&g1, &g2, vertex_labeling, edge_labeling, match_checking, false,
+         node_order);
   std::unique_ptr<detail::node_id[]> ni1(new detail::node_id[num_vertices(g1)]);
   std::unique_ptr<detail::node_id[]> ni2(new detail::node_id[num_vertices(g2)]);
 
@@ -0,0 +1,744 @@
+//
+//  Copyright (C) 2026 RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "MappedSubstructLibrary.h"
+
+#include <RDGeneral/BadFileException.h>
+#include <RDGeneral/MemoryMappedFileReader.h>
+#include <RDGeneral/StreamOps.h>
+
+#include <bit>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <stdexcept>
+
+namespace RDKit {
+/* Layout of a mapped substructure library file. All integers are little
+   endian.
+
+   The header is a sequence of 8 byte fields:
+     magic                "RDKSSLIB"
+     version              currently 1
+     numMols
+     molFormat            a MappedMolFormat
+     molIndexOffset       numMols+1 uint64 offsets into the molecule data
+     molDataOffset        the concatenated pickles or SMILES
+     molDataSize
+     fpType               0: none, 1: PatternHolder, 2: TautomerPatternHolder
+     fpNumBits
+     fpStride             bytes used per fingerprint, a multiple of 8
+     fpOffset             numMols fingerprints, fpStride bytes apart
+     numKeys              either 0 or numMols
+     keyIndexOffset       numKeys+1 uint64 offsets into the key data
+     keyDataOffset
+     keyDataSize
+     keyPropNameOffset
+     keyPropNameSize
+     searchOrderSize
+     searchOrderOffset    searchOrderSize uint32 molecule indices
+
+   All offsets are from the start of the file. Every section starts on a
+   64 byte boundary so that the fingerprints are aligned for vectorized
+   screening.
+*/
+namespace detail {
+namespace {
+const std::string mappedMagic("RDKSSLIB", 8);
+const std::uint64_t mappedVersion = 1;
+const unsigned int numHeaderFields = 19;
+const std::uint64_t headerSize = 192;
+const std::uint64_t sectionAlignment = 64;
+
+enum HeaderField {
+  VersionField = 1,
+  NumMolsField,
+  MolFormatField,
+  MolIndexOffsetField,
+  MolDataOffsetField,
+  MolDataSizeField,
+  FpTypeField,
+  FpNumBitsField,
+  FpStrideField,
+  FpOffsetField,
+  NumKeysField,
+  KeyIndexOffsetField,
+  KeyDataOffsetField,
+  KeyDataSizeField,
+  KeyPropNameOffsetField,
+  KeyPropNameSizeField,
+  SearchOrderSizeField,
+  SearchOrderOffsetField,
+};
+
+enum MappedFPType : std::uint64_t {
+  NoFingerprints = 0,
+  PatternFingerprints = 1,
+  TautomerPatternFingerprints = 2,
+};
+
+template <typename T>
+T readLE(const char *loc) {
+  T res;
+  memcpy(&res, loc, sizeof(T));
+  return EndianSwapBytes<LITTLE_ENDIAN_ORDER, HOST_ENDIAN_ORDER>(res);
+}
+
+// bit i of the fingerprint is bit (i % 8) of byte (i / 8), independent of the
+// host byte order
+void fingerprintToBytes(const ExplicitBitVect &fp, std::uint64_t stride,
+                        std::vector<std::uint8_t> &res) {
+  using block_type = boost::dynamic_bitset<>::block_type;
+  thread_local std::vector<block_type> blocks;
+  blocks.clear();
+  boost::to_block_range(*fp.dp_bits, std::back_inserter(blocks));
+  res.assign(stride, 0);
+  unsigned int byteIdx = 0;
+  for (auto block : blocks) {
+    for (unsigned int i = 0; i < sizeof(block_type) && byteIdx < stride;
+         ++i, ++byteIdx) {
+      res[byteIdx] = static_cast<std::uint8_t>(block >> (8 * i));
+    }
+  }
+}
+}  // namespace
+
+struct MappedSubstructLibraryData {
+  std::unique_ptr<MemoryMappedFileReader> file;
+  std::uint64_t numMols{0};
+  MappedMolFormat molFormat{MappedMolFormat::Pickle};
+  const char *molIndex{nullptr};
+  const char *molData{nullptr};
+  std::uint64_t molDataSize{0};
+  std::uint64_t fpType{NoFingerprints};
+  std::uint64_t fpNumBits{0};
+  std::uint64_t fpStride{0};
+  const std::uint8_t *fps{nullptr};
+  std::uint64_t numKeys{0};
+  const char *keyIndex{nullptr};
+  const char *keyData{nullptr};
+  std::uint64_t keyDataSize{0};
+  std::string keyPropName;
+  std::uint64_t searchOrderSize{0};
+  const char *searchOrder{nullptr};
+
+  std::string_view getEntry(const char *index, const char *data,
+                            std::uint64_t dataSize, unsigned int idx) const {
+    auto start = readLE<std::uint64_t>(index + idx * sizeof(std::uint64_t));
+    auto end = readLE<std::uint64_t>(index + (idx + 1) * sizeof(std::uint64_t));
+    if (start > end || end > dataSize) {
+      throw ValueErrorException("corrupt mapped substructure library");
+    }
+    return std::string_view(data + start, end - start);
+  }
+  std::string_view getMol(unsigned int idx) const {
+    if (idx >= numMols) {
+      throw IndexErrorException(idx);
+    }
+    return getEntry(molIndex, molData, molDataSize, idx);
+  }
+  std::string_view getKey(unsigned int idx) const {
+    if (idx >= numKeys) {
+      throw IndexErrorException(idx);
+    }
+    return getEntry(keyIndex, keyData, keyDataSize, idx);
+  }
+  const std::uint8_t *queryToBytes(const ExplicitBitVect &query) const {
+    if (query.getNumBits() != fpNumBits) {
+      throw ValueErrorException(
+          "query fingerprint size does not match the library");
+    }
+    thread_local std::vector<std::uint8_t> queryBytes;
+    fingerprintToBytes(query, fpStride, queryBytes);
+    return queryBytes.data();
+  }
+  bool passesFilter(unsigned int idx, const ExplicitBitVect &query) const {
+    if (idx >= numMols) {
+      throw IndexErrorException(idx);
+    }
+    return CalcBitmapAllProbeBitsMatch(queryToBytes(query),
+                                       fps + idx * fpStride, fpStride);
+  }
+  void getOnBits(unsigned int idx, std::vector<unsigned int> &bits) const {
+    if (idx >= numMols) {
+      throw IndexErrorException(idx);
+    }
+    const auto *bytes = fps + idx * fpStride;
+    for (std::uint64_t i = 0; i < fpStride; ++i) {
+      for (unsigned int byte = bytes[i]; byte; byte &= byte - 1) {
+        bits.push_back(rdcast<unsigned int>(i * 8 + std::countr_zero(byte)));
+      }
+    }
+  }
+  ExplicitBitVect getFingerprint(unsigned int idx) const {
+    ExplicitBitVect res(rdcast<unsigned int>(fpNumBits));
+    std::vector<unsigned int> bits;
+    getOnBits(idx, bits);
+    for (auto bit : bits) {
+      res.setBit(bit);
+    }
+    return res;
+  }
+  const std::uint64_t *getFingerprintWords(unsigned int idx) const {
+    if (idx >= numMols) {
+      throw IndexErrorException(idx);
+    }
+    const auto *row = reinterpret_cast<const char *>(fps + idx * fpStride);
+    thread_local std::vector<std::uint64_t> words;
+    words.resize(fpStride / sizeof(std::uint64_t));
+    for (size_t i = 0; i < words.size(); ++i) {
+      words[i] = readLE<std::uint64_t>(row + i * sizeof(std::uint64_t));
+    }
+    return words.data();
+  }
+  // the fingerprints are already a bit matrix, so they are screened in place
+  void passesFilterBatch(const ExplicitBitVect &query, unsigned int startIdx,
+                         unsigned int count, unsigned int step,
+                         bool *res) const {
+    PRECONDITION(step > 0, "bad step");
+    if (!count) {
+      return;
+    }
+    const auto lastIdx =
+        startIdx + static_cast<std::uint64_t>(count - 1) * step;
+    if (lastIdx >= numMols) {
+      throw IndexErrorException(rdcast<int>(lastIdx));
+    }
+    CalcBitmapAllProbeBitsMatchBatch(
+        queryToBytes(query), fps + startIdx * fpStride, count,
+        rdcast<unsigned int>(fpStride), rdcast<unsigned int>(fpStride * step),
+        res);
+  }
+};
+
+namespace {
+boost::shared_ptr<const MappedSubstructLibraryData> openMappedLibrary(
+    const std::string &fname) {
+  auto res = boost::make_shared<MappedSubstructLibraryData>();
+  try {
+    res->file.reset(new MemoryMappedFileReader(fname));
+  } catch (const std::runtime_error &) {
+    throw BadFileException("Bad input file " + fname);
+  }
+  const char *base = res->file->d_mappedMemory;
+  const std::uint64_t size = res->file->d_size;
+  if (size < headerSize || mappedMagic != std::string(base, 8)) {
+    throw BadFileException(fname + " is not a mapped substructure library");
+  }
+  std::vector<std::uint64_t> header(numHeaderFields);
+  for (unsigned int i = 1; i < numHeaderFields; ++i) {
+    header[i] = readLE<std::uint64_t>(base + i * sizeof(std::uint64_t));
+  }
+  if (header[VersionField] != mappedVersion) {
+    throw BadFileException("unsupported mapped substructure library version " +
+                           std::to_string(header[VersionField]));
+  }
+  // returns a pointer to the section, after making sure it is in the file
+  auto section = [&](std::uint64_t offset, std::uint64_t count,
+                     std::uint64_t elementSize) -> const char * {
+    if (offset > size || (elementSize && count > (size - offset) / elementSize)) {
+      throw BadFileException("truncated mapped substructure library " + fname);
+    }
+    return base + offset;
+  };
+
+  res->numMols = header[NumMolsField];
+  if (res->numMols >= UINT_MAX) {
+    throw BadFileException("too many molecules in " + fname);
+  }
+  if (header[MolFormatField] > static_cast<std::uint64_t>(
+                                   MappedMolFormat::TrustedSmiles)) {
+    throw BadFileException("bad molecule format in " + fname);
+  }
+  res->molFormat = static_cast<MappedMolFormat>(header[MolFormatField]);
+  res->molIndex = section(header[MolIndexOffsetField], res->numMols + 1,
+                          sizeof(std::uint64_t));
+  res->molDataSize = header[MolDataSizeField];
+  res->molData = section(header[MolDataOffsetField], res->molDataSize, 1);
+
+  res->fpType = header[FpTypeField];
+  if (res->fpType > TautomerPatternFingerprints) {
+    throw BadFileException("bad fingerprint type in " + fname);
+  }
+  if (res->fpType != NoFingerprints) {
+    res->fpNumBits = header[FpNumBitsField];
+    res->fpStride = header[FpStrideField];
+    if (!res->fpNumBits || res->fpStride % sizeof(std::uint64_t) ||
+        res->fpStride * 8 < res->fpNumBits) {
+      throw BadFileException("bad fingerprint size in " + fname);
+    }
+    res->fps = reinterpret_cast<const std::uint8_t *>(
+        section(header[FpOffsetField], res->numMols, res->fpStride));
+  }
+
+  res->numKeys = header[NumKeysField];
+  if (res->numKeys) {
+    if (res->numKeys != res->numMols) {
+      throw BadFileException("bad number of keys in " + fname);
+    }
+    res->keyIndex = section(header[KeyIndexOffsetField], res->numKeys + 1,
+                            sizeof(std::uint64_t));
+    res->keyDataSize = header[KeyDataSizeField];
+    res->keyData = section(header[KeyDataOffsetField], res->keyDataSize, 1);
+    res->keyPropName = std::string(
+        section(header[KeyPropNameOffsetField], header[KeyPropNameSizeField],
+                1),
+        header[KeyPropNameSizeField]);
+  }
+
+  res->searchOrderSize = header[SearchOrderSizeField];
+  res->searchOrder = section(header[SearchOrderOffsetField],
+                             res->searchOrderSize, sizeof(std::uint32_t));
+  return res;
+}
+
+// writes the sections of a mapped library file and keeps track of where they
+// are
+class MappedLibraryWriter {
+ public:
+  MappedLibraryWriter(const std::string &fname)
+      : d_fname(fname),
+        d_out(fname, std::ios_base::binary | std::ios_base::out |
+                         std::ios_base::trunc),
+        d_header(numHeaderFields, 0) {
+    if (!d_out) {
+      throw BadFileException("Bad output file " + fname);
+    }
+    d_out.write(std::string(headerSize, '\0').c_str(), headerSize);
+  }
+
+  void set(HeaderField field, std::uint64_t value) { d_header[field] = value; }
+
+  // pads the file to the next section boundary and returns the offset
+  std::uint64_t startSection() {
+    std::uint64_t pos = d_out.tellp();
+    std::uint64_t padding = (sectionAlignment - pos % sectionAlignment) %
+                            sectionAlignment;
+    d_out.write(std::string(padding, '\0').c_str(), padding);
+    return pos + padding;
+  }
+
+  // writes a set of strings as a data section and an index section
+  template <typename T>
+  void writeStrings(std::uint64_t count, T getString, HeaderField indexField,
+                    HeaderField dataField, HeaderField dataSizeField) {
+    std::vector<std::uint64_t> index;
+    index.reserve(count + 1);
+    set(dataField, startSection());
+    std::uint64_t dataSize = 0;
+    for (std::uint64_t i = 0; i < count; ++i) {
+      index.push_back(dataSize);
+      std::string_view entry = getString(i);
+      d_out.write(entry.data(), entry.size());
+      dataSize += entry.size();
+    }
+    index.push_back(dataSize);
+    set(dataSizeField, dataSize);
+    set(indexField, startSection());
+    for (auto offset : index) {
+      streamWrite(d_out, offset);
+    }
+  }
+
+  std::ostream &stream() { return d_out; }
+
+  void finish() {
+    d_out.seekp(0);
+    d_out.write(mappedMagic.c_str(), mappedMagic.size());
+    d_header[VersionField] = mappedVersion;
+    for (unsigned int i = 1; i < numHeaderFields; ++i) {
+      streamWrite(d_out, d_header[i]);
+    }
+    d_out.close();
+    if (!d_out) {
+      throw BadFileException("problems writing " + d_fname);
+    }
+  }
+
+ private:
+  std::string d_fname;
+  std::ofstream d_out;
+  std::vector<std::uint64_t> d_header;
+};
+
+void writeMolecules(MappedLibraryWriter &writer, const MolHolderBase &mols) {
+  const std::uint64_t numMols = mols.size();
+  writer.set(NumMolsField, numMols);
+  MappedMolFormat format = MappedMolFormat::Pickle;
+  const std::vector<std::string> *cached = nullptr;
+  if (const auto *holder = dynamic_cast<const CachedMolHolder *>(&mols)) {
+    cached = &holder->getMols();
+  } else if (const auto *holder =
+                 dynamic_cast<const CachedSmilesMolHolder *>(&mols)) {
+    cached = &holder->getMols();
+    format = MappedMolFormat::Smiles;
+  } else if (const auto *holder =
+                 dynamic_cast<const CachedTrustedSmilesMolHolder *>(&mols)) {
+    cached = &holder->getMols();
+    format = MappedMolFormat::TrustedSmiles;
+  }
+  writer.set(MolFormatField, static_cast<std::uint64_t>(format));
+  if (cached) {
+    writer.writeStrings(
+        numMols,
+        [cached](std::uint64_t i) -> std::string_view { return (*cached)[i]; },
+        MolIndexOffsetField, MolDataOffsetField, MolDataSizeField);
+  } else if (const auto *holder = dynamic_cast<const MappedMolHolder *>(&mols)) {
+    writer.set(MolFormatField, static_cast<std::uint64_t>(holder->getFormat()));
+    writer.writeStrings(
+        numMols,
+        [holder](std::uint64_t i) -> std::string_view {
+          return holder->getRaw(i);
+        },
+        MolIndexOffsetField, MolDataOffsetField, MolDataSizeField);
+  } else {
+    // anything else gets pickled
+    std::string pkl;
+    writer.writeStrings(
+        numMols,
+        [&mols, &pkl](std::uint64_t i) -> std::string_view {
+          pkl.clear();
+          auto mol = mols.getMol(i);
+          if (mol) {
+            MolPickler::pickleMol(*mol, pkl);
+          } else {
+            MolPickler::pickleMol(ROMol(), pkl);
+          }
+          return pkl;
+        },
+        MolIndexOffsetField, MolDataOffsetField, MolDataSizeField);
+  }
+}
+
+void writeFingerprints(MappedLibraryWriter &writer, const FPHolderBase *fps,
+                       unsigned int numMols) {
+  if (!fps) {
+    writer.set(FpTypeField, NoFingerprints);
+    return;
+  }
+  if (fps->size() != numMols) {
+    throw ValueErrorException(
+        "number of fingerprints does not match the number of molecules");
+  }
+  const auto *patterns = dynamic_cast<const PatternHolder *>(fps);
+  if (!patterns) {
+    throw ValueErrorException(
+        "only pattern fingerprints can be written to mapped files");
+  }
+  writer.set(FpTypeField,
+             dynamic_cast<const TautomerPatternHolder *>(fps)
+                 ? TautomerPatternFingerprints
+                 : PatternFingerprints);
+  const std::uint64_t numBits = patterns->getNumBits();
+  const std::uint64_t stride = (numBits + 63) / 64 * 8;
+  writer.set(FpNumBitsField, numBits);
+  writer.set(FpStrideField, stride);
+  writer.set(FpOffsetField, writer.startSection());
+
+  auto &out = writer.stream();
+  const auto *mapped = dynamic_cast<const MappedPatternHolder *>(fps);
+  const auto *mappedTautomer =
+      dynamic_cast<const MappedTautomerPatternHolder *>(fps);
+  std::vector<std::uint8_t> bytes;
+  for (unsigned int i = 0; i < numMols; ++i) {
+    const std::uint8_t *fpBytes = nullptr;
+    if (mapped) {
+      fpBytes = mapped->getFingerprintBytes(i);
+    } else if (mappedTautomer) {
+      fpBytes = mappedTautomer->getFingerprintBytes(i);
+    } else {
+      const auto &fp = fps->getFingerprint(i);
+      if (fp.getNumBits() != numBits) {
+        throw ValueErrorException(
+            "fingerprint size does not match the pattern holder");
+      }
+      fingerprintToBytes(fp, stride, bytes);
+      fpBytes = bytes.data();
+    }
+    out.write(reinterpret_cast<const char *>(fpBytes), stride);
+  }
+}
+
+void writeKeys(MappedLibraryWriter &writer, const KeyHolderBase *keys,
+               unsigned int numMols) {
+  if (!keys) {
+    return;
+  }
+  if (keys->size() != numMols) {
+    throw ValueErrorException(
+        "number of keys does not match the number of molecules");
+  }
+  std::string propName;
+  if (const auto *holder = dynamic_cast<const KeyFromPropHolder *>(keys)) {
+    propName = holder->getPropName();
+  } else if (const auto *holder = dynamic_cast<const MappedKeyHolder *>(keys)) {
+    propName = holder->getPropName();
+  }
+  writer.set(NumKeysField, numMols);
+  // go through the keys in chunks so that we don't need to ask the holder for
+  // them one at a time
+  const unsigned int chunkSize = 4096;
+  std::vector<std::string> chunk;
+  std::uint64_t chunkStart = 0;
+  writer.writeStrings(
+      numMols,
+      [&](std::uint64_t i) -> std::string_view {
+        if (chunk.empty() || i >= chunkStart + chunk.size()) {
+          chunkStart = i;
+          std::vector<unsigned int> indices;
+          for (std::uint64_t j = i; j < std::min<std::uint64_t>(
+                                            i + chunkSize, numMols);
+               ++j) {
+            indices.push_back(j);
+          }
+          chunk = keys->getKeys(indices);
+        }
+        return chunk[i - chunkStart];
+      },
+      KeyIndexOffsetField, KeyDataOffsetField, KeyDataSizeField);
+  writer.set(KeyPropNameOffsetField, writer.startSection());
+  writer.set(KeyPropNameSizeField, propName.size());
+  writer.stream().write(propName.c_str(), propName.size());
+}
+}  // namespace
+}  // namespace detail
+
+unsigned int MappedMolHolder::addMol(const ROMol &) {
+  throw ValueErrorException("mapped substructure libraries are read-only");
+}
+
+namespace {
+boost::shared_ptr<ROMol> molFromRaw(std::string_view raw,
+                                    MappedMolFormat format,
+                                    unsigned int pickleFlags) {
+  switch (format) {
+    case MappedMolFormat::Pickle: {
+      boost::shared_ptr<ROMol> mol(new ROMol);
+      MemoryStreamBuf buf(raw.data(), raw.size());
+      std::istream inStream(&buf);
+      MolPickler::molFromPickle(inStream, mol.get(), pickleFlags);
+      return mol;
+    }
+    case MappedMolFormat::Smiles:
+      return boost::shared_ptr<ROMol>(SmilesToMol(std::string(raw)));
+    case MappedMolFormat::TrustedSmiles: {
+      RWMol *m = SmilesToMol(std::string(raw), 0, false);
+      if (m) {
+        m->updatePropertyCache();
+      }
+      return boost::shared_ptr<ROMol>(m);
+    }
+  }
+  return boost::shared_ptr<ROMol>();
+}
+}  // namespace
+
+boost::shared_ptr<ROMol> MappedMolHolder::getMol(unsigned int idx) const {
+  return molFromRaw(data->getMol(idx), data->molFormat,
+                    PicklerOps::PropertyPickleOptions::AllProps);
+}
+
+boost::shared_ptr<ROMol> MappedMolHolder::getMolForSearch(
+    unsigned int idx) const {
+  return molFromRaw(data->getMol(idx), data->molFormat, searchPickleFlags);
+}
+
+unsigned int MappedMolHolder::size() const {
+  return rdcast<unsigned int>(data->numMols);
+}
+
+MappedMolFormat MappedMolHolder::getFormat() const { return data->molFormat; }
+
+std::string_view MappedMolHolder::getRaw(unsigned int idx) const {
+  return data->getMol(idx);
+}
+
+MappedPatternHolder::MappedPatternHolder(
+    boost::shared_ptr<const detail::MappedSubstructLibraryData> fileData)
+    : PatternHolder(rdcast<unsigned int>(fileData->fpNumBits)),
+      data(std::move(fileData)) {}
+
+unsigned int MappedPatternHolder::size() const {
+  return rdcast<unsigned int>(data->numMols);
+}
+
+bool MappedPatternHolder::passesFilter(unsigned int idx,
+                                       const ExplicitBitVect &query) const {
+  return data->passesFilter(idx, query);
+}
+
+void MappedPatternHolder::passesFilterBatch(const ExplicitBitVect &query,
+                                            unsigned int startIdx,
+                                            unsigned int count,
+                                            unsigned int step,
+                                            bool *res) const {
+  data->passesFilterBatch(query, startIdx, count, step, res);
+}
+
+unsigned int MappedPatternHolder::getFingerprintNumBits() const {
+  return rdcast<unsigned int>(data->fpNumBits);
+}
+
+void MappedPatternHolder::getOnBits(unsigned int idx,
+                   std::vector<unsigned int> &bits) const {
+  data->getOnBits(idx, bits);
+}
+
+unsigned int MappedPatternHolder::addMol(const ROMol &) {
+  throw ValueErrorException("mapped substructure libraries are read-only");
+}
+
+unsigned int MappedPatternHolder::addFingerprint(const ExplicitBitVect &) {
+  throw ValueErrorException("mapped substructure libraries are read-only");
+}
+
+ExplicitBitVect MappedPatternHolder::getFingerprint(unsigned int idx) const {
+  return data->getFingerprint(idx);
+}
+
+const std::uint64_t *MappedPatternHolder::getFingerprintWords(unsigned int idx) const {
+  return data->getFingerprintWords(idx);
+}
+
+const std::uint8_t *MappedPatternHolder::getFingerprintBytes(
+    unsigned int idx) const {
+  if (idx >= data->numMols) {
+    throw IndexErrorException(idx);
+  }
+  return data->fps + idx * data->fpStride;
+}
+
+MappedTautomerPatternHolder::MappedTautomerPatternHolder(
+    boost::shared_ptr<const detail::MappedSubstructLibraryData> fileData)
+    : TautomerPatternHolder(rdcast<unsigned int>(fileData->fpNumBits)),
+      data(std::move(fileData)) {}
+
+unsigned int MappedTautomerPatternHolder::size() const {
+  return rdcast<unsigned int>(data->numMols);
+}
+
+bool MappedTautomerPatternHolder::passesFilter(
+    unsigned int idx, const ExplicitBitVect &query) const {
+  return data->passesFilter(idx, query);
+}
+
+void MappedTautomerPatternHolder::passesFilterBatch(
+    const ExplicitBitVect &query, unsigned int startIdx, unsigned int count,
+    unsigned int step, bool *res) const {
+  data->passesFilterBatch(query, startIdx, count, step, res);
+}
+
+unsigned int MappedTautomerPatternHolder::getFingerprintNumBits() const {
+  return rdcast<unsigned int>(data->fpNumBits);
+}
+
+void MappedTautomerPatternHolder::getOnBits(unsigned int idx,
+                   std::vector<unsigned int> &bits) const {
+  data->getOnBits(idx, bits);
+}
+
+unsigned int MappedTautomerPatternHolder::addMol(const ROMol &) {
+  throw ValueErrorException("mapped substructure libraries are read-only");
+}
+
+unsigned int MappedTautomerPatternHolder::addFingerprint(const ExplicitBitVect &) {
+  throw ValueErrorException("mapped substructure libraries are read-only");
+}
+
+ExplicitBitVect MappedTautomerPatternHolder::getFingerprint(unsigned int idx) const {
+  return data->getFingerprint(idx);
+}
+
+const std::uint64_t *MappedTautomerPatternHolder::getFingerprintWords(unsigned int idx) const {
+  return data->getFingerprintWords(idx);
+}
+
+const std::uint8_t *MappedTautomerPatternHolder::getFingerprintBytes(
+    unsigned int idx) const {
+  if (idx >= data->numMols) {
+    throw IndexErrorException(idx);
+  }
+  return data->fps + idx * data->fpStride;
+}
+
+unsigned int MappedKeyHolder::addMol(const ROMol &) {
+  throw ValueErrorException("mapped substructure libraries are read-only");
+}
+
+unsigned int MappedKeyHolder::addKey(const std::string &) {
+  throw ValueErrorException("mapped substructure libraries are read-only");
+}
+
+std::string MappedKeyHolder::getKey(unsigned int idx) const {
+  return std::string(data->getKey(idx));
+}
+
+std::vector<std::string> MappedKeyHolder::getKeys(
+    const std::vector<unsigned int> &indices) const {
+  std::vector<std::string> res;
+  res.reserve(indices.size());
+  for (auto idx : indices) {
+    res.emplace_back(data->getKey(idx));
+  }
+  return res;
+}
+
+unsigned int MappedKeyHolder::size() const {
+  return rdcast<unsigned int>(data->numKeys);
+}
+
+const std::string &MappedKeyHolder::getPropName() const {
+  return data->keyPropName;
+}
+
+void SubstructLibrary::toMappedFile(const std::string &fname) const {
+  PRECONDITION(mols, "molholder is null in SubstructLibrary");
+  detail::MappedLibraryWriter writer(fname);
+  detail::writeMolecules(writer, *mols);
+  detail::writeFingerprints(writer, fps, mols->size());
+  detail::writeKeys(writer, keyholder.get(), mols->size());
+  writer.set(detail::SearchOrderSizeField, searchOrder.size());
+  writer.set(detail::SearchOrderOffsetField, writer.startSection());
+  for (auto idx : searchOrder) {
+    streamWrite(writer.stream(), static_cast<std::uint32_t>(idx));
+  }
+  writer.finish();
+}
+
+void SubstructLibrary::initFromMappedFile(const std::string &fname) {
+  auto data = detail::openMappedLibrary(fname);
+  molholder.reset(new MappedMolHolder(data));
+  switch (data->fpType) {
+    case detail::PatternFingerprints:
+      fpholder.reset(new MappedPatternHolder(data));
+      break;
+    case detail::TautomerPatternFingerprints:
+      fpholder.reset(new MappedTautomerPatternHolder(data));
+      break;
+    default:
+      fpholder.reset();
+  }
+  if (data->numKeys) {
+    keyholder.reset(new MappedKeyHolder(data));
+  } else {
+    keyholder.reset();
+  }
+  searchOrder.resize(data->searchOrderSize);
+  for (std::uint64_t i = 0; i < data->searchOrderSize; ++i) {
+    searchOrder[i] = detail::readLE<std::uint32_t>(
+        data->searchOrder + i * sizeof(std::uint32_t));
+    if (searchOrder[i] >= data->numMols) {
+      throw BadFileException("bad search order in " + fname);
+    }
+  }
+  resetHolders();
+}
+}  // namespace RDKit
@@ -0,0 +1,183 @@
+//
+//  Copyright (C) 2026 RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#ifndef RDK_MAPPED_SUBSTRUCT_LIBRARY
+#define RDK_MAPPED_SUBSTRUCT_LIBRARY
+#include <RDGeneral/export.h>
+#include "SubstructLibrary.h"
+
+#include <cstdint>
+#include <string_view>
+
+namespace RDKit {
+/*! \file MappedSubstructLibrary.h
+
+  Holders which use a substructure library file written with
+  SubstructLibrary::toMappedFile() in place.
+
+  The file is memory mapped, so opening it does not depend on the size of the
+  library and the pages are shared between all processes which have the same
+  file open. The pattern fingerprints are screened directly in the mapped
+  memory and molecules are only decoded from their pickles or SMILES when
+  getMol() is called, i.e. after the screen has passed.
+
+  The mapped holders are read-only: attempts to add molecules, fingerprints or
+  keys to them throw a ValueErrorException. Libraries which use them can't be
+  serialized with SubstructLibrary::Serialize(), write them with
+  SubstructLibrary::toMappedFile() instead.
+*/
+
+//! The representation used for the molecules in a mapped library file
+enum class MappedMolFormat : std::uint32_t {
+  Pickle = 0,         //!< as with CachedMolHolder
+  Smiles = 1,         //!< as with CachedSmilesMolHolder
+  TrustedSmiles = 2,  //!< as with CachedTrustedSmilesMolHolder
+};
+
+namespace detail {
+//! the contents of a mapped library file, shared by its holders
+struct MappedSubstructLibraryData;
+}  // namespace detail
+
+//! Molecule holder which decodes molecules from a mapped library file on
+//! demand
+class RDKIT_SUBSTRUCTLIBRARY_EXPORT MappedMolHolder : public MolHolderBase {
+  boost::shared_ptr<const detail::MappedSubstructLibraryData> data;
+
+ public:
+  MappedMolHolder(
+      boost::shared_ptr<const detail::MappedSubstructLibraryData> fileData)
+      : MolHolderBase(), data(std::move(fileData)) {}
+
+  //! mapped holders are read-only, this always throws
+  unsigned int addMol(const ROMol &m) override;
+
+  boost::shared_ptr<ROMol> getMol(unsigned int idx) const override;
+  //! pickles are only partially decoded
+  boost::shared_ptr<ROMol> getMolForSearch(unsigned int idx) const override;
+
+  unsigned int size() const override;
+
+  //! returns the format the molecules are stored in
+  MappedMolFormat getFormat() const;
+
+  //! returns the stored pickle or SMILES of a molecule. The view is valid for
+  //! as long as this holder exists.
+  std::string_view getRaw(unsigned int idx) const;
+};
+
+//! PatternHolder which screens against fingerprints in a mapped library file
+class RDKIT_SUBSTRUCTLIBRARY_EXPORT MappedPatternHolder : public PatternHolder {
+  boost::shared_ptr<const detail::MappedSubstructLibraryData> data;
+
+ public:
+  MappedPatternHolder(
+      boost::shared_ptr<const detail::MappedSubstructLibraryData> fileData);
+
+  using PatternHolder::addFingerprint;
+  //! mapped holders are read-only, this always throws
+  unsigned int addMol(const ROMol &m) override;
+  //! mapped holders are read-only, this always throws
+  unsigned int addFingerprint(const ExplicitBitVect &v) override;
+
+  unsigned int size() const override;
+
+  bool passesFilter(unsigned int idx,
+                    const ExplicitBitVect &query) const override;
+
+  void passesFilterBatch(const ExplicitBitVect &query, unsigned int startIdx,
+                         unsigned int count, unsigned int step,
+                         bool *res) const override;
+
+  unsigned int getFingerprintNumBits() const override;
+
+  ExplicitBitVect getFingerprint(unsigned int idx) const override;
+
+  //! the row is decoded from the file into a buffer which is only valid
+  //! until the next call on the same thread
+  const std::uint64_t *getFingerprintWords(unsigned int idx) const override;
+
+  //! returns the bytes of a stored fingerprint, bit i is bit (i % 8) of byte
+  //! (i / 8)
+  const std::uint8_t *getFingerprintBytes(unsigned int idx) const;
+
+ protected:
+  void getOnBits(unsigned int idx,
+                 std::vector<unsigned int> &bits) const override;
+};
+
+//! TautomerPatternHolder which screens against fingerprints in a mapped
+//! library file
+class RDKIT_SUBSTRUCTLIBRARY_EXPORT MappedTautomerPatternHolder
+    : public TautomerPatternHolder {
+  boost::shared_ptr<const detail::MappedSubstructLibraryData> data;
+
+ public:
+  MappedTautomerPatternHolder(
+      boost::shared_ptr<const detail::MappedSubstructLibraryData> fileData);
+
+  using TautomerPatternHolder::addFingerprint;
+  //! mapped holders are read-only, this always throws
+  unsigned int addMol(const ROMol &m) override;
+  //! mapped holders are read-only, this always throws
+  unsigned int addFingerprint(const ExplicitBitVect &v) override;
+
+  unsigned int size() const override;
+
+  bool passesFilter(unsigned int idx,
+                    const ExplicitBitVect &query) const override;
+
+  void passesFilterBatch(const ExplicitBitVect &query, unsigned int startIdx,
+                         unsigned int count, unsigned int step,
+                         bool *res) const override;
+
+  unsigned int getFingerprintNumBits() const override;
+
+  ExplicitBitVect getFingerprint(unsigned int idx) const override;
+
+  //! the row is decoded from the file into a buffer which is only valid
+  //! until the next call on the same thread
+  const std::uint64_t *getFingerprintWords(unsigned int idx) const override;
+
+  //! returns the bytes of a stored fingerprint, bit i is bit (i % 8) of byte
+  //! (i / 8)
+  const std::uint8_t *getFingerprintBytes(unsigned int idx) const;
+
+ protected:
+  void getOnBits(unsigned int idx,
+                 std::vector<unsigned int> &bits) const override;
+};
+
+//! Key holder which reads keys from a mapped library file
+class RDKIT_SUBSTRUCTLIBRARY_EXPORT MappedKeyHolder : public KeyHolderBase {
+  boost::shared_ptr<const detail::MappedSubstructLibraryData> data;
+
+ public:
+  MappedKeyHolder(
+      boost::shared_ptr<const detail::MappedSubstructLibraryData> fileData)
+      : KeyHolderBase(), data(std::move(fileData)) {}
+
+  //! mapped holders are read-only, this always throws
+  unsigned int addMol(const ROMol &m) override;
+  //! mapped holders are read-only, this always throws
+  unsigned int addKey(const std::string &key) override;
+
+  std::string getKey(unsigned int idx) const override;
+
+  std::vector<std::string> getKeys(
+      const std::vector<unsigned int> &indices) const override;
+
+  unsigned int size() const override;
+
+  //! returns the name of the property the keys were taken from
+  const std::string &getPropName() const;
+};
+}  // namespace RDKit
+
+#endif
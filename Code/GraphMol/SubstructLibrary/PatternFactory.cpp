@@ -19,15 +19,16 @@
 namespace RDKit {
 namespace {
 void fillPatterns(const SubstructLibrary &slib, const FPHolderBase &fph,
-                  std::vector<ExplicitBitVect *> &fps, unsigned int start,
-                  unsigned int end, unsigned int numThreads) {
+                  std::vector<std::unique_ptr<ExplicitBitVect>> &fps,
+                  unsigned int start, unsigned int end,
+                  unsigned int numThreads) {
   for (unsigned int idx = start; idx < end; idx += numThreads) {
     auto mol = slib.getMol(idx);
     if (mol.get()) {
-      fps[idx] = fph.makeFingerprint(*mol.get());
+      fps[idx].reset(fph.makeFingerprint(*mol.get()));
     } else {
       // Make an empty FP
-      fps[idx] = fph.makeFingerprint(ROMol());
+      fps[idx].reset(fph.makeFingerprint(ROMol()));
     }
   }
 }
@@ -47,9 +48,8 @@ void internalAddPatterns(SubstructLibrary &sslib, int numThreads,
     ptr = boost::shared_ptr<FPHolderBase>(new PatternHolder);
   }
 
-  std::vector<ExplicitBitVect *> &fps = ptr->getFingerprints();
   unsigned int endIdx = sslib.getMolecules().size();
-  fps.resize(endIdx);
+  std::vector<std::unique_ptr<ExplicitBitVect>> fps(endIdx);
 
 #ifdef RDK_BUILD_THREADSAFE_SSS
   unsigned int startIdx = 0;
@@ -67,6 +67,11 @@ void internalAddPatterns(SubstructLibrary &sslib, int numThreads,
 #else
   fillPatterns(sslib, *ptr, fps, 0, sslib.size(), 1);
 #endif
+  ptr->clearFingerprints();
+  for (auto &fp : fps) {
+    ptr->addFingerprint(*fp);
+    fp.reset();
+  }
   if (ptr->size() != sslib.size()) {
     throw ValueErrorException(
         "Number of fingerprints generated not equal to current number of "
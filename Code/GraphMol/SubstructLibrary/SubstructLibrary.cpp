@@ -31,6 +31,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 #include "SubstructLibrary.h"
+#include "MappedSubstructLibrary.h"
 #include <RDGeneral/RDThreads.h>
 #ifdef RDK_BUILD_THREADSAFE_SSS
 #include <thread>
@@ -40,11 +41,183 @@
 #include <GraphMol/Substruct/SubstructMatch.h>
 #include <GraphMol/GeneralizedSubstruct/XQMol.h>
 #include <boost/dynamic_bitset.hpp>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
 
 namespace RDKit {
 
 using namespace GeneralizedSubstruct;
 
+namespace {
+// the words of a fingerprint, in the layout used for the packed fingerprints
+void fingerprintWords(const ExplicitBitVect &fp, std::uint64_t *res) {
+  const auto &bits = *fp.dp_bits;
+  for (auto bit = bits.find_first(); bit != boost::dynamic_bitset<>::npos;
+       bit = bits.find_next(bit)) {
+    res[bit / 64] |= std::uint64_t(1) << (bit % 64);
+  }
+}
+}  // namespace
+
+unsigned int FPHolderBase::addFingerprint(const ExplicitBitVect &v) {
+  if (!numFps) {
+    fpNumBits = v.getNumBits();
+    fpNumWords = (fpNumBits + 63) / 64;
+  } else if (v.getNumBits() != fpNumBits) {
+    throw ValueErrorException(
+        "fingerprint size does not match the other fingerprints");
+  }
+  fpWords.resize(fpWords.size() + fpNumWords, 0);
+  fingerprintWords(v, fpWords.data() + size_t(numFps) * fpNumWords);
+  return numFps++;
+}
+
+ExplicitBitVect FPHolderBase::getFingerprint(unsigned int idx) const {
+  const auto *words = getRow(idx);
+  ExplicitBitVect res(fpNumBits);
+  for (unsigned int i = 0; i < fpNumWords; ++i) {
+    for (auto word = words[i]; word; word &= word - 1) {
+      res.setBit(i * 64 + std::countr_zero(word));
+    }
+  }
+  return res;
+}
+
+bool FPHolderBase::passesFilter(unsigned int idx,
+                                const ExplicitBitVect &query) const {
+  const auto *words = getRow(idx);
+  if (query.getNumBits() != fpNumBits) {
+    throw ValueErrorException(
+        "query fingerprint size does not match the fingerprints");
+  }
+  const auto &bits = *query.dp_bits;
+  for (auto bit = bits.find_first(); bit != boost::dynamic_bitset<>::npos;
+       bit = bits.find_next(bit)) {
+    if (!(words[bit / 64] & (std::uint64_t(1) << (bit % 64)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void FPHolderBase::passesFilterBatch(const ExplicitBitVect &query,
+                                     unsigned int startIdx, unsigned int count,
+                                     unsigned int step, bool *res) const {
+  PRECONDITION(step > 0, "bad step");
+  if (!count) {
+    return;
+  }
+  const auto lastIdx = startIdx + static_cast<size_t>(count - 1) * step;
+  if (lastIdx >= size()) {
+    throw IndexErrorException(rdcast<int>(lastIdx));
+  }
+  if (query.getNumBits() != fpNumBits) {
+    throw ValueErrorException(
+        "query fingerprint size does not match the fingerprints");
+  }
+  thread_local std::vector<std::uint64_t> queryWords;
+  queryWords.assign(fpNumWords, 0);
+  fingerprintWords(query, queryWords.data());
+  const unsigned int rowBytes = fpNumWords * sizeof(std::uint64_t);
+  CalcBitmapAllProbeBitsMatchBatch(
+      reinterpret_cast<const unsigned char *>(queryWords.data()),
+      reinterpret_cast<const unsigned char *>(getRow(startIdx)),
+      count, rowBytes, rowBytes * step, res);
+}
+
+void FPHolderBase::getOnBits(unsigned int idx,
+                             std::vector<unsigned int> &bits) const {
+  const auto *words = getRow(idx);
+  for (unsigned int i = 0; i < fpNumWords; ++i) {
+    for (auto word = words[i]; word; word &= word - 1) {
+      bits.push_back(i * 64 + std::countr_zero(word));
+    }
+  }
+}
+
+// must be called with the index locked, returns false if it can't be used
+bool FPHolderBase::updateInvertedIndex() const {
+  const unsigned int numIndexed = size();
+  const unsigned int numBits = getFingerprintNumBits();
+  if (!invertedIndex.enabled || !numIndexed || !numBits) {
+    return false;
+  }
+  if (invertedIndex.size > numIndexed ||
+      invertedIndex.postings.size() != numBits) {
+    invertedIndex.clear();
+    invertedIndex.postings.resize(numBits);
+  }
+  // fingerprints added since the last call are appended
+  std::vector<unsigned int> bits;
+  for (; invertedIndex.size < numIndexed; ++invertedIndex.size) {
+    bits.clear();
+    getOnBits(invertedIndex.size, bits);
+    for (auto bit : bits) {
+      invertedIndex.postings[bit].push_back(invertedIndex.size);
+    }
+  }
+  return true;
+}
+
+std::vector<unsigned int> FPHolderBase::getCandidates(
+    const ExplicitBitVect &query) const {
+  std::vector<unsigned int> res;
+  {
+    std::lock_guard<std::mutex> lock(invertedIndex.mutex);
+    if (updateInvertedIndex() &&
+        query.getNumBits() == invertedIndex.postings.size() &&
+        query.getNumOnBits()) {
+      std::vector<const std::vector<std::uint32_t> *> postings;
+      const auto &bits = *query.dp_bits;
+      for (auto bit = bits.find_first(); bit != boost::dynamic_bitset<>::npos;
+           bit = bits.find_next(bit)) {
+        postings.push_back(&invertedIndex.postings[bit]);
+      }
+      std::sort(postings.begin(), postings.end(),
+                [](const auto *a, const auto *b) {
+                  return a->size() < b->size();
+                });
+      // intersecting the lists for the rarest bits narrows things down
+      // quickly, the candidates which are left are checked against their
+      // fingerprints
+      const size_t maxIntersections = 4;
+      res.assign(postings.front()->begin(), postings.front()->end());
+      std::vector<unsigned int> tmp;
+      for (size_t i = 1;
+           i < std::min(postings.size(), maxIntersections) && !res.empty();
+           ++i) {
+        tmp.clear();
+        std::set_intersection(res.begin(), res.end(), postings[i]->begin(),
+                              postings[i]->end(), std::back_inserter(tmp));
+        res.swap(tmp);
+      }
+      if (postings.size() > maxIntersections) {
+        res.erase(std::remove_if(res.begin(), res.end(),
+                                 [&](unsigned int idx) {
+                                   return !passesFilter(idx, query);
+                                 }),
+                  res.end());
+      }
+      return res;
+    }
+  }
+  // no index, so everything is screened
+  const unsigned int numMols = size();
+  std::unique_ptr<bool[]> passes(new bool[numMols]);
+  passesFilterBatch(query, 0, numMols, 1, passes.get());
+  for (unsigned int i = 0; i < numMols; ++i) {
+    if (passes[i]) {
+      res.push_back(i);
+    }
+  }
+  return res;
+}
+
 bool SubstructLibraryCanSerialize() {
 #ifdef RDK_USE_BOOST_SERIALIZATION
   return true;
@@ -57,6 +230,11 @@ struct Bits {
   const ExplicitBitVect *queryBits;
   const FPHolderBase *fps;
   SubstructMatchParameters params;
+  // the molecules which pass the screen, when the fingerprints have an
+  // inverted index
+  bool useCandidates = false;
+  std::vector<unsigned int> candidates;
+  boost::dynamic_bitset<> candidateBits;
 
   Bits(const FPHolderBase *fingerprints, const ROMol &m,
        const SubstructMatchParameters &ssparams)
@@ -147,12 +325,41 @@ struct Bits {
     }
   }
 
+  // finds the candidates up front if the fingerprints are indexed
+  void findCandidates() {
+    if (!fps || !queryBits || !fps->getUseInvertedIndex()) {
+      return;
+    }
+    candidates = fps->getCandidates(*queryBits);
+    candidateBits.resize(fps->size());
+    for (auto idx : candidates) {
+      candidateBits.set(idx);
+    }
+    useCandidates = true;
+  }
+
   bool check(unsigned int idx) const {
-    if (fps) {
+    if (useCandidates) {
+      return candidateBits[idx];
+    } else if (fps) {
       return fps->passesFilter(idx, *queryBits);
     }
     return true;
   }
+
+  // screens count molecules, step apart, starting at idx
+  void check(unsigned int idx, unsigned int count, unsigned int step,
+             bool *res) const {
+    if (useCandidates) {
+      for (unsigned int i = 0; i < count; ++i) {
+        res[i] = candidateBits[idx + i * step];
+      }
+    } else if (fps) {
+      fps->passesFilterBatch(*queryBits, idx, count, step, res);
+    } else {
+      std::fill(res, res + count, true);
+    }
+  }
 };
 
 unsigned int SubstructLibrary::addMol(const ROMol &m) {
@@ -230,55 +437,213 @@ bool query_needs_rings(const ExtendedQueryMol &xqm) {
                 // necessary
 }
 
+// The molecules are searched in chunks which the threads take from a shared
+// counter as they finish their previous one, so a few slow molecules don't
+// hold up the rest of the search. The hits are kept per chunk so that the
+// results (and the cutoff for maxResults) are the same as for a serial
+// search.
+const unsigned int searchChunkSize = 256;
+
+class ChunkedSearch {
+ public:
+  ChunkedSearch(unsigned int startIdx, unsigned int endIdx, int maxResults)
+      : d_startIdx(startIdx),
+        d_endIdx(endIdx),
+        d_numChunks((endIdx - startIdx + searchChunkSize - 1) /
+                    searchChunkSize),
+        d_maxResults(maxResults),
+        d_lastNeededChunk(d_numChunks - 1),
+        d_hits(d_numChunks),
+        d_done(d_numChunks, 0) {}
+
+  //! returns false when there is no more work to do
+  bool nextChunk(unsigned int &chunk, unsigned int &first,
+                 unsigned int &last) {
+    chunk = d_nextChunk++;
+    if (cancelled(chunk)) {
+      return false;
+    }
+    first = d_startIdx + chunk * searchChunkSize;
+    last = std::min(first + searchChunkSize, d_endIdx);
+    return true;
+  }
+
+  //! a chunk is no longer needed once the chunks before it have found
+  //! maxResults hits
+  bool cancelled(unsigned int chunk) const {
+    return chunk > d_lastNeededChunk.load(std::memory_order_relaxed);
+  }
+
+  std::vector<unsigned int> &hits(unsigned int chunk) { return d_hits[chunk]; }
+
+  int maxResults() const { return d_maxResults; }
+
+  void finishChunk(unsigned int chunk) {
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_done[chunk] = 1;
+    while (d_donePrefix < d_numChunks && d_done[d_donePrefix] &&
+           !cancelled(d_donePrefix)) {
+      d_prefixHits += d_hits[d_donePrefix].size();
+      if (d_maxResults > 0 &&
+          d_prefixHits >= static_cast<unsigned int>(d_maxResults)) {
+        d_lastNeededChunk = d_donePrefix;
+      }
+      ++d_donePrefix;
+    }
+  }
+
+  //! collects the hits in search order
+  int collect(boost::dynamic_bitset<> &found,
+              std::vector<unsigned int> *idxs) const {
+    int counter = 0;
+    const unsigned int lastChunk =
+        std::min(d_lastNeededChunk.load(), d_numChunks - 1);
+    for (unsigned int chunk = 0; d_numChunks && chunk <= lastChunk; ++chunk) {
+      for (auto sidx : d_hits[chunk]) {
+        if (d_maxResults > 0 && counter == d_maxResults) {
+          return counter;
+        }
+        ++counter;
+        found.set(sidx);
+        if (idxs) {
+          idxs->push_back(sidx);
+        }
+      }
+    }
+    return counter;
+  }
+
+ private:
+  unsigned int d_startIdx;
+  unsigned int d_endIdx;
+  unsigned int d_numChunks;
+  int d_maxResults;
+  std::atomic<unsigned int> d_nextChunk{0};
+  std::atomic<unsigned int> d_lastNeededChunk;
+  std::vector<std::vector<unsigned int>> d_hits;
+  std::vector<char> d_done;
+  std::mutex d_mutex;
+  unsigned int d_donePrefix{0};
+  unsigned int d_prefixHits{0};
+};
+
+// each search thread works with its own copy of the query so that we don't
+// end up with lock contention for recursive matchers, molecule queries are
+// also prepared once per thread
 template <class Query>
-void SubSearcher(const Query &in_query, const Bits &bits,
-                 const MolHolderBase &mols, unsigned int start,
-                 unsigned int &end, unsigned int numThreads,
-                 const bool needs_rings, int &counter, const int maxResults,
-                 boost::dynamic_bitset<> &found,
+class ThreadQuery {
+ public:
+  explicit ThreadQuery(const Query &query) : d_query(query) {}
+  const Query &get() const { return d_query; }
+
+ private:
+  Query d_query;
+};
+
+template <>
+class ThreadQuery<ROMol> {
+ public:
+  explicit ThreadQuery(const ROMol &query)
+      : d_query(query), d_prepared(d_query) {}
+  ThreadQuery(const ThreadQuery &) = delete;
+  ThreadQuery &operator=(const ThreadQuery &) = delete;
+  const PreparedSubstructQuery &get() const { return d_prepared; }
+
+ private:
+  ROMol d_query;
+  PreparedSubstructQuery d_prepared;
+};
+
+// searches the molecules at positions [first, last) of the library, adding
+// the matches to hits. stop() is checked before each molecule.
+template <class Query, class StopFunc>
+void searchChunk(const Query &query, const Bits &bits,
+                 const MolHolderBase &mols, const bool needs_rings,
+                 const boost::dynamic_bitset<> *found,
                  const std::vector<unsigned int> &searchOrder,
-                 std::vector<unsigned int> *idxs) {
-  PRECONDITION(searchOrder.empty() || searchOrder.size() >= end,
-               "bad searchOrder data");
-  // we copy the query so that we don't end up with lock contention for
-  // recursive matchers when using multiple threads
-  Query query(in_query);
-  for (unsigned int idx = start; idx < end; idx += numThreads) {
+                 unsigned int first, unsigned int last,
+                 std::vector<unsigned int> &hits,
+                 SubstructSearchThreadStats &stats, StopFunc stop) {
+  ++stats.numChunks;
+  // without a search order the candidates from the inverted index can be
+  // used directly, otherwise the whole chunk is screened at once
+  bool screened[searchChunkSize];
+  const bool useCandidates = bits.useCandidates && searchOrder.empty();
+  auto candidate = bits.candidates.end();
+  if (useCandidates) {
+    candidate =
+        std::lower_bound(bits.candidates.begin(), bits.candidates.end(), first);
+  } else if (searchOrder.empty()) {
+    bits.check(first, last - first, 1, screened);
+  }
+  for (unsigned int idx = first; idx < last; ++idx) {
+    if (stop()) {
+      break;
+    }
     unsigned int sidx = idx;
-    if (!searchOrder.empty()) {
+    bool passes;
+    if (useCandidates) {
+      if (candidate == bits.candidates.end() || *candidate >= last) {
+        break;
+      }
+      sidx = idx = *candidate++;
+      passes = true;
+    } else if (!searchOrder.empty()) {
       sidx = searchOrder[idx];
+      passes = bits.check(sidx);
+    } else {
+      passes = screened[idx - first];
     }
-    if (!bits.check(sidx) || found[sidx]) {
+    if (!passes || (found && (*found)[sidx])) {
       continue;
     }
     // need shared_ptr as it (may) control the lifespan of the
     //  returned molecule!
-    const boost::shared_ptr<ROMol> &m = mols.getMol(sidx);
+    const boost::shared_ptr<ROMol> &m = mols.getMolForSearch(sidx);
     ROMol *mol = m.get();
     if (!mol) {
       continue;
     }
+    ++stats.numMolecules;
     if (needs_rings &&
         (!mol->getRingInfo() || !mol->getRingInfo()->isSymmSssr())) {
       MolOps::symmetrizeSSSR(*mol);
     }
 
     if (!SubstructMatch(*mol, query, bits.params).empty()) {
-      ++counter;
-      found.set(sidx);
-      if (idxs) {
-        idxs->push_back(sidx);
-        if (maxResults > 0 && counter == maxResults) {
-          // if we reached maxResults, record the last idx we processed and
-          // bail out
-          end = idx;
-          break;
-        }
-      }
+      ++stats.numMatches;
+      hits.push_back(sidx);
     }
   }
 }
 
+template <class Query>
+void SubSearcher(const Query &in_query, const Bits &bits,
+                 const MolHolderBase &mols, const bool needs_rings,
+                 const boost::dynamic_bitset<> &found,
+                 const std::vector<unsigned int> &searchOrder,
+                 ChunkedSearch &search, SubstructSearchThreadStats &stats) {
+  auto startTime = std::chrono::steady_clock::now();
+  ThreadQuery<Query> query(in_query);
+  unsigned int chunk, first, last;
+  while (search.nextChunk(chunk, first, last)) {
+    auto &hits = search.hits(chunk);
+    searchChunk(query.get(), bits, mols, needs_rings, &found, searchOrder,
+                first, last, hits, stats, [&]() {
+                  // the later molecules in this chunk can't make it into the
+                  // results once it has maxResults hits
+                  return search.cancelled(chunk) ||
+                         (search.maxResults() > 0 &&
+                          hits.size() == static_cast<unsigned int>(
+                                             search.maxResults()));
+                });
+    search.finishChunk(chunk);
+  }
+  stats.seconds += std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - startTime)
+                       .count();
+}
+
 template <class Query>
 int internalGetMatches(const Query &query, MolHolderBase &mols,
                        const FPHolderBase *fps, unsigned int startIdx,
@@ -286,7 +651,8 @@ int internalGetMatches(const Query &query, MolHolderBase &mols,
                        const SubstructMatchParameters &params, int numThreads,
                        int maxResults, boost::dynamic_bitset<> &found,
                        const std::vector<unsigned int> &searchOrder,
-                       std::vector<unsigned int> *idxs) {
+                       std::vector<unsigned int> *idxs,
+                       std::vector<SubstructSearchThreadStats> &stats) {
   PRECONDITION(startIdx < mols.size(), "startIdx out of bounds");
   PRECONDITION(searchOrder.empty() || startIdx < searchOrder.size(),
                "startIdx out of bounds");
@@ -302,139 +668,48 @@ int internalGetMatches(const Query &query, MolHolderBase &mols,
     endIdx = std::min(static_cast<unsigned int>(searchOrder.size()), endIdx);
   }
 
+  ChunkedSearch search(startIdx, endIdx, maxResults);
+  const unsigned int numChunks =
+      (endIdx - startIdx + searchChunkSize - 1) / searchChunkSize;
   numThreads = static_cast<int>(getNumThreadsToUse(numThreads));
-  numThreads = std::min(numThreads, static_cast<int>(endIdx));
+  numThreads = std::min(numThreads, static_cast<int>(numChunks));
+  if (stats.size() < static_cast<unsigned int>(numThreads)) {
+    stats.resize(numThreads);
+  }
 
   bool needs_rings = query_needs_rings(query);
   Bits bits(fps, query, params);
-  int counter = 0;
+  bits.findCandidates();
 
 #ifdef RDK_BUILD_THREADSAFE_SSS
   if (numThreads > 1) {
-    std::vector<int> counterVect(numThreads, 0);
-    int maxResultsPerThread = maxResults;
-    if (maxResults > 0) {
-      maxResultsPerThread /= numThreads;
-    }
-    std::vector<int> maxResultsVect(numThreads, maxResultsPerThread);
-    std::vector<unsigned int> endIdxVect(numThreads, endIdx);
-    if (maxResults > 0) {
-      int excess = maxResults % numThreads;
-      for (int i = 0; i < excess; ++i) {
-        ++maxResultsVect[i];
-      }
-    }
     std::vector<std::future<void>> thread_group;
-    std::vector<std::vector<unsigned int>> internal_results;
-    std::vector<boost::dynamic_bitset<>> internal_found(numThreads);
-    if (idxs) {
-      internal_results.resize(numThreads);
-    }
-    int thread_group_idx;
-    for (thread_group_idx = 0; thread_group_idx < numThreads;
+    for (int thread_group_idx = 0; thread_group_idx < numThreads;
          ++thread_group_idx) {
-      internal_found[thread_group_idx] = found;
-      // need to use boost::ref otherwise things are passed by value
+      // need to use std::ref otherwise things are passed by value
       thread_group.emplace_back(std::async(
-          std::launch::async, SubSearcher<Query>, std::ref(query), bits,
-          std::ref(mols), startIdx + thread_group_idx,
-          std::ref(endIdxVect[thread_group_idx]), numThreads, needs_rings,
-          std::ref(counterVect[thread_group_idx]),
-          maxResultsVect[thread_group_idx],
-          std::ref(internal_found[thread_group_idx]), std::ref(searchOrder),
-          idxs ? &internal_results[thread_group_idx] : nullptr));
-    }
-    unsigned int maxEndIdx;
-    if (maxResults > 0) {
-      // If we are running with maxResults in a multi-threaded settings,
-      // some threads may have screened more molecules than others.
-      // If maxResults was close to the theoretical maximum, some threads
-      // might have even run out of molecules to screen without reaching
-      // maxResults so we need to make sure that all threads have screened as
-      // many molecules as the most productive thread if we want
-      // multi-threaded runs to yield the same results independently from the
-      // number of threads.
-      thread_group_idx = 0;
-      for (auto &fut : thread_group) {
-        fut.get();
-        counter += counterVect[thread_group_idx++];
-      }
-      thread_group.clear();
-      // Find out out the max number of molecules that was screened by the
-      // most productive thread and do the same in all other threads, unless
-      // the max number of molecules was reached
-      maxEndIdx = *std::max_element(endIdxVect.begin(), endIdxVect.end());
-      for (thread_group_idx = 0; thread_group_idx < numThreads;
-           ++thread_group_idx) {
-        if (endIdxVect[thread_group_idx] >= maxEndIdx) {
-          continue;
-        }
-        internal_found[thread_group_idx] = found;
-        // need to use boost::ref otherwise things are passed by value
-        thread_group.emplace_back(std::async(
-            std::launch::async, SubSearcher<Query>, std::ref(query), bits,
-            std::ref(mols), endIdxVect[thread_group_idx] + numThreads,
-            std::ref(maxEndIdx), numThreads, needs_rings,
-            std::ref(counterVect[thread_group_idx]), -1,
-            std::ref(internal_found[thread_group_idx]), std::ref(searchOrder),
-            &internal_results[thread_group_idx]));
-      }
+          std::launch::async, SubSearcher<Query>, std::ref(query),
+          std::ref(bits), std::ref(mols), needs_rings, std::ref(found),
+          std::ref(searchOrder), std::ref(search),
+          std::ref(stats[thread_group_idx])));
     }
     for (auto &fut : thread_group) {
       fut.get();
     }
-    for (thread_group_idx = 0; thread_group_idx < numThreads;
-         ++thread_group_idx) {
-      if (idxs) {
-        idxs->insert(idxs->end(), internal_results[thread_group_idx].begin(),
-                     internal_results[thread_group_idx].end());
-      }
-      found |= internal_found[thread_group_idx];
-      // If there was no maxResults, we still need to count, otherwise
-      // this has already been done previously
-      if (maxResults < 0) {
-        counter += counterVect[thread_group_idx];
-      }
-    }
   } else {
     // if this is running single-threaded, no need to suffer the overhead of
     // std::async
-    SubSearcher(query, bits, mols, startIdx, endIdx, 1, needs_rings, counter,
-                maxResults, found, searchOrder, idxs);
-  }
-  if (idxs && numThreads > 1) {
-    // the sort is necessary to ensure consistency across runs with different
-    // numbers of threads
-    if (!searchOrder.empty()) {
-      std::transform(idxs->begin(), idxs->end(), idxs->begin(),
-                     [searchOrder](unsigned int v) -> unsigned int {
-                       return std::find(searchOrder.begin(), searchOrder.end(),
-                                        v) -
-                              searchOrder.begin();
-                     });
-    }
-    std::sort(idxs->begin(), idxs->end());
-    // we may have actually accumulated more results than maxResults due
-    // to the top up above, so trim the results down if that's the case
-    if (maxResults > 0 &&
-        idxs->size() > static_cast<unsigned int>(maxResults)) {
-      idxs->resize(maxResults);
-    }
-    if (!searchOrder.empty()) {
-      std::transform(idxs->begin(), idxs->end(), idxs->begin(),
-                     [searchOrder](unsigned int v) -> unsigned int {
-                       return searchOrder[v];
-                     });
-    }
+    SubSearcher(query, bits, mols, needs_rings, found, searchOrder, search,
+                stats[0]);
   }
 #else
-  SubSearcher(query, bits, mols, startIdx, endIdx, 1, needs_rings, counter,
-              maxResults, found, searchOrder, idxs);
+  SubSearcher(query, bits, mols, needs_rings, found, searchOrder, search,
+              stats[0]);
 #endif
 
   delete bits.queryBits;
 
-  return counter;
+  return search.collect(found, idxs);
 }
 
 int molbundleGetMatches(const MolBundle &query, MolHolderBase &mols,
@@ -443,13 +718,15 @@ int molbundleGetMatches(const MolBundle &query, MolHolderBase &mols,
                         const SubstructMatchParameters &params, int numThreads,
                         int maxResults,
                         const std::vector<unsigned int> &searchOrder,
-                        std::vector<unsigned int> *idxs) {
+                        std::vector<unsigned int> *idxs,
+                        std::vector<SubstructSearchThreadStats> &stats) {
   int res = 0;
   boost::dynamic_bitset<> found(mols.size());
   for (const auto &qmol : query.getMols()) {
     maxResults -= res;
     res += internalGetMatches(*qmol, mols, fps, startIdx, endIdx, params,
-                              numThreads, maxResults, found, searchOrder, idxs);
+                              numThreads, maxResults, found, searchOrder, idxs,
+                              stats);
   }
   return res;
 }
@@ -462,8 +739,10 @@ std::vector<unsigned int> SubstructLibrary::getMatches(
     int maxResults) const {
   std::vector<unsigned int> idxs;
   boost::dynamic_bitset<> found(mols->size());
+  std::vector<SubstructSearchThreadStats> stats;
   internalGetMatches(query, *mols, fps, startIdx, endIdx, params, numThreads,
-                     maxResults, found, searchOrder, &idxs);
+                     maxResults, found, searchOrder, &idxs, stats);
+  searchStats.set(std::move(stats));
   return idxs;
 }
 
@@ -473,8 +752,10 @@ std::vector<unsigned int> SubstructLibrary::getMatches(
     int maxResults) const {
   std::vector<unsigned int> idxs;
   boost::dynamic_bitset<> found(mols->size());
+  std::vector<SubstructSearchThreadStats> stats;
   internalGetMatches(query, *mols, fps, startIdx, endIdx, params, numThreads,
-                     maxResults, found, searchOrder, &idxs);
+                     maxResults, found, searchOrder, &idxs, stats);
+  searchStats.set(std::move(stats));
   return idxs;
 }
 
@@ -483,8 +764,10 @@ std::vector<unsigned int> SubstructLibrary::getMatches(
     const SubstructMatchParameters &params, int numThreads,
     int maxResults) const {
   std::vector<unsigned int> idxs;
+  std::vector<SubstructSearchThreadStats> stats;
   molbundleGetMatches(query, *mols, fps, startIdx, endIdx, params, numThreads,
-                      maxResults, searchOrder, &idxs);
+                      maxResults, searchOrder, &idxs, stats);
+  searchStats.set(std::move(stats));
   return idxs;
 }
 
@@ -494,8 +777,10 @@ std::vector<unsigned int> SubstructLibrary::getMatches(
     int maxResults) const {
   std::vector<unsigned int> idxs;
   boost::dynamic_bitset<> found(mols->size());
+  std::vector<SubstructSearchThreadStats> stats;
   internalGetMatches(query, *mols, fps, startIdx, endIdx, params, numThreads,
-                     maxResults, found, searchOrder, &idxs);
+                     maxResults, found, searchOrder, &idxs, stats);
+  searchStats.set(std::move(stats));
   return idxs;
 }
 
@@ -503,30 +788,45 @@ unsigned int SubstructLibrary::countMatches(
     const ROMol &query, unsigned int startIdx, unsigned int endIdx,
     const SubstructMatchParameters &params, int numThreads) const {
   boost::dynamic_bitset<> found(mols->size());
-  return internalGetMatches(query, *mols, fps, startIdx, endIdx, params,
-                            numThreads, -1, found, searchOrder, nullptr);
+  std::vector<SubstructSearchThreadStats> stats;
+  auto res = internalGetMatches(query, *mols, fps, startIdx, endIdx, params,
+                                numThreads, -1, found, searchOrder, nullptr,
+                                stats);
+  searchStats.set(std::move(stats));
+  return res;
 }
 
 unsigned int SubstructLibrary::countMatches(
     const TautomerQuery &query, unsigned int startIdx, unsigned int endIdx,
     const SubstructMatchParameters &params, int numThreads) const {
   boost::dynamic_bitset<> found(mols->size());
-  return internalGetMatches(query, *mols, fps, startIdx, endIdx, params,
-                            numThreads, -1, found, searchOrder, nullptr);
+  std::vector<SubstructSearchThreadStats> stats;
+  auto res = internalGetMatches(query, *mols, fps, startIdx, endIdx, params,
+                                numThreads, -1, found, searchOrder, nullptr,
+                                stats);
+  searchStats.set(std::move(stats));
+  return res;
 }
 unsigned int SubstructLibrary::countMatches(
     const MolBundle &query, unsigned int startIdx, unsigned int endIdx,
     const SubstructMatchParameters &params, int numThreads) const {
-  return molbundleGetMatches(query, *mols, fps, startIdx, endIdx, params,
-                             numThreads, -1, searchOrder, nullptr);
+  std::vector<SubstructSearchThreadStats> stats;
+  auto res = molbundleGetMatches(query, *mols, fps, startIdx, endIdx, params,
+                                 numThreads, -1, searchOrder, nullptr, stats);
+  searchStats.set(std::move(stats));
+  return res;
 }
 
 unsigned int SubstructLibrary::countMatches(
     const ExtendedQueryMol &query, unsigned int startIdx, unsigned int endIdx,
     const SubstructMatchParameters &params, int numThreads) const {
   boost::dynamic_bitset<> found(mols->size());
-  return internalGetMatches(query, *mols, fps, startIdx, endIdx, params,
-                            numThreads, -1, found, searchOrder, nullptr);
+  std::vector<SubstructSearchThreadStats> stats;
+  auto res = internalGetMatches(query, *mols, fps, startIdx, endIdx, params,
+                                numThreads, -1, found, searchOrder, nullptr,
+                                stats);
+  searchStats.set(std::move(stats));
+  return res;
 }
 
 bool SubstructLibrary::hasMatch(const ROMol &query, unsigned int startIdx,
@@ -563,11 +863,311 @@ bool SubstructLibrary::hasMatch(const ExtendedQueryMol &query,
              .size() > 0;
 }
 
+namespace detail {
+// the search behind a SubstructMatchCursor. Background threads search the
+// library a chunk at a time, the finished chunks are held until next() has
+// returned their matches.
+class MatchCursorImpl {
+ public:
+  // searches the molecules at positions [first, last) of the library
+  using ChunkSearcher =
+      std::function<void(unsigned int first, unsigned int last,
+                         std::vector<unsigned int> &hits,
+                         const std::atomic<bool> &cancelled)>;
+  // each thread gets its own searcher so that the query can be copied
+  using SearcherFactory = std::function<ChunkSearcher()>;
+
+  MatchCursorImpl(unsigned int endIdx, int numThreads,
+                  SearcherFactory factory)
+      : d_endIdx(endIdx),
+        d_numChunks((endIdx + searchChunkSize - 1) / searchChunkSize),
+        d_factory(std::move(factory)),
+        d_startTime(std::chrono::steady_clock::now()) {
+    numThreads = std::min(static_cast<int>(getNumThreadsToUse(numThreads)),
+                          static_cast<int>(d_numChunks));
+    // the most chunks which are searched before their matches are needed
+    d_maxChunksAhead = 4 * std::max(numThreads, 1);
+#ifdef RDK_BUILD_THREADSAFE_SSS
+    for (int i = 0; i < numThreads; ++i) {
+      d_threads.emplace_back(&MatchCursorImpl::work, this);
+    }
+    d_background = numThreads > 0;
+#endif
+  }
+  MatchCursorImpl(const MatchCursorImpl &) = delete;
+  MatchCursorImpl &operator=(const MatchCursorImpl &) = delete;
+  ~MatchCursorImpl() { cancel(); }
+
+  std::vector<unsigned int> next(unsigned int maxResults) {
+    std::vector<unsigned int> res;
+    std::unique_lock<std::mutex> lock(d_mutex);
+    while (res.size() < maxResults && !d_cancelled &&
+           d_currentChunk < d_numChunks) {
+      auto chunk = d_finished.find(d_currentChunk);
+      if (chunk == d_finished.end()) {
+        if (!d_background) {
+          if (!d_inlineSearcher) {
+            d_inlineSearcher = d_factory();
+          }
+          if (!runChunk(d_inlineSearcher, lock)) {
+            break;
+          }
+        } else {
+          d_cv.wait(lock, [this] {
+            return d_cancelled || d_finished.count(d_currentChunk);
+          });
+        }
+        continue;
+      }
+      const auto &hits = chunk->second;
+      auto count = std::min(hits.size() - d_currentPos,
+                            static_cast<size_t>(maxResults - res.size()));
+      res.insert(res.end(), hits.begin() + d_currentPos,
+                 hits.begin() + d_currentPos + count);
+      d_currentPos += count;
+      if (d_currentPos == hits.size()) {
+        d_finished.erase(chunk);
+        ++d_currentChunk;
+        d_currentPos = 0;
+        d_cv.notify_all();
+      }
+    }
+    if (d_error) {
+      std::rethrow_exception(d_error);
+    }
+    return res;
+  }
+
+  bool done() const {
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_cancelled || d_currentChunk >= d_numChunks;
+  }
+
+  void cancel() {
+    {
+      std::lock_guard<std::mutex> lock(d_mutex);
+      d_cancelled = true;
+    }
+    d_cv.notify_all();
+#ifdef RDK_BUILD_THREADSAFE_SSS
+    for (auto &thread : d_threads) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+#endif
+  }
+
+  double timeToFirstResult() const {
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_timeToFirstResult;
+  }
+
+ private:
+  // searches the next chunk, called with the lock held. Returns false if
+  // there was nothing left to search or the search failed; in the second
+  // case the exception is stored in d_error and the search is cancelled.
+  bool runChunk(ChunkSearcher &searcher, std::unique_lock<std::mutex> &lock) {
+    if (d_cancelled || d_nextChunk >= d_numChunks) {
+      return false;
+    }
+    auto chunk = d_nextChunk++;
+    auto first = chunk * searchChunkSize;
+    auto last = std::min(first + searchChunkSize, d_endIdx);
+    std::vector<unsigned int> hits;
+    lock.unlock();
+    try {
+      searcher(first, last, hits, d_cancelled);
+    } catch (...) {
+      lock.lock();
+      if (!d_error) {
+        d_error = std::current_exception();
+      }
+      d_cancelled = true;
+      d_cv.notify_all();
+      return false;
+    }
+    lock.lock();
+    d_finished[chunk] = std::move(hits);
+    // the first result is available once every chunk before it is finished
+    while (d_readyChunks < d_numChunks && d_finished.count(d_readyChunks)) {
+      if (d_timeToFirstResult < 0 && !d_finished[d_readyChunks].empty()) {
+        d_timeToFirstResult = std::chrono::duration<double>(
+                                  std::chrono::steady_clock::now() -
+                                  d_startTime)
+                                  .count();
+      }
+      ++d_readyChunks;
+    }
+    d_cv.notify_all();
+    return true;
+  }
+
+  void work() {
+    std::unique_lock<std::mutex> lock(d_mutex, std::defer_lock);
+    try {
+      auto searcher = d_factory();
+      lock.lock();
+      while (true) {
+        d_cv.wait(lock, [this] {
+          return d_cancelled || d_nextChunk >= d_numChunks ||
+                 d_nextChunk < d_currentChunk + d_maxChunksAhead;
+        });
+        if (!runChunk(searcher, lock)) {
+          return;
+        }
+      }
+    } catch (...) {
+      if (!lock.owns_lock()) {
+        lock.lock();
+      }
+      if (!d_error) {
+        d_error = std::current_exception();
+      }
+      d_cancelled = true;
+      d_cv.notify_all();
+    }
+  }
+
+  const unsigned int d_endIdx;
+  const unsigned int d_numChunks;
+  unsigned int d_maxChunksAhead;
+  SearcherFactory d_factory;
+  ChunkSearcher d_inlineSearcher;
+
+  mutable std::mutex d_mutex;
+  std::condition_variable d_cv;
+  std::atomic<bool> d_cancelled{false};
+  std::exception_ptr d_error;
+  // the next chunk to be searched
+  unsigned int d_nextChunk = 0;
+  // the chunk whose matches next() is returning and the position in it
+  unsigned int d_currentChunk = 0;
+  size_t d_currentPos = 0;
+  // every chunk before this one has been searched
+  unsigned int d_readyChunks = 0;
+  std::map<unsigned int, std::vector<unsigned int>> d_finished;
+  std::chrono::steady_clock::time_point d_startTime;
+  double d_timeToFirstResult = -1.0;
+  // without background threads next() searches the chunks itself
+  bool d_background = false;
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  std::vector<std::thread> d_threads;
+#endif
+};
+}  // namespace detail
+
+namespace {
+template <class Query>
+SubstructMatchCursor makeMatchCursor(
+    const Query &query, const boost::shared_ptr<MolHolderBase> &molholder,
+    const boost::shared_ptr<FPHolderBase> &fpholder,
+    const std::vector<unsigned int> &searchOrder,
+    const SubstructMatchParameters &params, int numThreads) {
+  PRECONDITION(molholder, "molholder is null in SubstructLibrary");
+  // the cursor keeps its own references to everything it searches
+  struct SearchData {
+    Query query;
+    boost::shared_ptr<MolHolderBase> mols;
+    boost::shared_ptr<FPHolderBase> fps;
+    std::vector<unsigned int> searchOrder;
+    bool needs_rings;
+    Bits bits;
+    SearchData(const Query &q, boost::shared_ptr<MolHolderBase> m,
+               boost::shared_ptr<FPHolderBase> f,
+               const std::vector<unsigned int> &order,
+               const SubstructMatchParameters &ssparams)
+        : query(q),
+          mols(std::move(m)),
+          fps(std::move(f)),
+          searchOrder(order),
+          needs_rings(query_needs_rings(query)),
+          bits(fps.get(), query, ssparams) {
+      bits.findCandidates();
+    }
+    SearchData(const SearchData &) = delete;
+    SearchData &operator=(const SearchData &) = delete;
+    ~SearchData() { delete bits.queryBits; }
+  };
+  auto data = std::make_shared<SearchData>(query, molholder, fpholder,
+                                           searchOrder, params);
+  auto endIdx = data->mols->size();
+  if (!searchOrder.empty()) {
+    endIdx = std::min(static_cast<unsigned int>(searchOrder.size()), endIdx);
+  }
+  auto factory = [data]() -> detail::MatchCursorImpl::ChunkSearcher {
+    auto threadQuery = std::make_shared<ThreadQuery<Query>>(data->query);
+    return [data, threadQuery](unsigned int first, unsigned int last,
+                               std::vector<unsigned int> &hits,
+                               const std::atomic<bool> &cancelled) {
+      SubstructSearchThreadStats stats;
+      searchChunk(threadQuery->get(), data->bits, *data->mols,
+                  data->needs_rings, nullptr, data->searchOrder, first, last,
+                  hits, stats, [&cancelled]() { return cancelled.load(); });
+    };
+  };
+  return SubstructMatchCursor(std::make_unique<detail::MatchCursorImpl>(
+      endIdx, numThreads, std::move(factory)));
+}
+}  // namespace
+
+SubstructMatchCursor::SubstructMatchCursor(
+    std::unique_ptr<detail::MatchCursorImpl> impl)
+    : dp_impl(std::move(impl)) {}
+SubstructMatchCursor::SubstructMatchCursor(
+    SubstructMatchCursor &&other) noexcept = default;
+SubstructMatchCursor &SubstructMatchCursor::operator=(
+    SubstructMatchCursor &&other) noexcept = default;
+SubstructMatchCursor::~SubstructMatchCursor() = default;
+
+std::vector<unsigned int> SubstructMatchCursor::next(unsigned int maxResults) {
+  PRECONDITION(dp_impl, "no search");
+  return dp_impl->next(maxResults);
+}
+
+bool SubstructMatchCursor::done() const {
+  PRECONDITION(dp_impl, "no search");
+  return dp_impl->done();
+}
+
+void SubstructMatchCursor::cancel() {
+  PRECONDITION(dp_impl, "no search");
+  dp_impl->cancel();
+}
+
+double SubstructMatchCursor::timeToFirstResult() const {
+  PRECONDITION(dp_impl, "no search");
+  return dp_impl->timeToFirstResult();
+}
+
+SubstructMatchCursor SubstructLibrary::getMatchCursor(
+    const ROMol &query, const SubstructMatchParameters &params,
+    int numThreads) const {
+  return makeMatchCursor(query, molholder, fpholder, searchOrder, params,
+                         numThreads);
+}
+
+SubstructMatchCursor SubstructLibrary::getMatchCursor(
+    const TautomerQuery &query, const SubstructMatchParameters &params,
+    int numThreads) const {
+  return makeMatchCursor(query, molholder, fpholder, searchOrder, params,
+                         numThreads);
+}
+
 void SubstructLibrary::toStream(std::ostream &ss) const {
 #ifndef RDK_USE_BOOST_SERIALIZATION
   RDUNUSED_PARAM(ss);
   PRECONDITION(0, "Boost SERIALIZATION is not enabled")
 #else
+  // the mapped holders only refer to their file, there's nothing to pickle
+  if (dynamic_cast<const MappedMolHolder *>(molholder.get()) ||
+      dynamic_cast<const MappedPatternHolder *>(fpholder.get()) ||
+      dynamic_cast<const MappedTautomerPatternHolder *>(fpholder.get()) ||
+      dynamic_cast<const MappedKeyHolder *>(keyholder.get())) {
+    throw ValueErrorException(
+        "mapped substructure libraries can't be serialized, use "
+        "toMappedFile() instead");
+  }
   boost::archive::text_oarchive ar(ss);
   ar << *this;
 #endif
@@ -49,7 +49,12 @@
 #include <GraphMol/GeneralizedSubstruct/XQMol.h>
 
 #include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <string>
+#include <vector>
 #include <boost/lexical_cast.hpp>
 
 namespace RDKit {
@@ -58,6 +63,12 @@ using GeneralizedSubstruct::ExtendedQueryMol;
 
 RDKIT_SUBSTRUCTLIBRARY_EXPORT bool SubstructLibraryCanSerialize();
 
+//! the parts of a pickle which are decoded for substructure searching: atom
+//! and bond properties are kept since queries can refer to them
+const unsigned int searchPickleFlags =
+    PicklerOps::AtomProps | PicklerOps::BondProps | PicklerOps::NoConformers |
+    PicklerOps::NoSubstanceGroups;
+
 //! Base class API for holding molecules to substructure search.
 /*!
   This is an API that hides the implementation details used for
@@ -75,6 +86,14 @@ class RDKIT_SUBSTRUCTLIBRARY_EXPORT MolHolderBase {
   // implementations should throw IndexError on out of range
   virtual boost::shared_ptr<ROMol> getMol(unsigned int) const = 0;
 
+  //! returns a molecule which will only be used for substructure matching.
+  //! Implementations can leave out the parts of the molecule which the
+  //! matching doesn't use (e.g. conformers and SubstanceGroups) if that
+  //! makes them faster.
+  virtual boost::shared_ptr<ROMol> getMolForSearch(unsigned int idx) const {
+    return getMol(idx);
+  }
+
   //! Get the current library size
   virtual unsigned int size() const = 0;
 };
@@ -146,6 +165,16 @@ class RDKIT_SUBSTRUCTLIBRARY_EXPORT CachedMolHolder : public MolHolderBase {
     return mol;
   }
 
+  //! only decodes the parts of the pickle which are used for matching
+  boost::shared_ptr<ROMol> getMolForSearch(unsigned int idx) const override {
+    if (idx >= mols.size()) {
+      throw IndexErrorException(idx);
+    }
+    boost::shared_ptr<ROMol> mol(new ROMol);
+    MolPickler::molFromPickle(mols[idx], mol.get(), searchPickleFlags);
+    return mol;
+  }
+
   unsigned int size() const override {
     return rdcast<unsigned int>(mols.size());
   }
@@ -254,64 +283,208 @@ class RDKIT_SUBSTRUCTLIBRARY_EXPORT CachedTrustedSmilesMolHolder
   const std::vector<std::string> &getMols() const { return mols; }
 };
 
+namespace detail {
+//! allocates storage aligned to \c Alignment bytes
+template <class T, std::size_t Alignment>
+struct AlignedAllocator {
+  using value_type = T;
+  template <class U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() = default;
+  template <class U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(
+        ::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+  }
+  void deallocate(T *p, std::size_t) {
+    ::operator delete(p, std::align_val_t(Alignment));
+  }
+  template <class U>
+  bool operator==(const AlignedAllocator<U, Alignment> &) const {
+    return true;
+  }
+  template <class U>
+  bool operator!=(const AlignedAllocator<U, Alignment> &) const {
+    return false;
+  }
+};
+}  // namespace detail
+
 //! Base FPI for the fingerprinter used to rule out impossible matches
+/*!
+  The fingerprints are stored packed into a single bit matrix with one row of
+  64-bit words per fingerprint, which is what the vectorized screen in
+  passesFilterBatch() works on. The matrix is aligned to 64 bytes. All of the
+  fingerprints in a holder must have the same number of bits.
+*/
 class RDKIT_SUBSTRUCTLIBRARY_EXPORT FPHolderBase {
-  std::vector<ExplicitBitVect *> fps;
+  std::vector<std::uint64_t, detail::AlignedAllocator<std::uint64_t, 64>>
+      fpWords;
+  unsigned int fpNumBits = 0;
+  unsigned int fpNumWords = 0;
+  unsigned int numFps = 0;
+
+  // for each bit, the sorted indices of the fingerprints which have it set.
+  // This is built on demand when it is enabled.
+  struct InvertedIndex {
+    bool enabled = false;
+    std::vector<std::vector<std::uint32_t>> postings;
+    size_t size = 0;
+    std::mutex mutex;
+
+    InvertedIndex() = default;
+    InvertedIndex(const InvertedIndex &other) : enabled(other.enabled) {}
+    InvertedIndex &operator=(const InvertedIndex &other) {
+      enabled = other.enabled;
+      clear();
+      return *this;
+    }
+    void clear() {
+      postings.clear();
+      size = 0;
+    }
+  };
+  mutable InvertedIndex invertedIndex;
 
- public:
-  virtual ~FPHolderBase() {
-    for (size_t i = 0; i < fps.size(); ++i) {
-      delete fps[i];
+  bool updateInvertedIndex() const;
+
+  const std::uint64_t *getRow(unsigned int idx) const {
+    if (idx >= numFps) {
+      throw IndexErrorException(idx);
     }
+    return fpWords.data() + size_t(idx) * fpNumWords;
   }
 
-  virtual unsigned int size() const { return rdcast<unsigned int>(fps.size()); }
+ protected:
+  //! Appends the indices of the bits which are set in the fingerprint at
+  //! \c idx to \c bits, this is what the inverted index is built from
+  virtual void getOnBits(unsigned int idx,
+                         std::vector<unsigned int> &bits) const;
+
+ public:
+  virtual ~FPHolderBase() = default;
+
+  virtual unsigned int size() const { return numFps; }
 
   //! Adds a molecule to the fingerprinter
-  unsigned int addMol(const ROMol &m) {
-    fps.push_back(makeFingerprint(m));
-    return rdcast<unsigned int>(fps.size() - 1);
+  virtual unsigned int addMol(const ROMol &m) {
+    std::unique_ptr<ExplicitBitVect> fp(makeFingerprint(m));
+    return addFingerprint(*fp);
   }
 
   //! Adds a raw bit vector pointer to the fingerprinter, which takes ownership
   //! PLEASE NOTE: make sure that the passed ExplicitBitVect
   //! is compatible with the one generated by makeFingerprint()
   unsigned int addFingerprint(ExplicitBitVect *v) {
-    fps.push_back(v);
-    return rdcast<unsigned int>(fps.size() - 1);
+    PRECONDITION(v, "no fingerprint");
+    std::unique_ptr<ExplicitBitVect> owned(v);
+    return addFingerprint(*owned);
   }
 
   //! Adds a raw bit vector to the fingerprinter
   //! PLEASE NOTE: make sure that the passed ExplicitBitVect
   //! is compatible with the one generated by makeFingerprint()
-  unsigned int addFingerprint(const ExplicitBitVect &v) {
-    return addFingerprint(new ExplicitBitVect(v));
-  }
+  /*!
+    Throws a ValueErrorException if the number of bits doesn't match that of
+    the fingerprints which are already there.
+  */
+  virtual unsigned int addFingerprint(const ExplicitBitVect &v);
 
   //! Return false if a substructure search can never match the molecule
-  bool passesFilter(unsigned int idx, const ExplicitBitVect &query) const {
-    if (idx >= fps.size()) {
-      throw IndexErrorException(idx);
-    }
+  virtual bool passesFilter(unsigned int idx,
+                            const ExplicitBitVect &query) const;
+
+  //! Screens a block of molecules at once
+  /*!
+    Sets \c res[i] to passesFilter(startIdx + i * step, query) for
+    i in [0, count). The fingerprints are screened with the vectorized kernel
+    from CalcBitmapAllProbeBitsMatchBatch(), so this is much faster than
+    calling passesFilter() for each molecule.
+
+    \param query    the query fingerprint
+    \param startIdx the index of the first molecule to screen
+    \param count    the number of molecules to screen
+    \param step     the distance between the indices of the molecules
+    \param res      storage for \c count results
+  */
+  virtual void passesFilterBatch(const ExplicitBitVect &query,
+                                 unsigned int startIdx, unsigned int count,
+                                 unsigned int step, bool *res) const;
 
-    return AllProbeBitsMatch(query, *fps[idx]);
+  //! Returns a copy of the bit vector at the specified index (throws
+  //! IndexError if out of range)
+  virtual ExplicitBitVect getFingerprint(unsigned int idx) const;
+
+  //! Returns the number of bits in the stored fingerprints, zero if there
+  //! are none
+  virtual unsigned int getFingerprintNumBits() const { return fpNumBits; }
+
+  //! Returns the packed row of the fingerprint at the specified index (throws
+  //! IndexError if out of range)
+  /*!
+    The row has (getFingerprintNumBits() + 63) / 64 words, bit \c i is bit
+    (i % 64) of word (i / 64).
+  */
+  virtual const std::uint64_t *getFingerprintWords(unsigned int idx) const {
+    return getRow(idx);
   }
 
-  //! Get the bit vector at the specified index (throws IndexError if out of
-  //! range)
-  const ExplicitBitVect &getFingerprint(unsigned int idx) const {
-    if (idx >= fps.size()) {
-      throw IndexErrorException(idx);
+  //! Returns copies of all of the fingerprints
+  /*!
+    The fingerprints are no longer stored as separate bit vectors, so the
+    results can't be used to modify the holder.
+  */
+  [[deprecated("please use getFingerprint() or getFingerprintWords()")]]
+  std::vector<boost::shared_ptr<ExplicitBitVect>> getFingerprints() const {
+    std::vector<boost::shared_ptr<ExplicitBitVect>> res;
+    res.reserve(size());
+    for (unsigned int i = 0; i < size(); ++i) {
+      res.push_back(boost::make_shared<ExplicitBitVect>(getFingerprint(i)));
     }
-    return *fps[idx];
+    return res;
+  }
+
+  //! Removes all of the fingerprints
+  void clearFingerprints() {
+    fpWords.clear();
+    fpWords.shrink_to_fit();
+    fpNumBits = 0;
+    fpNumWords = 0;
+    numFps = 0;
+    std::lock_guard<std::mutex> lock(invertedIndex.mutex);
+    invertedIndex.clear();
   }
 
   //! make the query vector
   //!  Caller owns the vector!
   virtual ExplicitBitVect *makeFingerprint(const ROMol &m) const = 0;
 
-  std::vector<ExplicitBitVect *> &getFingerprints() { return fps; }
-  const std::vector<ExplicitBitVect *> &getFingerprints() const { return fps; }
+  //! Enables or disables the inverted index of the fingerprint bits
+  /*!
+    With the index, getCandidates() finds the molecules which can match a
+    query by intersecting the lists of molecules which have the query's
+    rarest bits set, instead of screening every fingerprint. This makes
+    selective queries on large libraries much faster, at the cost of
+    memory proportional to the number of bits set in the library.
+
+    The index is built when it is first needed, updated as fingerprints are
+    added, and is not serialized.
+  */
+  void setUseInvertedIndex(bool useIndex) {
+    std::lock_guard<std::mutex> lock(invertedIndex.mutex);
+    invertedIndex.enabled = useIndex;
+    invertedIndex.clear();
+  }
+  bool getUseInvertedIndex() const { return invertedIndex.enabled; }
+
+  //! Returns the indices of the molecules which pass the filter for
+  //! \c query, in increasing order
+  std::vector<unsigned int> getCandidates(const ExplicitBitVect &query) const;
 };
 
 //! Uses the pattern fingerprinter with a user-defined number of bits (default:
@@ -361,7 +534,7 @@ class RDKIT_SUBSTRUCTLIBRARY_EXPORT KeyHolderBase {
 
   // !get the key at the requested index
   // implementations should throw IndexError on out of range
-  virtual const std::string &getKey(unsigned int) const = 0;
+  virtual std::string getKey(unsigned int) const = 0;
 
   // !get keys from a bunch of indices
   virtual std::vector<std::string> getKeys(
@@ -404,7 +577,7 @@ class RDKIT_SUBSTRUCTLIBRARY_EXPORT KeyFromPropHolder : public KeyHolderBase {
     return keys.size() - 1u;
   }
 
-  const std::string &getKey(unsigned int idx) const override {
+  std::string getKey(unsigned int idx) const override {
     if (idx >= keys.size()) {
       throw IndexErrorException(idx);
     }
@@ -421,6 +594,57 @@ class RDKIT_SUBSTRUCTLIBRARY_EXPORT KeyFromPropHolder : public KeyHolderBase {
   unsigned int size() const override { return keys.size(); }
 };
 
+//! Statistics for one of the threads used in a SubstructLibrary search
+struct RDKIT_SUBSTRUCTLIBRARY_EXPORT SubstructSearchThreadStats {
+  unsigned int numChunks = 0;     //!< chunks of the library searched
+  unsigned int numMolecules = 0;  //!< molecules which passed the screen
+  unsigned int numMatches = 0;    //!< molecules which matched the query
+  double seconds = 0.0;           //!< time spent searching
+};
+
+namespace detail {
+class MatchCursorImpl;
+}
+
+//! Returns the matches of a SubstructLibrary search a page at a time
+/*!
+  Cursors are created by SubstructLibrary::getMatchCursor(). The search runs
+  on background threads which stay a bounded number of chunks of the library
+  ahead of the results which have been read, so the memory used doesn't grow
+  with the size of the library and the first results are available before
+  the whole library has been searched.
+
+  The matches are returned in the order they would be returned by
+  getMatches(): library index order, or the search order if one is set.
+
+  The library must not be modified while the cursor is in use.
+*/
+class RDKIT_SUBSTRUCTLIBRARY_EXPORT SubstructMatchCursor {
+  std::unique_ptr<detail::MatchCursorImpl> dp_impl;
+
+ public:
+  explicit SubstructMatchCursor(std::unique_ptr<detail::MatchCursorImpl> impl);
+  SubstructMatchCursor(SubstructMatchCursor &&other) noexcept;
+  SubstructMatchCursor &operator=(SubstructMatchCursor &&other) noexcept;
+  //! stops the search if it is still running
+  ~SubstructMatchCursor();
+
+  //! Returns up to \c maxResults more matches
+  /*!
+    Blocks until \c maxResults matches are available or the search has
+    finished. Fewer than \c maxResults matches are only returned at the end
+    of the search.
+  */
+  std::vector<unsigned int> next(unsigned int maxResults);
+  //! Returns whether or not all of the matches have been returned
+  bool done() const;
+  //! Stops the search, next() returns no more matches after this
+  void cancel();
+  //! Returns the number of seconds between the creation of the cursor and
+  //! the first match being found, or a negative value if none has been
+  double timeToFirstResult() const;
+};
+
 //! Substructure Search a library of molecules
 /*!  This class allows for multithreaded substructure searches of
      large datasets.
@@ -526,6 +750,30 @@ class RDKIT_SUBSTRUCTLIBRARY_EXPORT SubstructLibrary {
   bool is_tautomerquery = false;
   std::vector<unsigned int> searchOrder;
 
+  // the statistics from the most recent search, copies of the library start
+  // without any
+  class SearchStatsHolder {
+    std::vector<SubstructSearchThreadStats> stats;
+    mutable std::mutex mutex;
+
+   public:
+    SearchStatsHolder() = default;
+    SearchStatsHolder(const SearchStatsHolder &) {}
+    SearchStatsHolder &operator=(const SearchStatsHolder &) {
+      set({});
+      return *this;
+    }
+    void set(std::vector<SubstructSearchThreadStats> newStats) {
+      std::lock_guard<std::mutex> lock(mutex);
+      stats = std::move(newStats);
+    }
+    std::vector<SubstructSearchThreadStats> get() const {
+      std::lock_guard<std::mutex> lock(mutex);
+      return stats;
+    }
+  };
+  mutable SearchStatsHolder searchStats;
+
  public:
   SubstructLibrary()
       : molholder(new MolHolder),
@@ -902,6 +1150,23 @@ class RDKIT_SUBSTRUCTLIBRARY_EXPORT SubstructLibrary {
   bool hasMatch(const ExtendedQueryMol &query, unsigned int startIdx,
                 unsigned int endIdx, const SubstructMatchParameters &params,
                 int numThreads = -1) const;
+  //! Returns a cursor which returns the matches a page at a time
+  /*!
+    \param query      Query to match against molecules
+    \param params     Parameters to the substructure search
+    \param numThreads If -1 use all available processors for the
+                       background search
+  */
+  SubstructMatchCursor getMatchCursor(
+      const ROMol &query,
+      const SubstructMatchParameters &params = SubstructMatchParameters(),
+      int numThreads = -1) const;
+  //! overload
+  SubstructMatchCursor getMatchCursor(
+      const TautomerQuery &query,
+      const SubstructMatchParameters &params = SubstructMatchParameters(),
+      int numThreads = -1) const;
+
   //! Returns the molecule at the given index
   /*!
     \param idx       Index of the molecule in the library (n.b. could contain
@@ -945,6 +1210,12 @@ class RDKIT_SUBSTRUCTLIBRARY_EXPORT SubstructLibrary {
   }
 
   std::vector<unsigned int> &getSearchOrder() { return searchOrder; }
+
+  //! Returns statistics for each of the threads used by the most recent
+  //! getMatches(), countMatches() or hasMatch() call on this library
+  std::vector<SubstructSearchThreadStats> getSearchStats() const {
+    return searchStats.get();
+  }
   //! access required for serialization
   void resetHolders() {
     is_tautomerquery = false;
@@ -956,6 +1227,10 @@ class RDKIT_SUBSTRUCTLIBRARY_EXPORT SubstructLibrary {
   }
 
   //! serializes (pickles) to a stream
+  /*!
+    Throws a ValueErrorException for libraries which were initialized with
+    initFromMappedFile()
+  */
   void toStream(std::ostream &ss) const;
   //! returns a string with a serialized (pickled) representation
   std::string Serialize() const;
@@ -963,6 +1238,26 @@ class RDKIT_SUBSTRUCTLIBRARY_EXPORT SubstructLibrary {
   void initFromStream(std::istream &ss);
   //! initializes from a string pickle
   void initFromString(const std::string &text);
+
+  //! writes the library to a binary file which can be memory mapped
+  /*!
+    The file stores the molecules (as pickles or SMILES, depending on the
+    molecule holder), the pattern fingerprints, the keys and the search order
+    in a versioned layout which can be used without being deserialized. See
+    initFromMappedFile() and MappedSubstructLibrary.h
+
+    Only PatternHolder and TautomerPatternHolder fingerprints are supported.
+
+    \b Note: \c fname must not be the file this library was initialized from
+    with initFromMappedFile()
+  */
+  void toMappedFile(const std::string &fname) const;
+  //! initializes from a file written by toMappedFile()
+  /*!
+    The file is memory mapped and used in place, so this is very fast even
+    for large libraries. The library is read-only afterwards.
+  */
+  void initFromMappedFile(const std::string &fname);
 };
 }  // namespace RDKit
 
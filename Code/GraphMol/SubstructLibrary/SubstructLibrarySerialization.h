@@ -122,8 +122,8 @@ void save(Archive &ar, const RDKit::FPHolderBase &fpholder,
           const unsigned int version) {
   RDUNUSED_PARAM(version);
   std::vector<std::string> pickles;
-  for (auto &fp : fpholder.getFingerprints()) {
-    pickles.push_back(fp->toString());
+  for (unsigned int i = 0; i < fpholder.size(); ++i) {
+    pickles.push_back(fpholder.getFingerprint(i).toString());
   }
   ar & pickles;
 }
@@ -133,16 +133,11 @@ void load(Archive &ar, RDKit::FPHolderBase &fpholder,
           const unsigned int version) {
   RDUNUSED_PARAM(version);
   std::vector<std::string> pickles;
-  std::vector<ExplicitBitVect *> &fps = fpholder.getFingerprints();
 
   ar & pickles;
-  for (size_t i = 0; i < fps.size(); ++i) {
-    delete fps[i];
-  }
-  fps.clear();
-
+  fpholder.clearFingerprints();
   for (auto &pkl : pickles) {
-    fps.push_back(new ExplicitBitVect(pkl));
+    fpholder.addFingerprint(ExplicitBitVect(pkl));
   }
 }
 
@@ -182,6 +177,8 @@ void serialize(Archive &ar, RDKit::KeyFromPropHolder &key_holder,
   ar & key_holder.getKeys();
 }
 
+// the holders from MappedSubstructLibrary.h are not registered,
+// SubstructLibrary::toStream() refuses to serialize them
 template <class Archive>
 void registerSubstructLibraryTypes(Archive &ar) {
   ar.register_type(static_cast<RDKit::MolHolder *>(nullptr));
@@ -373,6 +373,17 @@ const char *SubstructLibraryDoc =
     "['Z11234']\n"
     "";
 
+const char *SubstructMatchCursorDoc =
+    "Returns the matches of a SubstructLibrary search a page at a time.\n"
+    "The library is searched by background threads which only work a few "
+    "chunks\n"
+    "ahead of the matches which have been read, the matches are returned "
+    "in the\n"
+    "same order as GetMatches().\n\n"
+    ">>> cursor = library.GetMatchCursor(query)\n"
+    ">>> while not cursor.Done():\n"
+    "...   page = cursor.Next(100)\n";
+
 python::object SubstructLibrary_Serialize(const SubstructLibraryWrap &cat) {
   std::string res = cat.ss.Serialize();
   python::object retval = python::object(
@@ -405,6 +416,15 @@ void initFromStream(SubstructLibraryWrap &cat, python::object &fileobj) {
   cat.ss.initFromStream(is);
 }
 
+void toMappedFile(const SubstructLibraryWrap &cat, const std::string &fname) {
+  NOGIL h;
+  cat.ss.toMappedFile(fname);
+}
+
+void initFromMappedFile(SubstructLibraryWrap &cat, const std::string &fname) {
+  cat.ss.initFromMappedFile(fname);
+}
+
 boost::shared_ptr<MolHolderBase> GetMolHolder(SubstructLibraryWrap &sslib) {
   // need to convert from a ref to a real shared_ptr
   return sslib.ss.getMolHolder();
@@ -427,6 +447,42 @@ python::tuple getSearchOrderHelper(const SubstructLibraryWrap &sslib) {
   }
   return python::tuple(res);
 }
+python::tuple getSearchStatsHelper(const SubstructLibraryWrap &sslib) {
+  python::list res;
+  for (const auto &stats : sslib.ss.getSearchStats()) {
+    python::dict d;
+    d["numChunks"] = stats.numChunks;
+    d["numMolecules"] = stats.numMolecules;
+    d["numMatches"] = stats.numMatches;
+    d["seconds"] = stats.seconds;
+    res.append(d);
+  }
+  return python::tuple(res);
+}
+template <class Query>
+SubstructMatchCursor *getMatchCursorHelper(const SubstructLibraryWrap &sslib,
+                                           const Query &query,
+                                           bool recursionPossible,
+                                           bool useChirality,
+                                           bool useQueryQueryMatches,
+                                           int numThreads) {
+  SubstructMatchParameters params;
+  params.recursionPossible = recursionPossible;
+  params.useChirality = useChirality;
+  params.useQueryQueryMatches = useQueryQueryMatches;
+  NOGIL h;
+  return new SubstructMatchCursor(
+      sslib.ss.getMatchCursor(query, params, numThreads));
+}
+std::vector<unsigned int> cursorNextHelper(SubstructMatchCursor &cursor,
+                                           unsigned int maxResults) {
+  NOGIL h;
+  return cursor.next(maxResults);
+}
+void cursorCancelHelper(SubstructMatchCursor &cursor) {
+  NOGIL h;
+  cursor.cancel();
+}
 void setSearchOrderHelper(SubstructLibraryWrap &sslib,
                           const python::object &seq) {
   std::unique_ptr<std::vector<unsigned int>> sorder =
@@ -686,14 +742,24 @@ struct substructlibrary_wrapper {
              "Adds a raw bit vector to the fingerprint database, returns the "
              "index of the supplied pattern")
         .def("GetFingerprint", &FPHolderBase::getFingerprint,
-             python::return_value_policy<python::reference_existing_object>(),
              python::args("self", "idx"),
-             "Return the bit vector at the specified index")
+             "Return a copy of the bit vector at the specified index")
         .def("PassesFilter", &FPHolderBase::passesFilter,
              ((python::args("self"), python::args("idx")),
               python::args("query")),
              "Returns True if the specified index passes the filter supplied "
              "by the query bit vector")
+        .def("SetUseInvertedIndex", &FPHolderBase::setUseInvertedIndex,
+             python::args("self", "useIndex"),
+             "Enables or disables an inverted index of the fingerprint bits, "
+             "which\n"
+             "makes selective queries on large libraries much faster at the "
+             "cost of memory.\n"
+             "The index is built when it is first needed and is not "
+             "serialized.")
+        .def("GetUseInvertedIndex", &FPHolderBase::getUseInvertedIndex,
+             python::args("self"),
+             "Returns whether or not the inverted index is used")
         .def("MakeFingerprint", &FPHolderBase::makeFingerprint,
              ((python::arg("self"), python::arg("mol"))),
              python::return_value_policy<python::manage_new_object>(),
@@ -713,9 +779,7 @@ struct substructlibrary_wrapper {
              "of the new pattern")
         .def("AddKey", &KeyHolderBase::addKey, python::args("self", "arg1"),
              "Add a key to the key holder, must be manually synced")
-        .def("GetKey", &KeyHolderBase::getKey,
-             python::return_value_policy<python::copy_const_reference>(),
-             python::args("self", "arg1"),
+        .def("GetKey", &KeyHolderBase::getKey, python::args("self", "arg1"),
              "Return the key at the specified index")
         .def("GetKeys", &KeyHolderBase::getKeys,
              python::args("self", "indices"),
@@ -743,6 +807,24 @@ struct substructlibrary_wrapper {
         python::init<>(python::args("self")))
         .def(python::init<unsigned int>(python::args("self", "numBits")));
 
+    python::class_<SubstructMatchCursor, boost::noncopyable>(
+        "SubstructMatchCursor", SubstructMatchCursorDoc, python::no_init)
+        .def("Next", cursorNextHelper,
+             (python::arg("self"), python::arg("maxResults")),
+             "Returns up to maxResults more matches, blocking until they "
+             "are\n"
+             "available. Fewer matches are only returned at the end of the "
+             "search.")
+        .def("Done", &SubstructMatchCursor::done, python::args("self"),
+             "Returns whether or not all of the matches have been returned")
+        .def("Cancel", cursorCancelHelper, python::args("self"),
+             "Stops the search, Next() returns no more matches after this")
+        .def("TimeToFirstResult", &SubstructMatchCursor::timeToFirstResult,
+             python::args("self"),
+             "Returns the number of seconds it took to find the first "
+             "match,\n"
+             "or a negative value if none has been found");
+
     python::class_<SubstructLibraryWrap,
                    boost::shared_ptr<SubstructLibraryWrap>>(
         "SubstructLibrary", SubstructLibraryDoc,
@@ -792,6 +874,39 @@ struct substructlibrary_wrapper {
         .def("GetSearchOrder", getSearchOrderHelper, python::args("self"),
              "Returns the search order for the library\n\n"
              "  NOTE: molecule indices start at 0\n")
+        .def("GetSearchStats", getSearchStatsHelper, python::args("self"),
+             "Returns a dictionary of statistics for each of the threads "
+             "used\n"
+             "by the most recent search of the library\n")
+
+        .def("GetMatchCursor", getMatchCursorHelper<ROMol>,
+             (python::arg("self"), python::arg("query"),
+              python::arg("recursionPossible") = true,
+              python::arg("useChirality") = true,
+              python::arg("useQueryQueryMatches") = false,
+              python::arg("numThreads") = -1),
+             python::return_value_policy<python::manage_new_object>(),
+             "Returns a SubstructMatchCursor which searches the library in "
+             "the\n"
+             "background and returns the matches a page at a time.\n\n"
+             " Arguments:\n"
+             "  - query:      substructure query\n"
+             "  - numThreads: number of threads to use, -1 means all "
+             "threads\n")
+        .def("GetMatchCursor", getMatchCursorHelper<TautomerQuery>,
+             (python::arg("self"), python::arg("query"),
+              python::arg("recursionPossible") = true,
+              python::arg("useChirality") = true,
+              python::arg("useQueryQueryMatches") = false,
+              python::arg("numThreads") = -1),
+             python::return_value_policy<python::manage_new_object>(),
+             "Returns a SubstructMatchCursor which searches the library in "
+             "the\n"
+             "background and returns the matches a page at a time.\n\n"
+             " Arguments:\n"
+             "  - query:      substructure query\n"
+             "  - numThreads: number of threads to use, -1 means all "
+             "threads\n")
 
         .def("__len__", &SubstructLibraryWrap::size, python::args("self"))
 
@@ -831,6 +946,24 @@ struct substructlibrary_wrapper {
              "  >>> with open('rdkit.sslib', 'rb') as f: "
              "lib.InitFromStream(f)\n")
 
+        .def("ToMappedFile", &toMappedFile,
+             (python::arg("self"), python::arg("filename")),
+             "Writes the library to a binary file which can be memory "
+             "mapped with InitFromMappedFile()\n\n"
+             "  ARGUMENTS:\n"
+             "    - filename: the name of the file to write\n\n"
+             "  NOTE: only pattern fingerprints can be stored in the file\n")
+
+        .def("InitFromMappedFile", &initFromMappedFile,
+             (python::arg("self"), python::arg("filename")),
+             "Initializes the library from a file written by ToMappedFile()\n"
+             "The file is memory mapped and used in place, so this is fast "
+             "even for large\n"
+             "libraries. Molecules are only decoded when they are needed.\n\n"
+             "  ARGUMENTS:\n"
+             "    - filename: the name of the file to read\n\n"
+             "  NOTE: the library is read-only afterwards\n")
+
         .def("Serialize", &SubstructLibrary_Serialize, python::args("self"))
         // enable pickle support
         .def_pickle(substructlibrary_pickle_suite());
@@ -411,6 +411,87 @@ class TestCase(unittest.TestCase):
     slib3.InitFromStream(sb)
     self.assertEqual(len(slib), len(slib2))
 
+  def test_mapped_file(self):
+    mols = makeStereoExamples() * 10
+    for holder in (rdSubstructLibrary.MolHolder(), rdSubstructLibrary.CachedSmilesMolHolder(),
+                   rdSubstructLibrary.CachedTrustedSmilesMolHolder()):
+      slib = rdSubstructLibrary.SubstructLibrary(holder, rdSubstructLibrary.PatternHolder())
+      for mol in mols:
+        slib.AddMol(mol)
+
+      fd, path = tempfile.mkstemp()
+      os.close(fd)
+      try:
+        slib.ToMappedFile(path)
+        slib2 = rdSubstructLibrary.SubstructLibrary()
+        slib2.InitFromMappedFile(path)
+        self.assertEqual(len(slib), len(slib2))
+        for i in (0, len(slib) - 1):
+          self.assertEqual(Chem.MolToSmiles(slib.GetMol(i)), Chem.MolToSmiles(slib2.GetMol(i)))
+        for query in ('C1CCCCC1', 'C[C@H](F)Cl', 'O'):
+          q = Chem.MolFromSmiles(query)
+          self.assertEqual(list(slib.GetMatches(q)), list(slib2.GetMatches(q)))
+        with self.assertRaises(ValueError):
+          slib2.AddMol(mols[0])
+        del slib2
+      finally:
+        os.unlink(path)
+
+    slib = rdSubstructLibrary.SubstructLibrary()
+    with self.assertRaises(OSError):
+      slib.InitFromMappedFile(os.path.join(RDConfig.RDBaseDir, 'README.md'))
+
+  def test_search_stats(self):
+    slib = rdSubstructLibrary.SubstructLibrary(rdSubstructLibrary.CachedSmilesMolHolder(),
+                                               rdSubstructLibrary.PatternHolder())
+    for smi in ('CCCC', 'CCOC', 'c1ccccc1', 'OCC(=O)O') * 200:
+      slib.AddMol(Chem.MolFromSmiles(smi))
+    q = Chem.MolFromSmiles('CO')
+    self.assertEqual(slib.CountMatches(q, numThreads=2), 400)
+    stats = slib.GetSearchStats()
+    self.assertEqual(len(stats), 2)
+    self.assertEqual(sum(x['numMatches'] for x in stats), 400)
+    self.assertEqual(sum(x['numChunks'] for x in stats), 4)
+
+    self.assertEqual(list(slib.GetMatches(q, numThreads=2, maxResults=10)),
+                     list(slib.GetMatches(q, numThreads=1, maxResults=10)))
+
+  def test_inverted_index(self):
+    fps = rdSubstructLibrary.PatternHolder()
+    slib = rdSubstructLibrary.SubstructLibrary(rdSubstructLibrary.CachedSmilesMolHolder(), fps)
+    for smi in ('CCCC', 'CCOC', 'c1ccccc1', 'OCC(=O)O', 'Brc1ccccc1') * 20:
+      slib.AddMol(Chem.MolFromSmiles(smi))
+    queries = [Chem.MolFromSmiles(smi) for smi in ('CO', 'c1ccccc1Br', 'S')]
+    expected = [list(slib.GetMatches(q)) for q in queries]
+    self.assertFalse(fps.GetUseInvertedIndex())
+    fps.SetUseInvertedIndex(True)
+    self.assertTrue(fps.GetUseInvertedIndex())
+    self.assertEqual([list(slib.GetMatches(q)) for q in queries], expected)
+
+  def test_match_cursor(self):
+    slib = rdSubstructLibrary.SubstructLibrary(rdSubstructLibrary.CachedSmilesMolHolder(),
+                                               rdSubstructLibrary.PatternHolder())
+    for smi in ('CCCC', 'CCOC', 'c1ccccc1', 'OCC(=O)O') * 500:
+      slib.AddMol(Chem.MolFromSmiles(smi))
+    q = Chem.MolFromSmiles('CO')
+    expected = list(slib.GetMatches(q, maxResults=-1))
+    self.assertEqual(len(expected), 1000)
+    cursor = slib.GetMatchCursor(q, numThreads=2)
+    matches = []
+    while not cursor.Done():
+      page = list(cursor.Next(64))
+      if not cursor.Done():
+        self.assertEqual(len(page), 64)
+      matches.extend(page)
+    self.assertEqual(matches, expected)
+    self.assertGreaterEqual(cursor.TimeToFirstResult(), 0)
+
+    cursor = slib.GetMatchCursor(q)
+    self.assertEqual(len(cursor.Next(10)), 10)
+    cursor.Cancel()
+    self.assertTrue(cursor.Done())
+    self.assertEqual(len(cursor.Next(10)), 0)
+
   def test_addpatterns(self):
     pdb_ligands = [
       "CCS(=O)(=O)c1ccc(OC)c(Nc2ncc(-c3cccc(-c4ccccn4)c3)o2)c1",
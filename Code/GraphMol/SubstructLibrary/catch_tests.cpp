@@ -12,13 +12,19 @@
 
 #include <GraphMol/RDKitBase.h>
 #include <GraphMol/MolBundle.h>
+#include <GraphMol/SubstanceGroup.h>
 #include <GraphMol/SmilesParse/SmilesParse.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
 #include <GraphMol/RDKitQueries.h>
 #include <GraphMol/SubstructLibrary/SubstructLibrary.h>
 #include <GraphMol/SubstructLibrary/PatternFactory.h>
+#include <GraphMol/SubstructLibrary/MappedSubstructLibrary.h>
 #include <GraphMol/GeneralizedSubstruct/XQMol.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
 using namespace RDKit;
 
 TEST_CASE("querying with a molbundle") {
@@ -326,4 +332,543 @@ TEST_CASE("ExtendedQueryMol") {
     CHECK(!ssslib.hasMatch(xqm));
   }
 }
-#endif
\ No newline at end of file
+#endif
+
+TEST_CASE("memory mapped libraries") {
+  std::vector<std::string> libSmiles = {"CCCC",     "CCOC",  "CCNC",
+                                        "c1ccccc1", "C1CC1", "OCC(=O)O",
+                                        "C[C@H](F)Cl"};
+  std::vector<std::string> qSmiles = {"CC", "CO", "c1ccccc1", "C(=O)O",
+                                      "C[C@@H](F)Cl"};
+  std::string fname = std::tmpnam(nullptr);
+  std::string fname2 = fname + "_2";
+  auto check = [&](const SubstructLibrary &lib, const std::string &outName) {
+    lib.toMappedFile(outName);
+    SubstructLibrary mapped;
+    mapped.initFromMappedFile(outName);
+    REQUIRE(mapped.size() == lib.size());
+    CHECK(mapped.getSearchOrder() == lib.getSearchOrder());
+    for (unsigned int i = 0; i < lib.size(); ++i) {
+      CHECK(MolToSmiles(*mapped.getMol(i)) == MolToSmiles(*lib.getMol(i)));
+    }
+    for (auto useChirality : {false, true}) {
+      SubstructMatchParameters ps;
+      ps.useChirality = useChirality;
+      for (const auto &smi : qSmiles) {
+        std::unique_ptr<RWMol> query(SmilesToMol(smi));
+        REQUIRE(query);
+        CHECK(mapped.getMatches(*query, ps) == lib.getMatches(*query, ps));
+      }
+    }
+    CHECK_THROWS_AS(mapped.addMol(*lib.getMol(0)), ValueErrorException);
+    return mapped;
+  };
+
+  SECTION("molecule holders") {
+    std::vector<boost::shared_ptr<MolHolderBase>> holders = {
+        boost::make_shared<MolHolder>(), boost::make_shared<CachedMolHolder>(),
+        boost::make_shared<CachedSmilesMolHolder>(),
+        boost::make_shared<CachedTrustedSmilesMolHolder>()};
+    for (auto &holder : holders) {
+      SubstructLibrary lib(holder);
+      for (const auto &smi : libSmiles) {
+        std::unique_ptr<RWMol> mol(SmilesToMol(smi));
+        REQUIRE(mol);
+        lib.addMol(*mol);
+      }
+      auto mapped = check(lib, fname);
+      CHECK(!mapped.getFpHolder());
+      CHECK(!mapped.getKeyHolder());
+    }
+  }
+  SECTION("fingerprints, keys and search order") {
+    for (auto tautomers : {false, true}) {
+      boost::shared_ptr<FPHolderBase> fps;
+      if (tautomers) {
+        fps = boost::make_shared<TautomerPatternHolder>();
+      } else {
+        fps = boost::make_shared<PatternHolder>(1024);
+      }
+      auto keys = boost::make_shared<KeyFromPropHolder>("id");
+      SubstructLibrary lib(boost::make_shared<CachedSmilesMolHolder>(), fps,
+                           keys);
+      for (unsigned int i = 0; i < libSmiles.size(); ++i) {
+        std::unique_ptr<RWMol> mol(SmilesToMol(libSmiles[i]));
+        REQUIRE(mol);
+        mol->setProp("id", "mol-" + std::to_string(i));
+        lib.addMol(*mol);
+      }
+      lib.setSearchOrder({6, 5, 4, 3, 2, 1, 0});
+      auto mapped = check(lib, fname);
+      auto mappedFps =
+          dynamic_cast<PatternHolder *>(mapped.getFpHolder().get());
+      REQUIRE(mappedFps);
+      CHECK(mappedFps->getNumBits() == (tautomers ? 2048u : 1024u));
+      CHECK((dynamic_cast<TautomerPatternHolder *>(mappedFps) != nullptr) ==
+            tautomers);
+      // the stored fingerprints are read from the file
+      REQUIRE(mappedFps->size() == fps->size());
+      for (unsigned int i = 0; i < fps->size(); ++i) {
+        CHECK(mappedFps->getFingerprint(i) == fps->getFingerprint(i));
+        const auto *words = fps->getFingerprintWords(i);
+        CHECK(std::equal(words, words + fps->getFingerprintNumBits() / 64,
+                         mappedFps->getFingerprintWords(i)));
+      }
+      CHECK_THROWS_AS(mappedFps->getFingerprint(fps->size()),
+                      IndexErrorException);
+      CHECK_THROWS_AS(mappedFps->addMol(*lib.getMol(0)), ValueErrorException);
+      CHECK_THROWS_AS(mappedFps->addFingerprint(fps->getFingerprint(0)),
+                      ValueErrorException);
+      CHECK(mappedFps->size() == fps->size());
+#ifdef RDK_USE_BOOST_SERIALIZATION
+      CHECK_THROWS_AS(mapped.Serialize(), ValueErrorException);
+#endif
+      auto mappedKeys =
+          dynamic_cast<MappedKeyHolder *>(mapped.getKeyHolder().get());
+      REQUIRE(mappedKeys);
+      CHECK(mappedKeys->getPropName() == "id");
+      CHECK(mappedKeys->getKey(3) == "mol-3");
+      CHECK(mappedKeys->getKeys({1, 2}) ==
+            std::vector<std::string>{"mol-1", "mol-2"});
+
+      // a mapped library can be written to a new file
+      check(mapped, fname2);
+    }
+  }
+  SECTION("bad files") {
+    SubstructLibrary lib;
+    CHECK_THROWS_AS(lib.initFromMappedFile("does_not_exist.sslib"),
+                    BadFileException);
+    {
+      std::ofstream out(fname, std::ios_base::binary);
+      out << std::string(256, 'x');
+    }
+    CHECK_THROWS_AS(lib.initFromMappedFile(fname), BadFileException);
+  }
+  std::remove(fname.c_str());
+  std::remove(fname2.c_str());
+}
+
+TEST_CASE("batched pattern fingerprint screen") {
+  std::vector<std::string> libSmiles = {
+      "CCCC",        "CCOC",           "CCNC",      "c1ccccc1",
+      "C1CC1",       "OCC(=O)O",       "c1ccncc1",  "C[C@H](F)Cl",
+      "CCCCCCCCCCC", "c1ccccc1O",      "NCC(=O)O",  "CC(C)C",
+      "O=C1CCCCC1",  "c1ccc2ccccc2c1", "CS(=O)C"};
+  auto fps = boost::make_shared<PatternHolder>(1024);
+  SubstructLibrary lib(boost::make_shared<CachedSmilesMolHolder>(), fps);
+  // enough molecules that the screen has to use more than one block
+  for (unsigned int i = 0; i < 40; ++i) {
+    for (const auto &smi : libSmiles) {
+      std::unique_ptr<RWMol> mol(SmilesToMol(smi));
+      REQUIRE(mol);
+      lib.addMol(*mol);
+    }
+  }
+  std::vector<std::string> qSmiles = {"CC", "C(=O)O", "c1ccccc1", "CCCCCC",
+                                      "S"};
+  SECTION("agrees with passesFilter") {
+    for (const auto &smi : qSmiles) {
+      std::unique_ptr<RWMol> query(SmilesToMol(smi));
+      REQUIRE(query);
+      std::unique_ptr<ExplicitBitVect> qfp(fps->makeFingerprint(*query));
+      for (unsigned int step : {1u, 3u}) {
+        const unsigned int count = (fps->size() - 2) / step;
+        std::unique_ptr<bool[]> res(new bool[count]);
+        fps->passesFilterBatch(*qfp, 2, count, step, res.get());
+        for (unsigned int i = 0; i < count; ++i) {
+          CHECK(res[i] == fps->passesFilter(2 + i * step, *qfp));
+        }
+      }
+      std::unique_ptr<bool[]> res(new bool[2]);
+      CHECK_THROWS_AS(
+          fps->passesFilterBatch(*qfp, fps->size() - 1, 2, 1, res.get()),
+          IndexErrorException);
+    }
+  }
+  SECTION("packed storage") {
+    CHECK(fps->getFingerprintNumBits() == 1024);
+    CHECK(reinterpret_cast<std::uintptr_t>(fps->getFingerprintWords(0)) % 64 ==
+          0);
+    for (unsigned int i = 0; i < libSmiles.size(); ++i) {
+      std::unique_ptr<ExplicitBitVect> fp(fps->makeFingerprint(*lib.getMol(i)));
+      CHECK(fps->getFingerprint(i) == *fp);
+    }
+    CHECK_THROWS_AS(fps->getFingerprint(fps->size()), IndexErrorException);
+    CHECK_THROWS_AS(fps->addFingerprint(ExplicitBitVect(2048)),
+                    ValueErrorException);
+    PatternHolder copy(*fps);
+    CHECK(copy.size() == fps->size());
+    CHECK(copy.getFingerprint(3) == fps->getFingerprint(3));
+    copy.clearFingerprints();
+    CHECK(copy.size() == 0);
+    CHECK(fps->size() == lib.size());
+  }
+  SECTION("matches are unchanged") {
+    SubstructLibrary unscreened(boost::make_shared<CachedSmilesMolHolder>());
+    for (unsigned int i = 0; i < lib.size(); ++i) {
+      unscreened.addMol(*lib.getMol(i));
+    }
+    for (const auto &smi : qSmiles) {
+      std::unique_ptr<RWMol> query(SmilesToMol(smi));
+      REQUIRE(query);
+      for (auto numThreads : {1, 4}) {
+        CHECK(lib.getMatches(*query, true, true, false, numThreads) ==
+              unscreened.getMatches(*query, true, true, false, numThreads));
+        CHECK(lib.countMatches(*query, true, true, false, numThreads) ==
+              unscreened.countMatches(*query, true, true, false, numThreads));
+      }
+    }
+    // fingerprints added after a search are screened too
+    std::unique_ptr<RWMol> mol(SmilesToMol("c1ccccc1S"));
+    REQUIRE(mol);
+    auto idx = lib.addMol(*mol);
+    std::unique_ptr<RWMol> query(SmilesToMol("S"));
+    auto matches = lib.getMatches(*query);
+    CHECK(std::find(matches.begin(), matches.end(), idx) != matches.end());
+  }
+  SECTION("mapped libraries") {
+    std::string fname = std::tmpnam(nullptr);
+    lib.toMappedFile(fname);
+    {
+      SubstructLibrary mapped;
+      mapped.initFromMappedFile(fname);
+      const auto &mappedFps = *mapped.getFpHolder();
+      for (const auto &smi : qSmiles) {
+        std::unique_ptr<RWMol> query(SmilesToMol(smi));
+        REQUIRE(query);
+        std::unique_ptr<ExplicitBitVect> qfp(fps->makeFingerprint(*query));
+        const unsigned int count = (mappedFps.size() - 1) / 2;
+        std::unique_ptr<bool[]> res(new bool[count]);
+        mappedFps.passesFilterBatch(*qfp, 1, count, 2, res.get());
+        for (unsigned int i = 0; i < count; ++i) {
+          CHECK(res[i] == fps->passesFilter(1 + i * 2, *qfp));
+        }
+        CHECK(mapped.getMatches(*query) == lib.getMatches(*query));
+      }
+    }
+    std::remove(fname.c_str());
+  }
+}
+
+TEST_CASE("chunked multithreaded searches") {
+  std::vector<std::string> libSmiles = {"CCCC", "CCOC", "c1ccccc1", "C1CC1",
+                                        "OCC(=O)O", "CCNC", "c1ccncc1"};
+  SubstructLibrary lib(boost::make_shared<CachedSmilesMolHolder>(),
+                       boost::make_shared<PatternHolder>());
+  // enough molecules for a few chunks
+  for (unsigned int i = 0; i < 200; ++i) {
+    for (const auto &smi : libSmiles) {
+      std::unique_ptr<RWMol> mol(SmilesToMol(smi));
+      REQUIRE(mol);
+      lib.addMol(*mol);
+    }
+  }
+  auto query = "CO"_smiles;
+  REQUIRE(query);
+  SubstructMatchParameters ps;
+  auto allMatches = lib.getMatches(*query, ps, 1);
+  CHECK(allMatches.size() == 400);
+
+  SECTION("maxResults") {
+    for (auto maxResults : {1, 10, 300, 399, 400, 1000}) {
+      auto expected = allMatches;
+      if (maxResults < static_cast<int>(expected.size())) {
+        expected.resize(maxResults);
+      }
+      for (auto numThreads : {1, 2, 4}) {
+        CHECK(lib.getMatches(*query, ps, numThreads, maxResults) == expected);
+      }
+    }
+  }
+  SECTION("search order") {
+    std::vector<unsigned int> order(lib.size());
+    for (unsigned int i = 0; i < order.size(); ++i) {
+      order[i] = order.size() - 1 - i;
+    }
+    lib.setSearchOrder(order);
+    auto expected = lib.getMatches(*query, ps, 1, 25);
+    REQUIRE(expected.size() == 25);
+    CHECK(expected.front() == allMatches.back());
+    for (auto numThreads : {2, 4}) {
+      CHECK(lib.getMatches(*query, ps, numThreads, 25) == expected);
+      CHECK(lib.countMatches(*query, ps, numThreads) == allMatches.size());
+    }
+  }
+  SECTION("statistics") {
+    CHECK(lib.getSearchStats().size() == 1);
+    CHECK(lib.countMatches(*query, ps, 4) == allMatches.size());
+    auto stats = lib.getSearchStats();
+    REQUIRE(stats.size() == 4);
+    unsigned int numChunks = 0;
+    unsigned int numMatches = 0;
+    for (const auto &threadStats : stats) {
+      numChunks += threadStats.numChunks;
+      numMatches += threadStats.numMatches;
+      CHECK(threadStats.numMatches <= threadStats.numMolecules);
+      CHECK(threadStats.seconds >= 0.0);
+    }
+    CHECK(numChunks == (lib.size() + 255) / 256);
+    CHECK(numMatches == allMatches.size());
+
+    // early exit: only the first chunk is needed here
+    CHECK(lib.hasMatch(*query, ps, 1));
+    stats = lib.getSearchStats();
+    REQUIRE(stats.size() == 1);
+    CHECK(stats[0].numChunks == 1);
+    CHECK(stats[0].numMatches == 1);
+  }
+}
+
+TEST_CASE("inverted index for pattern fingerprints") {
+  std::vector<std::string> libSmiles = {
+      "CCCC",        "CCOC",           "CCNC",      "c1ccccc1",
+      "C1CC1",       "OCC(=O)O",       "c1ccncc1",  "C[C@H](F)Cl",
+      "CCCCCCCCCCC", "c1ccccc1O",      "NCC(=O)O",  "CC(C)C",
+      "O=C1CCCCC1",  "c1ccc2ccccc2c1", "CS(=O)C",   "Brc1ccccc1"};
+  auto fps = boost::make_shared<PatternHolder>(1024);
+  SubstructLibrary lib(boost::make_shared<CachedSmilesMolHolder>(), fps);
+  for (unsigned int i = 0; i < 50; ++i) {
+    for (const auto &smi : libSmiles) {
+      std::unique_ptr<RWMol> mol(SmilesToMol(smi));
+      REQUIRE(mol);
+      lib.addMol(*mol);
+    }
+  }
+  std::vector<std::string> qSmiles = {"CC",       "C(=O)O",     "c1ccccc1",
+                                      "CCCCCC",   "Brc1ccccc1", "S",
+                                      "c1ccccc1[N+](=O)[O-]", "C"};
+  std::vector<std::vector<unsigned int>> expected;
+  for (const auto &smi : qSmiles) {
+    std::unique_ptr<RWMol> query(SmilesToMol(smi));
+    REQUIRE(query);
+    expected.push_back(lib.getMatches(*query, true, true, false, 1));
+  }
+  CHECK(!fps->getUseInvertedIndex());
+  fps->setUseInvertedIndex(true);
+  CHECK(fps->getUseInvertedIndex());
+
+  SECTION("candidates agree with the screen") {
+    for (const auto &smi : qSmiles) {
+      std::unique_ptr<RWMol> query(SmilesToMol(smi));
+      std::unique_ptr<ExplicitBitVect> qfp(fps->makeFingerprint(*query));
+      std::vector<unsigned int> screened;
+      for (unsigned int i = 0; i < fps->size(); ++i) {
+        if (fps->passesFilter(i, *qfp)) {
+          screened.push_back(i);
+        }
+      }
+      CHECK(fps->getCandidates(*qfp) == screened);
+    }
+  }
+  SECTION("matches are unchanged") {
+    for (unsigned int i = 0; i < qSmiles.size(); ++i) {
+      std::unique_ptr<RWMol> query(SmilesToMol(qSmiles[i]));
+      for (auto numThreads : {1, 4}) {
+        CHECK(lib.getMatches(*query, true, true, false, numThreads) ==
+              expected[i]);
+      }
+      auto maxResults = std::min<int>(5, expected[i].size());
+      auto matches =
+          lib.getMatches(*query, true, true, false, 2, maxResults);
+      CHECK(matches == std::vector<unsigned int>(
+                           expected[i].begin(),
+                           expected[i].begin() + maxResults));
+    }
+  }
+  SECTION("search order") {
+    std::vector<unsigned int> order(lib.size());
+    for (unsigned int i = 0; i < order.size(); ++i) {
+      order[i] = order.size() - 1 - i;
+    }
+    lib.setSearchOrder(order);
+    for (unsigned int i = 0; i < qSmiles.size(); ++i) {
+      std::unique_ptr<RWMol> query(SmilesToMol(qSmiles[i]));
+      auto matches = lib.getMatches(*query, true, true, false, 1);
+      std::reverse(matches.begin(), matches.end());
+      CHECK(matches == expected[i]);
+    }
+  }
+  SECTION("the index is updated as molecules are added") {
+    auto query = "Brc1ccccc1"_smiles;
+    auto matches = lib.getMatches(*query);
+    auto mol = "Brc1ccc(Cl)cc1"_smiles;
+    auto idx = lib.addMol(*mol);
+    auto newMatches = lib.getMatches(*query);
+    REQUIRE(newMatches.size() == matches.size() + 1);
+    CHECK(newMatches.back() == idx);
+  }
+  SECTION("mapped fingerprints") {
+    std::string fname = std::tmpnam(nullptr);
+    lib.toMappedFile(fname);
+    {
+      SubstructLibrary mapped;
+      mapped.initFromMappedFile(fname);
+      auto mappedFps = mapped.getFpHolder();
+      mappedFps->setUseInvertedIndex(true);
+      CHECK(mappedFps->getFingerprintNumBits() == 1024);
+      for (unsigned int i = 0; i < qSmiles.size(); ++i) {
+        std::unique_ptr<RWMol> query(SmilesToMol(qSmiles[i]));
+        std::unique_ptr<ExplicitBitVect> qfp(fps->makeFingerprint(*query));
+        CHECK(mappedFps->getCandidates(*qfp) == fps->getCandidates(*qfp));
+        CHECK(mapped.getMatches(*query) == expected[i]);
+      }
+    }
+    std::remove(fname.c_str());
+  }
+}
+
+namespace {
+// a holder which can't produce one of its molecules
+class BrokenMolHolder : public MolHolder {
+ public:
+  explicit BrokenMolHolder(unsigned int brokenIdx) : d_brokenIdx(brokenIdx) {}
+  boost::shared_ptr<ROMol> getMol(unsigned int idx) const override {
+    if (idx == d_brokenIdx) {
+      throw ValueErrorException("broken molecule");
+    }
+    return MolHolder::getMol(idx);
+  }
+  boost::shared_ptr<ROMol> getMolForSearch(unsigned int idx) const override {
+    return getMol(idx);
+  }
+
+ private:
+  unsigned int d_brokenIdx;
+};
+}  // namespace
+
+TEST_CASE("paged match cursors") {
+  std::vector<std::string> libSmiles = {"CCCC", "CCOC", "c1ccccc1", "C1CC1",
+                                        "OCC(=O)O", "CCNC", "c1ccncc1"};
+  SubstructLibrary lib(boost::make_shared<CachedSmilesMolHolder>(),
+                       boost::make_shared<PatternHolder>());
+  // enough molecules for more chunks than the cursor searches ahead
+  for (unsigned int i = 0; i < 1000; ++i) {
+    for (const auto &smi : libSmiles) {
+      std::unique_ptr<RWMol> mol(SmilesToMol(smi));
+      REQUIRE(mol);
+      lib.addMol(*mol);
+    }
+  }
+  auto query = "CO"_smiles;
+  REQUIRE(query);
+  SubstructMatchParameters ps;
+  auto allMatches = lib.getMatches(*query, ps, 1, -1);
+  REQUIRE(allMatches.size() == 2000);
+
+  SECTION("pages") {
+    for (auto numThreads : {1, 4}) {
+      for (auto pageSize : {1u, 7u, 256u, 5000u}) {
+        auto cursor = lib.getMatchCursor(*query, ps, numThreads);
+        std::vector<unsigned int> matches;
+        while (!cursor.done()) {
+          auto page = cursor.next(pageSize);
+          if (!cursor.done()) {
+            CHECK(page.size() == pageSize);
+          }
+          matches.insert(matches.end(), page.begin(), page.end());
+        }
+        CHECK(matches == allMatches);
+        CHECK(cursor.next(pageSize).empty());
+        CHECK(cursor.timeToFirstResult() >= 0.0);
+      }
+    }
+  }
+  SECTION("search order") {
+    std::vector<unsigned int> order(lib.size());
+    for (unsigned int i = 0; i < order.size(); ++i) {
+      order[i] = order.size() - 1 - i;
+    }
+    lib.setSearchOrder(order);
+    auto cursor = lib.getMatchCursor(*query, ps, 2);
+    auto page = cursor.next(10);
+    CHECK(page == lib.getMatches(*query, ps, 1, 10));
+  }
+  SECTION("cancel") {
+    auto cursor = lib.getMatchCursor(*query, ps, 2);
+    CHECK(cursor.next(3).size() == 3);
+    cursor.cancel();
+    CHECK(cursor.done());
+    CHECK(cursor.next(3).empty());
+    // dropping a cursor which is still searching is fine too
+    auto other = lib.getMatchCursor(*query, ps, 2);
+  }
+  SECTION("no matches") {
+    auto noMatch = "[U]"_smiles;
+    auto cursor = lib.getMatchCursor(*noMatch, ps);
+    CHECK(cursor.next(10).empty());
+    CHECK(cursor.done());
+    CHECK(cursor.timeToFirstResult() < 0.0);
+  }
+  SECTION("errors") {
+    // the broken molecule is in the second chunk the cursor searches
+    auto holder = boost::make_shared<BrokenMolHolder>(300);
+    for (unsigned int i = 0; i < 1000; ++i) {
+      holder->addMol(*query);
+    }
+    SubstructLibrary brokenLib(holder);
+    for (auto numThreads : {1, 4}) {
+      auto cursor = brokenLib.getMatchCursor(*query, ps, numThreads);
+      CHECK_THROWS_AS(cursor.next(1000), ValueErrorException);
+      CHECK(cursor.done());
+      CHECK_THROWS_AS(cursor.next(1000), ValueErrorException);
+    }
+  }
+  SECTION("tautomer queries") {
+    auto tautLib = lib;
+    tautLib.getFpHolder().reset();
+    tautLib.resetHolders();
+    auto mol = "c1ccncc1"_smiles;
+    std::unique_ptr<TautomerQuery> tq(TautomerQuery::fromMol(*mol));
+    auto cursor = tautLib.getMatchCursor(*tq, ps, 2);
+    auto expected = tautLib.getMatches(*tq, ps, 1, -1);
+    CHECK(expected.size() == 1000);
+    CHECK(cursor.next(lib.size()) == expected);
+  }
+}
+
+TEST_CASE("molecules for searching") {
+  auto mol = "CCO |SgD:2:PieceName:Foo::::|"_smiles;
+  REQUIRE(mol);
+  REQUIRE(getSubstanceGroups(*mol).size() == 1);
+  auto conf = new Conformer(mol->getNumAtoms());
+  mol->addConformer(conf, true);
+
+  SECTION("cached holders leave out what matching doesn't need") {
+    CachedMolHolder holder;
+    holder.addMol(*mol);
+    auto full = holder.getMol(0);
+    CHECK(full->getNumConformers() == 1);
+    CHECK(getSubstanceGroups(*full).size() == 1);
+    auto forSearch = holder.getMolForSearch(0);
+    CHECK(forSearch->getNumConformers() == 0);
+    CHECK(getSubstanceGroups(*forSearch).empty());
+    CHECK_THROWS_AS(holder.getMolForSearch(1), IndexErrorException);
+  }
+  SECTION("other holders return the full molecule") {
+    MolHolder holder;
+    holder.addMol(*mol);
+    auto forSearch = holder.getMolForSearch(0);
+    CHECK(forSearch->getNumConformers() == 1);
+    CHECK(getSubstanceGroups(*forSearch).size() == 1);
+  }
+  SECTION("search results don't change") {
+    std::vector<std::string> libSmiles = {"CCCC", "CCOC", "CCNC", "c1ccccc1",
+                                          "OCC(=O)O"};
+    SubstructLibrary lib(boost::make_shared<MolHolder>());
+    SubstructLibrary cachedLib(boost::make_shared<CachedMolHolder>());
+    for (const auto &smi : libSmiles) {
+      std::unique_ptr<RWMol> libMol(SmilesToMol(smi));
+      REQUIRE(libMol);
+      lib.addMol(*libMol);
+      cachedLib.addMol(*libMol);
+    }
+    for (const auto &smi : {"CC", "CO", "c1ccccc1", "C(=O)O"}) {
+      std::unique_ptr<RWMol> query(SmilesToMol(smi));
+      REQUIRE(query);
+      CHECK(cachedLib.getMatches(*query) == lib.getMatches(*query));
+      CHECK(cachedLib.countMatches(*query) == lib.countMatches(*query));
+    }
+  }
+}
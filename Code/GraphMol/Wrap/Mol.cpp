@@ -285,6 +285,8 @@ struct mol_wrapper {
         .value("AllProps", RDKit::PicklerOps::AllProps)
         .value("CoordsAsDouble", RDKit::PicklerOps::CoordsAsDouble)
         .value("NoConformers", RDKit::PicklerOps::NoConformers)
+        .value("NoSubstanceGroups", RDKit::PicklerOps::NoSubstanceGroups)
+        .value("CoordsQuantized", RDKit::PicklerOps::CoordsQuantized)
         .export_values();
     ;
 
@@ -296,6 +298,14 @@ struct mol_wrapper {
     python::def("SetDefaultPickleProperties",
                 MolPickler::setDefaultPickleProperties, python::args("arg1"),
                 "Set the current global mol pickler options.");
+    python::def("GetPickleCoordinatePrecision",
+                MolPickler::getCoordinatePrecision,
+                "Get the precision (in Angstrom) of coordinates pickled with "
+                "PropertyPickleOptions.CoordsQuantized.");
+    python::def("SetPickleCoordinatePrecision",
+                MolPickler::setCoordinatePrecision, python::args("precision"),
+                "Set the precision (in Angstrom) of coordinates pickled with "
+                "PropertyPickleOptions.CoordsQuantized.");
 
     // REVIEW: There's probably a better place for this definition
     python::class_<RDKit::SubstructMatchParameters, boost::noncopyable>(
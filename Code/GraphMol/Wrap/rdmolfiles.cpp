@@ -546,6 +546,95 @@ ROMol *MolFromSmartsHelper(python::object ismiles,
   }
 }
 
+namespace {
+std::vector<std::string> pySequenceToStrings(python::object seq) {
+  std::vector<std::string> res;
+  auto n = python::len(seq);
+  res.reserve(n);
+  for (auto i = 0u; i < n; ++i) {
+    res.push_back(pyObjectToString(seq[i]));
+  }
+  return res;
+}
+
+python::object parseResultsToPython(
+    std::vector<v2::SmilesParse::MolParseResult> &results,
+    bool returnErrors) {
+  python::list mols;
+  python::list errors;
+  for (auto &result : results) {
+    if (result.mol) {
+      mols.append(ROMOL_SPTR(result.mol.release()));
+    } else {
+      mols.append(python::object());
+    }
+    errors.append(result.error);
+  }
+  if (returnErrors) {
+    return python::make_tuple(python::tuple(mols), python::tuple(errors));
+  }
+  return python::tuple(mols);
+}
+}  // namespace
+
+python::object MolsFromSmilesHelper(python::object smiles,
+                                    python::object pyParams, int numThreads,
+                                    bool returnErrors) {
+  SmilesParserParams params;
+  if (pyParams) {
+    params = python::extract<SmilesParserParams>(pyParams);
+  }
+  v2::SmilesParse::SmilesParserParams v2ps;
+  v2ps.debugParse = params.debugParse;
+  v2ps.sanitize = params.sanitize;
+  if (params.replacements) {
+    v2ps.replacements = *params.replacements;
+  }
+  v2ps.allowCXSMILES = params.allowCXSMILES;
+  v2ps.strictCXSMILES = params.strictCXSMILES;
+  v2ps.parseName = params.parseName;
+  v2ps.removeHs = params.removeHs;
+  v2ps.skipCleanup = params.skipCleanup;
+  v2ps.useFastParser = params.useFastParser;
+
+  auto strings = pySequenceToStrings(smiles);
+  std::vector<v2::SmilesParse::MolParseResult> results;
+  {
+    std::vector<std::string_view> inputs(strings.begin(), strings.end());
+    NOGIL gil;
+    results = v2::SmilesParse::MolsFromSmiles(inputs, v2ps, numThreads);
+  }
+  return parseResultsToPython(results, returnErrors);
+}
+
+python::object MolsFromSmartsHelper(python::object smarts,
+                                    python::object pyParams, int numThreads,
+                                    bool returnErrors) {
+  SmartsParserParams params;
+  if (pyParams) {
+    params = python::extract<SmartsParserParams>(pyParams);
+  }
+  v2::SmilesParse::SmartsParserParams v2ps;
+  v2ps.debugParse = params.debugParse;
+  if (params.replacements) {
+    v2ps.replacements = *params.replacements;
+  }
+  v2ps.allowCXSMILES = params.allowCXSMILES;
+  v2ps.strictCXSMILES = params.strictCXSMILES;
+  v2ps.parseName = params.parseName;
+  v2ps.mergeHs = params.mergeHs;
+  v2ps.skipCleanup = params.skipCleanup;
+
+  auto strings = pySequenceToStrings(smarts);
+  std::vector<v2::SmilesParse::MolParseResult> results;
+  {
+    std::vector<std::string_view> inputs(strings.begin(), strings.end());
+    NOGIL gil;
+    results = v2::SmilesParse::MolsFromSmarts(inputs, v2ps, numThreads);
+  }
+  return parseResultsToPython(results, returnErrors);
+}
+
 python::list MolToRandomSmilesHelper(const ROMol &mol, unsigned int numSmiles,
                                      unsigned int randomSeed,
                                      bool doIsomericSmiles, bool doKekule,
@@ -1637,6 +1726,10 @@ BOOST_PYTHON_MODULE(rdmolfiles) {
       .def_readwrite("removeHs", &RDKit::SmilesParserParams::removeHs,
                      "controls whether or not Hs are removed before the "
                      "molecule is returned")
+      .def_readwrite("useFastParser",
+                     &RDKit::SmilesParserParams::useFastParser,
+                     "controls whether or not simple SMILES are parsed with "
+                     "the faster hand-written parser")
       .def("__setattr__", &safeSetattr);
   python::class_<RDKit::SmartsParserParams, boost::noncopyable>(
       "SmartsParserParams", "Parameters controlling SMARTS Parsing")
@@ -1764,6 +1857,56 @@ BOOST_PYTHON_MODULE(rdmolfiles) {
               (python::arg("SMARTS"), python::arg("params")), docString.c_str(),
               python::return_value_policy<python::manage_new_object>());
 
+  docString =
+      "Construct molecules from a sequence of SMILES strings.\n\n\
+     ARGUMENTS:\n\
+\n\
+       - SMILES: a sequence of SMILES strings\n\
+\n\
+       - params: (optional) parameters used for every SMILES\n\
+\n\
+       - numThreads: (optional) the number of threads to use. If this is\n\
+         <= 0, it is the number of threads to leave free. Defaults to 1.\n\
+\n\
+       - returnErrors: (optional) also return the error message for each\n\
+         entry (an empty string for entries which were parsed)\n\
+\n\
+     RETURNS:\n\
+\n\
+       a tuple of Mol objects in input order, with None for entries which\n\
+       could not be parsed. If returnErrors is set, a 2-tuple of the\n\
+       molecules and the error messages is returned.\n\
+\n";
+  python::def("MolsFromSmiles", MolsFromSmilesHelper,
+              (python::arg("SMILES"), python::arg("params") = python::object(),
+               python::arg("numThreads") = 1,
+               python::arg("returnErrors") = false),
+              docString.c_str());
+
+  docString =
+      "Construct molecules from a sequence of SMARTS strings.\n\n\
+     ARGUMENTS:\n\
+\n\
+       - SMARTS: a sequence of SMARTS strings\n\
+\n\
+       - params: (optional) parameters used for every SMARTS\n\
+\n\
+       - numThreads: (optional) the number of threads to use. If this is\n\
+         <= 0, it is the number of threads to leave free. Defaults to 1.\n\
+\n\
+       - returnErrors: (optional) also return the error message for each\n\
+         entry (an empty string for entries which were parsed)\n\
+\n\
+     RETURNS:\n\
+\n\
+       see MolsFromSmiles()\n\
+\n";
+  python::def("MolsFromSmarts", MolsFromSmartsHelper,
+              (python::arg("SMARTS"), python::arg("params") = python::object(),
+               python::arg("numThreads") = 1,
+               python::arg("returnErrors") = false),
+              docString.c_str());
+
   python::class_<RDKit::SmilesWriteParams, boost::noncopyable>(
       "SmilesWriteParams", "Parameters controlling SMILES writing")
       .def_readwrite("doIsomericSmiles",
@@ -6192,6 +6192,39 @@ H      0.635000    0.635000    0.635000
     mol = Chem.MolFromSmiles("C1CC", smiles_params)
     self.assertIsNone(mol)
 
+  def testFastSmilesParser(self):
+    ps = Chem.SmilesParserParams()
+    self.assertFalse(ps.useFastParser)
+    ps.useFastParser = True
+    for smi in ('C[C@H](N)C(=O)[O-]', 'c1cc[nH]c1', '[C@TH1](F)(Cl)(Br)I'):
+      self.assertEqual(Chem.MolToSmiles(Chem.MolFromSmiles(smi, ps)),
+                       Chem.MolToSmiles(Chem.MolFromSmiles(smi)))
+    self.assertIsNone(Chem.MolFromSmiles("C1CC", ps))
+
+  def testMolsFromSmiles(self):
+    smis = ['CCO', 'C1CC', 'c1ccccn1 pyridine', 'CN(C)(C)(C)C'] + ['C' * i for i in range(1, 20)]
+    for numThreads in (1, 4):
+      mols = Chem.MolsFromSmiles(smis, numThreads=numThreads)
+      self.assertEqual(len(mols), len(smis))
+      self.assertIsNone(mols[1])
+      self.assertIsNone(mols[3])
+      self.assertEqual(mols[2].GetProp('_Name'), 'pyridine')
+      for smi, mol in zip(smis[4:], mols[4:]):
+        self.assertEqual(Chem.MolToSmiles(mol), smi)
+
+    ps = Chem.SmilesParserParams()
+    ps.sanitize = False
+    mols, errors = Chem.MolsFromSmiles(smis[:4], ps, returnErrors=True)
+    self.assertIsNotNone(mols[3])
+    self.assertEqual(errors[0], '')
+    self.assertIn('unclosed ring', errors[1])
+    self.assertEqual(errors[3], '')
+
+    mols, errors = Chem.MolsFromSmarts(['[#6]-[#8]', '[C'], numThreads=2, returnErrors=True)
+    self.assertEqual(Chem.MolToSmarts(mols[0]), '[#6]-[#8]')
+    self.assertIsNone(mols[1])
+    self.assertNotEqual(errors[1], '')
+
   def testDetectChemistryProblems(self):
     m = Chem.MolFromSmiles('CFCc1cc1FC', sanitize=False)
     ps = Chem.DetectChemistryProblems(m)
@@ -26,7 +26,10 @@
 #include <GraphMol/SmilesParse/CanonicalizeStereoGroups.h>
 #include <GraphMol/CIPLabeler/CIPLabeler.h>
 
+#include <algorithm>
+#include <numeric>
 #include <random>
+#include <set>
 
 using namespace RDKit;
 
@@ -1156,4 +1159,57 @@ TEST_CASE("allow disabling ring stereo in ranking") {
   CHECK(res1[2] == res1[3]);
   CHECK(res1[3] == res1[6]);
   CHECK(res1[6] == res1[7]);
-}
\ No newline at end of file
+}
+TEST_CASE("ranking large symmetric molecules") {
+  auto checkIsPermutation = [](std::vector<unsigned int> ranks) {
+    std::sort(ranks.begin(), ranks.end());
+    for (unsigned int i = 0; i < ranks.size(); ++i) {
+      if (ranks[i] != i) {
+        return false;
+      }
+    }
+    return true;
+  };
+  SECTION("chain") {
+    auto m = v2::SmilesParse::MolFromSmiles(std::string(200, 'C'));
+    REQUIRE(m);
+    std::vector<unsigned int> ranks;
+    Canon::rankMolAtoms(*m, ranks, false);
+    std::set<unsigned int> uniqueRanks(ranks.begin(), ranks.end());
+    CHECK(uniqueRanks.size() == 100);
+    for (unsigned int i = 0; i < 100; ++i) {
+      CHECK(ranks[i] == ranks[199 - i]);
+    }
+    Canon::rankMolAtoms(*m, ranks);
+    CHECK(checkIsPermutation(ranks));
+  }
+  SECTION("ring and fullerene") {
+    std::vector<std::string> smis = {
+        "C1" + std::string(198, 'C') + "C1",
+        "C12=C3C4=C5C6=C1C7=C8C9=C1C%10=C%11C(=C29)C3=C2C3=C4C4=C5C5=C9C6=C7C6="
+        "C7C8=C1C1=C8C%10=C%10C%11=C2C2=C3C3=C4C4=C5C5=C%11C%12=C(C6=C95)C7=C1"
+        "C1=C%12C5=C%11C4=C3C3=C5C(=C81)C%10=C23"};
+    for (const auto &smi : smis) {
+      auto m = v2::SmilesParse::MolFromSmiles(smi);
+      REQUIRE(m);
+      std::vector<unsigned int> ranks;
+      Canon::rankMolAtoms(*m, ranks, false);
+      CHECK(std::count(ranks.begin(), ranks.end(), ranks[0]) ==
+            static_cast<int>(m->getNumAtoms()));
+      Canon::rankMolAtoms(*m, ranks);
+      CHECK(checkIsPermutation(ranks));
+
+      // the canonical SMILES does not depend on the input atom order
+      auto csmi = MolToSmiles(*m);
+      std::vector<unsigned int> newOrder(m->getNumAtoms());
+      std::iota(newOrder.begin(), newOrder.end(), 0);
+      std::mt19937 rng(0xf00d);
+      for (unsigned int iter = 0; iter < 5; ++iter) {
+        std::shuffle(newOrder.begin(), newOrder.end(), rng);
+        std::unique_ptr<ROMol> renumbered(
+            MolOps::renumberAtoms(*m, newOrder));
+        CHECK(MolToSmiles(*renumbered) == csmi);
+      }
+    }
+  }
+}
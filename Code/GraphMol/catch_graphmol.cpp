@@ -23,6 +23,7 @@
 #include <GraphMol/QueryOps.h>
 #include <GraphMol/Chirality.h>
 #include <GraphMol/MonomerInfo.h>
+#include <GraphMol/FrozenMol.h>
 #include <GraphMol/MolPickler.h>
 #include <GraphMol/FileParsers/FileParsers.h>
 #include <GraphMol/FileParsers/SequenceParsers.h>
@@ -4941,3 +4942,89 @@ TEST_CASE("large smiles benchmark") {
   REQUIRE(m);
   CHECK(m->getNumAtoms() == 1000);
 }
+
+TEST_CASE("FrozenMol") {
+  SECTION("basics") {
+    auto mol = "[13CH3]C(=O)[O-].C1CC1c1ccccc1"_smiles;
+    REQUIRE(mol);
+    FrozenMol frozen(*mol);
+    REQUIRE(frozen.getNumAtoms() == mol->getNumAtoms());
+    REQUIRE(frozen.getNumBonds() == mol->getNumBonds());
+    for (const auto atom : mol->atoms()) {
+      auto idx = atom->getIdx();
+      CHECK(frozen.getAtomicNums()[idx] == atom->getAtomicNum());
+      CHECK(frozen.getFormalCharges()[idx] == atom->getFormalCharge());
+      CHECK(frozen.getIsotopes()[idx] == atom->getIsotope());
+      CHECK(frozen.getTotalNumHs()[idx] == atom->getTotalNumHs());
+      CHECK(static_cast<bool>(frozen.getAtomIsAromatic()[idx]) ==
+            atom->getIsAromatic());
+      CHECK(frozen.getAtomNumRings()[idx] ==
+            mol->getRingInfo()->numAtomRings(idx));
+      CHECK(frozen.getAtomMinRingSizes()[idx] ==
+            mol->getRingInfo()->minAtomRingSize(idx));
+      CHECK(frozen.getDegree(idx) == atom->getDegree());
+      std::vector<std::uint32_t> nbrs;
+      std::vector<std::uint32_t> bonds;
+      for (const auto bond : mol->atomBonds(atom)) {
+        nbrs.push_back(bond->getOtherAtomIdx(idx));
+        bonds.push_back(bond->getIdx());
+      }
+      auto frozenNbrs = frozen.getAtomNeighbors(idx);
+      auto frozenBonds = frozen.getAtomBonds(idx);
+      CHECK(std::vector<std::uint32_t>(frozenNbrs.begin(), frozenNbrs.end()) ==
+            nbrs);
+      CHECK(std::vector<std::uint32_t>(frozenBonds.begin(),
+                                       frozenBonds.end()) == bonds);
+    }
+    for (const auto bond : mol->bonds()) {
+      auto idx = bond->getIdx();
+      CHECK(frozen.getBondTypes()[idx] == bond->getBondType());
+      CHECK(frozen.getBondBeginAtoms()[idx] == bond->getBeginAtomIdx());
+      CHECK(frozen.getBondEndAtoms()[idx] == bond->getEndAtomIdx());
+      CHECK(static_cast<bool>(frozen.getBondIsAromatic()[idx]) ==
+            bond->getIsAromatic());
+      CHECK(frozen.getBondNumRings()[idx] ==
+            mol->getRingInfo()->numBondRings(idx));
+    }
+    CHECK(frozen.getNeighborOffsets().size() == mol->getNumAtoms() + 1);
+    CHECK(frozen.getNeighborAtoms().size() == 2 * mol->getNumBonds());
+    CHECK(frozen.getAtomMinRingSizes()[4] == 3);
+  }
+  SECTION("from pickles") {
+    auto mol = "C[C@H](F)/C=C/c1ccc[nH]1"_smiles;
+    REQUIRE(mol);
+    std::string pkl;
+    MolPickler::pickleMol(*mol, pkl);
+    auto frozen = FrozenMol::fromPickle(pkl);
+    FrozenMol expected(*mol);
+    REQUIRE(frozen.getNumAtoms() == expected.getNumAtoms());
+    auto same = [](auto a, auto b) {
+      return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    };
+    CHECK(same(frozen.getAtomicNums(), expected.getAtomicNums()));
+    CHECK(same(frozen.getTotalNumHs(), expected.getTotalNumHs()));
+    CHECK(same(frozen.getChiralTags(), expected.getChiralTags()));
+    CHECK(same(frozen.getAtomNumRings(), expected.getAtomNumRings()));
+    CHECK(same(frozen.getBondTypes(), expected.getBondTypes()));
+    CHECK(same(frozen.getBondStereos(), expected.getBondStereos()));
+    CHECK(same(frozen.getNeighborOffsets(), expected.getNeighborOffsets()));
+    CHECK(same(frozen.getNeighborAtoms(), expected.getNeighborAtoms()));
+    CHECK(same(frozen.getNeighborBonds(), expected.getNeighborBonds()));
+  }
+  SECTION("empty and ringless molecules") {
+    FrozenMol empty;
+    CHECK(empty.getNumAtoms() == 0);
+    CHECK(empty.getNeighborOffsets().size() == 1);
+
+    SmilesParserParams ps;
+    ps.sanitize = false;
+    std::unique_ptr<RWMol> mol(SmilesToMol("CCO", ps));
+    REQUIRE(mol);
+    mol->updatePropertyCache();
+    mol->getRingInfo()->reset();
+    FrozenMol frozen(*mol);
+    CHECK(frozen.getNumAtoms() == 3);
+    CHECK(frozen.getAtomNumRings()[0] == 0);
+    CHECK(frozen.getTotalNumHs()[2] == 1);
+  }
+}
@@ -287,3 +287,179 @@ TEST_CASE("pickling HasPropWithValue queries") {
     }
   }
 }
+
+TEST_CASE("partial decoding of pickles") {
+  auto m = "C/C=C/C[C@H](O)[C@@H](C)F |a:6,o2:4,r,SgD:5:data_pt:4.5::::|"_smiles;
+  REQUIRE(m);
+  m->setProp("molprop", 1);
+  m->getAtomWithIdx(0)->setProp("atomprop", 2);
+  auto conf = new Conformer(m->getNumAtoms());
+  conf->setAtomPos(1, RDGeom::Point3D(1.0, 2.0, 3.0));
+  m->addConformer(conf, true);
+  std::string pkl;
+  MolPickler::pickleMol(*m, pkl, PicklerOps::AllProps);
+
+  SECTION("everything") {
+    RWMol m2;
+    MolPickler::molFromPickle(pkl, m2, PicklerOps::AllProps);
+    CHECK(getSubstanceGroups(m2).size() == 1);
+    CHECK(m2.getNumConformers() == 1);
+    CHECK(m2.hasProp("molprop"));
+    CHECK(MolToCXSmiles(*m) == MolToCXSmiles(m2));
+  }
+  SECTION("just the graph") {
+    RWMol m2;
+    MolPickler::molFromPickle(pkl, m2,
+                              PicklerOps::AtomProps | PicklerOps::NoConformers |
+                                  PicklerOps::NoSubstanceGroups);
+    CHECK(m2.getNumAtoms() == m->getNumAtoms());
+    CHECK(getSubstanceGroups(m2).empty());
+    CHECK(m2.getNumConformers() == 0);
+    CHECK(!m2.hasProp("molprop"));
+    CHECK(m2.getAtomWithIdx(0)->getProp<int>("atomprop") == 2);
+    // the stereo groups are still there
+    CHECK(m2.getStereoGroups().size() == 2);
+    CHECK(MolToSmiles(*m) == MolToSmiles(m2));
+  }
+  SECTION("pickles without SubstanceGroups") {
+    std::string pkl2;
+    MolPickler::pickleMol(*m, pkl2, PicklerOps::NoSubstanceGroups);
+    CHECK(pkl2.size() < pkl.size());
+    RWMol m2(pkl2);
+    CHECK(getSubstanceGroups(m2).empty());
+    CHECK(m2.getNumConformers() == 1);
+  }
+  SECTION("from a stream") {
+    std::stringstream ss(pkl);
+    RWMol m2;
+    MolPickler::molFromPickle(ss, m2, PicklerOps::NoSubstanceGroups);
+    CHECK(getSubstanceGroups(m2).empty());
+    CHECK(m2.getNumConformers() == 1);
+  }
+  SECTION("old pickles") {
+    std::string pklName = getenv("RDBASE");
+    pklName += "/Code/GraphMol/test_data/mol_with_sgroups_and_stereo.pkl";
+    std::ifstream inStream(pklName.c_str(), std::ios_base::binary);
+    RWMol m2;
+    MolPickler::molFromPickle(inStream, m2, PicklerOps::NoSubstanceGroups);
+    CHECK(m2.getNumAtoms() == m->getNumAtoms());
+    CHECK(getSubstanceGroups(m2).empty());
+    CHECK(m2.getStereoGroups().size() == 2);
+  }
+  SECTION("truncated pickles") {
+    for (auto len : {pkl.size() / 2, pkl.size() - 5}) {
+      RWMol m2;
+      CHECK_THROWS_AS(MolPickler::molFromPickle(pkl.substr(0, len), m2,
+                                                PicklerOps::NoConformers |
+                                                    PicklerOps::NoSubstanceGroups),
+                      MolPicklerException);
+    }
+  }
+}
+
+TEST_CASE("quantized conformers") {
+  auto m = "CCOc1ccc(cc1)C(=O)N"_smiles;
+  REQUIRE(m);
+  const unsigned int nConfs = 10;
+  for (unsigned int i = 0; i < nConfs; ++i) {
+    auto conf = new Conformer(m->getNumAtoms());
+    for (unsigned int j = 0; j < m->getNumAtoms(); ++j) {
+      conf->setAtomPos(j, RDGeom::Point3D(1.5 * j + 0.123456 * i,
+                                          std::sin(0.7 * j + i) * 3.0,
+                                          -2.0 + std::cos(1.3 * j * i)));
+    }
+    conf->setProp("confnum", i);
+    m->addConformer(conf, true);
+  }
+  const auto flags = PicklerOps::CoordsQuantized | PicklerOps::MolProps;
+  std::string pkl;
+  MolPickler::pickleMol(*m, pkl, flags);
+  auto checkConformer = [&](const Conformer &conf, unsigned int which,
+                            double tol) {
+    const auto &ref = m->getConformer(which);
+    CHECK(conf.getId() == ref.getId());
+    CHECK(conf.getProp<unsigned int>("confnum") == which);
+    REQUIRE(conf.getNumAtoms() == ref.getNumAtoms());
+    for (unsigned int j = 0; j < ref.getNumAtoms(); ++j) {
+      CHECK((conf.getAtomPos(j) - ref.getAtomPos(j)).length() < tol);
+    }
+  };
+
+  SECTION("round trip") {
+    RWMol m2;
+    MolPickler::molFromPickle(pkl, m2);
+    REQUIRE(m2.getNumConformers() == nConfs);
+    // the rounding error for each coordinate is at most half the precision
+    const auto tol = std::sqrt(3.0) * 0.0005 + 1e-9;
+    for (unsigned int i = 0; i < nConfs; ++i) {
+      checkConformer(m2.getConformer(i), i, tol);
+    }
+    CHECK(MolToSmiles(m2) == MolToSmiles(*m));
+  }
+  SECTION("size") {
+    std::string floatPkl;
+    MolPickler::pickleMol(*m, floatPkl, PicklerOps::MolProps);
+    CHECK(pkl.size() < floatPkl.size());
+
+    MolPickler::setCoordinatePrecision(0.01);
+    std::string coarsePkl;
+    MolPickler::pickleMol(*m, coarsePkl, flags);
+    MolPickler::setCoordinatePrecision(0.001);
+    CHECK(coarsePkl.size() < pkl.size());
+    RWMol m2;
+    MolPickler::molFromPickle(coarsePkl, m2);
+    REQUIRE(m2.getNumConformers() == nConfs);
+    checkConformer(m2.getConformer(3), 3, std::sqrt(3.0) * 0.005 + 1e-9);
+  }
+  SECTION("single conformers") {
+    for (auto which : {0u, 4u, nConfs - 1}) {
+      auto conf = MolPickler::conformerFromPickle(pkl, which);
+      REQUIRE(conf);
+      CHECK(!conf->hasOwningMol());
+      checkConformer(*conf, which, 0.001);
+    }
+    CHECK_THROWS_AS(MolPickler::conformerFromPickle(pkl, nConfs),
+                    IndexErrorException);
+
+    // this also works with the other coordinate formats
+    std::string doublePkl;
+    MolPickler::pickleMol(*m, doublePkl,
+                          PicklerOps::CoordsAsDouble | PicklerOps::MolProps);
+    auto conf = MolPickler::conformerFromPickle(doublePkl, 7);
+    checkConformer(*conf, 7, 1e-12);
+  }
+  SECTION("several conformers") {
+    const std::vector<unsigned int> which = {7, 2, nConfs - 1, 2};
+    auto confs = MolPickler::conformersFromPickle(pkl, which);
+    REQUIRE(confs.size() == which.size());
+    for (unsigned int i = 0; i < which.size(); ++i) {
+      REQUIRE(confs[i]);
+      CHECK(!confs[i]->hasOwningMol());
+      checkConformer(*confs[i], which[i], 0.001);
+    }
+    CHECK(confs[1].get() != confs[3].get());
+    CHECK(MolPickler::conformersFromPickle(pkl, {}).empty());
+    CHECK_THROWS_AS(MolPickler::conformersFromPickle(pkl, {1, nConfs}),
+                    IndexErrorException);
+  }
+  SECTION("skipping the conformers") {
+    RWMol m2;
+    MolPickler::molFromPickle(pkl, m2, PicklerOps::NoConformers);
+    CHECK(m2.getNumConformers() == 0);
+    CHECK(m2.getNumAtoms() == m->getNumAtoms());
+  }
+  SECTION("bad input") {
+    RWMol m2;
+    CHECK_THROWS_AS(
+        MolPickler::molFromPickle(pkl.substr(0, pkl.size() / 2), m2),
+        MolPicklerException);
+
+    auto m3 = "C"_smiles;
+    auto conf = new Conformer(1);
+    conf->setAtomPos(0, RDGeom::Point3D(1e20, 0, 0));
+    m3->addConformer(conf);
+    std::string tmp;
+    CHECK_THROWS_AS(MolPickler::pickleMol(*m3, tmp, PicklerOps::CoordsQuantized),
+                    MolPicklerException);
+  }
+}
@@ -260,6 +260,7 @@ void rankWithFunctor(T &ftor, bool breakTies, int *order, bool useSpecial,
   memset(changed.get(), 1, nAts * sizeof(int));
   auto touched = std::make_unique<char[]>(nAts);
   memset(touched.get(), 0, nAts * sizeof(char));
+  std::vector<int> touchedList;
   int activeset;
   CreateSinglePartition(nAts, order, count.get(), atoms);
 // ActivatePartitions(nAts,order,count,activeset,next,changed);
@@ -282,7 +283,7 @@ void rankWithFunctor(T &ftor, bool breakTies, int *order, bool useSpecial,
   }
 #endif
   RefinePartitions(mol, atoms, ftor, true, order, count.get(), activeset,
-                   next.get(), changed.get(), touched.get());
+                   next.get(), changed.get(), touched.get(), touchedList);
 #ifdef VERBOSE_CANON
   std::cerr << "2--------" << std::endl;
   for (unsigned int i = 0; i < mol.getNumAtoms(); ++i) {
@@ -302,7 +303,7 @@ void rankWithFunctor(T &ftor, bool breakTies, int *order, bool useSpecial,
     ActivatePartitions(nAts, order, count.get(), activeset, next.get(),
                        changed.get());
     RefinePartitions(mol, atoms, scftor, true, order, count.get(), activeset,
-                     next.get(), changed.get(), touched.get());
+                     next.get(), changed.get(), touched.get(), touchedList);
 #ifdef VERBOSE_CANON
     std::cerr << "2a--------" << std::endl;
     for (unsigned int i = 0; i < mol.getNumAtoms(); ++i) {
@@ -340,7 +341,7 @@ void rankWithFunctor(T &ftor, bool breakTies, int *order, bool useSpecial,
     ActivatePartitions(nAts, order, count.get(), activeset, next.get(),
                        changed.get());
     RefinePartitions(mol, atoms, sftor, true, order, count.get(), activeset,
-                     next.get(), changed.get(), touched.get());
+                     next.get(), changed.get(), touched.get(), touchedList);
 #ifdef VERBOSE_CANON
     std::cerr << "2b--------" << std::endl;
     for (unsigned int i = 0; i < mol.getNumAtoms(); ++i) {
@@ -368,7 +369,7 @@ bool hasRingNbr(const ROMol &mol, const Atom *at) {
   for (const auto nbr : mol.atomNeighbors(at)) {
     if ((nbr->getChiralTag() == Atom::CHI_TETRAHEDRAL_CW ||
          nbr->getChiralTag() == Atom::CHI_TETRAHEDRAL_CCW) &&
-        nbr->hasProp(common_properties::_ringStereoAtoms)) {
+        nbr->hasProp(common_properties::keys::_ringStereoAtoms)) {
       return true;
     }
   }
@@ -556,7 +557,7 @@ void advancedInitCanonAtom(const ROMol &mol, Canon::canon_atom &atom,
   atom.isRingStereoAtom =
       (atom.atom->getChiralTag() == Atom::CHI_TETRAHEDRAL_CW ||
        atom.atom->getChiralTag() == Atom::CHI_TETRAHEDRAL_CCW) &&
-      atom.atom->hasProp(common_properties::_ringStereoAtoms);
+      atom.atom->hasProp(common_properties::keys::_ringStereoAtoms);
   atom.hasRingNbr = hasRingNbr(mol, atom.atom);
 }
 }  // end anonymous namespace
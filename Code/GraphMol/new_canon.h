@@ -21,6 +21,7 @@
 #include <cstring>
 #include <cassert>
 #include <cstring>
+#include <algorithm>
 #include <vector>
 
 // #define VERBOSE_CANON 1
@@ -331,13 +332,13 @@ class RDKIT_GRAPHMOL_EXPORT AtomCompareFunctor {
       int molAtomMapNumber_j = 0;
       if (df_useAtomMaps ||
           (df_useAtomMapsOnDummies && dp_atoms[i].atom->getAtomicNum() == 0)) {
-        dp_atoms[i].atom->getPropIfPresent(common_properties::molAtomMapNumber,
-                                           molAtomMapNumber_i);
+        dp_atoms[i].atom->getPropIfPresent(
+            common_properties::keys::molAtomMapNumber, molAtomMapNumber_i);
       }
       if (df_useAtomMaps ||
           (df_useAtomMapsOnDummies && dp_atoms[j].atom->getAtomicNum() == 0)) {
-        dp_atoms[j].atom->getPropIfPresent(common_properties::molAtomMapNumber,
-                                           molAtomMapNumber_j);
+        dp_atoms[j].atom->getPropIfPresent(
+            common_properties::keys::molAtomMapNumber, molAtomMapNumber_j);
       }
       if (molAtomMapNumber_i < molAtomMapNumber_j) {
         return -1;
@@ -618,11 +619,11 @@ class RDKIT_GRAPHMOL_EXPORT ChiralAtomCompareFunctor {
     ivi = 0;
     ivj = 0;
     std::string cipCode;
-    if (dp_atoms[i].atom->getPropIfPresent(common_properties::_CIPCode,
+    if (dp_atoms[i].atom->getPropIfPresent(common_properties::keys::_CIPCode,
                                            cipCode)) {
       ivi = cipCode == "R" ? 2 : 1;
     }
-    if (dp_atoms[j].atom->getPropIfPresent(common_properties::_CIPCode,
+    if (dp_atoms[j].atom->getPropIfPresent(common_properties::keys::_CIPCode,
                                            cipCode)) {
       ivj = cipCode == "R" ? 2 : 1;
     }
@@ -687,15 +688,74 @@ class RDKIT_GRAPHMOL_EXPORT ChiralAtomCompareFunctor {
   }
 };
 
+namespace detail {
+//! marks the partitions holding the neighbors of \c atom as touched.
+/*!
+  Newly touched partitions are also added to \c touchedList so that
+  activateTouchedPartitions() only needs to look at those partitions
+  instead of scanning every partition after each split.
+*/
+inline void touchNeighborPartitions(const canon_atom &atom,
+                                    const canon_atom *atoms,
+                                    char *touchedPartitions,
+                                    std::vector<int> &touchedList) {
+  for (unsigned j = 0; j < atom.degree; ++j) {
+    int nbrPart = atoms[atom.nbrIds[j]].index;
+    if (!touchedPartitions[nbrPart]) {
+      touchedPartitions[nbrPart] = 1;
+      touchedList.push_back(nbrPart);
+    }
+  }
+}
+
+//! adds the touched partitions which can still be split to the active set
+/*!
+  The partitions are pushed in order of increasing index, which is the
+  order the full scan over all partitions used, so the refinement (and the
+  resulting ranks) do not depend on the order the partitions were touched.
+*/
+inline void activateTouchedPartitions(unsigned int nAtoms, const int *order,
+                                      const int *count, int &activeset,
+                                      int *next, char *touchedPartitions,
+                                      std::vector<int> &touchedList) {
+  if (touchedList.size() * 8 > nAtoms) {
+    // most partitions were touched, scanning them all is cheaper than sorting
+    touchedList.clear();
+    for (unsigned int ii = 0; ii < nAtoms; ++ii) {
+      if (touchedPartitions[ii]) {
+        touchedList.push_back(ii);
+      }
+    }
+  } else {
+    std::sort(touchedList.begin(), touchedList.end());
+  }
+  for (auto ii : touchedList) {
+    int partition = order[ii];
+    if ((count[partition] > 1) && (next[partition] == -2)) {
+      next[partition] = activeset;
+      activeset = partition;
+    }
+    touchedPartitions[ii] = 0;
+  }
+  touchedList.clear();
+}
+}  // namespace detail
+
 /*
  * Basic canonicalization function to organize the partitions which will be
  * sorted next.
+ *
+ * Only the partitions touched by the previous split are put back on the
+ * active set (refinement by splitter), so the work done per split is
+ * proportional to the size of the split partition and its neighborhood
+ * rather than to the size of the molecule.
  * */
 
 template <typename CompareFunc>
 void RefinePartitions(const ROMol &mol, canon_atom *atoms, CompareFunc compar,
                       int mode, int *order, int *count, int &activeset,
-                      int *next, int *changed, char *touchedPartitions) {
+                      int *next, int *changed, char *touchedPartitions,
+                      std::vector<int> &touchedList) {
   unsigned int nAtoms = mol.getNumAtoms();
   int partition;
   int symclass = 0;
@@ -770,30 +830,31 @@ void RefinePartitions(const ROMol &mol, canon_atom *atoms, CompareFunc compar,
       index = start[0];
       for (i = count[index]; i < len; i++) {
         index = start[i];
-        for (unsigned j = 0; j < atoms[index].degree; ++j) {
-          unsigned int nbor = atoms[index].nbrIds[j];
-          touchedPartitions[atoms[nbor].index] = 1;
-        }
-      }
-      for (unsigned int ii = 0; ii < nAtoms; ++ii) {
-        if (touchedPartitions[ii]) {
-          partition = order[ii];
-          if ((count[partition] > 1) && (next[partition] == -2)) {
-            next[partition] = activeset;
-            activeset = partition;
-          }
-          touchedPartitions[ii] = 0;
-        }
+        detail::touchNeighborPartitions(atoms[index], atoms, touchedPartitions,
+                                        touchedList);
       }
+      detail::activateTouchedPartitions(nAtoms, order, count, activeset, next,
+                                        touchedPartitions, touchedList);
     }
   }
 }  // end of RefinePartitions()
 
+template <typename CompareFunc>
+void RefinePartitions(const ROMol &mol, canon_atom *atoms, CompareFunc compar,
+                      int mode, int *order, int *count, int &activeset,
+                      int *next, int *changed, char *touchedPartitions) {
+  std::vector<int> touchedList;
+  RefinePartitions(mol, atoms, compar, mode, order, count, activeset, next,
+                   changed, touchedPartitions, touchedList);
+}
+
 template <typename CompareFunc>
 void BreakTies(const ROMol &mol, canon_atom *atoms, CompareFunc compar,
                int mode, int *order, int *count, int &activeset, int *next,
                int *changed, char *touchedPartitions) {
   unsigned int nAtoms = mol.getNumAtoms();
+  // shared by all the refinements below
+  std::vector<int> touchedList;
   int partition;
   int offset;
   int index;
@@ -816,23 +877,14 @@ void BreakTies(const ROMol &mol, canon_atom *atoms, CompareFunc compar,
         continue;
       }
       for (unsigned j = 0; j < atoms[index].degree; ++j) {
-        unsigned int nbor = atoms[index].nbrIds[j];
-        touchedPartitions[atoms[nbor].index] = 1;
-        changed[nbor] = 1;
-      }
-
-      for (unsigned int ii = 0; ii < nAtoms; ++ii) {
-        if (touchedPartitions[ii]) {
-          int npart = order[ii];
-          if ((count[npart] > 1) && (next[npart] == -2)) {
-            next[npart] = activeset;
-            activeset = npart;
-          }
-          touchedPartitions[ii] = 0;
-        }
+        changed[atoms[index].nbrIds[j]] = 1;
       }
+      detail::touchNeighborPartitions(atoms[index], atoms, touchedPartitions,
+                                      touchedList);
+      detail::activateTouchedPartitions(nAtoms, order, count, activeset, next,
+                                        touchedPartitions, touchedList);
       RefinePartitions(mol, atoms, compar, mode, order, count, activeset, next,
-                       changed, touchedPartitions);
+                       changed, touchedPartitions, touchedList);
     }
     // not sure if this works each time
     if (atoms[partition].index != oldPart) {
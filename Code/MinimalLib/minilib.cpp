@@ -783,7 +783,7 @@ std::string JSSubstructLibrary::get_pattern_fp(unsigned int i) const {
   if (!d_fpHolder) {
     throw ValueErrorException(NO_SUPPORT_FOR_PATTERN_FPS);
   }
-  return d_fpHolder->getFingerprints().at(i)->toString();
+  return d_fpHolder->getFingerprint(i).toString();
 }
 
 inline int JSSubstructLibrary::add_mol_helper(const ROMol &mol) {
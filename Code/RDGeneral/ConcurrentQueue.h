@@ -12,6 +12,7 @@
 #define CONCURRENT_QUEUE
 #include <condition_variable>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace RDKit {
@@ -40,6 +41,8 @@ class ConcurrentQueue {
   //! modifying the variable element, if the queue is full then pushing an
   //! element will result in blocking
   void push(const E &element);
+  //! \overload
+  void push(E &&element);
 
   //! tries to pop an element from the queue if it is not empty and not done
   //! the boolean value indicates the whether popping is successful, if the
@@ -62,6 +65,11 @@ class ConcurrentQueue {
 
 template <typename E>
 void ConcurrentQueue<E>::push(const E &element) {
+  push(E(element));
+}
+
+template <typename E>
+void ConcurrentQueue<E>::push(E &&element) {
   std::unique_lock<std::mutex> lk(d_lock);
   //! concurrent queue is full so we wait until
   //! it is not full
@@ -70,7 +78,7 @@ void ConcurrentQueue<E>::push(const E &element) {
     d_notFull.wait(lk);
   }
   bool wasEmpty = (d_head == d_tail);
-  d_elements.at(d_tail % d_capacity) = element;
+  d_elements.at(d_tail % d_capacity) = std::move(element);
   d_tail++;
   //! if the concurrent queue was empty before
   //! then it is not any more since we have "pushed" an element
@@ -92,7 +100,7 @@ bool ConcurrentQueue<E>::pop(E &element) {
     d_notEmpty.wait(lk);
   }
   bool wasFull = (d_head + d_capacity == d_tail);
-  element = d_elements.at(d_head % d_capacity);
+  element = std::move(d_elements.at(d_head % d_capacity));
   d_head++;
   //! if the concurrent queue was full before
   //! then it is not any more since we have "popped" an element
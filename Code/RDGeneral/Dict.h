@@ -16,35 +16,57 @@
 #ifndef RD_DICT_H_012020
 #define RD_DICT_H_012020
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <string_view>
 #include <vector>
 #include "RDValue.h"
 #include "Exceptions.h"
+#include "PropKey.h"
 #include <RDGeneral/BoostStartInclude.h>
 #include <boost/lexical_cast.hpp>
 #include <RDGeneral/BoostEndInclude.h>
 
+#ifdef _MSC_VER
+#define RDK_DICT_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define RDK_DICT_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
 namespace RDKit {
 typedef std::vector<std::string> STR_VECT;
 
 //! \brief The \c Dict class can be used to store objects of arbitrary
 //!        type keyed by \c strings.
 //!
-//!  The actual storage is done using \c RDValue objects.
+//!  The actual storage is done using \c RDValue objects. All of the lookup
+//!  functions also accept a \c PropKey: entries whose names are interned
+//!  (because they were set with a PropKey or are one of the common
+//!  properties) are found by comparing ids instead of names.
 //!
 class RDKIT_RDGENERAL_EXPORT Dict {
  public:
   struct Pair {
     std::string key;
-    RDValue val;
+    // keyId goes in the padding at the end of the RDValue, so it doesn't
+    // make the Pair any bigger
+    RDK_DICT_NO_UNIQUE_ADDRESS RDValue val;
+    //! PropKey::id() of the key if it is interned, zero otherwise
+    std::uint32_t keyId{0};
 
     Pair() : key(), val() {}
-    explicit Pair(std::string s) : key(std::move(s)), val() {}
-    explicit Pair(std::string_view s) : key(std::string(s)), val() {}
-    Pair(std::string s, const RDValue &v) : key(std::move(s)), val(v) {}
-    Pair(std::string_view s, const RDValue &v) : key(std::string(s)), val(v) {}
+    explicit Pair(std::string s)
+        : key(std::move(s)), val(), keyId(PropKey::getCommonId(key)) {}
+    explicit Pair(std::string_view s)
+        : key(std::string(s)), val(), keyId(PropKey::getCommonId(s)) {}
+    explicit Pair(const PropKey &k) : key(k.str()), val(), keyId(k.id()) {}
+    Pair(std::string s, const RDValue &v)
+        : key(std::move(s)), val(v), keyId(PropKey::getCommonId(key)) {}
+    Pair(std::string_view s, const RDValue &v)
+        : key(std::string(s)), val(v), keyId(PropKey::getCommonId(s)) {}
+    Pair(const PropKey &k, const RDValue &v)
+        : key(k.str()), val(v), keyId(k.id()) {}
     // In the case you are holding onto an rdvalue outside of a dictionary
     //  or other container, you kust call cleanup to release non POD memory.
     void cleanup() { RDValue::cleanup_rdvalue(val); }
@@ -61,6 +83,7 @@ class RDKIT_RDGENERAL_EXPORT Dict {
       _data.swap(data);
       for (size_t i = 0; i < _data.size(); ++i) {
         _data[i].key = other._data[i].key;
+        _data[i].keyId = other._data[i].keyId;
         copy_rdvalue(_data[i].val, other._data[i].val);
       }
     }
@@ -91,6 +114,7 @@ class RDKIT_RDGENERAL_EXPORT Dict {
         if (!target) {
           // need to create blank entry and copy
           _data.push_back(Pair(opair.key));
+          _data.back().keyId = opair.keyId;
           copy_rdvalue(_data.back().val, opair.val);
         } else {
           // just copy
@@ -113,6 +137,7 @@ class RDKIT_RDGENERAL_EXPORT Dict {
       _data.swap(data);
       for (size_t i = 0; i < _data.size(); ++i) {
         _data[i].key = other._data[i].key;
+        _data[i].keyId = other._data[i].keyId;
         copy_rdvalue(_data[i].val, other._data[i].val);
       }
     } else {
@@ -150,13 +175,10 @@ class RDKIT_RDGENERAL_EXPORT Dict {
   //! \brief Returns whether or not the dictionary contains a particular
   //!        key.
   bool hasVal(const std::string_view what) const {
-    for (const auto &data : _data) {
-      if (data.key == what) {
-        return true;
-      }
-    }
-    return false;
+    return findPair(what) != nullptr;
   }
+  //! \overload
+  bool hasVal(const PropKey &what) const { return findPair(what) != nullptr; }
 
   //----------------------------------------------------------
   //! Returns the set of keys in the dictionary
@@ -189,27 +211,30 @@ class RDKIT_RDGENERAL_EXPORT Dict {
   void getVal(const std::string_view what, T &res) const {
     res = getVal<T>(what);
   }
+  //! \overload
+  template <typename T>
+  void getVal(const PropKey &what, T &res) const {
+    res = getVal<T>(what);
+  }
 
   //! \overload
   template <typename T>
   T getVal(const std::string_view what) const {
-    for (auto &data : _data) {
-      if (data.key == what) {
-        return from_rdvalue<T>(data.val);
-      }
-    }
-    throw KeyErrorException(what);
+    return from_rdvalue<T>(getPair(what).val);
+  }
+  //! \overload
+  template <typename T>
+  T getVal(const PropKey &what) const {
+    return from_rdvalue<T>(getPair(what).val);
   }
 
   //! \overload
   void getVal(const std::string_view what, std::string &res) const {
-    for (const auto &i : _data) {
-      if (i.key == what) {
-        rdvalue_tostring(i.val, res);
-        return;
-      }
-    }
-    throw KeyErrorException(what);
+    rdvalue_tostring(getPair(what).val, res);
+  }
+  //! \overload
+  void getVal(const PropKey &what, std::string &res) const {
+    rdvalue_tostring(getPair(what).val, res);
   }
 
   //----------------------------------------------------------
@@ -228,24 +253,21 @@ class RDKIT_RDGENERAL_EXPORT Dict {
   */
   template <typename T>
   bool getValIfPresent(const std::string_view what, T &res) const {
-    for (const auto &data : _data) {
-      if (data.key == what) {
-        res = from_rdvalue<T>(data.val);
-        return true;
-      }
-    }
-    return false;
+    return getValIfPresentImpl(what, res);
+  }
+  //! \overload
+  template <typename T>
+  bool getValIfPresent(const PropKey &what, T &res) const {
+    return getValIfPresentImpl(what, res);
   }
 
   //! \overload
   bool getValIfPresent(const std::string_view what, std::string &res) const {
-    for (const auto &i : _data) {
-      if (i.key == what) {
-        rdvalue_tostring(i.val, res);
-        return true;
-      }
-    }
-    return false;
+    return getValIfPresentImpl(what, res);
+  }
+  //! \overload
+  bool getValIfPresent(const PropKey &what, std::string &res) const {
+    return getValIfPresentImpl(what, res);
   }
 
   //----------------------------------------------------------
@@ -266,14 +288,15 @@ class RDKIT_RDGENERAL_EXPORT Dict {
     static_assert(!std::is_same_v<T, std::string_view>,
                   "T cannot be string_view");
     _hasNonPodData = true;
-    for (auto &&data : _data) {
-      if (data.key == what) {
-        RDValue::cleanup_rdvalue(data.val);
-        data.val = val;
-        return;
-      }
-    }
-    _data.push_back(Pair(what, val));
+    setValImpl(what, val);
+  }
+  //! \overload
+  template <typename T>
+  void setVal(const PropKey &what, T &val) {
+    static_assert(!std::is_same_v<T, std::string_view>,
+                  "T cannot be string_view");
+    _hasNonPodData = true;
+    setValImpl(what, val);
   }
 
   template <typename T>
@@ -281,33 +304,43 @@ class RDKIT_RDGENERAL_EXPORT Dict {
     static_assert(!std::is_same_v<T, std::string_view>,
                   "T cannot be string_view");
     // don't change the hasNonPodData status
-    for (auto &&data : _data) {
-      if (data.key == what) {
-        RDValue::cleanup_rdvalue(data.val);
-        data.val = val;
-        return;
-      }
-    }
-    _data.push_back(Pair(what, val));
+    setValImpl(what, val);
+  }
+  template <typename T>
+  void setPODVal(const PropKey &what, T val) {
+    static_assert(!std::is_same_v<T, std::string_view>,
+                  "T cannot be string_view");
+    // don't change the hasNonPodData status
+    setValImpl(what, val);
   }
 
   void setVal(const std::string_view what, bool val) { setPODVal(what, val); }
+  void setVal(const PropKey &what, bool val) { setPODVal(what, val); }
 
   void setVal(const std::string_view what, double val) { setPODVal(what, val); }
+  void setVal(const PropKey &what, double val) { setPODVal(what, val); }
 
   void setVal(const std::string_view what, float val) { setPODVal(what, val); }
+  void setVal(const PropKey &what, float val) { setPODVal(what, val); }
 
   void setVal(const std::string_view what, int val) { setPODVal(what, val); }
+  void setVal(const PropKey &what, int val) { setPODVal(what, val); }
 
   void setVal(const std::string_view what, unsigned int val) {
     setPODVal(what, val);
   }
+  void setVal(const PropKey &what, unsigned int val) { setPODVal(what, val); }
 
   //! \overload
   void setVal(const std::string_view what, const char *val) {
     std::string h(val);
     setVal(what, h);
   }
+  //! \overload
+  void setVal(const PropKey &what, const char *val) {
+    std::string h(val);
+    setVal(what, h);
+  }
 
   //----------------------------------------------------------
   //! \brief Clears the value associated with a particular key,
@@ -317,17 +350,9 @@ class RDKIT_RDGENERAL_EXPORT Dict {
      \param what the key to clear
 
   */
-  void clearVal(const std::string_view what) {
-    for (DataType::iterator it = _data.begin(); it < _data.end(); ++it) {
-      if (it->key == what) {
-        if (_hasNonPodData) {
-          RDValue::cleanup_rdvalue(it->val);
-        }
-        _data.erase(it);
-        return;
-      }
-    }
-  }
+  void clearVal(const std::string_view what) { clearValImpl(what); }
+  //! \overload
+  void clearVal(const PropKey &what) { clearValImpl(what); }
 
   //----------------------------------------------------------
   //! \brief Clears all keys (and values) from the dictionary.
@@ -343,6 +368,89 @@ class RDKIT_RDGENERAL_EXPORT Dict {
   }
 
  private:
+  // the lookups are shared by the std::string_view and the PropKey versions
+  // of the public functions
+  static bool matches(const Pair &pair, std::string_view what) {
+    return pair.key == what;
+  }
+  // interned names are unique, so if the pair has one there's no need to
+  // look at the name
+  static bool matches(const Pair &pair, const PropKey &what) {
+    return pair.keyId ? pair.keyId == what.id() : pair.key == what.str();
+  }
+
+  template <typename K>
+  const Pair *findPair(const K &what) const {
+    for (const auto &data : _data) {
+      if (matches(data, what)) {
+        return &data;
+      }
+    }
+    return nullptr;
+  }
+  const Pair *findPair(const PropKey &what) const {
+    const auto id = what.id();
+    for (const auto &data : _data) {
+      if (data.keyId ? data.keyId == id : data.key == what.str()) {
+        return &data;
+      }
+    }
+    return nullptr;
+  }
+
+  template <typename K>
+  const Pair &getPair(const K &what) const {
+    if (const auto pair = findPair(what)) {
+      return *pair;
+    }
+    throw KeyErrorException(keyName(what));
+  }
+  static std::string_view keyName(std::string_view what) { return what; }
+  static std::string_view keyName(const PropKey &what) { return what.str(); }
+
+  template <typename K, typename T>
+  bool getValIfPresentImpl(const K &what, T &res) const {
+    if (const auto pair = findPair(what)) {
+      res = from_rdvalue<T>(pair->val);
+      return true;
+    }
+    return false;
+  }
+
+  template <typename K>
+  bool getValIfPresentImpl(const K &what, std::string &res) const {
+    if (const auto pair = findPair(what)) {
+      rdvalue_tostring(pair->val, res);
+      return true;
+    }
+    return false;
+  }
+
+  template <typename K, typename T>
+  void setValImpl(const K &what, T &val) {
+    for (auto &&data : _data) {
+      if (matches(data, what)) {
+        RDValue::cleanup_rdvalue(data.val);
+        data.val = val;
+        return;
+      }
+    }
+    _data.push_back(Pair(what, val));
+  }
+
+  template <typename K>
+  void clearValImpl(const K &what) {
+    for (DataType::iterator it = _data.begin(); it < _data.end(); ++it) {
+      if (matches(*it, what)) {
+        if (_hasNonPodData) {
+          RDValue::cleanup_rdvalue(it->val);
+        }
+        _data.erase(it);
+        return;
+      }
+    }
+  }
+
   DataType _data{};            //!< the actual dictionary
   bool _hasNonPodData{false};  // if true, need a deep copy
                                //  (copy_rdvalue)
@@ -356,6 +464,13 @@ inline std::string Dict::getVal<std::string>(
   return res;
 }
 
+template <>
+inline std::string Dict::getVal<std::string>(const PropKey &what) const {
+  std::string res;
+  getVal(what, res);
+  return res;
+}
+
 // Utility class for holding a Dict::Pair
 //  Dict::Pairs require containers for memory management
 //  This utility class covers cleanup and copying
@@ -364,15 +479,18 @@ class PairHolder : public Dict::Pair {
   PairHolder() : Pair() {}
 
   explicit PairHolder(const PairHolder &p) : Pair(p.key) {
+    this->keyId = p.keyId;
     copy_rdvalue(this->val, p.val);
   }
 
   explicit PairHolder(PairHolder &&p) : Pair(p.key) {
+    this->keyId = p.keyId;
     this->val = p.val;
     p.val.type = RDTypeTag::EmptyTag;
   }
 
   explicit PairHolder(Dict::Pair &&p) : Pair(p.key) {
+    this->keyId = p.keyId;
     this->val = p.val;
     p.val.type = RDTypeTag::EmptyTag;
   }
@@ -0,0 +1,42 @@
+//
+// Copyright (C) David Cosgrove 2025.
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+
+#ifndef MEMORYMAPPEDFILEREADER_H
+#define MEMORYMAPPEDFILEREADER_H
+
+#include <cstddef>
+#include <string>
+
+#include <RDGeneral/export.h>
+
+namespace RDKit {
+//! maps a file read-only into memory
+/*!
+  The mapping is shared, so several processes mapping the same file will
+  share its pages through the OS page cache.
+  Throws std::runtime_error if the file cannot be opened or mapped.
+*/
+struct RDKIT_RDGENERAL_EXPORT MemoryMappedFileReader {
+  MemoryMappedFileReader() = delete;
+  MemoryMappedFileReader(const std::string &filePath);
+  MemoryMappedFileReader(const MemoryMappedFileReader &) = delete;
+  MemoryMappedFileReader(MemoryMappedFileReader &&other);
+
+  ~MemoryMappedFileReader();
+
+  MemoryMappedFileReader &operator=(const MemoryMappedFileReader &) = delete;
+  MemoryMappedFileReader &operator=(MemoryMappedFileReader &&other);
+
+  char *d_mappedMemory{nullptr};
+  size_t d_size{0};
+};
+}  // namespace RDKit
+
+#endif  // MEMORYMAPPEDFILEREADER_H
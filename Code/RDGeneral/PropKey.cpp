@@ -0,0 +1,131 @@
+//
+//  Copyright (C) 2025 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include <array>
+#include <deque>
+#include <iterator>
+#include <unordered_map>
+
+#ifdef RDK_BUILD_THREADSAFE_SSS
+#include <mutex>
+#include <shared_mutex>
+#endif
+
+#include "PropKey.h"
+
+namespace RDKit {
+namespace {
+// the names of the keys in common_properties::keys. They are interned when
+// the table is created, so that properties set by one of these names can be
+// given its id without taking the lock.
+constexpr std::string_view commonNames[] = {"_CIPCode",
+                                             "_CIPRank",
+                                             "_ChiralityPossible",
+                                             "_chiralPermutation",
+                                             "_UnknownStereo",
+                                             "_ringStereoAtoms",
+                                             "molAtomMapNumber",
+                                             "dummyLabel",
+                                             "atomLabel",
+                                             "molParity",
+                                             "_MolFileRLabel",
+                                             "_MolFileBondCfg",
+                                             "_isotopicHs"};
+constexpr std::size_t numCommonNames = std::size(commonNames);
+
+class InternTable {
+ public:
+  InternTable() {
+    d_empty = intern(std::string_view());
+    for (std::size_t i = 0; i < numCommonNames; ++i) {
+      d_common[i] = intern(commonNames[i]);
+      d_commonLengths |= std::uint64_t(1) << commonNames[i].size();
+    }
+  }
+
+  const PropKey::Name *intern(std::string_view name) {
+    {
+#ifdef RDK_BUILD_THREADSAFE_SSS
+      std::shared_lock<std::shared_mutex> lock(d_mutex);
+#endif
+      auto it = d_index.find(name);
+      if (it != d_index.end()) {
+        return it->second;
+      }
+    }
+#ifdef RDK_BUILD_THREADSAFE_SSS
+    std::unique_lock<std::shared_mutex> lock(d_mutex);
+#endif
+    // another thread may have added it in the meantime
+    auto it = d_index.find(name);
+    if (it != d_index.end()) {
+      return it->second;
+    }
+    // elements of a deque don't move when it grows, so the index can refer
+    // to the stored names
+    const auto id = static_cast<std::uint32_t>(d_names.size() + 1);
+    const auto &stored =
+        d_names.emplace_back(PropKey::Name{std::string(name), id});
+    d_index.emplace(stored.str, &stored);
+    return &stored;
+  }
+
+  // d_common is never modified after construction, so this doesn't need
+  // the lock
+  std::uint32_t getCommonId(std::string_view name) const {
+    // most names can be ruled out by their length
+    if (name.size() >= 64 || !((d_commonLengths >> name.size()) & 1)) {
+      return 0;
+    }
+    for (const auto common : d_common) {
+      if (common->str == name) {
+        return common->id;
+      }
+    }
+    return 0;
+  }
+
+  std::size_t size() const {
+#ifdef RDK_BUILD_THREADSAFE_SSS
+    std::shared_lock<std::shared_mutex> lock(d_mutex);
+#endif
+    return d_names.size();
+  }
+
+  const PropKey::Name *d_empty;
+
+ private:
+  std::array<const PropKey::Name *, numCommonNames> d_common;
+  std::uint64_t d_commonLengths = 0;
+  std::deque<PropKey::Name> d_names;
+  std::unordered_map<std::string_view, const PropKey::Name *> d_index;
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  mutable std::shared_mutex d_mutex;
+#endif
+};
+
+InternTable &getInternTable() {
+  // never destroyed, so that keys can be used during static destruction
+  static auto *table = new InternTable;
+  return *table;
+}
+}  // namespace
+
+PropKey::PropKey() : dp_name(getInternTable().d_empty) {}
+
+PropKey::PropKey(std::string_view name)
+    : dp_name(getInternTable().intern(name)) {}
+
+std::size_t PropKey::getNumInterned() { return getInternTable().size(); }
+
+std::uint32_t PropKey::getCommonId(std::string_view name) {
+  return getInternTable().getCommonId(name);
+}
+
+}  // namespace RDKit
@@ -0,0 +1,100 @@
+//
+//  Copyright (C) 2025 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+/*! \file PropKey.h
+
+  \brief Defines the PropKey class
+
+*/
+#include <RDGeneral/export.h>
+#ifndef RD_PROPKEY_H
+#define RD_PROPKEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace RDKit {
+
+//! \brief An interned property name
+/*!
+  Each distinct name is stored once for the whole process, and a PropKey
+  just points at that copy, so PropKeys with the same name are equal if and
+  only if their pointers are. Each interned name also has a small id.
+  Properties which are set with a PropKey remember its id, and looking them
+  up with a PropKey compares ids instead of strings. Code which sets and looks up the same
+  property over and over should create the PropKey once (the keys for the
+  most frequently used common properties are in common_properties::keys)
+  and pass that instead of the name.
+
+  Apart from the names of the keys in common_properties::keys, which are
+  interned up front and are recognized when a property is set by name (or
+  read back from a pickle), only names which are used to construct a
+  PropKey are interned: other properties which are set by name keep their
+  own copy of it. Interned names are never freed, so PropKeys should not be
+  created for names generated on the fly in large numbers.
+*/
+class RDKIT_RDGENERAL_EXPORT PropKey {
+ public:
+  //! the empty name
+  PropKey();
+  //! interns \c name
+  explicit PropKey(std::string_view name);
+
+  //! returns the name
+  const std::string &str() const { return dp_name->str; }
+  operator const std::string &() const { return dp_name->str; }
+  const char *c_str() const { return dp_name->str.c_str(); }
+  std::size_t size() const { return dp_name->str.size(); }
+  bool empty() const { return dp_name->str.empty(); }
+  //! returns the (nonzero) number identifying the name
+  std::uint32_t id() const { return dp_name->id; }
+
+  bool operator==(const PropKey &other) const {
+    return dp_name == other.dp_name;
+  }
+  bool operator==(std::string_view name) const { return str() == name; }
+  bool operator<(const PropKey &other) const { return str() < other.str(); }
+
+  //! returns the number of distinct names which have been interned
+  static std::size_t getNumInterned();
+  //! returns the id of \c name if it is one of the names which are
+  //! interned up front, zero otherwise
+  /*!
+    This doesn't lock and doesn't intern anything, so it is cheap enough to
+    call whenever a property is added by name.
+  */
+  static std::uint32_t getCommonId(std::string_view name);
+
+  //! the stored copy of an interned name
+  struct Name {
+    std::string str;
+    std::uint32_t id;
+  };
+
+  friend std::ostream &operator<<(std::ostream &os, const PropKey &key) {
+    return os << key.str();
+  }
+
+ private:
+  const Name *dp_name;
+};
+}  // namespace RDKit
+
+template <>
+struct std::hash<RDKit::PropKey> {
+  std::size_t operator()(const RDKit::PropKey &key) const noexcept {
+    return std::hash<std::uint32_t>()(key.id());
+  }
+};
+
+#endif
@@ -76,12 +76,15 @@ class RDProps {
   template <typename T>
   void setProp(const std::string_view key, T val, bool computed = false) const {
     if (computed) {
-      STR_VECT compLst;
-      getPropIfPresent(RDKit::detail::computedPropName, compLst);
-      if (std::find(compLst.begin(), compLst.end(), key) == compLst.end()) {
-        compLst.emplace_back(key);
-        d_props.setVal(RDKit::detail::computedPropName, compLst);
-      }
+      addComputedProp(key);
+    }
+    d_props.setVal(key, val);
+  }
+  //! \overload
+  template <typename T>
+  void setProp(const PropKey &key, T val, bool computed = false) const {
+    if (computed) {
+      addComputedProp(key.str());
     }
     d_props.setVal(key, val);
   }
@@ -107,12 +110,22 @@ class RDProps {
   void getProp(const std::string_view key, T &res) const {
     d_props.getVal(key, res);
   }
+  //! \overload
+  template <typename T>
+  void getProp(const PropKey &key, T &res) const {
+    d_props.getVal(key, res);
+  }
 
   //! \overload
   template <typename T>
   T getProp(const std::string_view key) const {
     return d_props.getVal<T>(key);
   }
+  //! \overload
+  template <typename T>
+  T getProp(const PropKey &key) const {
+    return d_props.getVal<T>(key);
+  }
 
   //! returns whether or not we have a \c property with name \c key
   //!  and assigns the value if we do
@@ -121,9 +134,16 @@ class RDProps {
   bool getPropIfPresent(const std::string_view key, T &res) const {
     return d_props.getValIfPresent(key, res);
   }
+  //! \overload
+  template <typename T>
+  bool getPropIfPresent(const PropKey &key, T &res) const {
+    return d_props.getValIfPresent(key, res);
+  }
 
   //! \overload
   bool hasProp(const std::string_view key) const { return d_props.hasVal(key); }
+  //! \overload
+  bool hasProp(const PropKey &key) const { return d_props.hasVal(key); }
 
   //! clears the value of a \c property
   /*!
@@ -134,14 +154,12 @@ class RDProps {
   */
   //! \overload
   void clearProp(const std::string_view key) const {
-    STR_VECT compLst;
-    if (getPropIfPresent(RDKit::detail::computedPropName, compLst)) {
-      auto svi = std::find(compLst.begin(), compLst.end(), key);
-      if (svi != compLst.end()) {
-        compLst.erase(svi);
-        d_props.setVal(RDKit::detail::computedPropName, compLst);
-      }
-    }
+    removeComputedProp(key);
+    d_props.clearVal(key);
+  }
+  //! \overload
+  void clearProp(const PropKey &key) const {
+    removeComputedProp(key.str());
     d_props.clearVal(key);
   }
 
@@ -167,6 +185,27 @@ class RDProps {
   void updateProps(const RDProps &source, bool preserveExisting = false) {
     d_props.update(source.getDict(), preserveExisting);
   }
+
+ private:
+  void addComputedProp(const std::string_view key) const {
+    STR_VECT compLst;
+    getPropIfPresent(RDKit::detail::computedPropName, compLst);
+    if (std::find(compLst.begin(), compLst.end(), key) == compLst.end()) {
+      compLst.emplace_back(key);
+      d_props.setVal(RDKit::detail::computedPropName, compLst);
+    }
+  }
+
+  void removeComputedProp(const std::string_view key) const {
+    STR_VECT compLst;
+    if (getPropIfPresent(RDKit::detail::computedPropName, compLst)) {
+      auto svi = std::find(compLst.begin(), compLst.end(), key);
+      if (svi != compLst.end()) {
+        compLst.erase(svi);
+        d_props.setVal(RDKit::detail::computedPropName, compLst);
+      }
+    }
+  }
 };
 }  // namespace RDKit
 #endif
@@ -17,6 +17,7 @@
 #include "RDProps.h"
 #include <string>
 #include <sstream>
+#include <streambuf>
 #include <unordered_set>
 #include <boost/cstdint.hpp>
 #include <boost/predef.h>
@@ -333,13 +334,20 @@ inline void streamReadStringVec(std::istream &ss, std::vector<std::string> &val,
   }
 }
 
-//! grabs the next line from an instream and returns it.
-inline std::string getLine(std::istream *inStream) {
-  std::string res;
+//! grabs the next line from an instream and puts it in \c res.
+//! The storage of \c res is reused, so calling this in a loop with the same
+//! string does not allocate for every line.
+inline void getLine(std::istream *inStream, std::string &res) {
   std::getline(*inStream, res);
   if (!res.empty() && (res.back() == '\r')) {
-    res.resize(res.length() - 1);
+    res.pop_back();
   }
+}
+
+//! grabs the next line from an instream and returns it.
+inline std::string getLine(std::istream *inStream) {
+  std::string res;
+  getLine(inStream, res);
   return res;
 }
 
@@ -348,6 +356,44 @@ inline std::string getLine(std::istream &inStream) {
   return getLine(&inStream);
 }
 
+//! a read-only streambuf over memory which it does not own.
+/*!
+  This allows text (or binary data) which is already in memory, e.g. in a
+  memory mapped file or a std::string_view, to be read with the stream-based
+  parsers without copying it. Seeking is supported. The memory must outlive
+  the streambuf.
+*/
+class MemoryStreamBuf : public std::streambuf {
+ public:
+  MemoryStreamBuf(const char *data, size_t size) {
+    auto *start = const_cast<char *>(data);
+    setg(start, start, start + size);
+  }
+
+ protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which = std::ios_base::in) override {
+    if (!(which & std::ios_base::in)) {
+      return pos_type(off_type(-1));
+    }
+    off_type base = 0;
+    if (dir == std::ios_base::cur) {
+      base = gptr() - eback();
+    } else if (dir == std::ios_base::end) {
+      base = egptr() - eback();
+    }
+    if (base + off < 0 || base + off > egptr() - eback()) {
+      return pos_type(off_type(-1));
+    }
+    setg(eback(), eback() + base + off, egptr());
+    return pos_type(base + off);
+  }
+  pos_type seekpos(pos_type pos,
+                   std::ios_base::openmode which = std::ios_base::in) override {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+};
+
 // n.b. We can't use RDTypeTag directly, they are implementation
 //  specific
 namespace DTags {
@@ -563,6 +609,7 @@ inline bool streamReadProp(std::istream &ss, Dict::Pair &pair,
                            const CustomPropHandlerVec &handlers = {}) {
   int version = 0;
   streamRead(ss, pair.key, version);
+  pair.keyId = PropKey::getCommonId(pair.key);
 
   unsigned char type;
   streamRead(ss, type);
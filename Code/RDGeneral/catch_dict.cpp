@@ -11,6 +11,8 @@
 #include <catch2/catch_all.hpp>
 #include "Dict.h"
 #include "RDProps.h"
+#include "StreamOps.h"
+#include "types.h"
 using namespace std::string_literals;
 
 TEST_CASE("Dict move semantics") {
@@ -70,3 +72,148 @@ TEST_CASE("RDProps move semantics") {
     CHECK(!d1.hasProp("bar"s));
   }
 }
+
+TEST_CASE("PropKey") {
+  SECTION("interning") {
+    RDKit::PropKey k1("foo");
+    RDKit::PropKey k2("foo"s);
+    RDKit::PropKey k3("bar");
+    CHECK(k1 == k2);
+    CHECK(&k1.str() == &k2.str());
+    CHECK(!(k1 == k3));
+    CHECK(k1 == "foo");
+    CHECK(k1.str() == "foo");
+    CHECK(RDKit::PropKey().empty());
+    CHECK(RDKit::PropKey() == RDKit::PropKey(""));
+    auto nInterned = RDKit::PropKey::getNumInterned();
+    RDKit::PropKey k4("foo");
+    CHECK(RDKit::PropKey::getNumInterned() == nInterned);
+    CHECK(std::hash<RDKit::PropKey>()(k4) == std::hash<RDKit::PropKey>()(k1));
+  }
+  SECTION("Dict lookups") {
+    const RDKit::PropKey foo("foo");
+    const RDKit::PropKey bar("bar");
+    RDKit::Dict d;
+    d.setVal(foo, 1);
+    d.setVal("bar"s, "yep");
+    CHECK(d.hasVal(foo));
+    CHECK(d.hasVal("foo"s));
+    CHECK(d.hasVal(bar));
+    CHECK(d.getVal<int>(foo) == 1);
+    CHECK(d.getVal<int>("foo"s) == 1);
+    CHECK(d.getVal<std::string>(bar) == "yep");
+    int ival = 0;
+    CHECK(d.getValIfPresent(foo, ival));
+    CHECK(ival == 1);
+    std::string sval;
+    CHECK(d.getValIfPresent(bar, sval));
+    CHECK(sval == "yep");
+    CHECK(d.getValIfPresent(foo, sval));
+    CHECK(sval == "1");
+    d.setVal(foo, 2);
+    CHECK(d.getVal<int>("foo"s) == 2);
+    CHECK(d.keys().size() == 2);
+
+    const RDKit::PropKey missing("missing");
+    CHECK(!d.hasVal(missing));
+    CHECK(!d.getValIfPresent(missing, ival));
+    CHECK_THROWS_AS(d.getVal<int>(missing), KeyErrorException);
+    d.clearVal(foo);
+    CHECK(!d.hasVal("foo"s));
+    CHECK_NOTHROW(d.clearVal(foo));
+  }
+  SECTION("RDProps") {
+    const RDKit::PropKey foo("foo");
+    RDKit::RDProps props;
+    props.setProp(foo, 3.5, true);
+    CHECK(props.hasProp(foo));
+    CHECK(props.getProp<double>("foo"s) == 3.5);
+    double dval = 0.0;
+    CHECK(props.getPropIfPresent(foo, dval));
+    CHECK(dval == 3.5);
+    auto computed = props.getProp<std::vector<std::string>>(
+        RDKit::detail::computedPropName);
+    CHECK(computed == std::vector<std::string>{"foo"});
+    CHECK(props.getPropList(false, false).empty());
+    props.clearProp(foo);
+    CHECK(!props.hasProp("foo"s));
+    computed = props.getProp<std::vector<std::string>>(
+        RDKit::detail::computedPropName);
+    CHECK(computed.empty());
+  }
+  SECTION("names set as strings are not interned") {
+    auto nInterned = RDKit::PropKey::getNumInterned();
+    RDKit::RDProps props;
+    props.setProp("not_interned_1"s, 1);
+    CHECK(props.hasProp("not_interned_1"s));
+    std::stringstream ss;
+    RDKit::streamWriteProps(ss, props);
+    RDKit::RDProps props2;
+    RDKit::streamReadProps(ss, props2);
+    CHECK(props2.getProp<int>("not_interned_1"s) == 1);
+    CHECK(RDKit::PropKey::getNumInterned() == nInterned);
+
+    // a PropKey still finds them, and setting one through it reuses the
+    // existing entry
+    const RDKit::PropKey key("not_interned_1");
+    CHECK(props2.getProp<int>(key) == 1);
+    props2.setProp(key, 2);
+    CHECK(props2.getPropList().size() == props.getPropList().size());
+    CHECK(props2.getProp<int>("not_interned_1"s) == 2);
+  }
+  SECTION("common names") {
+    for (const auto key : {&RDKit::common_properties::keys::_CIPCode,
+                           &RDKit::common_properties::keys::_CIPRank,
+                           &RDKit::common_properties::keys::_ChiralityPossible,
+                           &RDKit::common_properties::keys::_chiralPermutation,
+                           &RDKit::common_properties::keys::_UnknownStereo,
+                           &RDKit::common_properties::keys::_ringStereoAtoms,
+                           &RDKit::common_properties::keys::molAtomMapNumber,
+                           &RDKit::common_properties::keys::dummyLabel,
+                           &RDKit::common_properties::keys::atomLabel,
+                           &RDKit::common_properties::keys::molParity,
+                           &RDKit::common_properties::keys::_MolFileRLabel,
+                           &RDKit::common_properties::keys::_MolFileBondCfg,
+                           &RDKit::common_properties::keys::_isotopicHs}) {
+      CHECK(RDKit::PropKey::getCommonId(key->str()) == key->id());
+    }
+    CHECK(RDKit::PropKey::getCommonId("foo") == 0);
+
+    // setting one of them by name, directly or through a pickle, records
+    // the id
+    RDKit::Dict d;
+    d.setVal(RDKit::common_properties::molAtomMapNumber, 3);
+    d.setVal("foo"s, 1);
+    CHECK(d.getData()[0].keyId ==
+          RDKit::common_properties::keys::molAtomMapNumber.id());
+    CHECK(d.getData()[1].keyId == 0);
+    RDKit::RDProps props;
+    props.setProp(RDKit::common_properties::molAtomMapNumber, 3);
+    std::stringstream ss;
+    RDKit::streamWriteProps(ss, props);
+    RDKit::RDProps props2;
+    RDKit::streamReadProps(ss, props2);
+    CHECK(props2.getDict().getData()[0].keyId ==
+          RDKit::common_properties::keys::molAtomMapNumber.id());
+    CHECK(props2.getProp<int>(
+              RDKit::common_properties::keys::molAtomMapNumber) == 3);
+  }
+#ifndef _MSC_VER
+  SECTION("the key id doesn't make Pairs bigger") {
+    CHECK(sizeof(RDKit::Dict::Pair) ==
+          sizeof(std::string) + sizeof(RDKit::RDValue));
+  }
+#endif
+  SECTION("stream round trip") {
+    const RDKit::PropKey foo("foo");
+    RDKit::RDProps props;
+    props.setProp(foo, 7);
+    props.setProp("bar"s, "yep");
+    std::stringstream ss;
+    RDKit::streamWriteProps(ss, props);
+    RDKit::RDProps props2;
+    RDKit::streamReadProps(ss, props2);
+    CHECK(props2.getProp<int>(foo) == 7);
+    CHECK(props2.getProp<std::string>(RDKit::PropKey("bar")) == "yep");
+  }
+}
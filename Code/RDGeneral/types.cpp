@@ -149,6 +149,23 @@ const std::string _QueryAtomGenericLabel = "_QueryAtomGenericLabel";
 const std::string _displayLabel = "_displayLabel";
 const std::string _displayLabelW = "_displayLabelW";
 
+// these have to come after the names they are created from
+namespace keys {
+const PropKey _CIPCode{common_properties::_CIPCode};
+const PropKey _CIPRank{common_properties::_CIPRank};
+const PropKey _ChiralityPossible{common_properties::_ChiralityPossible};
+const PropKey _chiralPermutation{common_properties::_chiralPermutation};
+const PropKey _UnknownStereo{common_properties::_UnknownStereo};
+const PropKey _ringStereoAtoms{common_properties::_ringStereoAtoms};
+const PropKey molAtomMapNumber{common_properties::molAtomMapNumber};
+const PropKey dummyLabel{common_properties::dummyLabel};
+const PropKey atomLabel{common_properties::atomLabel};
+const PropKey molParity{common_properties::molParity};
+const PropKey _MolFileRLabel{common_properties::_MolFileRLabel};
+const PropKey _MolFileBondCfg{common_properties::_MolFileBondCfg};
+const PropKey _isotopicHs{common_properties::_isotopicHs};
+}  // namespace keys
+
 }  // namespace common_properties
 
 const double MAX_DOUBLE = std::numeric_limits<double>::max();
@@ -274,6 +274,25 @@ RDKIT_RDGENERAL_EXPORT extern const std::string atomNote;
 RDKIT_RDGENERAL_EXPORT extern const std::string bondNote;
 RDKIT_RDGENERAL_EXPORT extern const std::string _isotopicHs;
 
+///////////////////////////////////////////////////////////////
+// Interned keys for the properties which are looked up most often (see
+// PropKey). Passing these instead of the names avoids string comparisons.
+namespace keys {
+RDKIT_RDGENERAL_EXPORT extern const PropKey _CIPCode;
+RDKIT_RDGENERAL_EXPORT extern const PropKey _CIPRank;
+RDKIT_RDGENERAL_EXPORT extern const PropKey _ChiralityPossible;
+RDKIT_RDGENERAL_EXPORT extern const PropKey _chiralPermutation;
+RDKIT_RDGENERAL_EXPORT extern const PropKey _UnknownStereo;
+RDKIT_RDGENERAL_EXPORT extern const PropKey _ringStereoAtoms;
+RDKIT_RDGENERAL_EXPORT extern const PropKey molAtomMapNumber;
+RDKIT_RDGENERAL_EXPORT extern const PropKey dummyLabel;
+RDKIT_RDGENERAL_EXPORT extern const PropKey atomLabel;
+RDKIT_RDGENERAL_EXPORT extern const PropKey molParity;
+RDKIT_RDGENERAL_EXPORT extern const PropKey _MolFileRLabel;
+RDKIT_RDGENERAL_EXPORT extern const PropKey _MolFileBondCfg;
+RDKIT_RDGENERAL_EXPORT extern const PropKey _isotopicHs;
+}  // namespace keys
+
 }  // namespace common_properties
 #ifndef WIN32
 typedef long long int LONGINT;